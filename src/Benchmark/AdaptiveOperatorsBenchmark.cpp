@@ -0,0 +1,103 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+// Размер популяции
+const std::size_t populationSize = 20;
+// Количество особей, учавствующих в турнирном отборе
+const std::size_t tournamentSize = 2;
+// Коэффициент мутации
+const double mutation = 0.65;
+// Минимальное значение в гене
+const RealType minValue = -100.0;
+// Максимальное значение в гене
+const RealType maxValue = 10.0;
+// Максимальное количество поколений
+const std::size_t numGenerations = 500;
+// Количество запусков каждой конфигурации
+const std::size_t numRuns = 50;
+
+}
+
+void AdaptiveOperatorsBenchmark()
+{
+    const RealType realTarget = 4.0 + 1e-6;
+    std::cout << std::setprecision(10) << "Real GA, f(x) = x^2 + 4, target f <= " << realTarget << std::endl;
+    Compare("fixed BlendCrossover + GaussianMutator", numRuns, realTarget, DemoFitness, "best f(x)",
+        RunGA(minValue, maxValue, numGenerations, [] ()
+        {
+            return GA::RealGeneticAlgorithm<RealType> {
+                populationSize, tournamentSize, 0.5, { mutation, 0.1 } };
+        }));
+    Compare("1/5 success rule", numRuns, realTarget, DemoFitness, "best f(x)",
+        RunGA(minValue, maxValue, numGenerations, [] ()
+        {
+            return GA::GeneticAlgorithm<
+                GA::RealGene<RealType>,
+                GA::TournamentSelection<GA::RealGene<RealType>>,
+                GA::BlendCrossover<RealType>,
+                GA::OneFifthRuleGaussianMutator<RealType>> {
+                populationSize, tournamentSize, 0.5, { mutation, 0.1 } };
+        }));
+    Compare("self-adaptive step sizes", numRuns, realTarget, DemoFitness, "best f(x)",
+        RunGA(minValue, maxValue, numGenerations, [] ()
+        {
+            return GA::SelfAdaptiveRealGeneticAlgorithm<RealType> {
+                populationSize, tournamentSize, 0.5, { mutation } };
+        }));
+    Compare("adaptive mutator selection", numRuns, realTarget, DemoFitness, "best f(x)",
+        RunGA(minValue, maxValue, numGenerations, [] ()
+        {
+            using Mutator = GA::GaussianMutator<RealType>;
+            return GA::GeneticAlgorithm<
+                GA::RealGene<RealType>,
+                GA::TournamentSelection<GA::RealGene<RealType>>,
+                GA::BlendCrossover<RealType>,
+                GA::AdaptiveMutatorSelection<Mutator, Mutator, Mutator, Mutator>> {
+                populationSize, tournamentSize, 0.5,
+                { { { mutation, 0.001 }, { mutation, 0.1 }, { mutation, 1.0 }, { mutation, 10.0 } } } };
+        }));
+    Compare("adaptive crossover selection", numRuns, realTarget, DemoFitness, "best f(x)",
+        RunGA(minValue, maxValue, numGenerations, [] ()
+        {
+            using Crossover = GA::BlendCrossover<RealType>;
+            return GA::GeneticAlgorithm<
+                GA::RealGene<RealType>,
+                GA::TournamentSelection<GA::RealGene<RealType>>,
+                GA::AdaptiveCrossoverSelection<Crossover, Crossover, Crossover>,
+                GA::GaussianMutator<RealType>> {
+                populationSize, tournamentSize,
+                { { Crossover(0.1), Crossover(0.5), Crossover(0.9) } },
+                { mutation, 0.1 } };
+        }));
+
+    const RealType integerTarget = 4.0 + 1e-5;
+    std::cout << "Integer GA (16 bit), f(x) = x^2 + 4, target f <= " << integerTarget << std::endl;
+    Compare("fixed BitInvertMutator", numRuns, integerTarget, DemoFitness, "best f(x)",
+        RunGA(minValue, maxValue, numGenerations, [] ()
+        {
+            return GA::IntegerGeneticAlgorithm<RealType, uint16_t> {
+                populationSize, tournamentSize, {}, mutation };
+        }));
+    Compare("adaptive mutator selection", numRuns, integerTarget, DemoFitness, "best f(x)",
+        RunGA(minValue, maxValue, numGenerations, [] ()
+        {
+            using Mutator = GA::BitInvertMutator<RealType, uint16_t>;
+            return GA::GeneticAlgorithm<
+                GA::IntegerGene<RealType, uint16_t>,
+                GA::TournamentSelection<GA::IntegerGene<RealType, uint16_t>>,
+                GA::OnePointCrossover<RealType, uint16_t>,
+                GA::AdaptiveMutatorSelection<Mutator, Mutator, Mutator>> {
+                populationSize, tournamentSize, {},
+                { { Mutator(0.9), Mutator(mutation), Mutator(0.0) } } };
+        }));
+}
@@ -0,0 +1,120 @@
+﻿#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+using GeneType = GA::RealGene<RealType>;
+using GAType = GA::RealGeneticAlgorithm<RealType>;
+
+// Размер популяции
+const std::size_t populationSize = 2000;
+// Количество поколений без отмены
+const std::size_t numGenerations = 300;
+// Поколение, увидев которое наблюдатель отменяет запуск
+const std::size_t cancelGeneration = 100;
+
+/**
+ * Создание и инициализация алгоритма
+ *
+ * \param engine Движок генерации случайных чисел
+ * \return Генетический алгоритм
+ */
+GAType MakeGA(
+    std::mt19937& engine)
+{
+    GAType ga { populationSize, 2, 0.5, { 0.65, 0.1 } };
+    GA::DefaultPopulationGenerator<GeneType> generator(-5.0, 5.0);
+    ga.Init(generator, engine);
+    return ga;
+}
+
+}
+
+void AnytimeBenchmark()
+{
+    std::cout << "Best-so-far snapshots, population " << populationSize << std::endl;
+    double plainTime = 0.0;
+    {
+        std::mt19937 engine(5);
+        auto ga = MakeGA(engine);
+        plainTime = MeasureMilliseconds([&] ()
+        {
+            ga.Run(numGenerations, Rastrigin, engine);
+        });
+        std::cout << "  " << numGenerations << " generations, no reader: " << std::fixed << std::setprecision(1)
+            << plainTime << " ms" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+    {
+        // Наблюдатель непрерывно читает снимки и проверяет их согласованность:
+        // приспособленность лучшей особи должна совпадать с функцией от её гена
+        std::mt19937 engine(5);
+        auto ga = MakeGA(engine);
+        std::atomic<bool> done { false };
+        std::size_t reads = 0;
+        std::size_t torn = 0;
+        std::size_t lastGeneration = 0;
+        std::thread reader([&] ()
+        {
+            while (!done.load(std::memory_order_acquire)) {
+                const auto snapshot = ga.GetSnapshot();
+                ++reads;
+                if (snapshot.best.IsEvaluated()) {
+                    torn += snapshot.best.GetFitness() != Rastrigin(snapshot.best()) ? 1 : 0;
+                    torn += snapshot.bestGeneration > snapshot.statistics.generation ? 1 : 0;
+                }
+                lastGeneration = std::max(lastGeneration, snapshot.statistics.generation);
+                std::this_thread::yield();
+            }
+        });
+        const double time = MeasureMilliseconds([&] ()
+        {
+            ga.Run(numGenerations, Rastrigin, engine);
+        });
+        done.store(true, std::memory_order_release);
+        reader.join();
+        const auto snapshot = ga.GetSnapshot();
+        std::cout << "  " << numGenerations << " generations, concurrent reader: " << std::fixed << std::setprecision(1)
+            << time << " ms, " << reads << " snapshots read, " << torn << " inconsistent, highest generation seen "
+            << lastGeneration << std::endl << std::setprecision(6) << "  final snapshot: best f(" << snapshot.best()
+            << ") = " << snapshot.best.GetFitness() << " found in generation " << snapshot.bestGeneration << ", "
+            << snapshot.totalEvaluations << " evaluations, running " << snapshot.running << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+    {
+        // Наблюдатель отменяет запуск, увидев поколение cancelGeneration
+        std::mt19937 engine(5);
+        auto ga = MakeGA(engine);
+        GA::CancellationToken token;
+        ga.SetCancellation(token);
+        std::chrono::steady_clock::time_point cancelTime;
+        std::thread reader([&] ()
+        {
+            while (ga.GetSnapshot().statistics.generation < cancelGeneration) {
+                std::this_thread::yield();
+            }
+            cancelTime = std::chrono::steady_clock::now();
+            token.Cancel();
+        });
+        ga.Run(numGenerations, Rastrigin, engine);
+        const auto stopTime = std::chrono::steady_clock::now();
+        reader.join();
+        const auto snapshot = ga.GetSnapshot();
+        std::cout << "  cancelled after generation " << cancelGeneration << ": stopped at generation "
+            << snapshot.statistics.generation << " of " << numGenerations << ", cancelled " << snapshot.cancelled
+            << ", running " << snapshot.running << ", latency " << std::fixed << std::setprecision(2)
+            << std::chrono::duration<double, std::milli>(stopTime - cancelTime).count() << " ms ("
+            << plainTime / numGenerations << " ms per generation)" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+}
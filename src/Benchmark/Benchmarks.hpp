@@ -0,0 +1,381 @@
+﻿#pragma once
+
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <random>
+#include <vector>
+#include <string>
+#include <iomanip>
+#include <numeric>
+#include <iostream>
+#include <algorithm>
+
+#include "PopulationGenerators.hpp"
+
+// Тип вещественных чисел
+using RealType = double;
+
+/**
+ * Функция приспособленности из демонстрационного приложения:
+ * минимум 4 в точке 0
+ *
+ * \param input Значение гена
+ * \return Значение функции приспособленности
+ */
+inline RealType DemoFitness(
+    const RealType input)
+{
+    return input * input + 4;
+}
+
+/**
+ * Одномерная функция Растригина: многоэкстремальная функция
+ * с глобальным минимумом 0 в точке 0
+ *
+ * \param x Значение гена
+ * \return Значение функции приспособленности
+ */
+inline RealType Rastrigin(
+    const RealType x)
+{
+    return x * x + 10.0 * (1.0 - std::cos(2.0 * 3.14159265358979323846 * x));
+}
+
+/**
+ * Счётчик вычислений функции приспособленности.
+ * Запоминает, после какого по счёту вычисления и через сколько миллисекунд
+ * после создания счётчика впервые была достигнута цель.
+ * Допускает вызов из нескольких потоков
+ */
+class EvaluationCounter
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param target Целевое значение функции приспособленности
+     */
+    explicit EvaluationCounter(
+        const RealType target) :
+        m_target(target),
+        m_start(std::chrono::steady_clock::now()) {}
+
+    /**
+     * Учёт очередного вычисления
+     *
+     * \param fitness Вычисленное значение функции приспособленности
+     * \return
+     */
+    void Count(
+        const RealType fitness)
+    {
+        const std::size_t evaluations = ++m_evaluations;
+        if (fitness <= m_target && m_evaluationsToTarget == 0) {
+            std::size_t expected = 0;
+            if (m_evaluationsToTarget.compare_exchange_strong(expected, evaluations)) {
+                m_millisecondsToTarget = std::chrono::duration<double, std::milli>(
+                    std::chrono::steady_clock::now() - m_start).count();
+            }
+        }
+    }
+
+    /**
+     * Получение количества вычислений до достижения цели
+     *
+     * \return Количество вычислений или 0, если цель не достигнута
+     */
+    std::size_t GetEvaluationsToTarget() const
+    {
+        return m_evaluationsToTarget;
+    }
+
+    /**
+     * Получение времени до достижения цели
+     *
+     * \return Время в миллисекундах (имеет смысл, если цель достигнута)
+     */
+    double GetMillisecondsToTarget() const
+    {
+        return m_millisecondsToTarget;
+    }
+
+    /**
+     * Получение общего количества вычислений
+     *
+     * \return Количество вычислений
+     */
+    std::size_t GetEvaluations() const
+    {
+        return m_evaluations;
+    }
+
+    /**
+     * Функция приспособленности, учитывающая свои вычисления в этом счётчике
+     *
+     * \param fitnessFunction Исходная функция приспособленности
+     * \return Функция приспособленности со счётчиком
+     */
+    template<
+        typename Fitness>
+    auto Counted(
+        const Fitness& fitnessFunction)
+    {
+        return [this, fitnessFunction] (const RealType input)
+        {
+            const RealType fitness = fitnessFunction(input);
+            Count(fitness);
+            return fitness;
+        };
+    }
+private:
+    // Целевое значение
+    RealType m_target;
+    // Момент создания счётчика
+    std::chrono::steady_clock::time_point m_start;
+    // Общее количество вычислений
+    std::atomic<std::size_t> m_evaluations { 0 };
+    // Количество вычислений до достижения цели
+    std::atomic<std::size_t> m_evaluationsToTarget { 0 };
+    // Время до достижения цели
+    double m_millisecondsToTarget = 0.0;
+};
+
+/**
+ * Медиана набора значений
+ *
+ * \param values Значения
+ * \return Медиана
+ */
+template<
+    typename T>
+T Median(
+    std::vector<T> values)
+{
+    if (values.empty()) {
+        return T();
+    }
+    std::nth_element(values.begin(), values.begin() + values.size() / 2, values.end());
+    return values[values.size() / 2];
+}
+
+/**
+ * Время выполнения функции в миллисекундах
+ *
+ * \param function Измеряемая функция
+ * \return Время в миллисекундах
+ */
+template<
+    typename Function>
+double MeasureMilliseconds(
+    Function&& function)
+{
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    const auto finish = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(finish - start).count();
+}
+
+/**
+ * Вывод названия конфигурации в начале строки таблицы
+ *
+ * \param name Название конфигурации
+ * \param width Ширина столбца названия
+ * \return
+ */
+inline void PrintName(
+    const std::string& name,
+    const int width)
+{
+    std::cout << "  " << std::left << std::setw(width) << name << std::right;
+}
+
+/**
+ * Заполнение начальной популяции алгоритма равномерно распределёнными генами
+ *
+ * \param ga Генетический алгоритм
+ * \param minValue Минимальное значение в гене
+ * \param maxValue Максимальное значение в гене
+ * \param engine Движок генерации случайных чисел
+ * \return
+ */
+template<
+    typename GAType,
+    typename Engine>
+void InitUniform(
+    GAType& ga,
+    const RealType minValue,
+    const RealType maxValue,
+    Engine& engine)
+{
+    GA::DefaultPopulationGenerator<typename GAType::gene_type> generator(minValue, maxValue);
+    ga.Init(generator, engine);
+}
+
+/**
+ * Результат запуска алгоритма
+ */
+struct RunResult
+{
+    // Лучшее значение функции приспособленности
+    RealType best = 0;
+    // Время работы в миллисекундах
+    double milliseconds = 0.0;
+};
+
+/**
+ * Запуск алгоритма с измерением времени
+ *
+ * \param ga Генетический алгоритм с заполненной начальной популяцией
+ * \param numGenerations Количество поколений
+ * \param fitnessFunction Функция приспособленности
+ * \param engine Движок генерации случайных чисел
+ * \return Лучшее значение и время работы
+ */
+template<
+    typename GAType,
+    typename Fitness,
+    typename Engine>
+RunResult MeasureRun(
+    GAType& ga,
+    const std::size_t numGenerations,
+    const Fitness& fitnessFunction,
+    Engine& engine)
+{
+    RunResult result;
+    result.milliseconds = MeasureMilliseconds([&] ()
+    {
+        result.best = ga.Run(numGenerations, fitnessFunction, engine);
+    });
+    return result;
+}
+
+/**
+ * Запуск конфигурации с зёрнами 0, 1, ..., numRuns - 1 и вывод количества
+ * вычислений функции приспособленности и времени до достижения цели
+ *
+ * \param name Название конфигурации
+ * \param numRuns Количество запусков
+ * \param target Целевое значение функции приспособленности
+ * \param fitnessFunction Функция приспособленности
+ * \param resultName Название результата запуска в выводе
+ * \param run Функция, запускающая алгоритм с заданными функцией приспособленности
+ *            и движком и возвращающая результат запуска
+ * \return
+ */
+template<
+    typename Fitness,
+    typename Run>
+void Compare(
+    const std::string& name,
+    const std::size_t numRuns,
+    const RealType target,
+    const Fitness& fitnessFunction,
+    const std::string& resultName,
+    Run run)
+{
+    std::vector<std::size_t> evaluations;
+    std::vector<double> times;
+    std::vector<double> results;
+    for (std::size_t i = 0; i < numRuns; ++i) {
+        std::mt19937 engine(static_cast<std::mt19937::result_type>(i));
+        EvaluationCounter counter(target);
+        results.push_back(static_cast<double>(run(counter.Counted(fitnessFunction), engine)));
+        if (counter.GetEvaluationsToTarget() > 0) {
+            evaluations.push_back(counter.GetEvaluationsToTarget());
+            times.push_back(counter.GetMillisecondsToTarget());
+        }
+    }
+    PrintName(name, 40);
+    std::cout << " reached " << std::setw(3) << evaluations.size() << "/" << numRuns
+        << "  median evaluations-to-target = " << std::setw(6) << Median(evaluations)
+        << "  median time-to-target = " << std::setw(8) << Median(times) << " ms"
+        << "  median " << resultName << " = " << Median(results) << std::endl;
+}
+
+/**
+ * Функция запуска генетического алгоритма для Compare: создание алгоритма,
+ * равномерное заполнение начальной популяции и запуск
+ *
+ * \param minValue Минимальное значение в гене
+ * \param maxValue Максимальное значение в гене
+ * \param numGenerations Количество поколений
+ * \param makeGA Функция, создающая генетический алгоритм
+ * \return Функция запуска с заданными функцией приспособленности и движком
+ */
+template<
+    typename MakeGA>
+auto RunGA(
+    const RealType minValue,
+    const RealType maxValue,
+    const std::size_t numGenerations,
+    MakeGA makeGA)
+{
+    return [=] (const auto& fitnessFunction, std::mt19937& engine)
+    {
+        auto ga = makeGA();
+        InitUniform(ga, minValue, maxValue, engine);
+        return ga.Run(numGenerations, fitnessFunction, engine);
+    };
+}
+
+// Сравнение адаптивных операторов с операторами с фиксированными параметрами
+void AdaptiveOperatorsBenchmark();
+
+// Отсев потомков суррогатной моделью
+void SurrogateBenchmark();
+
+// Скорость алгоритмов выбора
+void SelectionBenchmark();
+
+// Гибридный (меметический) режим
+void MemeticBenchmark();
+
+// Скорость создания поколения потомков
+void BreedingBenchmark();
+
+// Метрики разнообразия популяции
+void DiversityBenchmark();
+
+// Дифференциальная эволюция в сравнении с вещественным генетическим алгоритмом
+void DifferentialEvolutionBenchmark();
+
+// Популяция, отображённая в файлы, в сравнении с популяцией в памяти
+void OutOfCoreBenchmark();
+
+// Размещение популяции и потоков по узлам NUMA
+void NumaBenchmark();
+
+// Нишевание с пространственным индексом в сравнении с полным перебором
+void NichingBenchmark();
+
+// Хранение генов и приспособленности с пониженной точностью
+void PrecisionBenchmark();
+
+// Хромосомы-перестановки и пересчёт приспособленности по изменению
+void PermutationBenchmark();
+
+// Пропуск повторного вычисления приспособленности неизменённых особей
+void ReevaluationBenchmark();
+
+// Кооперативная коэволюция с разбиением переменных на подкомпоненты
+void CoevolutionBenchmark();
+
+// Параллельное заполнение популяции квазислучайными последовательностями
+void InitializationBenchmark();
+
+// Быстрые генераторы и пакетные буферы случайных чисел для операторов
+void RandomBenchmark();
+
+// Составные операторы: цепочки и взвешенный выбор за один проход
+void CompositionBenchmark();
+
+// Проверка ограничений до вычисления дорогой функции приспособленности
+void ConstraintsBenchmark();
+
+// Чтение лучшего решения во время работы алгоритма и кооперативная отмена
+void AnytimeBenchmark();
+
+// Самонастраивающийся выбор способа вычисления приспособленности
+void PlannerBenchmark();
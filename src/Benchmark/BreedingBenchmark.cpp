@@ -0,0 +1,125 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+// Размер популяции
+const std::size_t populationSize = 1000000;
+// Коэффициент мутации
+const double mutation = 0.65;
+
+/**
+ * Сравнение поштучных операторов (пара детей по значению, копия родителей,
+ * Population::Mutate) с пакетными, пишущими прямо в буфер следующего поколения
+ *
+ * \param name Название конфигурации
+ * \param crossover Алгоритм скрещивания
+ * \param mutator Алгоритм мутации
+ */
+template<
+    typename GeneType,
+    typename Crossover,
+    typename Mutator>
+void MeasureBreeding(
+    const std::string& name,
+    const Crossover& crossover,
+    const Mutator& mutator)
+{
+    using PopulationType = GA::Population<GeneType>;
+    std::mt19937 engine(42);
+    PopulationType population(populationSize);
+    PopulationType parents(populationSize);
+    PopulationType offspring(populationSize);
+    GA::DefaultPopulationGenerator<GeneType> generator(-100.0, 10.0);
+    population.Init(generator, engine);
+    population.CalculateFitness(DemoFitness);
+    std::vector<std::size_t> indices(populationSize);
+    GA::TournamentSelection<GeneType>(2).SelectIndices(population, indices, engine);
+
+    std::vector<double> legacy;
+    std::vector<double> batched;
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        legacy.push_back(MeasureMilliseconds([&] ()
+        {
+            for (std::size_t j = 0; j < populationSize; ++j) {
+                parents[j] = population[indices[j]];
+            }
+            for (std::size_t j = 0; j < populationSize; j += 2) {
+                auto [child1, child2] = crossover(parents[j], parents[j + 1], engine);
+                offspring[j] = child1;
+                offspring[j + 1] = child2;
+            }
+            offspring.Mutate(mutator, engine);
+        }));
+        batched.push_back(MeasureMilliseconds([&] ()
+        {
+            GA::CrossoverBatch(crossover, population.GetSpan(),
+                GA::Span<const std::size_t>(indices), offspring.GetSpan(), engine);
+            GA::MutateBatch(mutator, offspring.GetSpan(), engine);
+        }));
+    }
+    PrintName(name, 36);
+    std::cout << std::fixed << std::setprecision(2)
+        << " per-pair " << std::setw(8) << Median(legacy) << " ms"
+        << "   batched " << std::setw(8) << Median(batched) << " ms" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+/**
+ * Время нескольких поколений генетического алгоритма при разном количестве потоков
+ *
+ * \param name Название конфигурации
+ * \param makeGA Функция, создающая генетический алгоритм
+ */
+template<
+    typename MakeGA>
+void MeasureThreads(
+    const std::string& name,
+    MakeGA makeGA)
+{
+    const std::size_t numGenerations = 3;
+    std::cout << "  " << name << ", " << numGenerations << " generations:";
+    for (const std::size_t numThreads : { std::size_t(1), std::size_t(2), std::size_t(4), std::size_t(8) }) {
+        std::mt19937 engine(42);
+        auto ga = makeGA();
+        InitUniform(ga, -100.0, 10.0, engine);
+        ga.SetBreedingThreads(numThreads);
+        ga.SetEvaluationThreads(numThreads);
+        const double time = MeasureRun(ga, numGenerations, DemoFitness, engine).milliseconds;
+        std::cout << "  " << numThreads << " thr " << std::fixed << std::setprecision(1) << time << " ms";
+    }
+    std::cout << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+}
+
+void BreedingBenchmark()
+{
+    std::cout << "Crossover + mutation of one generation, population size = " << populationSize << std::endl;
+    MeasureBreeding<GA::IntegerGene<RealType, uint16_t>>("OnePointCrossover + BitInvertMutator",
+        GA::OnePointCrossover<RealType, uint16_t>(),
+        GA::BitInvertMutator<RealType, uint16_t>(mutation));
+    MeasureBreeding<GA::RealGene<RealType>>("BlendCrossover + GaussianMutator",
+        GA::BlendCrossover<RealType>(0.5),
+        GA::GaussianMutator<RealType>(mutation, 0.1));
+
+    std::cout << "Parallel breeding pipeline, population size = " << populationSize
+        << ", hardware threads = " << GA::GetNumThreads(0) << std::endl;
+    MeasureThreads("Integer GA", [] ()
+    {
+        return GA::IntegerGeneticAlgorithm<RealType, uint16_t> { populationSize, 2, {}, mutation };
+    });
+    MeasureThreads("Real GA", [] ()
+    {
+        return GA::RealGeneticAlgorithm<RealType> { populationSize, 2, 0.5, { mutation, 0.1 } };
+    });
+}
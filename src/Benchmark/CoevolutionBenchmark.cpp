@@ -0,0 +1,238 @@
+﻿#include <array>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+
+#include "CooperativeCoevolution.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+// Количество переменных
+const std::size_t dimension = 1000;
+// Количество неразделимых блоков
+const std::size_t numBlocks = 20;
+// Размер неразделимого блока
+const std::size_t blockSize = 25;
+// Границы поиска
+const RealType minValue = -5.0;
+const RealType maxValue = 5.0;
+// Размер подпопуляции
+const std::size_t populationSize = 30;
+// Количество поколений подпопуляции за цикл
+const std::size_t generationsPerCycle = 5;
+// Количество циклов
+const std::size_t numCycles = 100;
+// Размер группы случайного разбиения
+const std::size_t randomGroupSize = 25;
+
+/**
+ * Частично разделимая функция: numBlocks блоков по blockSize переменных,
+ * внутри блока все переменные взаимодействуют (функция Швефеля 1.2),
+ * остальные переменные независимы (сфера). Переменные блоков разбросаны
+ * по вектору случайной перестановкой, минимум 0 в смещённой точке.
+ * Partial суммирует только блоки и слагаемые, затронутые переменными
+ */
+class PartiallySeparableFunction
+{
+public:
+    explicit PartiallySeparableFunction(
+        std::mt19937& engine) :
+        m_shift(dimension),
+        m_block(dimension, numBlocks),
+        m_blocks(numBlocks)
+    {
+        std::uniform_real_distribution<RealType> shift(0.5 * minValue, 0.5 * maxValue);
+        for (auto& value : m_shift) {
+            value = shift(engine);
+        }
+        std::vector<std::size_t> indices(dimension);
+        std::iota(indices.begin(), indices.end(), static_cast<std::size_t>(0));
+        std::shuffle(indices.begin(), indices.end(), engine);
+        for (std::size_t b = 0; b < numBlocks; ++b) {
+            m_blocks[b].assign(indices.begin() + b * blockSize, indices.begin() + (b + 1) * blockSize);
+            for (const std::size_t index : m_blocks[b]) {
+                m_block[index] = b;
+            }
+        }
+    }
+
+    RealType operator () (
+        GA::Span<const RealType> x) const
+    {
+        RealType result = 0.0;
+        for (std::size_t b = 0; b < numBlocks; ++b) {
+            result += Block(x, b);
+        }
+        for (std::size_t i = 0; i < dimension; ++i) {
+            if (m_block[i] == numBlocks) {
+                result += Separable(x, i);
+            }
+        }
+        return result;
+    }
+
+    RealType Partial(
+        GA::Span<const RealType> x,
+        GA::Span<const std::size_t> indices) const
+    {
+        std::array<char, numBlocks> visited {};
+        RealType result = 0.0;
+        for (const std::size_t index : indices) {
+            const std::size_t b = m_block[index];
+            if (b == numBlocks) {
+                result += Separable(x, index);
+            }
+            else if (!visited[b]) {
+                visited[b] = 1;
+                result += Block(x, b);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Количество групп разбиения, совпадающих с блоками функции
+     */
+    std::size_t CountRecoveredBlocks(
+        const GA::VariableGroups& groups) const
+    {
+        std::size_t count = 0;
+        for (auto block : m_blocks) {
+            std::sort(block.begin(), block.end());
+            count += static_cast<std::size_t>(std::count(groups.begin(), groups.end(), block));
+        }
+        return count;
+    }
+private:
+    RealType Block(
+        GA::Span<const RealType> x,
+        const std::size_t b) const
+    {
+        RealType result = 0.0;
+        RealType sum = 0.0;
+        for (const std::size_t index : m_blocks[b]) {
+            sum += x[index] - m_shift[index];
+            result += sum * sum;
+        }
+        return result;
+    }
+
+    RealType Separable(
+        GA::Span<const RealType> x,
+        const std::size_t index) const
+    {
+        const RealType z = x[index] - m_shift[index];
+        return z * z;
+    }
+private:
+    // Смещение минимума
+    std::vector<RealType> m_shift;
+    // Блок переменной (numBlocks - переменная независима)
+    std::vector<std::size_t> m_block;
+    // Переменные блоков
+    std::vector<std::vector<std::size_t>> m_blocks;
+};
+
+/**
+ * Та же функция без вычисления вклада части переменных:
+ * каждая особь подкомпоненты оценивается по всему вектору
+ */
+class FullFunction
+{
+public:
+    explicit FullFunction(
+        const PartiallySeparableFunction& function) :
+        m_function(function) {}
+
+    RealType operator () (
+        GA::Span<const RealType> x) const
+    {
+        return m_function(x);
+    }
+private:
+    const PartiallySeparableFunction& m_function;
+};
+
+/**
+ * Запуск кооперативной коэволюции
+ *
+ * \param name Название конфигурации
+ * \param function Функция приспособленности
+ * \param groups Разбиение (пустое - случайное разбиение каждый цикл)
+ * \param numThreads Количество потоков для подкомпонент
+ */
+template<
+    typename Function>
+void RunCoevolution(
+    const std::string& name,
+    const Function& function,
+    const GA::VariableGroups& groups,
+    const std::size_t numThreads)
+{
+    std::mt19937 engine(42);
+    GA::CooperativeCoevolution<RealType> coevolution(populationSize, 2, 0.9, 1.0 / blockSize);
+    coevolution.Init(dimension, minValue, maxValue, engine);
+    coevolution.SetGenerationsPerCycle(generationsPerCycle);
+    coevolution.SetSubcomponentThreads(numThreads);
+    if (groups.empty()) {
+        coevolution.SetRandomGrouping(randomGroupSize);
+    }
+    else {
+        coevolution.SetGroups(groups);
+    }
+    RealType result = 0.0;
+    const double time = MeasureMilliseconds([&] ()
+    {
+        result = coevolution.Run(numCycles, function, engine);
+    });
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(1)
+        << std::setw(9) << time << " ms   f " << std::setw(10) << coevolution.GetStatistics().front().bestFitness
+        << " -> " << std::setw(8) << std::setprecision(3) << result
+        << "   full " << std::setw(7) << coevolution.GetNumEvaluations()
+        << "   partial " << std::setw(7) << coevolution.GetNumPartialEvaluations() << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+}
+
+void CoevolutionBenchmark()
+{
+    std::mt19937 engine(7);
+    const PartiallySeparableFunction function(engine);
+    const FullFunction fullFunction(function);
+
+    std::cout << "Differential grouping, " << dimension << " variables, " << numBlocks << " blocks of "
+        << blockSize << std::endl;
+    GA::DifferentialGrouping<RealType> grouping(minValue, maxValue);
+    GA::VariableGroups groups;
+    const double partialTime = MeasureMilliseconds([&] ()
+    {
+        groups = grouping(function, dimension);
+    });
+    const std::size_t partialEvaluations = grouping.GetNumEvaluations();
+    GA::VariableGroups fullGroups;
+    const double fullTime = MeasureMilliseconds([&] ()
+    {
+        fullGroups = grouping(fullFunction, dimension);
+    });
+    std::cout << std::fixed << std::setprecision(1)
+        << "  partial evaluation " << std::setw(9) << partialTime << " ms, " << partialEvaluations << " evaluations" << std::endl
+        << "  full evaluation    " << std::setw(9) << fullTime << " ms, " << grouping.GetNumEvaluations() << " evaluations" << std::endl
+        << "  " << groups.size() << " groups, " << function.CountRecoveredBlocks(groups) << " of " << numBlocks
+        << " blocks recovered, same grouping: " << (groups == fullGroups ? "yes" : "no") << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+
+    std::cout << "Cooperative coevolution, population " << populationSize << ", " << generationsPerCycle
+        << " generations per cycle, " << numCycles << " cycles" << std::endl;
+    RunCoevolution("random grouping of " + std::to_string(randomGroupSize), function, {}, 1);
+    RunCoevolution("differential grouping", function, groups, 1);
+    RunCoevolution("differential grouping, full eval", fullFunction, groups, 1);
+    RunCoevolution("differential grouping, " + std::to_string(GA::GetNumThreads(0)) + " threads", function, groups, 0);
+}
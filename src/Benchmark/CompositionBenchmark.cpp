@@ -0,0 +1,243 @@
+﻿#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+using GeneType = GA::IntegerGene<RealType, std::uint16_t>;
+using IndividualType = GA::Individual<GeneType>;
+using BitInvert = GA::BitInvertMutator<RealType, std::uint16_t>;
+using BlockReset = GA::BlockResetMutator<RealType, std::uint16_t>;
+
+// Размер популяции
+const std::size_t populationSize = 1000000;
+// Коэффициент мутации инвертирования бита
+const double bitMutation = 0.65;
+// Коэффициент мутации замены блока (замена происходит редко)
+const double blockMutation = 0.95;
+// Размер заменяемого блока
+const std::size_t blockSize = 6;
+
+/**
+ * Мутатор, написанный вручную: инвертирование бита и замена блока
+ * за один проход. Случайные числа генерируются в том же порядке,
+ * что и в MutatorChain, поэтому результат должен совпасть
+ */
+class HandFusedMutator
+{
+public:
+    using individual_type = IndividualType;
+public:
+    template<
+        typename Engine>
+    void MutateBatch(
+        const GA::Span<individual_type> individuals,
+        Engine& engine) const
+    {
+        const std::size_t size = individuals.GetSize();
+        m_invertFlags.resize(size);
+        m_invertBits.resize(size);
+        m_resetFlags.resize(size);
+        m_offsets.resize(size);
+        m_resetBits.resize(size);
+        GA::RandomStream invertStream(engine);
+        invertStream.FillBernoulli(m_invertFlags, 1.0 - bitMutation);
+        invertStream.FillBounded(m_invertBits, 16);
+        GA::RandomStream resetStream(engine);
+        resetStream.FillBernoulli(m_resetFlags, 1.0 - blockMutation);
+        resetStream.FillBounded(m_offsets, static_cast<std::uint32_t>(16 - blockSize + 1));
+        resetStream.Fill(m_resetBits);
+        const std::uint64_t blockMask = (std::uint64_t(1) << blockSize) - 1;
+        for (std::size_t i = 0; i < size; ++i) {
+            auto& individual = individuals[i];
+            if (m_invertFlags[i]) {
+                individual.GetGene().InvertBit(m_invertBits[i]);
+            }
+            if (m_resetFlags[i]) {
+                const auto& gene = std::as_const(individual).GetGene();
+                const auto mask = static_cast<std::uint16_t>(blockMask << m_offsets[i]);
+                const auto value = static_cast<std::uint16_t>((gene.GetGene() & ~mask) | (m_resetBits[i] & mask));
+                if (value != gene.GetGene()) {
+                    individual.GetGene() = GeneType(value, gene.GetMinValue(), gene.GetMaxValue());
+                }
+            }
+        }
+    }
+private:
+    mutable std::vector<std::uint8_t> m_invertFlags;
+    mutable std::vector<std::uint32_t> m_invertBits;
+    mutable std::vector<std::uint8_t> m_resetFlags;
+    mutable std::vector<std::uint32_t> m_offsets;
+    mutable std::vector<std::uint64_t> m_resetBits;
+};
+
+/**
+ * Два мутатора, применённые друг за другом отдельными проходами
+ */
+class TwoSweepMutator
+{
+public:
+    using individual_type = IndividualType;
+public:
+    template<
+        typename Engine>
+    void MutateBatch(
+        const GA::Span<individual_type> individuals,
+        Engine& engine) const
+    {
+        m_bitInvert.MutateBatch(individuals, engine);
+        m_blockReset.MutateBatch(individuals, engine);
+    }
+private:
+    BitInvert m_bitInvert { bitMutation };
+    BlockReset m_blockReset { blockMutation, blockSize };
+};
+
+/**
+ * Мутатор без пакетного метода: MutateBatch применяет его к каждой особи
+ * по очереди, генерируя случайные числа по одному
+ */
+template<
+    typename Mutator>
+class PerIndividual
+{
+public:
+    using individual_type = typename Mutator::individual_type;
+public:
+    explicit PerIndividual(
+        const Mutator& mutator) :
+        m_mutator(mutator) {}
+
+    template<
+        typename Engine>
+    void operator() (
+        individual_type& individual,
+        Engine& engine) const
+    {
+        m_mutator(individual, engine);
+    }
+private:
+    Mutator m_mutator;
+};
+
+/**
+ * Время мутации популяции и её итоговые гены
+ *
+ * \param name Название конфигурации
+ * \param mutator Алгоритм мутации
+ * \param population Исходная популяция
+ * \return Гены после первой мутации копии популяции
+ */
+template<
+    typename Mutator>
+std::vector<std::uint16_t> MeasureMutation(
+    const std::string& name,
+    const Mutator& mutator,
+    const GA::Population<GeneType>& population)
+{
+    GA::Population<GeneType> offspring(populationSize);
+    std::vector<double> times;
+    std::vector<std::uint16_t> genes;
+    for (int repeat = 0; repeat < 5; ++repeat) {
+        std::mt19937 engine(42);
+        for (std::size_t i = 0; i < populationSize; ++i) {
+            offspring[i] = population[i];
+        }
+        times.push_back(MeasureMilliseconds([&] ()
+        {
+            GA::MutateBatch(mutator, offspring.GetSpan(), engine);
+        }));
+    }
+    for (const auto& individual : offspring.GetSpan()) {
+        genes.push_back(individual.GetGene().GetGene());
+    }
+    std::cout << "  " << std::left << std::setw(34) << name << std::right << std::fixed << std::setprecision(2)
+        << std::setw(8) << Median(times) << " ms" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    return genes;
+}
+
+/**
+ * Функция Растригина с ослабленным квадратичным слагаемым:
+ * многоэкстремальная функция на [-100, 10) с минимумом 0 в точке 0
+ */
+RealType ScaledRastrigin(
+    const RealType x)
+{
+    return x * x / 100.0 + 10.0 * (1.0 - std::cos(2.0 * 3.14159265358979323846 * x));
+}
+
+/**
+ * Время и результат генетического алгоритма с заданным мутатором
+ *
+ * \param name Название конфигурации
+ * \param mutator Алгоритм мутации
+ */
+template<
+    typename Mutator>
+void MeasureMutatorRuns(
+    const std::string& name,
+    const Mutator& mutator)
+{
+    const std::size_t numGenerations = 20;
+    const std::size_t gaPopulationSize = 100000;
+    std::vector<double> results;
+    double time = 0.0;
+    for (unsigned seed = 1; seed <= 5; ++seed) {
+        std::mt19937 engine(seed);
+        GA::GeneticAlgorithm<
+            GeneType,
+            GA::TournamentSelection<GeneType>,
+            GA::OnePointCrossover<RealType, std::uint16_t>,
+            Mutator> ga { gaPopulationSize, 2, {}, mutator };
+        InitUniform(ga, -100.0, 10.0, engine);
+        const auto run = MeasureRun(ga, numGenerations, ScaledRastrigin, engine);
+        results.push_back(run.best);
+        time += run.milliseconds;
+    }
+    PrintName(name, 34);
+    std::cout << std::fixed << std::setprecision(1)
+        << std::setw(8) << time / results.size() << " ms   median best f(x) " << std::setprecision(4)
+        << Median(results) << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+}
+
+void CompositionBenchmark()
+{
+    GA::Population<GeneType> population(populationSize);
+    {
+        std::mt19937 engine(7);
+        GA::DefaultPopulationGenerator<GeneType> generator(-100.0, 10.0);
+        population.Init(generator, engine);
+    }
+    const BitInvert bitInvert(bitMutation);
+    const BlockReset blockReset(blockMutation, blockSize);
+
+    std::cout << "Mutation of " << populationSize << " individuals: bit invert + block reset of "
+        << blockSize << " bits" << std::endl;
+    MeasureMutation("BitInvertMutator only", bitInvert, population);
+    const auto twoSweeps = MeasureMutation("two separate sweeps", TwoSweepMutator(), population);
+    const auto handFused = MeasureMutation("hand-written fused mutator", HandFusedMutator(), population);
+    const auto chained = MeasureMutation("MutatorChain", GA::MutatorChain(bitInvert, blockReset), population);
+    MeasureMutation("MutatorChoice 0.9 / 0.1", GA::MutatorChoice({ 0.9, 0.1 }, bitInvert, blockReset), population);
+    MeasureMutation("MutatorChain, per individual", PerIndividual(GA::MutatorChain(bitInvert, blockReset)), population);
+    std::cout << "  MutatorChain matches hand-written mutator: " << (chained == handFused ? "yes" : "no")
+        << ", matches two sweeps: " << (chained == twoSweeps ? "yes" : "no") << std::endl;
+
+    std::cout << "Integer GA on a multimodal function, population 100000, 20 generations, 5 seeds" << std::endl;
+    MeasureMutatorRuns("BitInvertMutator", bitInvert);
+    MeasureMutatorRuns("MutatorChain with BlockReset", GA::MutatorChain(bitInvert, blockReset));
+    MeasureMutatorRuns("MutatorChoice 0.9 / 0.1", GA::MutatorChoice({ 0.9, 0.1 }, bitInvert, blockReset));
+}
@@ -0,0 +1,136 @@
+﻿#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <string>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+using GeneType = GA::RealGene<RealType>;
+using GAType = GA::RealGeneticAlgorithm<RealType>;
+
+// Размер популяции
+const std::size_t populationSize = 10000;
+// Количество поколений
+const std::size_t numGenerations = 30;
+// Количество итераций, имитирующих дорогую функцию приспособленности
+const std::size_t fitnessCost = 200;
+// Допустимая область [lowerBound, upperBound]
+const RealType lowerBound = -2.0;
+const RealType upperBound = 1.0;
+// Коэффициент статического штрафа
+const RealType penaltyFactor = 1000.0;
+
+/**
+ * Дорогая функция приспособленности с безусловным минимумом 4 в точке 3.
+ * С учётом ограничений минимум равен 8 в точке 1
+ *
+ * \param input Значение гена
+ * \return Значение функции приспособленности
+ */
+RealType ExpensiveFitness(
+    const RealType input)
+{
+    RealType noise = 0;
+    for (std::size_t i = 0; i < fitnessCost; ++i) {
+        noise += std::sin(input + static_cast<RealType>(i));
+    }
+    // Слагаемое равно нулю, но компилятор не может убрать цикл
+    return (input - 3) * (input - 3) + 4 + noise * 0;
+}
+
+/**
+ * Дешёвая проверка ограничений lowerBound <= x <= upperBound
+ *
+ * \param input Значение гена
+ * \return Суммарное нарушение ограничений (0 - значение допустимо)
+ */
+RealType Violation(
+    const RealType input)
+{
+    return std::max<RealType>(lowerBound - input, 0) + std::max<RealType>(input - upperBound, 0);
+}
+
+/**
+ * Запуск алгоритма и вывод сэкономленных вычислений и лучшей допустимой особи
+ *
+ * \param name Название конфигурации
+ * \param constraints Обработчик ограничений (пустой - статический штраф в функции приспособленности)
+ */
+void Measure(
+    const std::string& name,
+    const GA::ConstraintHandler<GeneType>& constraints)
+{
+    std::mt19937 engine(42);
+    GAType ga { populationSize, 2, 0.5, { 0.65, 0.5 } };
+    InitUniform(ga, -5.0, 5.0, engine);
+    ga.SetConstraints(constraints);
+    const bool staticPenalty = !constraints.IsEnabled();
+    std::size_t evaluations = 0;
+    const double time = MeasureRun(ga, numGenerations, [&evaluations, staticPenalty] (const RealType input)
+    {
+        ++evaluations;
+        const RealType fitness = ExpensiveFitness(input);
+        return staticPenalty ? fitness + penaltyFactor * Violation(input) : fitness;
+    }, engine).milliseconds;
+    std::size_t rejected = 0;
+    std::size_t repairs = 0;
+    for (const auto& statistics : ga.GetStatistics()) {
+        rejected += statistics.numRejectedEvaluations;
+        repairs += statistics.numRepairs;
+    }
+    // Лучшая допустимая особь итоговой популяции
+    std::size_t feasible = 0;
+    RealType best = std::numeric_limits<RealType>::max();
+    RealType bestValue = 0;
+    for (const auto& individual : ga.GetPopulation().GetSpan()) {
+        if (Violation(individual()) <= 0) {
+            ++feasible;
+            if (individual.GetFitness() < best) {
+                best = individual.GetFitness();
+                bestValue = individual();
+            }
+        }
+    }
+    const auto& first = ga.GetStatistics().front();
+    const auto& last = ga.GetStatistics().back();
+    PrintName(name, 30);
+    std::cout << std::fixed << std::setprecision(1)
+        << std::setw(9) << time << " ms" << std::setw(8) << evaluations << " evals" << std::setw(8) << rejected
+        << " saved" << std::setw(7) << repairs << " repaired   saved gen 0/1/last "
+        << first.numRejectedEvaluations << "/" << ga.GetStatistics()[1].numRejectedEvaluations << "/"
+        << last.numRejectedEvaluations << std::setprecision(4) << "   best feasible ";
+    if (feasible > 0) {
+        std::cout << "f(" << bestValue << ") = " << best;
+    }
+    else {
+        std::cout << "none";
+    }
+    std::cout << "   feasible " << std::setprecision(1) << 100.0 * feasible / populationSize << "%" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+}
+
+void ConstraintsBenchmark()
+{
+    std::cout << "Constrained minimum of an expensive function on [" << lowerBound << ", " << upperBound
+        << "], genes drawn from [-5, 5), population " << populationSize << ", " << numGenerations
+        << " generations" << std::endl;
+    Measure("static penalty in objective", {});
+    Measure("death penalty", { Violation, GA::ConstraintHandling::DeathPenalty });
+    Measure("Deb's feasibility rules", { Violation, GA::ConstraintHandling::FeasibilityRules });
+    Measure("feasibility rules + repair", { Violation, GA::ConstraintHandling::FeasibilityRules,
+        [] (GeneType& gene)
+        {
+            gene.SetValue(std::clamp(gene(), lowerBound, upperBound));
+        } });
+}
@@ -0,0 +1,101 @@
+﻿#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+
+#include "GeneticAlgorithm.hpp"
+#include "DifferentialEvolution.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+// Размер популяции
+const std::size_t populationSize = 20;
+// Количество особей, учавствующих в турнирном отборе
+const std::size_t tournamentSize = 2;
+// Коэффициент мутации
+const double mutation = 0.65;
+// Коэффициент для скрещивания смешением
+const double blendAlpha = 0.5;
+// Стандартное отклонение для Гауссовой мутации
+const double stddev = 0.1;
+// Максимальное количество поколений
+const std::size_t numGenerations = 300;
+// Количество запусков каждой конфигурации
+const std::size_t numRuns = 50;
+// Целевое значение функции приспособленности (у всех функций минимум 0)
+const RealType target = 1e-6;
+// Число π
+const RealType pi = 3.14159265358979323846;
+
+/**
+ * Тестовая функция: значение, область поиска и название
+ */
+struct TestFunction
+{
+    // Название
+    std::string name;
+    // Функция
+    RealType (*function)(const RealType);
+    // Минимальное значение в гене
+    RealType minValue;
+    // Максимальное значение в гене
+    RealType maxValue;
+};
+
+RealType Sphere(const RealType x)
+{
+    return x * x;
+}
+
+RealType Ackley(const RealType x)
+{
+    return -20 * std::exp(-0.2 * std::abs(x)) - std::exp(std::cos(2 * pi * x)) + 20 + std::exp(1.0);
+}
+
+RealType Griewank(const RealType x)
+{
+    return 1 + x * x / 4000 - std::cos(x);
+}
+
+}
+
+void DifferentialEvolutionBenchmark()
+{
+    using Strategy = GA::DifferentialEvolution<RealType>::Strategy;
+    const std::vector<TestFunction> tests {
+        { "sphere", Sphere, -100.0, 10.0 },
+        { "Rastrigin", Rastrigin, -5.12, 5.12 },
+        { "Ackley", Ackley, -32.768, 32.768 },
+        { "Griewank", Griewank, -600.0, 600.0 }
+    };
+    for (const auto& test : tests) {
+        std::cout << test.name << ", x in [" << test.minValue << ", " << test.maxValue
+            << "], target f <= " << target << std::endl;
+        Compare("RealGeneticAlgorithm", numRuns, target, test.function, "final fitness",
+            RunGA(test.minValue, test.maxValue, numGenerations, [] ()
+            {
+                return GA::RealGeneticAlgorithm<RealType> {
+                    populationSize, tournamentSize, blendAlpha, { mutation, stddev } };
+            }));
+        Compare("DE rand/1/bin", numRuns, target, test.function, "final fitness",
+            RunGA(test.minValue, test.maxValue, numGenerations, [] ()
+            {
+                return GA::DifferentialEvolution<RealType>(populationSize, Strategy::Rand1Bin);
+            }));
+        Compare("DE best/1/bin", numRuns, target, test.function, "final fitness",
+            RunGA(test.minValue, test.maxValue, numGenerations, [] ()
+            {
+                return GA::DifferentialEvolution<RealType>(populationSize, Strategy::Best1Bin);
+            }));
+        Compare("DE current-to-pbest (JADE)", numRuns, target, test.function, "final fitness",
+            RunGA(test.minValue, test.maxValue, numGenerations, [] ()
+            {
+                return GA::DifferentialEvolution<RealType>(populationSize, Strategy::CurrentToPBest1Bin);
+            }));
+    }
+}
@@ -0,0 +1,112 @@
+﻿#include <bitset>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+using IntegerType = uint16_t;
+
+/**
+ * Наивное среднее попарное расстояние Хэмминга: O(n²)
+ */
+double NaiveMeanHammingDistance(const std::vector<IntegerType>& genes)
+{
+    double sum = 0.0;
+    for (std::size_t i = 0; i < genes.size(); ++i) {
+        for (std::size_t j = i + 1; j < genes.size(); ++j) {
+            sum += std::bitset<sizeof(IntegerType) * 8>(genes[i] ^ genes[j]).count();
+        }
+    }
+    return sum / (0.5 * genes.size() * (genes.size() - 1));
+}
+
+/**
+ * Частоты аллелей поразрядным проходом: O(n·bits)
+ */
+double PerBitMeanHammingDistance(const std::vector<IntegerType>& genes)
+{
+    double sum = 0.0;
+    for (std::size_t bit = 0; bit < sizeof(IntegerType) * 8; ++bit) {
+        std::size_t count = 0;
+        for (const IntegerType gene : genes) {
+            count += (gene >> bit) & 1;
+        }
+        sum += static_cast<double>(count) * (genes.size() - count);
+    }
+    return sum / (0.5 * genes.size() * (genes.size() - 1));
+}
+
+/**
+ * Частоты аллелей вертикальными счётчиками
+ */
+double BitSlicedMeanHammingDistance(const std::vector<IntegerType>& genes)
+{
+    GA::AlleleFrequencies<IntegerType> alleles;
+    for (const IntegerType gene : genes) {
+        alleles.Add(gene);
+    }
+    return alleles.GetMeanHammingDistance();
+}
+
+}
+
+void DiversityBenchmark()
+{
+    std::mt19937 engine(42);
+    std::cout << "Mean pairwise Hamming distance, 16 bit genes" << std::endl;
+    for (const std::size_t size : { std::size_t(2000), std::size_t(100000), std::size_t(10000000) }) {
+        std::vector<IntegerType> genes(size);
+        for (auto& gene : genes) {
+            gene = static_cast<IntegerType>(engine());
+        }
+        double naive = 0.0;
+        double perBit = 0.0;
+        double bitSliced = 0.0;
+        std::cout << "  n = " << std::setw(8) << size << std::fixed << std::setprecision(3);
+        if (size <= 2000) {
+            std::cout << "  naive O(n^2) " << MeasureMilliseconds([&] () { naive = NaiveMeanHammingDistance(genes); }) << " ms";
+        }
+        std::cout << "  per-bit " << MeasureMilliseconds([&] () { perBit = PerBitMeanHammingDistance(genes); }) << " ms";
+        std::cout << "  bit-sliced " << MeasureMilliseconds([&] () { bitSliced = BitSlicedMeanHammingDistance(genes); }) << " ms";
+        std::cout << "  distance = " << bitSliced;
+        if (size <= 2000) {
+            std::cout << " (naive " << naive << ")";
+        }
+        std::cout << " (per-bit " << perBit << ")" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    std::cout << "Integer GA diversity by generation (population 200)" << std::endl;
+    GA::IntegerGeneticAlgorithm<RealType, IntegerType> integerGA { 200, 2, {}, 0.65 };
+    InitUniform(integerGA, -100.0, 10.0, engine);
+    integerGA.Run(60, DemoFitness, engine);
+    for (const auto& statistics : integerGA.GetStatistics()) {
+        if (statistics.generation % 10 == 0) {
+            std::cout << "  generation " << std::setw(3) << statistics.generation
+                << "  best = " << std::setw(10) << statistics.bestFitness
+                << "  Hamming = " << std::setw(8) << statistics.meanHammingDistance
+                << "  entropy = " << std::setw(8) << statistics.alleleEntropy << std::endl;
+        }
+    }
+
+    std::cout << "Real GA gene variance by generation (population 200)" << std::endl;
+    GA::RealGeneticAlgorithm<RealType> realGA { 200, 2, 0.5, { 0.65, 0.1 } };
+    InitUniform(realGA, -100.0, 10.0, engine);
+    realGA.Run(60, DemoFitness, engine);
+    for (const auto& statistics : realGA.GetStatistics()) {
+        if (statistics.generation % 10 == 0) {
+            std::cout << "  generation " << std::setw(3) << statistics.generation
+                << "  best = " << std::setw(10) << statistics.bestFitness
+                << "  mean gene = " << std::setw(10) << statistics.geneMean
+                << "  variance = " << std::setw(10) << statistics.geneVariance << std::endl;
+        }
+    }
+}
@@ -0,0 +1,151 @@
+﻿#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "Population.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+using GeneType = GA::RealGene<RealType>;
+using GeneratorType = GA::DefaultPopulationGenerator<GeneType>;
+
+// Размер большой популяции
+const std::size_t largePopulationSize = 10000000;
+// Размер малой популяции для оценки покрытия
+const std::size_t smallPopulationSize = 100;
+// Количество запусков для оценки покрытия
+const std::size_t numRuns = 101;
+// Границы поиска
+const RealType minValue = -100.0;
+const RealType maxValue = 10.0;
+
+/**
+ * Генератор без заполнения всей популяции: Population::Init
+ * создаёт особей по одной, как до появления Generate
+ */
+class SingleGenerator
+{
+public:
+    explicit SingleGenerator(
+        const GeneratorType& generator) :
+        m_generator(generator) {}
+
+    template<
+        typename Engine>
+    GA::Individual<GeneType> operator () (
+        Engine& engine) const
+    {
+        return m_generator(engine);
+    }
+private:
+    const GeneratorType& m_generator;
+};
+
+/**
+ * Покрытие области поиска популяцией
+ */
+struct Coverage
+{
+    // Звёздная невязка
+    double discrepancy = 0.0;
+    // Наибольший непокрытый интервал
+    double gap = 0.0;
+};
+
+/**
+ * Вычисление покрытия по значениям генов популяции
+ *
+ * \param population Популяция
+ * \return Покрытие в долях ширины области
+ */
+Coverage MeasureCoverage(
+    const GA::Population<GeneType>& population)
+{
+    const std::size_t size = population.GetSize();
+    std::vector<double> points(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        points[i] = (population[i]() - minValue) / (maxValue - minValue);
+    }
+    std::sort(points.begin(), points.end());
+    Coverage coverage;
+    double previous = 0.0;
+    for (std::size_t i = 0; i < size; ++i) {
+        coverage.discrepancy = std::max(coverage.discrepancy, std::abs(points[i] - (2.0 * i + 1.0) / (2.0 * size)));
+        coverage.gap = std::max(coverage.gap, points[i] - previous);
+        previous = points[i];
+    }
+    coverage.gap = std::max(coverage.gap, 1.0 - previous);
+    coverage.discrepancy += 0.5 / size;
+    return coverage;
+}
+
+/**
+ * Время заполнения большой популяции и покрытие малой
+ *
+ * \param name Название конфигурации
+ * \param sampling Способ выбора значений
+ * \param numThreads Количество потоков
+ * \param population Большая популяция
+ */
+void MeasureSampling(
+    const std::string& name,
+    const GA::Sampling sampling,
+    const std::size_t numThreads,
+    GA::Population<GeneType>& population)
+{
+    std::mt19937 engine(42);
+    const GeneratorType generator(minValue, maxValue, sampling, numThreads);
+    const double time = MeasureMilliseconds([&] ()
+    {
+        population.Init(generator, engine);
+    });
+    std::vector<double> discrepancies;
+    std::vector<double> gaps;
+    for (std::size_t run = 0; run < numRuns; ++run) {
+        GA::Population<GeneType> small(smallPopulationSize);
+        small.Init(generator, engine);
+        const Coverage coverage = MeasureCoverage(small);
+        discrepancies.push_back(coverage.discrepancy);
+        gaps.push_back(coverage.gap);
+    }
+    std::cout << "  " << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(1)
+        << std::setw(8) << time << " ms" << std::setprecision(4)
+        << "   discrepancy " << Median(discrepancies)
+        << "   largest gap " << Median(gaps) << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+}
+
+void InitializationBenchmark()
+{
+    GA::Population<GeneType> population(largePopulationSize);
+    const std::size_t numThreads = GA::GetNumThreads(0);
+    std::cout << "Initialization of " << largePopulationSize << " individuals; coverage of "
+        << smallPopulationSize << " individuals, median of " << numRuns << " runs" << std::endl;
+    {
+        std::mt19937 engine(42);
+        const GeneratorType generator(minValue, maxValue);
+        const double time = MeasureMilliseconds([&] ()
+        {
+            population.Init(SingleGenerator(generator), engine);
+        });
+        std::cout << "  " << std::left << std::setw(26) << "one at a time" << std::right << std::fixed
+            << std::setprecision(1) << std::setw(8) << time << " ms" << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+    const std::string threads = ", " + std::to_string(numThreads) + " threads";
+    MeasureSampling("uniform, 1 thread", GA::Sampling::Uniform, 1, population);
+    MeasureSampling("uniform" + threads, GA::Sampling::Uniform, 0, population);
+    MeasureSampling("Sobol" + threads, GA::Sampling::Sobol, 0, population);
+    MeasureSampling("Halton" + threads, GA::Sampling::Halton, 0, population);
+    MeasureSampling("Latin hypercube" + threads, GA::Sampling::LatinHypercube, 0, population);
+}
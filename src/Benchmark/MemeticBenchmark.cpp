@@ -0,0 +1,92 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+// Размер популяции
+const std::size_t populationSize = 20;
+// Количество особей, учавствующих в турнирном отборе
+const std::size_t tournamentSize = 2;
+// Коэффициент мутации
+const double mutation = 0.65;
+// Минимальное значение в гене
+const RealType minValue = -100.0;
+// Максимальное значение в гене
+const RealType maxValue = 10.0;
+// Максимальное количество поколений
+const std::size_t numGenerations = 200;
+// Количество запусков каждой конфигурации
+const std::size_t numRuns = 20;
+// Искусственная стоимость одного вычисления функции приспособленности
+const std::chrono::microseconds evaluationCost(20);
+
+/**
+ * Функция приспособленности из демонстрационного приложения
+ * с искусственной задержкой, имитирующей дорогое вычисление
+ */
+RealType FitnessFunction(const RealType input)
+{
+    const auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < evaluationCost) {
+    }
+    return input * input + 4;
+}
+
+}
+
+void MemeticBenchmark()
+{
+    std::cout << "Fitness cost = " << evaluationCost.count() << " us, threads = "
+        << GA::GetNumThreads(0) << std::endl;
+
+    const RealType realTarget = 4.0 + 1e-8;
+    std::cout << std::setprecision(10) << "Real GA, target f <= " << realTarget << std::endl;
+    Compare("GA", numRuns, realTarget, FitnessFunction, "best f(x)",
+        RunGA(minValue, maxValue, numGenerations, [] ()
+        {
+            return GA::RealGeneticAlgorithm<RealType> {
+                populationSize, tournamentSize, 0.5, { mutation, 0.1 } };
+        }));
+    for (const std::size_t period : { std::size_t(1), std::size_t(5) }) {
+        Compare("memetic, coordinate search, K = " + std::to_string(period),
+            numRuns, realTarget, FitnessFunction, "best f(x)",
+            RunGA(minValue, maxValue, numGenerations, [period] ()
+            {
+                GA::RealGeneticAlgorithm<RealType> ga {
+                    populationSize, tournamentSize, 0.5, { mutation, 0.1 } };
+                ga.SetRefinement(GA::MemeticRefinement<GA::CoordinateSearch<RealType>>(
+                    { 1.0, 1e-6, 40 }, period, 4));
+                return ga;
+            }));
+    }
+
+    const RealType integerTarget = 4.0 + 1e-5;
+    std::cout << "Integer GA (16 bit), target f <= " << integerTarget << std::endl;
+    Compare("GA", numRuns, integerTarget, FitnessFunction, "best f(x)",
+        RunGA(minValue, maxValue, numGenerations, [] ()
+        {
+            return GA::IntegerGeneticAlgorithm<RealType, uint16_t> {
+                populationSize, tournamentSize, {}, mutation };
+        }));
+    for (const std::size_t period : { std::size_t(1), std::size_t(5) }) {
+        Compare("memetic, bit-flip hill climbing, K = " + std::to_string(period),
+            numRuns, integerTarget, FitnessFunction, "best f(x)",
+            RunGA(minValue, maxValue, numGenerations, [period] ()
+            {
+                GA::IntegerGeneticAlgorithm<RealType, uint16_t> ga {
+                    populationSize, tournamentSize, {}, mutation };
+                ga.SetRefinement(GA::MemeticRefinement<GA::BitFlipHillClimbing<RealType, uint16_t>>(
+                    GA::BitFlipHillClimbing<RealType, uint16_t>(64), period, 4));
+                return ga;
+            }));
+    }
+}
@@ -0,0 +1,121 @@
+﻿#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+// Счётчик глобальных выделений. Он заменяет operator new для всей программы,
+// поэтому бенчмарк памяти собирается отдельно от остальных бенчмарков
+GA_COUNT_GLOBAL_ALLOCATIONS()
+
+namespace
+{
+
+using GeneType = GA::RealGene<RealType>;
+
+// Размер популяции
+const std::size_t populationSize = 20000;
+// Количество поколений
+const std::size_t numGenerations = 10;
+
+/**
+ * Вывод выделений этапа
+ *
+ * \param usage Выделения этапа
+ */
+void PrintUsage(
+    const GA::MemoryUsage& usage)
+{
+    std::cout << std::setw(6) << usage.numAllocations << " / " << std::setw(7) << usage.numBytes
+        << " B / " << std::setw(7) << usage.peakBytes << " B";
+}
+
+/**
+ * Запуск алгоритма с учётом памяти и вывод памяти по поколениям
+ *
+ * \param name Название конфигурации
+ * \param breedingThreads Количество потоков создания потомков
+ */
+void MeasureMemory(
+    const std::string& name,
+    const std::size_t breedingThreads)
+{
+    std::mt19937 engine(1);
+    GA::RealGeneticAlgorithm<RealType> ga { populationSize, 3, 0.5, { 0.8, 0.1 } };
+    InitUniform(ga, -5.0, 5.0, engine);
+    ga.SetBreedingThreads(breedingThreads);
+    ga.SetMemoryAccounting(true);
+    const auto best = ga.Run(numGenerations, Rastrigin, engine);
+    std::cout << "  " << name << ", best f(x) " << best << std::endl;
+    std::cout << "    gen  evaluation (allocs / bytes / peak)   breeding (allocs / bytes / peak)"
+        << "     bookkeeping   arena / upstream" << std::endl;
+    for (const auto& statistics : ga.GetStatistics()) {
+        const auto& memory = statistics.memory;
+        std::cout << "    " << std::setw(3) << statistics.generation << "  ";
+        PrintUsage(memory.evaluation);
+        std::cout << "   ";
+        PrintUsage(memory.breeding);
+        std::cout << "   " << std::setw(4) << memory.bookkeeping.numAllocations
+            << "   " << std::setw(5) << memory.arenaBytes << " / " << memory.arenaUpstreamBytes << std::endl;
+    }
+    std::cout << "    population buffers: " << ga.GetStatistics().back().memory.populationBytes << " B" << std::endl;
+}
+
+}
+
+/**
+ * Учёт выделений памяти по этапам поколения и арена поколения
+ */
+int main()
+{
+    {
+        // Отбор одной особи турниром: раньше каждый вызов копировал участников во временный массив
+        GA::Population<GeneType> population(populationSize);
+        std::mt19937 engine(3);
+        GA::DefaultPopulationGenerator<GeneType> generator(-5.0, 5.0);
+        population.Init(generator, engine);
+        population.CalculateFitness(Rastrigin);
+        GA::TournamentSelection<GeneType> selection(3);
+        GA::MemoryUsage usage;
+        double sum = 0.0;
+        {
+            GA::MemoryPhase phase(usage, true);
+            for (std::size_t i = 0; i < populationSize; ++i) {
+                sum += selection.Select(population, engine).GetFitness();
+            }
+        }
+        std::cout << "TournamentSelection::Select, " << populationSize << " calls: "
+            << usage.numAllocations << " allocations, " << usage.numBytes << " bytes (checksum "
+            << sum / populationSize << ")" << std::endl;
+    }
+    {
+        // Арена поколения: после первого поколения запросов к куче быть не должно
+        GA::GenerationArena arena(256);
+        GA::MemoryUsage usage;
+        std::size_t upstream = 0;
+        {
+            GA::MemoryPhase phase(usage, true);
+            for (int generation = 0; generation < 100; ++generation) {
+                arena.Reset();
+                std::pmr::vector<double> scratch(arena.GetResource());
+                scratch.resize(100);
+                upstream = arena.GetUpstreamBytes();
+            }
+        }
+        std::cout << "GenerationArena, 100 generations of 800 B scratch in a 256 B arena: "
+            << usage.numAllocations << " heap allocations, capacity " << arena.GetCapacity()
+            << " B, upstream bytes in last generation " << upstream << std::endl;
+    }
+    std::cout << "Real GA, population " << populationSize << ", " << numGenerations
+        << " generations, memory accounting enabled" << std::endl;
+    MeasureMemory("1 breeding thread", 1);
+    MeasureMemory("2 breeding threads", 2);
+    return 0;
+}
@@ -0,0 +1,237 @@
+﻿#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+using PopulationType = GA::Population<GA::RealGene<RealType>>;
+
+// Радиус ниши для сравнения с полным перебором
+const RealType radius = 0.01;
+// Количество строк полного перебора, по которым оценивается его время на больших популяциях
+const std::size_t sampledRows = 2000;
+// Число π
+const RealType pi = 3.14159265358979323846;
+
+/**
+ * Разделение приспособленности полным перебором пар: O(n²).
+ * Если rows меньше размера популяции, вычисляются только первые rows особей
+ *
+ * \param population Популяция
+ * \param rows Количество особей, для которых считается нишевое число
+ * \return Изменённая приспособленность первых rows особей
+ */
+std::vector<RealType> BruteForceSharing(
+    const PopulationType& population,
+    const std::size_t rows)
+{
+    RealType worst = population[0].GetFitness();
+    for (std::size_t i = 1; i < population.GetSize(); ++i) {
+        worst = std::max(worst, population[i].GetFitness());
+    }
+    std::vector<RealType> result(rows);
+    for (std::size_t i = 0; i < rows; ++i) {
+        double count = 0.0;
+        for (std::size_t j = 0; j < population.GetSize(); ++j) {
+            const RealType distance = std::abs(population[i]() - population[j]());
+            count += distance < radius ? 1.0 - distance / radius : 0.0;
+        }
+        result[i] = static_cast<RealType>(worst - (worst - population[i].GetFitness()) / std::max(count, 1.0));
+    }
+    return result;
+}
+
+/**
+ * Расчистка полным перебором: каждая особь от лучшей к худшей
+ * сравнивается со всеми более слабыми непогашенными
+ *
+ * \param population Популяция
+ * \return Количество погашенных особей
+ */
+std::size_t BruteForceClearing(
+    PopulationType& population)
+{
+    std::vector<std::size_t> order(population.GetSize());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&population] (const std::size_t index1, const std::size_t index2)
+    {
+        return population[index1].GetFitness() < population[index2].GetFitness();
+    });
+    const RealType worst = population[order.back()].GetFitness();
+    std::vector<bool> cleared(population.GetSize(), false);
+    std::size_t numCleared = 0;
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        if (cleared[order[i]]) {
+            continue;
+        }
+        for (std::size_t j = i + 1; j < order.size(); ++j) {
+            if (!cleared[order[j]] && std::abs(population[order[i]]() - population[order[j]]()) < radius) {
+                cleared[order[j]] = true;
+                population[order[j]].SetFitness(worst);
+                ++numCleared;
+            }
+        }
+    }
+    return numCleared;
+}
+
+/**
+ * Создание оценённой популяции со случайными генами на [0, 1]
+ *
+ * \param size Размер популяции
+ * \param engine Движок генерации случайных чисел
+ * \return Популяция
+ */
+PopulationType MakePopulation(
+    const std::size_t size,
+    std::mt19937& engine)
+{
+    PopulationType population(size);
+    GA::DefaultPopulationGenerator<GA::RealGene<RealType>> generator(0.0, 1.0);
+    population.Init(generator, engine);
+    population.CalculateFitness([] (const RealType input) { return std::sin(20 * input) + input; });
+    return population;
+}
+
+/**
+ * Функция с пятью одинаковыми минимумами в точках 0.1, 0.3, 0.5, 0.7, 0.9
+ * (функция Деба F1 для задачи минимизации). Вне [0, 1] функция
+ * равна значению во впадинах
+ */
+RealType EqualMinima(const RealType input)
+{
+    if (input < 0 || input > 1) {
+        return 1;
+    }
+    return 1 - std::pow(std::sin(5 * pi * input), 6);
+}
+
+/**
+ * Количество минимумов EqualMinima, рядом с которыми есть хорошая особь
+ *
+ * \param population Популяция
+ * \return Количество найденных минимумов
+ */
+std::size_t CountOptima(
+    const PopulationType& population)
+{
+    std::size_t count = 0;
+    for (const RealType optimum : { 0.1, 0.3, 0.5, 0.7, 0.9 }) {
+        for (const auto& individual : population.GetSpan()) {
+            if (std::abs(individual() - optimum) < 0.02 && EqualMinima(individual()) < 0.01) {
+                ++count;
+                break;
+            }
+        }
+    }
+    return count;
+}
+
+/**
+ * Запуск генетического алгоритма на EqualMinima и вывод среднего количества
+ * минимумов, сохранённых популяцией к концу запуска
+ *
+ * \param name Название конфигурации
+ * \param tournamentSize Размер турнира
+ * \param configure Функция, настраивающая алгоритм
+ */
+template<
+    typename Configure>
+void CompareOptima(
+    const std::string& name,
+    const std::size_t tournamentSize,
+    Configure configure)
+{
+    const std::size_t numRuns = 20;
+    double optima = 0.0;
+    for (std::size_t run = 0; run < numRuns; ++run) {
+        std::mt19937 engine(static_cast<std::mt19937::result_type>(run));
+        // α = 0: дети совпадают с родителями, поиск ведёт только мутация.
+        // Скрещивание смешением с α > 0 всегда выносит детей за родителей
+        // и на почти плоской функции разгоняет популяцию за пределы [0, 1]
+        GA::RealGeneticAlgorithm<RealType> ga { 100, tournamentSize, 0.0, { 0.65, 0.01 } };
+        configure(ga);
+        GA::DefaultPopulationGenerator<decltype(ga)::gene_type> generator(0.0, 1.0);
+        ga.Init(generator, engine);
+        ga.Run(100, EqualMinima, engine);
+        // Нишевание не применяется к итоговой популяции, приспособленность в ней настоящая
+        optima += CountOptima(ga.GetPopulation());
+    }
+    std::cout << "  " << std::left << std::setw(36) << name
+        << " mean optima kept = " << optima / numRuns << " / 5" << std::endl;
+}
+
+}
+
+void NichingBenchmark()
+{
+    std::mt19937 engine(42);
+    std::cout << "Niche computation on uniform genes in [0, 1], sigma = " << radius << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const std::size_t size : { std::size_t(10000), std::size_t(100000), std::size_t(1000000) }) {
+        auto population = MakePopulation(size, engine);
+        // Полный перебор: точно при n = 10⁴, по первым sampledRows строкам при большем n
+        const std::size_t rows = size <= 10000 ? size : sampledRows;
+        std::vector<RealType> bruteForce;
+        const double bruteTime = MeasureMilliseconds([&] () { bruteForce = BruteForceSharing(population, rows); })
+            * size / rows;
+        auto shared = population;
+        GA::FitnessSharing<RealType> sharing(radius);
+        const double indexTime = MeasureMilliseconds([&] () { sharing(shared); });
+        double maxError = 0.0;
+        for (std::size_t i = 0; i < rows; ++i) {
+            maxError = std::max(maxError, static_cast<double>(std::abs(bruteForce[i] - shared[i].GetFitness())));
+        }
+        std::cout << "  n = " << std::setw(8) << size
+            << "  sharing: brute force " << std::setw(10) << bruteTime << " ms" << (rows < size ? " (est.)" : "       ")
+            << "  index " << std::setw(7) << indexTime << " ms"
+            << "  max difference " << std::scientific << std::setprecision(1) << maxError
+            << std::fixed << std::setprecision(2) << std::endl;
+        if (size <= 100000) {
+            auto sharedAlpha = population;
+            GA::FitnessSharing<RealType> sharingAlpha(radius, 2.0);
+            std::cout << "  " << std::setw(14) << " " << "sharing alpha = 2, index "
+                << MeasureMilliseconds([&] () { sharingAlpha(sharedAlpha); }) << " ms" << std::endl;
+        }
+        auto clearedBrute = population;
+        std::size_t numClearedBrute = 0;
+        const double bruteClearingTime = size <= 100000
+            ? MeasureMilliseconds([&] () { numClearedBrute = BruteForceClearing(clearedBrute); }) : 0.0;
+        auto cleared = population;
+        GA::Clearing<RealType> clearing(radius);
+        const double clearingTime = MeasureMilliseconds([&] () { clearing(cleared); });
+        std::cout << "  " << std::setw(14) << " " << "clearing: ";
+        if (size <= 100000) {
+            std::cout << "brute force " << std::setw(10) << bruteClearingTime << " ms ("
+                << numClearedBrute << " cleared)  ";
+        }
+        std::cout << "index " << std::setw(7) << clearingTime << " ms (" << clearing.GetNumCleared() << " cleared)" << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(3);
+
+    std::cout << "Real GA (mutation only) on 1 - sin^6(5 pi x), 5 equal minima, population 100, 100 generations" << std::endl;
+    CompareOptima("no niching", 2, [] (auto&) {});
+    CompareOptima("fitness sharing (sigma = 0.1)", 2, [] (auto& ga)
+    {
+        ga.SetNiching(GA::FitnessSharing<RealType>(0.1));
+    });
+    CompareOptima("clearing (sigma = 0.1, capacity 2)", 2, [] (auto& ga)
+    {
+        ga.SetNiching(GA::Clearing<RealType>(0.1, 2));
+    });
+    CompareOptima("deterministic crowding", 1, [] (auto& ga)
+    {
+        ga.SetDeterministicCrowding(true);
+    });
+}
@@ -0,0 +1,82 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+// Размер популяции
+const std::size_t populationSize = 2000000;
+// Количество особей, учавствующих в турнирном отборе
+const std::size_t tournamentSize = 2;
+// Коэффициент мутации
+const double mutation = 0.65;
+// Коэффициент для скрещивания смешением
+const double blendAlpha = 0.5;
+// Стандартное отклонение для Гауссовой мутации
+const double stddev = 0.1;
+// Количество поколений
+const std::size_t numGenerations = 5;
+
+/**
+ * Запуск вещественного генетического алгоритма и вывод времени поколения
+ *
+ * \param name Название конфигурации
+ * \param numThreads Количество потоков
+ * \param configure Функция, настраивающая алгоритм до инициализации
+ */
+template<
+    typename Configure>
+void Measure(
+    const std::string& name,
+    const std::size_t numThreads,
+    Configure configure)
+{
+    std::mt19937 engine(42);
+    GA::RealGeneticAlgorithm<RealType> ga {
+        populationSize, tournamentSize, blendAlpha, { mutation, stddev } };
+    configure(ga, numThreads);
+    InitUniform(ga, -100.0, 10.0, engine);
+    const double time = MeasureRun(ga, numGenerations, DemoFitness, engine).milliseconds;
+    PrintName(name, 28);
+    std::cout << std::setw(3) << numThreads << " thr"
+        << std::fixed << std::setprecision(1) << std::setw(9) << time / numGenerations << " ms/generation" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+}
+
+void NumaBenchmark()
+{
+    const GA::NumaTopology& topology = GA::NumaTopology::Get();
+    std::cout << "NUMA nodes: " << topology.GetNumNodes() << std::endl;
+    for (std::size_t node = 0; node < topology.GetNumNodes(); ++node) {
+        std::cout << "  node " << node << ": " << topology.GetCpus(node).size() << " cpus" << std::endl;
+    }
+    std::cout << "Real GA, population " << populationSize << std::endl;
+    std::vector<std::size_t> threadCounts { 1, GA::GetNumThreads(0), 2 * GA::GetNumThreads(0) };
+    threadCounts.erase(std::unique(threadCounts.begin(), threadCounts.end()), threadCounts.end());
+    for (const std::size_t numThreads : threadCounts) {
+        Measure("first touch by Init", numThreads, [] (auto& ga, const std::size_t numThreads)
+        {
+            ga.SetBreedingThreads(numThreads);
+            ga.SetEvaluationThreads(numThreads);
+        });
+        Measure("NUMA placement", numThreads, [] (auto& ga, const std::size_t numThreads)
+        {
+            ga.SetPlacement(GA::ThreadPlacement(numThreads));
+        });
+        Measure("NUMA placement, pinned", numThreads, [] (auto& ga, const std::size_t numThreads)
+        {
+            ga.SetPlacement(GA::ThreadPlacement(numThreads, true));
+        });
+    }
+}
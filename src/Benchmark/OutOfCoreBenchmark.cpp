@@ -0,0 +1,141 @@
+﻿#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <filesystem>
+#ifndef _WIN32
+#   include <sys/resource.h>
+#endif
+
+#include "GeneticAlgorithm.hpp"
+#include "OutOfCoreGeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+// Размер популяции
+const std::size_t populationSize = 10000000;
+// Количество особей, обрабатываемых за раз
+const std::size_t chunkSize = 1 << 16;
+// Количество особей, учавствующих в турнирном отборе
+const std::size_t tournamentSize = 2;
+// Коэффициент мутации
+const double mutation = 0.65;
+// Коэффициент для скрещивания смешением
+const double blendAlpha = 0.5;
+// Стандартное отклонение для Гауссовой мутации
+const double stddev = 0.1;
+// Минимальное значение в гене
+const RealType minValue = -100.0;
+// Максимальное значение в гене
+const RealType maxValue = 10.0;
+// Количество поколений
+const std::size_t numGenerations = 3;
+
+/**
+ * Сброс пикового размера резидентной памяти процесса (Linux)
+ */
+void ResetPeakResidentSetSize()
+{
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+/**
+ * Пиковый размер резидентной памяти процесса в мегабайтах (Linux)
+ *
+ * \return Размер или 0, если он недоступен
+ */
+double GetPeakResidentSetSize()
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stod(line.substr(6)) / 1024.0;
+        }
+    }
+    return 0.0;
+}
+
+/**
+ * Количество страничных отказов процесса
+ *
+ * \return Пара (без чтения с диска, с чтением с диска)
+ */
+std::pair<long, long> GetPageFaults()
+{
+#ifndef _WIN32
+    rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return { usage.ru_minflt, usage.ru_majflt };
+#else
+    return { 0, 0 };
+#endif
+}
+
+/**
+ * Запуск конфигурации и вывод времени, пиковой резидентной памяти
+ * и количества страничных отказов
+ *
+ * \param name Название конфигурации
+ * \param runGA Функция, создающая и запускающая генетический алгоритм
+ */
+template<
+    typename RunGA>
+void Measure(
+    const std::string& name,
+    RunGA runGA)
+{
+    ResetPeakResidentSetSize();
+    const double baseline = GetPeakResidentSetSize();
+    const auto faults = GetPageFaults();
+    RealType result = 0;
+    const double time = MeasureMilliseconds([&] () { result = runGA(); });
+    const auto faultsAfter = GetPageFaults();
+    PrintName(name, 36);
+    std::cout << std::fixed << std::setprecision(1)
+        << std::setw(9) << time / numGenerations << " ms/generation"
+        << "  peak RSS " << std::setw(7) << GetPeakResidentSetSize() - baseline << " MB"
+        << "  minor faults " << std::setw(8) << faultsAfter.first - faults.first
+        << "  major faults " << std::setw(5) << faultsAfter.second - faults.second
+        << std::defaultfloat << std::setprecision(6) << "  best = " << result << std::endl;
+}
+
+/**
+ * Запуск генетического алгоритма с внешним хранением популяции
+ *
+ * \param advice Использовать подсказки madvise
+ * \return Решение
+ */
+RealType RunOutOfCore(
+    const bool advice)
+{
+    std::mt19937 engine(42);
+    GA::OutOfCoreRealGeneticAlgorithm<RealType> ga(populationSize, chunkSize,
+        std::filesystem::temp_directory_path(), tournamentSize, { blendAlpha }, { mutation, stddev });
+    ga.SetAdvice(advice);
+    InitUniform(ga, minValue, maxValue, engine);
+    return ga.Run(numGenerations, DemoFitness, engine);
+}
+
+}
+
+void OutOfCoreBenchmark()
+{
+    std::cout << "Real GA, population " << populationSize << ", " << numGenerations
+        << " generations, chunk " << chunkSize << std::endl;
+    Measure("in-memory RealGeneticAlgorithm", [] ()
+    {
+        std::mt19937 engine(42);
+        GA::RealGeneticAlgorithm<RealType> ga {
+            populationSize, tournamentSize, blendAlpha, { mutation, stddev } };
+        InitUniform(ga, minValue, maxValue, engine);
+        return ga.Run(numGenerations, DemoFitness, engine);
+    });
+    Measure("out-of-core, no madvise", [] () { return RunOutOfCore(false); });
+    Measure("out-of-core, madvise", [] () { return RunOutOfCore(true); });
+}
@@ -0,0 +1,224 @@
+﻿#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "PermutationGeneticAlgorithm.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+using PermutationType = GA::Permutation<>;
+
+// Количество городов
+const std::size_t numCities = 10000;
+// Количество изменений для измерения пересчёта по изменению
+const std::size_t numDeltaMoves = 1000000;
+// Количество изменений для измерения полного вычисления
+const std::size_t numFullMoves = 2000;
+// Количество скрещиваний
+const std::size_t numCrossovers = 200;
+// Размер популяции
+const std::size_t populationSize = 100;
+// Количество поколений
+const std::size_t numGenerations = 1000;
+
+/**
+ * Длина маршрута без пересчёта по изменению:
+ * генетический алгоритм вынужден оценивать каждую мутацию полностью
+ */
+class FullTourLength
+{
+public:
+    explicit FullTourLength(
+        const GA::TourLength<RealType>& tourLength) :
+        m_tourLength(tourLength) {}
+
+    RealType operator () (
+        const PermutationType& tour) const
+    {
+        return m_tourLength(tour);
+    }
+private:
+    const GA::TourLength<RealType>& m_tourLength;
+};
+
+/**
+ * PMX с линейным поиском элемента в участке родителя: O(n) на шаг цепочки
+ */
+void LinearSearchPMX(
+    const PermutationType& donor,
+    const PermutationType& other,
+    const std::size_t first,
+    const std::size_t last,
+    std::vector<PermutationType::index_type>& child)
+{
+    const std::size_t size = donor.GetSize();
+    child.resize(size);
+    const auto find = [&] (const PermutationType::index_type element)
+    {
+        for (std::size_t i = first; i <= last; ++i) {
+            if (donor[i] == element) {
+                return i;
+            }
+        }
+        return size;
+    };
+    for (std::size_t i = 0; i < size; ++i) {
+        if (i >= first && i <= last) {
+            child[i] = donor[i];
+            continue;
+        }
+        auto element = other[i];
+        for (std::size_t position = find(element); position < size; position = find(element)) {
+            element = other[position];
+        }
+        child[i] = element;
+    }
+}
+
+/**
+ * Время пересчёта длины маршрута после изменения: полностью и по изменению
+ *
+ * \param name Название мутатора
+ * \param mutator Мутатор
+ * \param tourLength Длина маршрута
+ */
+template<
+    typename Mutator>
+void MeasureMoves(
+    const std::string& name,
+    const Mutator& mutator,
+    const GA::TourLength<RealType>& tourLength)
+{
+    std::mt19937 engine(42);
+    PermutationType tour(numCities);
+    tour.Shuffle(engine);
+    GA::PermutationMove move;
+    RealType length = tourLength(tour);
+    const double fullTime = MeasureMilliseconds([&] ()
+    {
+        for (std::size_t i = 0; i < numFullMoves; ++i) {
+            mutator.Propose(tour, move, engine);
+            tour.Apply(move);
+            length = tourLength(tour);
+        }
+    });
+    const double deltaTime = MeasureMilliseconds([&] ()
+    {
+        for (std::size_t i = 0; i < numDeltaMoves; ++i) {
+            mutator.Propose(tour, move, engine);
+            length += tourLength.Delta(tour, move);
+            tour.Apply(move);
+        }
+    });
+    std::cout << "  " << std::left << std::setw(10) << name << std::right << std::fixed << std::setprecision(3)
+        << " full " << std::setw(9) << 1000.0 * fullTime / numFullMoves << " us"
+        << "   delta " << std::setw(7) << 1000.0 * deltaTime / numDeltaMoves << " us"
+        << "   drift after " << numDeltaMoves << " moves " << std::scientific << std::setprecision(2)
+        << std::abs(length - tourLength(tour)) << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Запуск генетического алгоритма с 2-opt мутацией
+ *
+ * \param name Название конфигурации
+ * \param fitness Функция приспособленности
+ * \param crossoverProbability Вероятность скрещивания
+ */
+template<
+    typename Fitness>
+void RunGA(
+    const std::string& name,
+    const Fitness& fitness,
+    const double crossoverProbability)
+{
+    std::mt19937 engine(42);
+    GA::PermutationGeneticAlgorithm<RealType, GA::OrderCrossover<>, GA::TwoOptMutator<>> ga {
+        populationSize, 2, crossoverProbability, {}, GA::TwoOptMutator<>(0.0) };
+    ga.Init(numCities, engine);
+    RealType result = 0;
+    const double time = MeasureMilliseconds([&] ()
+    {
+        result = ga.Run(numGenerations, fitness, engine);
+    });
+    std::cout << "  " << std::left << std::setw(26) << name << std::right << std::fixed << std::setprecision(1)
+        << std::setw(10) << time << " ms   length " << std::setw(8) << ga.GetStatistics().front().bestFitness
+        << " -> " << std::setw(8) << result
+        << "   full " << std::setw(7) << ga.GetNumEvaluations()
+        << "   delta " << std::setw(7) << ga.GetNumDeltaEvaluations() << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+}
+
+void PermutationBenchmark()
+{
+    std::mt19937 engine(7);
+    std::uniform_real_distribution<RealType> coordinate(0.0, 1.0);
+    std::vector<RealType> x(numCities);
+    std::vector<RealType> y(numCities);
+    for (std::size_t i = 0; i < numCities; ++i) {
+        x[i] = coordinate(engine);
+        y[i] = coordinate(engine);
+    }
+    const GA::TourLength<RealType> tourLength(x, y);
+
+    std::cout << "Tour length update per move, " << numCities << " cities" << std::endl;
+    MeasureMoves("swap", GA::SwapMutator<>(0.0), tourLength);
+    MeasureMoves("insertion", GA::InsertionMutator<>(0.0), tourLength);
+    MeasureMoves("2-opt", GA::TwoOptMutator<>(0.0), tourLength);
+
+    std::cout << "Crossover of two " << numCities << "-city parents, " << numCrossovers << " pairs" << std::endl;
+    PermutationType parent1(numCities);
+    PermutationType parent2(numCities);
+    PermutationType child1;
+    PermutationType child2;
+    parent1.Shuffle(engine);
+    parent2.Shuffle(engine);
+    const double orderTime = MeasureMilliseconds([&] ()
+    {
+        for (std::size_t i = 0; i < numCrossovers; ++i) {
+            GA::OrderCrossover<>()(parent1, parent2, child1, child2, engine);
+        }
+    });
+    const double mappedTime = MeasureMilliseconds([&] ()
+    {
+        for (std::size_t i = 0; i < numCrossovers; ++i) {
+            GA::PartiallyMappedCrossover<>()(parent1, parent2, child1, child2, engine);
+        }
+    });
+    std::vector<PermutationType::index_type> linear1;
+    std::vector<PermutationType::index_type> linear2;
+    std::uniform_int_distribution<std::size_t> cut(0, numCities - 1);
+    const double linearTime = MeasureMilliseconds([&] ()
+    {
+        for (std::size_t i = 0; i < numCrossovers; ++i) {
+            std::size_t first = cut(engine);
+            std::size_t last = cut(engine);
+            if (first > last) {
+                std::swap(first, last);
+            }
+            LinearSearchPMX(parent1, parent2, first, last, linear1);
+            LinearSearchPMX(parent2, parent1, first, last, linear2);
+        }
+    });
+    std::cout << std::fixed << std::setprecision(3)
+        << "  OX (position table)   " << std::setw(9) << orderTime / numCrossovers << " ms per pair" << std::endl
+        << "  PMX (position table)  " << std::setw(9) << mappedTime / numCrossovers << " ms per pair" << std::endl
+        << "  PMX (linear search)   " << std::setw(9) << linearTime / numCrossovers << " ms per pair" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+
+    std::cout << "Permutation GA, OX + 2-opt, " << numCities << " cities, population " << populationSize
+        << ", " << numGenerations << " generations" << std::endl;
+    for (const double crossoverProbability : { 0.1, 0.5 }) {
+        const std::string suffix = ", crossover " + std::to_string(crossoverProbability).substr(0, 3);
+        RunGA("full evaluation" + suffix, FullTourLength(tourLength), crossoverProbability);
+        RunGA("delta evaluation" + suffix, tourLength, crossoverProbability);
+    }
+}
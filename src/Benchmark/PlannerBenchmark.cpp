@@ -0,0 +1,116 @@
+﻿#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+using GeneType = GA::RealGene<RealType>;
+using GAType = GA::RealGeneticAlgorithm<RealType>;
+
+/**
+ * Название способа вычисления
+ *
+ * \param strategy Способ вычисления
+ * \return Название
+ */
+const char* GetStrategyName(
+    const GA::ExecutionStrategy strategy)
+{
+    switch (strategy) {
+    case GA::ExecutionStrategy::Batch:
+        return "batch";
+    case GA::ExecutionStrategy::Parallel:
+        return "parallel";
+    default:
+        return "serial";
+    }
+}
+
+/**
+ * Запуск алгоритма и вывод времени и решений планировщика
+ *
+ * \param name Название конфигурации
+ * \param populationSize Размер популяции
+ * \param numGenerations Количество поколений
+ * \param fitnessFunction Функция приспособленности
+ * \param configure Настройка алгоритма перед запуском, вызывается как configure(ga)
+ */
+template<
+    typename Configure>
+void Measure(
+    const std::string& name,
+    const std::size_t populationSize,
+    const std::size_t numGenerations,
+    const GAType::fitness_function& fitnessFunction,
+    const Configure& configure)
+{
+    std::mt19937 engine(11);
+    GAType ga { populationSize, 2, 0.5, { 0.65, 0.1 } };
+    InitUniform(ga, -5.0, 5.0, engine);
+    configure(ga);
+    const auto run = MeasureRun(ga, numGenerations, fitnessFunction, engine);
+    PrintName(name, 34);
+    std::cout << std::fixed << std::setprecision(1)
+        << std::setw(9) << run.milliseconds << " ms   result " << std::setprecision(6) << run.best << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    // Решения планировщика - только поколения с калибровкой
+    for (const auto& statistics : ga.GetStatistics()) {
+        const auto& execution = statistics.execution;
+        if (execution.calibrated) {
+            std::cout << "    gen " << std::setw(3) << statistics.generation << ": " << std::setw(8)
+                << GetStrategyName(execution.strategy) << ", " << execution.numThreads << " threads, chunk "
+                << execution.chunkSize << ", " << std::fixed << std::setprecision(1) << execution.evaluationNs
+                << " ns per evaluation, dispatch " << execution.dispatchNs << " ns, speedup "
+                << std::setprecision(2) << execution.speedup << std::endl;
+            std::cout.unsetf(std::ios::fixed);
+        }
+    }
+}
+
+}
+
+void PlannerBenchmark()
+{
+    const auto cheap = [] (const RealType x)
+    {
+        return x * x + 4;
+    };
+    // Внешняя симуляция: поток ждёт результата, не занимая процессор
+    const auto simulation = [] (const RealType x)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        return x * x + 4;
+    };
+    std::cout << "Cheap fitness x*x + 4, population 100000, 50 generations, " << std::thread::hardware_concurrency()
+        << " hardware threads" << std::endl;
+    Measure("serial", 100000, 50, cheap, [] (GAType&) {});
+    Measure("4 evaluation threads", 100000, 50, cheap, [] (GAType& ga) { ga.SetEvaluationThreads(4); });
+    Measure("planner, up to 4 threads", 100000, 50, cheap, [] (GAType& ga) { ga.SetExecutionPlanning(true, 4); });
+
+    std::cout << "2 ms simulation, population 20, 10 generations" << std::endl;
+    Measure("serial", 20, 10, simulation, [] (GAType&) {});
+    Measure("planner, up to 8 threads", 20, 10, simulation, [] (GAType& ga) { ga.SetExecutionPlanning(true, 8); });
+
+    // Стоимость функции меняется во время запуска: после 50000 вычислений она становится дорогой
+    std::atomic<std::size_t> evaluations { 0 };
+    const auto changing = [&evaluations] (const RealType x)
+    {
+        if (evaluations.fetch_add(1, std::memory_order_relaxed) >= 50000) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        }
+        return x * x + 4;
+    };
+    std::cout << "Fitness becomes a 200 us simulation after 50000 evaluations, population 1000, 80 generations"
+        << std::endl;
+    Measure("planner, up to 8 threads", 1000, 80, changing, [] (GAType& ga) { ga.SetExecutionPlanning(true, 8); });
+}
@@ -0,0 +1,162 @@
+﻿#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+// Размер популяции для измерения времени поколения
+const std::size_t largePopulationSize = 4000000;
+// Размер популяции для измерения качества решения
+const std::size_t populationSize = 1000;
+// Количество поколений для измерения качества решения
+const std::size_t numGenerations = 100;
+// Количество запусков с разными зёрнами
+const std::size_t numRuns = 9;
+// Коэффициент мутации
+const double mutation = 0.65;
+// Точка минимума тестовых функций
+const RealType optimum = 1.2345;
+// Количество значений для измерения скорости пакетного преобразования
+const std::size_t numValues = 10000000;
+
+/**
+ * Время поколения на большой популяции и качество решения
+ * при хранении генов и приспособленности в StorageType
+ *
+ * \param name Название типа хранения
+ */
+template<
+    typename StorageType>
+void Measure(
+    const std::string& name)
+{
+    using GAType = GA::RealGeneticAlgorithm<RealType, StorageType>;
+    using IndividualType = GA::Individual<typename GAType::gene_type>;
+    const std::size_t bytes = sizeof(IndividualType);
+
+    double generationTime = 0.0;
+    {
+        std::mt19937 engine(42);
+        GAType ga { largePopulationSize, 2, 0.5, { mutation, 0.1 } };
+        InitUniform(ga, -100.0, 10.0, engine);
+        const std::size_t generations = 3;
+        generationTime = MeasureRun(ga, generations, DemoFitness, engine).milliseconds / generations;
+    }
+
+    // Минимум со значением 4: разрешение приспособленности около минимума
+    // определяется шагом типа хранения вблизи 4.
+    // Минимум со значением 0: разрешение определяется только шагом генов
+    std::vector<double> offsetErrors;
+    std::vector<double> zeroErrors;
+    for (std::size_t run = 0; run < numRuns; ++run) {
+        for (const RealType offset : { RealType(4), RealType(0) }) {
+            std::mt19937 engine(static_cast<unsigned>(run + 1));
+            GAType ga { populationSize, 2, 0.5, { mutation, 0.1 } };
+            InitUniform(ga, -100.0, 10.0, engine);
+            ga.Run(numGenerations, [offset] (const RealType input)
+            {
+                return (input - optimum) * (input - optimum) + offset;
+            }, engine);
+            // Run оставляет популяцию отсортированной по приспособленности
+            const double error = std::abs(ga.GetPopulation()[0]() - optimum);
+            (offset > 0 ? offsetErrors : zeroErrors).push_back(error);
+        }
+    }
+
+    PrintName(name, 10);
+    std::cout << std::setw(4) << bytes << " B"
+        << std::fixed << std::setprecision(1)
+        << std::setw(10) << 2.0 * bytes * largePopulationSize / (1 << 20) << " MB"
+        << std::setw(10) << 4.0 * bytes * largePopulationSize / (1 << 20) << " MB"
+        << std::setw(10) << generationTime << " ms"
+        << std::scientific << std::setprecision(2)
+        << std::setw(14) << Median(offsetErrors)
+        << std::setw(14) << Median(zeroErrors) << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+/**
+ * Скорость пакетного и поштучного преобразования 16-битных значений во float и обратно
+ *
+ * \param name Название типа
+ */
+template<
+    typename HalfType>
+void MeasureConversion(
+    const std::string& name)
+{
+    std::mt19937 engine(42);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+    std::vector<float> values(numValues);
+    for (auto& value : values) {
+        value = distribution(engine);
+    }
+    std::vector<HalfType> halves(numValues);
+    std::vector<float> restored(numValues);
+    std::vector<double> scalarTimes;
+    std::vector<double> batchTimes;
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        scalarTimes.push_back(MeasureMilliseconds([&] ()
+        {
+            for (std::size_t i = 0; i < numValues; ++i) {
+                halves[i] = HalfType(values[i]);
+            }
+            for (std::size_t i = 0; i < numValues; ++i) {
+                restored[i] = static_cast<float>(halves[i]);
+            }
+        }));
+        batchTimes.push_back(MeasureMilliseconds([&] ()
+        {
+            GA::ConvertFromFloat(values.data(), halves.data(), numValues);
+            GA::ConvertToFloat(halves.data(), restored.data(), numValues);
+        }));
+    }
+    double maxRelativeError = 0.0;
+    for (std::size_t i = 0; i < numValues; ++i) {
+        maxRelativeError = std::max(maxRelativeError,
+            std::abs(static_cast<double>(restored[i]) - values[i]) / std::abs(values[i]));
+    }
+    PrintName(name, 10);
+    std::cout << std::fixed << std::setprecision(2)
+        << " per-value " << std::setw(8) << Median(scalarTimes) << " ms"
+        << "   batched " << std::setw(8) << Median(batchTimes) << " ms"
+        << "   max relative error " << std::scientific << maxRelativeError << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+}
+
+void PrecisionBenchmark()
+{
+#ifdef GA_HAS_F16C
+    std::cout << "Float16 conversion: F16C" << std::endl;
+#else
+    std::cout << "Float16 conversion: software (configure with -DLIBGA_ENABLE_F16C=ON for F16C)" << std::endl;
+#endif
+    std::cout << "Round trip float -> 16 bit -> float, " << numValues << " values" << std::endl;
+    MeasureConversion<GA::Float16>("Float16");
+    MeasureConversion<GA::BFloat16>("BFloat16");
+
+    std::cout << "Storage type: bytes per individual, population buffers and bytes streamed per generation"
+        << " (evaluation, selection, breeding, mutation) at " << largePopulationSize << " individuals,"
+        << std::endl << "  time per generation, median |best - optimum| over " << numRuns << " runs"
+        << " of " << numGenerations << " generations (population " << populationSize << ")"
+        << " for minimum value 4 and 0" << std::endl;
+    std::cout << "  " << std::left << std::setw(10) << "storage" << std::right
+        << std::setw(6) << "size" << std::setw(13) << "buffers" << std::setw(13) << "streamed"
+        << std::setw(13) << "generation" << std::setw(14) << "error (f=4)" << std::setw(14) << "error (f=0)"
+        << std::endl;
+    Measure<double>("double");
+    Measure<float>("float");
+    Measure<GA::BFloat16>("BFloat16");
+    Measure<GA::Float16>("Float16");
+}
@@ -0,0 +1,267 @@
+﻿#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+#include "Random.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+using GeneType = GA::IntegerGene<RealType, std::uint16_t>;
+
+// Количество случайных чисел в измерении
+const std::size_t numDraws = 10000000;
+// Количество значений ограниченных целых чисел
+const std::uint32_t range = 1000;
+// Вероятность испытания Бернулли
+const double probability = 0.35;
+// Размер популяции
+const std::size_t populationSize = 1000000;
+// Коэффициент мутации
+const double mutation = 0.65;
+
+/**
+ * Время одного числа в наносекундах: по одному через распределение
+ * стандартной библиотеки и пакетом через RandomStream
+ *
+ * \param name Название распределения
+ * \param single Генерация по одному, single(engine) -> сумма значений
+ * \param bulk Генерация пакетом, bulk(stream) -> сумма значений
+ */
+template<
+    typename Single,
+    typename Bulk>
+void MeasureDraws(
+    const std::string& name,
+    Single single,
+    Bulk bulk)
+{
+    std::mt19937 mersenne(42);
+    GA::Xoshiro256PlusPlus xoshiro(42);
+    GA::RandomStream stream(42);
+    double sink = 0.0;
+    const double mersenneTime = MeasureMilliseconds([&] () { sink += single(mersenne); });
+    const double xoshiroTime = MeasureMilliseconds([&] () { sink += single(xoshiro); });
+    const double bulkTime = MeasureMilliseconds([&] () { sink += bulk(stream); });
+    const double scale = 1e6 / numDraws;
+    std::cout << "  " << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(2)
+        << " mt19937 " << std::setw(6) << mersenneTime * scale << " ns"
+        << "   xoshiro256++ " << std::setw(6) << xoshiroTime * scale << " ns"
+        << "   RandomStream " << std::setw(6) << bulkTime * scale << " ns"
+        << "   (mean " << std::setprecision(4) << sink / (3.0 * numDraws) << ")" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+/**
+ * Отбор и мутация поколения с генерацией чисел по одному -
+ * так, как операторы работали до пакетных буферов
+ *
+ * \param population Популяция
+ * \param indices Индексы родителей
+ * \param offspring Потомки
+ * \param engine Движок генерации случайных чисел
+ */
+template<
+    typename Engine>
+void SelectAndMutatePerDraw(
+    const GA::Population<GeneType>& population,
+    std::vector<std::size_t>& indices,
+    GA::Population<GeneType>& offspring,
+    Engine& engine)
+{
+    std::uniform_int_distribution<std::size_t> individual(0, population.GetSize() - 1);
+    for (auto& index : indices) {
+        index = individual(engine);
+        const std::size_t candidate = individual(engine);
+        if (population[candidate].GetFitness() < population[index].GetFitness()) {
+            index = candidate;
+        }
+    }
+    std::uniform_real_distribution<double> coin(0.0, 1.0);
+    std::uniform_int_distribution<std::size_t> bit(0, 15);
+    for (std::size_t i = 0; i < offspring.GetSize(); ++i) {
+        offspring[i] = population[indices[i]];
+        if (coin(engine) > mutation) {
+            offspring[i].GetGene().InvertBit(bit(engine));
+        }
+    }
+}
+
+/**
+ * Отбор и мутация поколения операторами библиотеки (пакетные буферы)
+ *
+ * \param population Популяция
+ * \param indices Индексы родителей
+ * \param offspring Потомки
+ * \param engine Движок генерации случайных чисел
+ */
+template<
+    typename Engine>
+void SelectAndMutateBuffered(
+    const GA::Population<GeneType>& population,
+    std::vector<std::size_t>& indices,
+    GA::Population<GeneType>& offspring,
+    Engine& engine)
+{
+    static GA::TournamentSelection<GeneType> selection(2);
+    static const GA::BitInvertMutator<RealType, std::uint16_t> mutator(mutation);
+    selection.SelectIndices(population, indices, engine);
+    for (std::size_t i = 0; i < offspring.GetSize(); ++i) {
+        offspring[i] = population[indices[i]];
+    }
+    mutator.MutateBatch(offspring.GetSpan(), engine);
+}
+
+/**
+ * Время отбора и мутации поколения с заданным движком
+ *
+ * \param name Название движка
+ * \param population Популяция
+ */
+template<
+    typename Engine>
+void MeasureOperators(
+    const std::string& name,
+    const GA::Population<GeneType>& population)
+{
+    Engine engine(42);
+    std::vector<std::size_t> indices(populationSize);
+    GA::Population<GeneType> offspring(populationSize);
+    std::vector<double> perDraw;
+    std::vector<double> buffered;
+    for (int repeat = 0; repeat < 5; ++repeat) {
+        perDraw.push_back(MeasureMilliseconds([&] ()
+        {
+            SelectAndMutatePerDraw(population, indices, offspring, engine);
+        }));
+        buffered.push_back(MeasureMilliseconds([&] ()
+        {
+            SelectAndMutateBuffered(population, indices, offspring, engine);
+        }));
+    }
+    std::cout << "  " << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(2)
+        << " per draw " << std::setw(7) << Median(perDraw) << " ms"
+        << "   buffered " << std::setw(7) << Median(buffered) << " ms" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+/**
+ * Время нескольких поколений генетического алгоритма с заданным движком
+ *
+ * \param name Название движка
+ */
+template<
+    typename Engine>
+void MeasureEngineRun(
+    const std::string& name)
+{
+    const std::size_t numGenerations = 5;
+    Engine engine(42);
+    GA::IntegerGeneticAlgorithm<RealType, std::uint16_t> ga { populationSize, 2, {}, mutation };
+    InitUniform(ga, -100.0, 10.0, engine);
+    const auto run = MeasureRun(ga, numGenerations, DemoFitness, engine);
+    PrintName(name, 14);
+    std::cout << std::fixed << std::setprecision(1)
+        << std::setw(8) << run.milliseconds << " ms for " << numGenerations << " generations   result "
+        << std::setprecision(4) << run.best << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+}
+
+void RandomBenchmark()
+{
+    std::cout << "Time per number, " << numDraws << " numbers" << std::endl;
+    std::vector<double> uniforms(numDraws);
+    std::vector<std::uint32_t> bounded(numDraws);
+    std::vector<std::uint8_t> bits(numDraws);
+    MeasureDraws("uniform [0, 1)", [] (auto& engine)
+    {
+        std::uniform_real_distribution<double> distribution(0.0, 1.0);
+        double sum = 0.0;
+        for (std::size_t i = 0; i < numDraws; ++i) {
+            sum += distribution(engine);
+        }
+        return sum;
+    }, [&] (GA::RandomStream& stream)
+    {
+        stream.FillUniform(uniforms);
+        return std::accumulate(uniforms.begin(), uniforms.end(), 0.0);
+    });
+    MeasureDraws("integer [0, " + std::to_string(range) + ")", [] (auto& engine)
+    {
+        std::uniform_int_distribution<std::uint32_t> distribution(0, range - 1);
+        double sum = 0.0;
+        for (std::size_t i = 0; i < numDraws; ++i) {
+            sum += distribution(engine);
+        }
+        return sum;
+    }, [&] (GA::RandomStream& stream)
+    {
+        stream.FillBounded(bounded, range);
+        return std::accumulate(bounded.begin(), bounded.end(), 0.0);
+    });
+    MeasureDraws("Bernoulli p = " + std::to_string(probability).substr(0, 4), [] (auto& engine)
+    {
+        std::bernoulli_distribution distribution(probability);
+        double sum = 0.0;
+        for (std::size_t i = 0; i < numDraws; ++i) {
+            sum += distribution(engine);
+        }
+        return sum;
+    }, [&] (GA::RandomStream& stream)
+    {
+        stream.FillBernoulli(bits, probability);
+        return std::accumulate(bits.begin(), bits.end(), 0.0);
+    });
+    MeasureDraws("normal", [] (auto& engine)
+    {
+        std::normal_distribution<double> distribution(0.0, 1.0);
+        double sum = 0.0;
+        for (std::size_t i = 0; i < numDraws; ++i) {
+            sum += distribution(engine);
+        }
+        return sum;
+    }, [&] (GA::RandomStream& stream)
+    {
+        stream.FillNormal(uniforms);
+        return std::accumulate(uniforms.begin(), uniforms.end(), 0.0);
+    });
+
+    // Равномерность ограниченных целых: χ² с range - 1 степенями свободы
+    std::vector<std::size_t> counts(range, 0);
+    for (const std::uint32_t value : bounded) {
+        ++counts[value];
+    }
+    const double expected = static_cast<double>(numDraws) / range;
+    double chiSquare = 0.0;
+    for (const std::size_t count : counts) {
+        chiSquare += (count - expected) * (count - expected) / expected;
+    }
+    std::cout << "  chi-square of RandomStream integers / degrees of freedom = " << std::fixed << std::setprecision(3)
+        << chiSquare / (range - 1) << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+
+    std::cout << "Tournament selection + bit invert mutation, population size = " << populationSize << std::endl;
+    GA::Population<GeneType> population(populationSize);
+    {
+        std::mt19937 engine(42);
+        GA::DefaultPopulationGenerator<GeneType> generator(-100.0, 10.0);
+        population.Init(generator, engine);
+        population.CalculateFitness(DemoFitness);
+    }
+    MeasureOperators<std::mt19937>("mt19937", population);
+    MeasureOperators<GA::Xoshiro256PlusPlus>("xoshiro256++", population);
+
+    std::cout << "Integer GA, population size = " << populationSize << std::endl;
+    MeasureEngineRun<std::mt19937>("mt19937");
+    MeasureEngineRun<GA::Xoshiro256PlusPlus>("xoshiro256++");
+}
@@ -0,0 +1,91 @@
+﻿#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+// Размер популяции
+const std::size_t populationSize = 10000;
+// Количество поколений
+const std::size_t numGenerations = 50;
+// Количество итераций, имитирующих дорогую функцию приспособленности
+const std::size_t fitnessCost = 200;
+
+/**
+ * Дорогая функция приспособленности с минимумом 4 в точке 0
+ *
+ * \param input Значение гена
+ * \return Значение функции приспособленности
+ */
+RealType ExpensiveFitness(
+    const RealType input)
+{
+    RealType noise = 0;
+    for (std::size_t i = 0; i < fitnessCost; ++i) {
+        noise += std::sin(input + static_cast<RealType>(i));
+    }
+    // Слагаемое равно нулю, но компилятор не может убрать цикл
+    return input * input + 4 + noise * 0;
+}
+
+/**
+ * Запуск генетического алгоритма и вывод пропущенных вычислений по поколениям
+ *
+ * \param name Название конфигурации
+ * \param ga Генетический алгоритм
+ */
+template<
+    typename GAType>
+void Measure(
+    const std::string& name,
+    GAType ga)
+{
+    std::mt19937 engine(42);
+    InitUniform(ga, -100.0, 10.0, engine);
+    EvaluationCounter counter(0);
+    const auto [result, time] = MeasureRun(ga, numGenerations, counter.Counted(ExpensiveFitness), engine);
+    // Приспособленность каждой особи должна совпадать с пересчитанной заново
+    std::size_t stale = 0;
+    for (const auto& individual : ga.GetPopulation().GetSpan()) {
+        stale += individual.GetFitness() != ExpensiveFitness(individual()) ? 1 : 0;
+    }
+    const std::size_t fullEvaluations = populationSize * (numGenerations + 1);
+    std::cout << "  " << name << std::endl << "   ";
+    for (const auto& statistics : ga.GetStatistics()) {
+        if (statistics.generation % 10 == 0 || statistics.generation == 1) {
+            std::cout << "  gen " << statistics.generation << ": " << statistics.numEvaluations
+                << "/" << statistics.numSkippedEvaluations;
+        }
+    }
+    std::cout << "  (evaluated/skipped)" << std::endl << std::fixed << std::setprecision(1)
+        << "    evaluations " << counter.GetEvaluations() << " of " << fullEvaluations
+        << " (" << 100.0 * (fullEvaluations - counter.GetEvaluations()) / fullEvaluations << "% skipped)"
+        << "   time " << time << " ms, full evaluation would add "
+        << time * (fullEvaluations - counter.GetEvaluations()) / counter.GetEvaluations() << " ms"
+        << std::setprecision(5) << "   result " << result << "   stale " << stale << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+}
+
+void ReevaluationBenchmark()
+{
+    std::cout << "Skipping re-evaluation of unchanged individuals, population " << populationSize
+        << ", " << numGenerations << " generations" << std::endl;
+    Measure("Integer GA, OnePointCrossover + BitInvertMutator(0.65)",
+        GA::IntegerGeneticAlgorithm<RealType, uint16_t> { populationSize, 2, {}, 0.65 });
+    Measure("Integer GA, OnePointCrossover + BitInvertMutator(0.95)",
+        GA::IntegerGeneticAlgorithm<RealType, uint16_t> { populationSize, 2, {}, 0.95 });
+    Measure("Real GA, BlendCrossover(0.5) + GaussianMutator(0.65)",
+        GA::RealGeneticAlgorithm<RealType> { populationSize, 2, 0.5, { 0.65, 0.1 } });
+    Measure("Real GA, mutation only + GaussianMutator(0.65)",
+        GA::RealGeneticAlgorithm<RealType> { populationSize, 2, 0.0, { 0.65, 0.1 } });
+}
@@ -0,0 +1,106 @@
+﻿#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+
+#include "Population.hpp"
+#include "Selectors.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+using GeneType = GA::RealGene<RealType>;
+using PopulationType = GA::Population<GeneType>;
+
+/**
+ * Наивный пропорциональный отбор: O(n) на каждый выбор.
+ * Используется только для сравнения
+ */
+class NaiveRouletteWheelSelection
+{
+public:
+    template<
+        typename Engine>
+    void SelectIndices(
+        const PopulationType& population,
+        std::vector<std::size_t>& indices,
+        Engine& engine)
+    {
+        GA::CalculateProportionalWeights(population, m_weights);
+        double sum = 0.0;
+        for (const double weight : m_weights) {
+            sum += weight;
+        }
+        std::uniform_real_distribution<double> distribution(0.0, sum);
+        for (auto& index : indices) {
+            double value = distribution(engine);
+            index = 0;
+            while (index + 1 < m_weights.size() && value >= m_weights[index]) {
+                value -= m_weights[index++];
+            }
+        }
+    }
+private:
+    std::vector<double> m_weights;
+};
+
+/**
+ * Время выбора populationSize родителей (одно поколение)
+ *
+ * \param name Название алгоритма выбора
+ * \param selector Алгоритм выбора
+ * \param population Популяция
+ * \param engine Движок генерации случайных чисел
+ */
+template<
+    typename Selector>
+void Measure(
+    const std::string& name,
+    Selector selector,
+    const PopulationType& population,
+    std::mt19937& engine)
+{
+    std::vector<std::size_t> indices(population.GetSize());
+    std::vector<double> times;
+    for (int repeat = 0; repeat < 3; ++repeat) {
+        times.push_back(MeasureMilliseconds([&] ()
+        {
+            selector.SelectIndices(population, indices, engine);
+        }));
+    }
+    double meanFitness = 0.0;
+    for (const std::size_t index : indices) {
+        meanFitness += population[index].GetFitness();
+    }
+    PrintName(name, 26);
+    std::cout << std::setw(12) << std::fixed << std::setprecision(3) << Median(times) << " ms"
+        << "   mean selected fitness = " << std::setprecision(2) << meanFitness / indices.size() << std::endl;
+}
+
+}
+
+void SelectionBenchmark()
+{
+    std::mt19937 engine(42);
+    for (const std::size_t size : { std::size_t(1000), std::size_t(10000), std::size_t(100000), std::size_t(1000000) }) {
+        PopulationType population(size);
+        GA::DefaultPopulationGenerator<GeneType> generator(-100.0, 10.0);
+        population.Init(generator, engine);
+        population.CalculateFitness(DemoFitness);
+        std::cout << "Population size = " << size << ", one generation of parents" << std::endl;
+        if (size <= 10000) {
+            Measure("naive roulette O(n) draw", NaiveRouletteWheelSelection(), population, engine);
+        }
+        Measure("tournament (k=2)", GA::TournamentSelection<GeneType>(2), population, engine);
+        Measure("roulette (alias method)", GA::RouletteWheelSelection<GeneType>(), population, engine);
+        Measure("SUS", GA::StochasticUniversalSampling<GeneType>(), population, engine);
+        Measure("linear rank (s=1.5)", GA::RankSelection<GeneType>(
+            GA::RankSelection<GeneType>::Scheme::Linear, 1.5), population, engine);
+        Measure("exponential rank (c=0.99)", GA::RankSelection<GeneType>(
+            GA::RankSelection<GeneType>::Scheme::Exponential, 0.99), population, engine);
+        std::cout.unsetf(std::ios::fixed);
+    }
+}
@@ -0,0 +1,94 @@
+﻿#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Benchmarks.hpp"
+
+namespace
+{
+
+// Размер популяции
+const std::size_t populationSize = 20;
+// Количество особей, учавствующих в турнирном отборе
+const std::size_t tournamentSize = 2;
+// Коэффициент мутации
+const double mutation = 0.65;
+// Коэффициент для скрещивания смешением
+const double blendAlpha = 0.5;
+// Стандартное отклонение для Гауссовой мутации
+const double stddev = 0.1;
+// Минимальное значение в гене
+const RealType minValue = -100.0;
+// Максимальное значение в гене
+const RealType maxValue = 10.0;
+// Максимальное количество поколений
+const std::size_t numGenerations = 300;
+// Количество запусков каждой конфигурации
+const std::size_t numRuns = 50;
+// Целевое значение функции приспособленности
+const RealType target = 4.0 + 1e-6;
+
+/**
+ * "Дорогая" функция приспособленности: нелинейная функция
+ * с глобальным минимумом 4 в точке 0
+ */
+RealType FitnessFunction(const RealType input)
+{
+    return input * input + 4 + 2 * (1 - std::cos(input));
+}
+
+/**
+ * Запуск вещественного генетического алгоритма с отсевом
+ *
+ * \param model Суррогатная модель
+ * \param fitnessFunction Функция приспособленности
+ * \param engine Движок генерации случайных чисел
+ * \return Количество суррогатных вычислений
+ */
+template<
+    typename Model,
+    typename Fitness>
+std::size_t RunScreened(
+    const Model& model,
+    const Fitness& fitnessFunction,
+    std::mt19937& engine)
+{
+    GA::RealGeneticAlgorithm<RealType> ga {
+        populationSize, tournamentSize, blendAlpha, { mutation, stddev } };
+    InitUniform(ga, minValue, maxValue, engine);
+    GA::SurrogateScreening<Model> screening(model, 4, 2 * populationSize);
+    ga.Run(numGenerations, fitnessFunction, screening, engine);
+    return screening.GetNumSurrogateEvaluations();
+}
+
+}
+
+void SurrogateBenchmark()
+{
+    std::cout << std::setprecision(10)
+        << "Real GA, f(x) = x^2 + 4 + 2(1 - cos x), target f <= " << target << std::endl;
+    Compare("no surrogate", numRuns, target, FitnessFunction, "surrogate evaluations",
+        [] (const auto& fitnessFunction, std::mt19937& engine)
+        {
+            GA::RealGeneticAlgorithm<RealType> ga {
+                populationSize, tournamentSize, blendAlpha, { mutation, stddev } };
+            InitUniform(ga, minValue, maxValue, engine);
+            ga.Run(numGenerations, fitnessFunction, engine);
+            return std::size_t(0);
+        });
+    Compare("k-nearest neighbours (k=3)", numRuns, target, FitnessFunction, "surrogate evaluations",
+        [] (const auto& fitnessFunction, std::mt19937& engine)
+        {
+            return RunScreened(GA::KNearestNeighboursSurrogate<RealType>(3, 200), fitnessFunction, engine);
+        });
+    Compare("cubic RBF", numRuns, target, FitnessFunction, "surrogate evaluations",
+        [] (const auto& fitnessFunction, std::mt19937& engine)
+        {
+            return RunScreened(GA::RadialBasisSurrogate<RealType>(60), fitnessFunction, engine);
+        });
+}
@@ -0,0 +1,47 @@
+﻿#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Benchmarks.hpp"
+
+/**
+ * Запуск бенчмарков.
+ * Без аргументов запускаются все бенчмарки, иначе - только перечисленные по имени
+ */
+int main (int argc, char *argv[]){
+    const std::vector<std::pair<std::string, void (*)()>> benchmarks {
+        { "adaptive", AdaptiveOperatorsBenchmark },
+        { "surrogate", SurrogateBenchmark },
+        { "selection", SelectionBenchmark },
+        { "memetic", MemeticBenchmark },
+        { "breeding", BreedingBenchmark },
+        { "diversity", DiversityBenchmark },
+        { "de", DifferentialEvolutionBenchmark },
+        { "outofcore", OutOfCoreBenchmark },
+        { "numa", NumaBenchmark },
+        { "niching", NichingBenchmark },
+        { "precision", PrecisionBenchmark },
+        { "permutation", PermutationBenchmark },
+        { "reevaluation", ReevaluationBenchmark },
+        { "coevolution", CoevolutionBenchmark },
+        { "initialization", InitializationBenchmark },
+        { "random", RandomBenchmark },
+        { "composition", CompositionBenchmark },
+        { "constraints", ConstraintsBenchmark },
+        { "anytime", AnytimeBenchmark },
+        { "planner", PlannerBenchmark },
+    };
+    for (const auto& [name, benchmark] : benchmarks) {
+        bool enabled = argc < 2;
+        for (int i = 1; i < argc; ++i) {
+            enabled = enabled || name == argv[i];
+        }
+        if (enabled) {
+            std::cout << "=== " << name << " ===" << std::endl;
+            benchmark();
+            std::cout << std::endl;
+        }
+    }
+    return 0;
+}
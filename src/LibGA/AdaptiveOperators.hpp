@@ -0,0 +1,412 @@
+﻿#pragma once
+
+#include <tuple>
+#include <vector>
+#include <random>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#ifdef _DEBUG
+#   include <iostream>
+#endif
+
+namespace GA
+{
+
+/**
+ * Проверка наличия у оператора метода обратной связи
+ * Feedback(parents, offspring), который генетический алгоритм
+ * вызывает после вычисления приспособленности потомков.
+ */
+template<
+    typename Operator,
+    typename PopulationType,
+    typename = void>
+struct has_feedback : std::false_type {};
+
+template<
+    typename Operator,
+    typename PopulationType>
+struct has_feedback<
+    Operator,
+    PopulationType,
+    std::void_t<decltype(std::declval<Operator&>().Feedback(
+        std::declval<const PopulationType&>(),
+        std::declval<const PopulationType&>()))>> : std::true_type {};
+
+template<
+    typename Operator,
+    typename PopulationType>
+inline constexpr bool has_feedback_v = has_feedback<Operator, PopulationType>::value;
+
+/**
+ * Передача обратной связи оператору, если он её поддерживает
+ *
+ * \param op Оператор
+ * \param parents Популяция выбранных родителей
+ * \param offspring Оценённая популяция потомков
+ * \return
+ */
+template<
+    typename Operator,
+    typename PopulationType>
+void ApplyFeedback(
+    Operator& op,
+    const PopulationType& parents,
+    const PopulationType& offspring)
+{
+    if constexpr (has_feedback_v<Operator, PopulationType>) {
+        op.Feedback(parents, offspring);
+    }
+}
+
+/**
+ * Адаптивное преследование (adaptive pursuit).
+ * Хранит оценки качества и вероятности выбора для набора операторов.
+ * Лучший по оценке оператор получает вероятность pMax, остальные - pMin
+ * "Adaptive Allocation of Operator Probabilities", Thierens, 2005
+ */
+class AdaptivePursuit
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param numOperators Количество операторов
+     * \param minProbability Минимальная вероятность выбора оператора pMin
+     * \param adaptationRate Скорость обновления оценок качества α
+     * \param learningRate Скорость обновления вероятностей β
+     */
+    AdaptivePursuit(
+        const std::size_t numOperators,
+        const double minProbability,
+        const double adaptationRate,
+        const double learningRate) :
+        m_minProbability(minProbability),
+        m_adaptationRate(adaptationRate),
+        m_learningRate(learningRate),
+        m_probabilities(numOperators, 1.0 / numOperators),
+        m_qualities(numOperators, 1.0),
+        m_rewards(numOperators, 0.0),
+        m_counts(numOperators, 0) {}
+
+    /**
+     * Выбор оператора
+     *
+     * \param engine Движок генерации случайных чисел
+     * \return Индекс оператора
+     */
+    template<
+        typename Engine>
+    std::size_t Choose(
+        Engine& engine) const
+    {
+        std::uniform_real_distribution<double> distribution(0.0, 1.0);
+        double value = distribution(engine);
+        for (std::size_t i = 0; i + 1 < m_probabilities.size(); ++i) {
+            if (value < m_probabilities[i]) {
+                return i;
+            }
+            value -= m_probabilities[i];
+        }
+        return m_probabilities.size() - 1;
+    }
+
+    /**
+     * Начисление награды оператору
+     *
+     * \param index Индекс оператора
+     * \param reward Награда (улучшение приспособленности)
+     * \return
+     */
+    void Reward(
+        const std::size_t index,
+        const double reward)
+    {
+        m_rewards[index] += reward;
+        ++m_counts[index];
+    }
+
+    /**
+     * Обновление оценок качества и вероятностей по накопленным наградам.
+     * Средние награды нормируются на наибольшую, поэтому масштаб
+     * функции приспособленности не влияет на скорость адаптации
+     *
+     * \return
+     */
+    void Update()
+    {
+        double maxReward = 0.0;
+        for (std::size_t i = 0; i < m_rewards.size(); ++i) {
+            if (m_counts[i] > 0) {
+                m_rewards[i] /= m_counts[i];
+                maxReward = std::max(maxReward, m_rewards[i]);
+            }
+        }
+        for (std::size_t i = 0; i < m_qualities.size(); ++i) {
+            if (m_counts[i] > 0) {
+                const double reward = maxReward > 0.0 ? m_rewards[i] / maxReward : 0.0;
+                m_qualities[i] += m_adaptationRate * (reward - m_qualities[i]);
+            }
+        }
+        const std::size_t best = std::distance(m_qualities.begin(),
+            std::max_element(m_qualities.begin(), m_qualities.end()));
+        const double maxProbability = 1.0 - (m_probabilities.size() - 1) * m_minProbability;
+        for (std::size_t i = 0; i < m_probabilities.size(); ++i) {
+            const double target = (i == best) ? maxProbability : m_minProbability;
+            m_probabilities[i] += m_learningRate * (target - m_probabilities[i]);
+        }
+        std::fill(m_rewards.begin(), m_rewards.end(), 0.0);
+        std::fill(m_counts.begin(), m_counts.end(), 0);
+    }
+
+    /**
+     * Получение вероятности выбора оператора
+     *
+     * \param index Индекс оператора
+     * \return Вероятность выбора
+     */
+    double GetProbability(
+        const std::size_t index) const
+    {
+        return m_probabilities[index];
+    }
+private:
+    // Минимальная вероятность выбора оператора
+    double m_minProbability;
+    // Скорость обновления оценок качества
+    double m_adaptationRate;
+    // Скорость обновления вероятностей
+    double m_learningRate;
+    // Вероятности выбора операторов
+    std::vector<double> m_probabilities;
+    // Оценки качества операторов
+    std::vector<double> m_qualities;
+    // Суммарные награды за текущее поколение
+    std::vector<double> m_rewards;
+    // Количество применений за текущее поколение
+    std::vector<std::size_t> m_counts;
+};
+
+/**
+ * Адаптивный выбор мутатора.
+ * Для каждой особи выбирается один из мутаторов по вероятностям AdaptivePursuit,
+ * а после оценки потомков мутатор получает награду, равную улучшению
+ * приспособленности потомка относительно родителя.
+ * Мутаторы должны применяться к популяции по порядку индексов (Population::Mutate)
+ */
+template<
+    typename... Mutators>
+class AdaptiveMutatorSelection
+{
+public:
+    // Тип особи - берётся из первого мутатора
+    using individual_type = typename std::tuple_element_t<0, std::tuple<Mutators...>>::individual_type;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param mutators Набор мутаторов
+     * \param minProbability Минимальная вероятность выбора мутатора
+     * \param adaptationRate Скорость обновления оценок качества
+     * \param learningRate Скорость обновления вероятностей
+     */
+    AdaptiveMutatorSelection(
+        const std::tuple<Mutators...>& mutators,
+        const double minProbability = 0.05,
+        const double adaptationRate = 0.3,
+        const double learningRate = 0.3) :
+        m_mutators(mutators),
+        m_pursuit(sizeof...(Mutators), minProbability, adaptationRate, learningRate) {}
+
+    /**
+     * Применение мутатора к особи
+     *
+     * \param individual Особь
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void operator() (
+        individual_type& individual,
+        Engine& engine) const
+    {
+        const std::size_t index = m_pursuit.Choose(engine);
+        m_choices.push_back(index);
+        Apply(index, individual, engine, std::index_sequence_for<Mutators...>{});
+    }
+
+    /**
+     * Обратная связь по результатам поколения
+     *
+     * \param parents Популяция выбранных родителей
+     * \param offspring Оценённая популяция потомков
+     * \return
+     */
+    template<
+        typename PopulationType>
+    void Feedback(
+        const PopulationType& parents,
+        const PopulationType& offspring)
+    {
+        const std::size_t count = std::min(m_choices.size(), offspring.GetSize());
+        for (std::size_t i = 0; i < count; ++i) {
+            const double improvement = parents[i].GetFitness() - offspring[i].GetFitness();
+            m_pursuit.Reward(m_choices[i], std::max(0.0, improvement));
+        }
+        m_pursuit.Update();
+        m_choices.clear();
+#ifdef _DEBUG
+        std::cout << "\tAdaptive Mutator Selection:";
+        for (std::size_t i = 0; i < sizeof...(Mutators); ++i) {
+            std::cout << " " << m_pursuit.GetProbability(i);
+        }
+        std::cout << std::endl;
+#endif
+    }
+
+    /**
+     * Получение вероятности выбора мутатора
+     *
+     * \param index Индекс мутатора
+     * \return Вероятность выбора
+     */
+    double GetProbability(
+        const std::size_t index) const
+    {
+        return m_pursuit.GetProbability(index);
+    }
+private:
+    template<
+        typename Engine,
+        std::size_t... Indices>
+    void Apply(
+        const std::size_t index,
+        individual_type& individual,
+        Engine& engine,
+        std::index_sequence<Indices...>) const
+    {
+        ((index == Indices ? std::get<Indices>(m_mutators)(individual, engine) : void()), ...);
+    }
+private:
+    // Набор мутаторов
+    std::tuple<Mutators...> m_mutators;
+    // Вероятности выбора мутаторов
+    AdaptivePursuit m_pursuit;
+    // Выбранные мутаторы в порядке применения
+    mutable std::vector<std::size_t> m_choices;
+};
+
+/**
+ * Адаптивный выбор скрещивания.
+ * Например, позволяет выбирать между несколькими BlendCrossover с разными α.
+ * Пара детей (2i, 2i + 1) сравнивается с родителями (2i, 2i + 1),
+ * как их формирует GeneticAlgorithm::Run
+ */
+template<
+    typename... Crossovers>
+class AdaptiveCrossoverSelection
+{
+public:
+    // Тип особи - берётся из первого скрещивания
+    using individual_type = typename std::tuple_element_t<0, std::tuple<Crossovers...>>::individual_type;
+    // Тип результата скрещивания - пара особей
+    using result_type = std::pair<individual_type, individual_type>;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param crossovers Набор скрещиваний
+     * \param minProbability Минимальная вероятность выбора скрещивания
+     * \param adaptationRate Скорость обновления оценок качества
+     * \param learningRate Скорость обновления вероятностей
+     */
+    AdaptiveCrossoverSelection(
+        const std::tuple<Crossovers...>& crossovers,
+        const double minProbability = 0.05,
+        const double adaptationRate = 0.3,
+        const double learningRate = 0.3) :
+        m_crossovers(crossovers),
+        m_pursuit(sizeof...(Crossovers), minProbability, adaptationRate, learningRate) {}
+
+    /**
+     * Применение скрещивания к особям
+     *
+     * \param parent1 Первый родитель
+     * \param parent1 Второй родитель
+     * \param engine Движок генерации случайных чисел
+     * \return Пара особей-детей
+     */
+    template<
+        typename Engine>
+    result_type operator() (
+        const individual_type& parent1,
+        const individual_type& parent2,
+        Engine& engine) const
+    {
+        const std::size_t index = m_pursuit.Choose(engine);
+        m_choices.push_back(index);
+        result_type result;
+        Apply(index, parent1, parent2, engine, result, std::index_sequence_for<Crossovers...>{});
+        return result;
+    }
+
+    /**
+     * Обратная связь по результатам поколения
+     *
+     * \param parents Популяция выбранных родителей
+     * \param offspring Оценённая популяция потомков
+     * \return
+     */
+    template<
+        typename PopulationType>
+    void Feedback(
+        const PopulationType& parents,
+        const PopulationType& offspring)
+    {
+        const std::size_t count = std::min(m_choices.size(), offspring.GetSize() / 2);
+        for (std::size_t i = 0; i < count; ++i) {
+            const double improvement1 = parents[2 * i].GetFitness() - offspring[2 * i].GetFitness();
+            const double improvement2 = parents[2 * i + 1].GetFitness() - offspring[2 * i + 1].GetFitness();
+            m_pursuit.Reward(m_choices[i], std::max(0.0, std::max(improvement1, improvement2)));
+        }
+        m_pursuit.Update();
+        m_choices.clear();
+    }
+
+    /**
+     * Получение вероятности выбора скрещивания
+     *
+     * \param index Индекс скрещивания
+     * \return Вероятность выбора
+     */
+    double GetProbability(
+        const std::size_t index) const
+    {
+        return m_pursuit.GetProbability(index);
+    }
+private:
+    template<
+        typename Engine,
+        std::size_t... Indices>
+    void Apply(
+        const std::size_t index,
+        const individual_type& parent1,
+        const individual_type& parent2,
+        Engine& engine,
+        result_type& result,
+        std::index_sequence<Indices...>) const
+    {
+        ((index == Indices ? (void)(result = std::get<Indices>(m_crossovers)(parent1, parent2, engine)) : void()), ...);
+    }
+private:
+    // Набор скрещиваний
+    std::tuple<Crossovers...> m_crossovers;
+    // Вероятности выбора скрещиваний
+    AdaptivePursuit m_pursuit;
+    // Выбранные скрещивания в порядке применения
+    mutable std::vector<std::size_t> m_choices;
+};
+
+}
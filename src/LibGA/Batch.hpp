@@ -0,0 +1,239 @@
+﻿#pragma once
+
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+namespace GA
+{
+
+/**
+ * Непрерывный участок массива (указатель и размер).
+ * Используется пакетными операторами для записи прямо в буфер популяции
+ */
+template<
+    typename T>
+class Span
+{
+public:
+    // Тип элемента
+    using value_type = std::remove_cv_t<T>;
+public:
+    Span() = default;
+    /**
+     * Конструктор.
+     *
+     * \param data Указатель на первый элемент
+     * \param size Количество элементов
+     */
+    Span(
+        T* data,
+        const std::size_t size) :
+        m_data(data),
+        m_size(size) {}
+    /**
+     * Конструктор из массива.
+     *
+     * \param vector Массив
+     */
+    template<
+        typename Allocator>
+    Span(
+        std::vector<value_type, Allocator>& vector) :
+        m_data(vector.data()),
+        m_size(vector.size()) {}
+    /**
+     * Конструктор из константного массива.
+     *
+     * \param vector Массив
+     */
+    template<
+        typename Allocator,
+        typename U = T,
+        typename = std::enable_if_t<std::is_const_v<U>>>
+    Span(
+        const std::vector<value_type, Allocator>& vector) :
+        m_data(vector.data()),
+        m_size(vector.size()) {}
+    /**
+     * Неявное преобразование к участку константных элементов
+     */
+    operator Span<const T>() const
+    {
+        return { m_data, m_size };
+    }
+
+    T& operator [] (
+        const std::size_t index) const
+    {
+        return m_data[index];
+    }
+    T* begin() const
+    {
+        return m_data;
+    }
+    T* end() const
+    {
+        return m_data + m_size;
+    }
+    T* GetData() const
+    {
+        return m_data;
+    }
+    std::size_t GetSize() const
+    {
+        return m_size;
+    }
+    /**
+     * Получение части участка
+     *
+     * \param offset Смещение первого элемента
+     * \param count Количество элементов
+     * \return Участок [offset, offset + count)
+     */
+    Span SubSpan(
+        const std::size_t offset,
+        const std::size_t count) const
+    {
+        return { m_data + offset, count };
+    }
+private:
+    // Указатель на первый элемент
+    T* m_data = nullptr;
+    // Количество элементов
+    std::size_t m_size = 0;
+};
+
+/**
+ * Проверка наличия у скрещивания пакетного метода
+ * CrossBatch(parents, parentIndices, children, engine)
+ */
+template<
+    typename Crossover,
+    typename Engine,
+    typename = void>
+struct has_batch_crossover : std::false_type {};
+
+template<
+    typename Crossover,
+    typename Engine>
+struct has_batch_crossover<
+    Crossover,
+    Engine,
+    std::void_t<decltype(std::declval<const Crossover&>().CrossBatch(
+        std::declval<Span<const typename Crossover::individual_type>>(),
+        std::declval<Span<const std::size_t>>(),
+        std::declval<Span<typename Crossover::individual_type>>(),
+        std::declval<Engine&>()))>> : std::true_type {};
+
+/**
+ * Проверка наличия у мутатора пакетного метода MutateBatch(individuals, engine)
+ */
+template<
+    typename Mutator,
+    typename Engine,
+    typename = void>
+struct has_batch_mutation : std::false_type {};
+
+template<
+    typename Mutator,
+    typename Engine>
+struct has_batch_mutation<
+    Mutator,
+    Engine,
+    std::void_t<decltype(std::declval<const Mutator&>().MutateBatch(
+        std::declval<Span<typename Mutator::individual_type>>(),
+        std::declval<Engine&>()))>> : std::true_type {};
+
+/**
+ * Копирование родителя в последний слот нечётного участка детей.
+ * Без копии в слоте осталась бы особь позапрошлого поколения
+ * (популяция хранится в двух буферах) с вычисленной приспособленностью
+ *
+ * \param parents Особи, из которых выбираются родители
+ * \param parentIndices Индексы родителей (размер равен количеству детей)
+ * \param children Участок популяции детей
+ * \return true, если последний ребёнок скопирован
+ */
+template<
+    typename IndividualType>
+bool CopyOddChild(
+    const Span<const IndividualType> parents,
+    const Span<const std::size_t> parentIndices,
+    const Span<IndividualType> children)
+{
+    const std::size_t size = children.GetSize();
+    if (size % 2 == 0) {
+        return false;
+    }
+    children[size - 1] = parents[parentIndices[size - 1]];
+    return true;
+}
+
+/**
+ * Пакетное скрещивание.
+ * Пара родителей (parentIndices[2i], parentIndices[2i + 1]) даёт детей
+ * children[2i] и children[2i + 1]. При нечётном количестве детей последний
+ * ребёнок - копия своего родителя. Если у скрещивания нет пакетного метода,
+ * используется адаптер, вызывающий его для каждой пары
+ *
+ * \param crossover Алгоритм скрещивания
+ * \param parents Особи, из которых выбираются родители
+ * \param parentIndices Индексы родителей (размер равен количеству детей)
+ * \param children Участок популяции, в который записываются дети
+ * \param engine Движок генерации случайных чисел
+ * \return
+ */
+template<
+    typename Crossover,
+    typename Engine>
+void CrossoverBatch(
+    const Crossover& crossover,
+    const Span<const typename Crossover::individual_type> parents,
+    const Span<const std::size_t> parentIndices,
+    const Span<typename Crossover::individual_type> children,
+    Engine& engine)
+{
+    if constexpr (has_batch_crossover<Crossover, Engine>::value) {
+        crossover.CrossBatch(parents, parentIndices, children, engine);
+    }
+    else {
+        for (std::size_t i = 0; i + 1 < children.GetSize(); i += 2) {
+            auto [child1, child2] = crossover(
+                parents[parentIndices[i]], parents[parentIndices[i + 1]], engine);
+            children[i] = std::move(child1);
+            children[i + 1] = std::move(child2);
+        }
+        CopyOddChild(parents, parentIndices, children);
+    }
+}
+
+/**
+ * Пакетная мутация.
+ * Если у мутатора нет пакетного метода, используется адаптер,
+ * вызывающий его для каждой особи по порядку
+ *
+ * \param mutator Алгоритм мутации
+ * \param individuals Участок популяции
+ * \param engine Движок генерации случайных чисел
+ * \return
+ */
+template<
+    typename Mutator,
+    typename Engine>
+void MutateBatch(
+    const Mutator& mutator,
+    const Span<typename Mutator::individual_type> individuals,
+    Engine& engine)
+{
+    if constexpr (has_batch_mutation<Mutator, Engine>::value) {
+        mutator.MutateBatch(individuals, engine);
+    }
+    else {
+        for (auto& individual : individuals) {
+            mutator(individual, engine);
+        }
+    }
+}
+
+}
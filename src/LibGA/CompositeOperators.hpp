@@ -0,0 +1,1034 @@
+﻿#pragma once
+
+#include <array>
+#include <tuple>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <utility>
+#include <type_traits>
+#ifdef _DEBUG
+#   include <iostream>
+#endif
+
+#include "Batch.hpp"
+#include "Diversity.hpp"
+#include "Random.hpp"
+
+namespace GA
+{
+
+/**
+ * Проверка того, что мутатор умеет применяться к пакету в два шага:
+ * PrepareBatch(size, engine) заранее генерирует случайные числа для size особей,
+ * MutatePrepared(individual, index, engine) изменяет особь, используя набор index.
+ * Такие мутаторы можно объединять в один проход по популяции
+ */
+template<
+    typename Mutator,
+    typename Engine,
+    typename = void>
+struct has_prepared_mutation : std::false_type {};
+
+template<
+    typename Mutator,
+    typename Engine>
+struct has_prepared_mutation<
+    Mutator,
+    Engine,
+    std::void_t<
+        decltype(std::declval<const Mutator&>().PrepareBatch(
+            std::declval<std::size_t>(),
+            std::declval<Engine&>())),
+        decltype(std::declval<const Mutator&>().MutatePrepared(
+            std::declval<typename Mutator::individual_type&>(),
+            std::declval<std::size_t>(),
+            std::declval<Engine&>()))>> : std::true_type {};
+
+template<
+    typename Mutator,
+    typename Engine>
+inline constexpr bool has_prepared_mutation_v = has_prepared_mutation<Mutator, Engine>::value;
+
+/**
+ * Проверка того, что скрещивание умеет применяться к пакету в два шага:
+ * PrepareBatch(numPairs, engine) и
+ * CrossPrepared(parent1, parent2, child1, child2, index, engine)
+ */
+template<
+    typename Crossover,
+    typename Engine,
+    typename = void>
+struct has_prepared_crossover : std::false_type {};
+
+template<
+    typename Crossover,
+    typename Engine>
+struct has_prepared_crossover<
+    Crossover,
+    Engine,
+    std::void_t<
+        decltype(std::declval<const Crossover&>().PrepareBatch(
+            std::declval<std::size_t>(),
+            std::declval<Engine&>())),
+        decltype(std::declval<const Crossover&>().CrossPrepared(
+            std::declval<const typename Crossover::individual_type&>(),
+            std::declval<const typename Crossover::individual_type&>(),
+            std::declval<typename Crossover::individual_type&>(),
+            std::declval<typename Crossover::individual_type&>(),
+            std::declval<std::size_t>(),
+            std::declval<Engine&>()))>> : std::true_type {};
+
+template<
+    typename Crossover,
+    typename Engine>
+inline constexpr bool has_prepared_crossover_v = has_prepared_crossover<Crossover, Engine>::value;
+
+/**
+ * Подготовка мутатора к пакету, если он это поддерживает
+ *
+ * \param mutator Алгоритм мутации
+ * \param size Количество особей
+ * \param engine Движок генерации случайных чисел
+ * \return
+ */
+template<
+    typename Mutator,
+    typename Engine>
+void PrepareMutation(
+    const Mutator& mutator,
+    const std::size_t size,
+    Engine& engine)
+{
+    if constexpr (has_prepared_mutation_v<Mutator, Engine>) {
+        mutator.PrepareBatch(size, engine);
+    }
+}
+
+/**
+ * Мутация одной особи пакета: подготовленными числами,
+ * если мутатор это поддерживает, иначе - обычным вызовом
+ *
+ * \param mutator Алгоритм мутации
+ * \param individual Особь
+ * \param index Номер набора подготовленных чисел
+ * \param engine Движок генерации случайных чисел
+ * \return
+ */
+template<
+    typename Mutator,
+    typename Engine>
+void MutateOne(
+    const Mutator& mutator,
+    typename Mutator::individual_type& individual,
+    const std::size_t index,
+    Engine& engine)
+{
+    if constexpr (has_prepared_mutation_v<Mutator, Engine>) {
+        mutator.MutatePrepared(individual, index, engine);
+    }
+    else {
+        mutator(individual, engine);
+    }
+}
+
+/**
+ * Подготовка скрещивания к пакету, если оно это поддерживает
+ *
+ * \param crossover Алгоритм скрещивания
+ * \param numPairs Количество пар
+ * \param engine Движок генерации случайных чисел
+ * \return
+ */
+template<
+    typename Crossover,
+    typename Engine>
+void PrepareCrossover(
+    const Crossover& crossover,
+    const std::size_t numPairs,
+    Engine& engine)
+{
+    if constexpr (has_prepared_crossover_v<Crossover, Engine>) {
+        crossover.PrepareBatch(numPairs, engine);
+    }
+}
+
+/**
+ * Скрещивание одной пары пакета с записью детей на место
+ *
+ * \param crossover Алгоритм скрещивания
+ * \param parent1 Первый родитель
+ * \param parent2 Второй родитель
+ * \param child1 Первый ребёнок
+ * \param child2 Второй ребёнок
+ * \param index Номер пары среди подготовленных
+ * \param engine Движок генерации случайных чисел
+ * \return
+ */
+template<
+    typename Crossover,
+    typename Engine>
+void CrossOne(
+    const Crossover& crossover,
+    const typename Crossover::individual_type& parent1,
+    const typename Crossover::individual_type& parent2,
+    typename Crossover::individual_type& child1,
+    typename Crossover::individual_type& child2,
+    const std::size_t index,
+    Engine& engine)
+{
+    if constexpr (has_prepared_crossover_v<Crossover, Engine>) {
+        crossover.CrossPrepared(parent1, parent2, child1, child2, index, engine);
+    }
+    else {
+        auto [first, second] = crossover(parent1, parent2, engine);
+        child1 = std::move(first);
+        child2 = std::move(second);
+    }
+}
+
+/**
+ * Учёт изменения целочисленного гена в частотах аллелей
+ *
+ * \param alleles Частоты аллелей
+ * \param before Ген до изменения
+ * \param after Ген после изменения
+ * \return
+ */
+template<
+    typename IntegerType>
+void TrackGeneChange(
+    AlleleFrequencies<IntegerType>& alleles,
+    const IntegerType before,
+    const IntegerType after)
+{
+    const auto changed = static_cast<IntegerType>(before ^ after);
+    for (std::size_t bit = 0; changed >> bit; ++bit) {
+        if ((changed >> bit) & 1) {
+            alleles.FlipBit(bit, (after >> bit) & 1);
+        }
+    }
+}
+
+/**
+ * Взвешенный выбор одного из N операторов.
+ * Для пакета выбор делается заранее для всех слотов: каждый слот получает
+ * номер оператора и номер среди слотов этого оператора, поэтому каждый
+ * оператор готовит случайные числа только для своих слотов
+ */
+template<
+    std::size_t N>
+class WeightedChoice
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param weights Веса операторов (неотрицательные, не все нулевые)
+     */
+    explicit WeightedChoice(
+        const std::array<double, N>& weights)
+    {
+        double sum = 0.0;
+        for (const double weight : weights) {
+            sum += weight;
+        }
+        double cumulative = 0.0;
+        for (std::size_t i = 0; i < N; ++i) {
+            cumulative += weights[i];
+            m_thresholds[i] = cumulative / sum;
+        }
+        m_thresholds[N - 1] = 1.0;
+    }
+
+    /**
+     * Выбор оператора
+     *
+     * \param engine Движок генерации случайных чисел
+     * \return Номер оператора
+     */
+    template<
+        typename Engine>
+    std::size_t Choose(
+        Engine& engine) const
+    {
+        return Find(std::uniform_real_distribution<double>(0.0, 1.0)(engine));
+    }
+
+    /**
+     * Выбор операторов для всех слотов пакета
+     *
+     * \param size Количество слотов
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void Prepare(
+        const std::size_t size,
+        Engine& engine) const
+    {
+        m_uniforms.resize(size);
+        m_choices.resize(size);
+        m_slots.resize(size);
+        RandomStream(engine).FillUniform(m_uniforms);
+        m_counts.fill(0);
+        for (std::size_t i = 0; i < size; ++i) {
+            const std::size_t choice = Find(m_uniforms[i]);
+            m_choices[i] = static_cast<std::uint32_t>(choice);
+            m_slots[i] = static_cast<std::uint32_t>(m_counts[choice]++);
+        }
+    }
+
+    /**
+     * Получение оператора слота
+     *
+     * \param index Номер слота
+     * \return Номер оператора
+     */
+    std::size_t GetChoice(
+        const std::size_t index) const
+    {
+        return m_choices[index];
+    }
+    /**
+     * Получение номера слота среди слотов его оператора
+     *
+     * \param index Номер слота
+     * \return Номер набора подготовленных чисел оператора
+     */
+    std::size_t GetSlot(
+        const std::size_t index) const
+    {
+        return m_slots[index];
+    }
+    /**
+     * Получение количества слотов оператора
+     *
+     * \param choice Номер оператора
+     * \return Количество слотов
+     */
+    std::size_t GetCount(
+        const std::size_t choice) const
+    {
+        return m_counts[choice];
+    }
+private:
+    std::size_t Find(
+        const double value) const
+    {
+        std::size_t choice = 0;
+        while (choice + 1 < N && value >= m_thresholds[choice]) {
+            ++choice;
+        }
+        return choice;
+    }
+private:
+    // Накопленные нормированные веса
+    std::array<double, N> m_thresholds {};
+    // Буферы пакета: равномерные числа, выбранные операторы,
+    // номера слотов среди слотов оператора и количество слотов операторов
+    mutable std::vector<double> m_uniforms;
+    mutable std::vector<std::uint32_t> m_choices;
+    mutable std::vector<std::uint32_t> m_slots;
+    mutable std::array<std::size_t, N> m_counts {};
+};
+
+/**
+ * Пакетная мутация составного мутатора за один проход по участку:
+ * сначала все составляющие готовят случайные числа, затем каждая особь
+ * проходит через всю цепочку, пока она в кэше
+ *
+ * \param mutator Составной мутатор
+ * \param individuals Участок популяции
+ * \param engine Движок генерации случайных чисел
+ * \return
+ */
+template<
+    typename Mutator,
+    typename Engine>
+void MutateComposite(
+    const Mutator& mutator,
+    const Span<typename Mutator::individual_type> individuals,
+    Engine& engine)
+{
+    mutator.PrepareBatch(individuals.GetSize(), engine);
+    for (std::size_t i = 0; i < individuals.GetSize(); ++i) {
+        mutator.MutatePrepared(individuals[i], i, engine);
+    }
+}
+
+/**
+ * Пакетная мутация составного мутатора с учётом частот аллелей.
+ * Изменённые биты каждой особи учитываются сразу после её мутации
+ *
+ * \param mutator Составной мутатор
+ * \param individuals Участок популяции
+ * \param engine Движок генерации случайных чисел
+ * \param alleles Частоты аллелей, в которые уже добавлены гены участка
+ * \return
+ */
+template<
+    typename Mutator,
+    typename Engine,
+    typename IntegerType>
+void MutateComposite(
+    const Mutator& mutator,
+    const Span<typename Mutator::individual_type> individuals,
+    Engine& engine,
+    AlleleFrequencies<IntegerType>& alleles)
+{
+    mutator.PrepareBatch(individuals.GetSize(), engine);
+    for (std::size_t i = 0; i < individuals.GetSize(); ++i) {
+        auto& individual = individuals[i];
+        const IntegerType before = std::as_const(individual).GetGene().GetGene();
+        mutator.MutatePrepared(individual, i, engine);
+        TrackGeneChange(alleles, before, std::as_const(individual).GetGene().GetGene());
+    }
+}
+
+/**
+ * Пакетное скрещивание составного скрещивания за один проход по парам
+ *
+ * \param crossover Составное скрещивание
+ * \param parents Особи, из которых выбираются родители
+ * \param parentIndices Индексы родителей
+ * \param children Участок популяции для детей
+ * \param engine Движок генерации случайных чисел
+ * \param alleles Указатель на частоты аллелей детей (nullptr - не собирать)
+ * \return
+ */
+template<
+    typename Crossover,
+    typename Engine,
+    typename Frequencies>
+void CrossComposite(
+    const Crossover& crossover,
+    const Span<const typename Crossover::individual_type> parents,
+    const Span<const std::size_t> parentIndices,
+    const Span<typename Crossover::individual_type> children,
+    Engine& engine,
+    Frequencies alleles)
+{
+    crossover.PrepareBatch(children.GetSize() / 2, engine);
+    for (std::size_t i = 0; i + 1 < children.GetSize(); i += 2) {
+        crossover.CrossPrepared(parents[parentIndices[i]], parents[parentIndices[i + 1]],
+            children[i], children[i + 1], i / 2, engine);
+        if constexpr (!std::is_same_v<Frequencies, std::nullptr_t>) {
+            alleles->Add(std::as_const(children[i]).GetGene().GetGene());
+            alleles->Add(std::as_const(children[i + 1]).GetGene().GetGene());
+        }
+    }
+    // Нечётный последний ребёнок - копия своего родителя
+    if (CopyOddChild(parents, parentIndices, children)) {
+        if constexpr (!std::is_same_v<Frequencies, std::nullptr_t>) {
+            alleles->Add(std::as_const(children[children.GetSize() - 1]).GetGene().GetGene());
+        }
+    }
+}
+
+/**
+ * Последовательное применение нескольких мутаторов к каждой особи.
+ * Например, частое инвертирование бита и редкая замена блока:
+ * MutatorChain(BitInvertMutator(...), BlockResetMutator(...)).
+ * Вызовы составляющих разрешаются при компиляции, пакетная мутация
+ * проходит по популяции один раз, сколько бы мутаторов ни было в цепочке.
+ * Обратная связь составляющим не передаётся
+ */
+template<
+    typename... Mutators>
+class MutatorChain
+{
+public:
+    // Тип особи - берётся из первого мутатора
+    using individual_type = typename std::tuple_element_t<0, std::tuple<Mutators...>>::individual_type;
+    static_assert((std::is_same_v<typename Mutators::individual_type, individual_type> && ...),
+        "All mutators must work with the same individual type");
+public:
+    /**
+     * Конструктор.
+     *
+     * \param mutators Мутаторы в порядке применения
+     */
+    explicit MutatorChain(
+        const Mutators&... mutators) :
+        m_mutators(mutators...) {}
+
+    /**
+     * Применение мутаторов к особи
+     *
+     * \param individual Особь
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void operator() (
+        individual_type& individual,
+        Engine& engine) const
+    {
+        std::apply([&] (const Mutators&... mutators) { (mutators(individual, engine), ...); }, m_mutators);
+    }
+
+    /**
+     * Пакетное применение мутаторов к участку популяции за один проход
+     *
+     * \param individuals Участок популяции
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void MutateBatch(
+        const Span<individual_type> individuals,
+        Engine& engine) const
+    {
+        MutateComposite(*this, individuals, engine);
+    }
+
+    /**
+     * Пакетное применение мутаторов с учётом частот аллелей
+     *
+     * \param individuals Участок популяции
+     * \param engine Движок генерации случайных чисел
+     * \param alleles Частоты аллелей, в которые уже добавлены гены участка
+     * \return
+     */
+    template<
+        typename Engine,
+        typename IntegerType>
+    void MutateBatch(
+        const Span<individual_type> individuals,
+        Engine& engine,
+        AlleleFrequencies<IntegerType>& alleles) const
+    {
+        MutateComposite(*this, individuals, engine, alleles);
+    }
+
+    /**
+     * Подготовка случайных чисел всех мутаторов для size особей
+     *
+     * \param size Количество особей
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void PrepareBatch(
+        const std::size_t size,
+        Engine& engine) const
+    {
+        std::apply([&] (const Mutators&... mutators) { (PrepareMutation(mutators, size, engine), ...); }, m_mutators);
+    }
+
+    /**
+     * Применение мутаторов к особи с подготовленными числами
+     *
+     * \param individual Особь
+     * \param index Номер набора подготовленных чисел
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void MutatePrepared(
+        individual_type& individual,
+        const std::size_t index,
+        Engine& engine) const
+    {
+        std::apply([&] (const Mutators&... mutators) { (MutateOne(mutators, individual, index, engine), ...); }, m_mutators);
+    }
+
+    /**
+     * Получение мутатора цепочки
+     *
+     * \return Мутатор с номером Index
+     */
+    template<
+        std::size_t Index>
+    const auto& Get() const
+    {
+        return std::get<Index>(m_mutators);
+    }
+private:
+    // Мутаторы в порядке применения
+    std::tuple<Mutators...> m_mutators;
+};
+
+/**
+ * Взвешенный выбор мутатора: к каждой особи применяется ровно один
+ * из мутаторов, выбранный с вероятностью, пропорциональной его весу
+ * (сам мутатор затем решает по своему коэффициенту, мутировать ли особь).
+ * В отличие от AdaptiveMutatorSelection веса постоянны,
+ * а выбор разрешается при компиляции без обратной связи
+ */
+template<
+    typename... Mutators>
+class MutatorChoice
+{
+public:
+    // Тип особи - берётся из первого мутатора
+    using individual_type = typename std::tuple_element_t<0, std::tuple<Mutators...>>::individual_type;
+    static_assert((std::is_same_v<typename Mutators::individual_type, individual_type> && ...),
+        "All mutators must work with the same individual type");
+public:
+    /**
+     * Конструктор.
+     *
+     * \param weights Веса мутаторов
+     * \param mutators Мутаторы
+     */
+    MutatorChoice(
+        const std::array<double, sizeof...(Mutators)>& weights,
+        const Mutators&... mutators) :
+        m_choice(weights),
+        m_mutators(mutators...) {}
+
+    /**
+     * Применение выбранного мутатора к особи
+     *
+     * \param individual Особь
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void operator() (
+        individual_type& individual,
+        Engine& engine) const
+    {
+        const std::size_t choice = m_choice.Choose(engine);
+#ifdef _DEBUG
+        std::cout << "\tMutator Choice: " << choice << std::endl;
+#endif
+        Apply(choice, [&] (const auto& mutator) { mutator(individual, engine); },
+            std::index_sequence_for<Mutators...>{});
+    }
+
+    /**
+     * Пакетное применение к участку популяции за один проход
+     *
+     * \param individuals Участок популяции
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void MutateBatch(
+        const Span<individual_type> individuals,
+        Engine& engine) const
+    {
+        MutateComposite(*this, individuals, engine);
+    }
+
+    /**
+     * Пакетное применение с учётом частот аллелей
+     *
+     * \param individuals Участок популяции
+     * \param engine Движок генерации случайных чисел
+     * \param alleles Частоты аллелей, в которые уже добавлены гены участка
+     * \return
+     */
+    template<
+        typename Engine,
+        typename IntegerType>
+    void MutateBatch(
+        const Span<individual_type> individuals,
+        Engine& engine,
+        AlleleFrequencies<IntegerType>& alleles) const
+    {
+        MutateComposite(*this, individuals, engine, alleles);
+    }
+
+    /**
+     * Выбор мутаторов для size особей и подготовка случайных чисел:
+     * каждый мутатор готовит их только для выбравших его особей
+     *
+     * \param size Количество особей
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void PrepareBatch(
+        const std::size_t size,
+        Engine& engine) const
+    {
+        m_choice.Prepare(size, engine);
+        Prepare(engine, std::index_sequence_for<Mutators...>{});
+    }
+
+    /**
+     * Применение выбранного мутатора к особи с подготовленными числами
+     *
+     * \param individual Особь
+     * \param index Номер набора подготовленных чисел
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void MutatePrepared(
+        individual_type& individual,
+        const std::size_t index,
+        Engine& engine) const
+    {
+        const std::size_t slot = m_choice.GetSlot(index);
+        Apply(m_choice.GetChoice(index), [&] (const auto& mutator) { MutateOne(mutator, individual, slot, engine); },
+            std::index_sequence_for<Mutators...>{});
+    }
+private:
+    template<
+        typename Function,
+        std::size_t... Indices>
+    void Apply(
+        const std::size_t choice,
+        Function&& function,
+        std::index_sequence<Indices...>) const
+    {
+        ((choice == Indices ? function(std::get<Indices>(m_mutators)) : void()), ...);
+    }
+
+    template<
+        typename Engine,
+        std::size_t... Indices>
+    void Prepare(
+        Engine& engine,
+        std::index_sequence<Indices...>) const
+    {
+        (PrepareMutation(std::get<Indices>(m_mutators), m_choice.GetCount(Indices), engine), ...);
+    }
+private:
+    // Выбор мутатора
+    WeightedChoice<sizeof...(Mutators)> m_choice;
+    // Мутаторы
+    std::tuple<Mutators...> m_mutators;
+};
+
+/**
+ * Последовательное применение нескольких скрещиваний к паре:
+ * дети первого скрещивания становятся родителями второго и так далее
+ */
+template<
+    typename... Crossovers>
+class CrossoverChain
+{
+public:
+    // Тип особи - берётся из первого скрещивания
+    using individual_type = typename std::tuple_element_t<0, std::tuple<Crossovers...>>::individual_type;
+    // Тип результата скрещивания - пара особей
+    using result_type = std::pair<individual_type, individual_type>;
+    static_assert((std::is_same_v<typename Crossovers::individual_type, individual_type> && ...),
+        "All crossovers must work with the same individual type");
+public:
+    /**
+     * Конструктор.
+     *
+     * \param crossovers Скрещивания в порядке применения
+     */
+    explicit CrossoverChain(
+        const Crossovers&... crossovers) :
+        m_crossovers(crossovers...) {}
+
+    /**
+     * Применение скрещиваний к особям
+     *
+     * \param parent1 Первый родитель
+     * \param parent2 Второй родитель
+     * \param engine Движок генерации случайных чисел
+     * \return Пара особей-детей
+     */
+    template<
+        typename Engine>
+    result_type operator() (
+        const individual_type& parent1,
+        const individual_type& parent2,
+        Engine& engine) const
+    {
+        result_type result { parent1, parent2 };
+        std::apply([&] (const Crossovers&... crossovers)
+        {
+            ((result = crossovers(result.first, result.second, engine)), ...);
+        }, m_crossovers);
+        return result;
+    }
+
+    /**
+     * Пакетное применение скрещиваний за один проход по парам
+     *
+     * \param parents Особи, из которых выбираются родители
+     * \param parentIndices Индексы родителей
+     * \param children Участок популяции для детей
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void CrossBatch(
+        const Span<const individual_type> parents,
+        const Span<const std::size_t> parentIndices,
+        const Span<individual_type> children,
+        Engine& engine) const
+    {
+        CrossComposite(*this, parents, parentIndices, children, engine, nullptr);
+    }
+
+    /**
+     * Пакетное применение скрещиваний с учётом частот аллелей
+     *
+     * \param parents Особи, из которых выбираются родители
+     * \param parentIndices Индексы родителей
+     * \param children Участок популяции для детей
+     * \param engine Движок генерации случайных чисел
+     * \param alleles Частоты аллелей поколения детей
+     * \return
+     */
+    template<
+        typename Engine,
+        typename IntegerType>
+    void CrossBatch(
+        const Span<const individual_type> parents,
+        const Span<const std::size_t> parentIndices,
+        const Span<individual_type> children,
+        Engine& engine,
+        AlleleFrequencies<IntegerType>& alleles) const
+    {
+        CrossComposite(*this, parents, parentIndices, children, engine, &alleles);
+    }
+
+    /**
+     * Подготовка случайных чисел всех скрещиваний для numPairs пар
+     *
+     * \param numPairs Количество пар
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void PrepareBatch(
+        const std::size_t numPairs,
+        Engine& engine) const
+    {
+        std::apply([&] (const Crossovers&... crossovers)
+        {
+            (PrepareCrossover(crossovers, numPairs, engine), ...);
+        }, m_crossovers);
+    }
+
+    /**
+     * Скрещивание пары с подготовленными числами
+     *
+     * \param parent1 Первый родитель
+     * \param parent2 Второй родитель
+     * \param child1 Первый ребёнок
+     * \param child2 Второй ребёнок
+     * \param index Номер пары среди подготовленных
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void CrossPrepared(
+        const individual_type& parent1,
+        const individual_type& parent2,
+        individual_type& child1,
+        individual_type& child2,
+        const std::size_t index,
+        Engine& engine) const
+    {
+        CrossOne(std::get<0>(m_crossovers), parent1, parent2, child1, child2, index, engine);
+        CrossRest(child1, child2, index, engine, std::make_index_sequence<sizeof...(Crossovers) - 1>{});
+    }
+private:
+    /**
+     * Применение скрещиваний со второго по последнее к детям первого
+     */
+    template<
+        typename Engine,
+        std::size_t... Indices>
+    void CrossRest(
+        individual_type& child1,
+        individual_type& child2,
+        const std::size_t index,
+        Engine& engine,
+        std::index_sequence<Indices...>) const
+    {
+        ((void)[&] ()
+        {
+            const individual_type parent1 = child1;
+            const individual_type parent2 = child2;
+            CrossOne(std::get<Indices + 1>(m_crossovers), parent1, parent2, child1, child2, index, engine);
+        }(), ...);
+    }
+private:
+    // Скрещивания в порядке применения
+    std::tuple<Crossovers...> m_crossovers;
+};
+
+/**
+ * Взвешенный выбор скрещивания: каждая пара скрещивается ровно одним
+ * из скрещиваний, выбранным с вероятностью, пропорциональной его весу
+ */
+template<
+    typename... Crossovers>
+class CrossoverChoice
+{
+public:
+    // Тип особи - берётся из первого скрещивания
+    using individual_type = typename std::tuple_element_t<0, std::tuple<Crossovers...>>::individual_type;
+    // Тип результата скрещивания - пара особей
+    using result_type = std::pair<individual_type, individual_type>;
+    static_assert((std::is_same_v<typename Crossovers::individual_type, individual_type> && ...),
+        "All crossovers must work with the same individual type");
+public:
+    /**
+     * Конструктор.
+     *
+     * \param weights Веса скрещиваний
+     * \param crossovers Скрещивания
+     */
+    CrossoverChoice(
+        const std::array<double, sizeof...(Crossovers)>& weights,
+        const Crossovers&... crossovers) :
+        m_choice(weights),
+        m_crossovers(crossovers...) {}
+
+    /**
+     * Применение выбранного скрещивания к особям
+     *
+     * \param parent1 Первый родитель
+     * \param parent2 Второй родитель
+     * \param engine Движок генерации случайных чисел
+     * \return Пара особей-детей
+     */
+    template<
+        typename Engine>
+    result_type operator() (
+        const individual_type& parent1,
+        const individual_type& parent2,
+        Engine& engine) const
+    {
+        result_type result;
+        Apply(m_choice.Choose(engine), [&] (const auto& crossover)
+        {
+            result = crossover(parent1, parent2, engine);
+        }, std::index_sequence_for<Crossovers...>{});
+        return result;
+    }
+
+    /**
+     * Пакетное применение за один проход по парам
+     *
+     * \param parents Особи, из которых выбираются родители
+     * \param parentIndices Индексы родителей
+     * \param children Участок популяции для детей
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void CrossBatch(
+        const Span<const individual_type> parents,
+        const Span<const std::size_t> parentIndices,
+        const Span<individual_type> children,
+        Engine& engine) const
+    {
+        CrossComposite(*this, parents, parentIndices, children, engine, nullptr);
+    }
+
+    /**
+     * Пакетное применение с учётом частот аллелей
+     *
+     * \param parents Особи, из которых выбираются родители
+     * \param parentIndices Индексы родителей
+     * \param children Участок популяции для детей
+     * \param engine Движок генерации случайных чисел
+     * \param alleles Частоты аллелей поколения детей
+     * \return
+     */
+    template<
+        typename Engine,
+        typename IntegerType>
+    void CrossBatch(
+        const Span<const individual_type> parents,
+        const Span<const std::size_t> parentIndices,
+        const Span<individual_type> children,
+        Engine& engine,
+        AlleleFrequencies<IntegerType>& alleles) const
+    {
+        CrossComposite(*this, parents, parentIndices, children, engine, &alleles);
+    }
+
+    /**
+     * Выбор скрещиваний для numPairs пар и подготовка случайных чисел
+     *
+     * \param numPairs Количество пар
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void PrepareBatch(
+        const std::size_t numPairs,
+        Engine& engine) const
+    {
+        m_choice.Prepare(numPairs, engine);
+        Prepare(engine, std::index_sequence_for<Crossovers...>{});
+    }
+
+    /**
+     * Скрещивание пары выбранным скрещиванием с подготовленными числами
+     *
+     * \param parent1 Первый родитель
+     * \param parent2 Второй родитель
+     * \param child1 Первый ребёнок
+     * \param child2 Второй ребёнок
+     * \param index Номер пары среди подготовленных
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void CrossPrepared(
+        const individual_type& parent1,
+        const individual_type& parent2,
+        individual_type& child1,
+        individual_type& child2,
+        const std::size_t index,
+        Engine& engine) const
+    {
+        const std::size_t slot = m_choice.GetSlot(index);
+        Apply(m_choice.GetChoice(index), [&] (const auto& crossover)
+        {
+            CrossOne(crossover, parent1, parent2, child1, child2, slot, engine);
+        }, std::index_sequence_for<Crossovers...>{});
+    }
+private:
+    template<
+        typename Function,
+        std::size_t... Indices>
+    void Apply(
+        const std::size_t choice,
+        Function&& function,
+        std::index_sequence<Indices...>) const
+    {
+        ((choice == Indices ? function(std::get<Indices>(m_crossovers)) : void()), ...);
+    }
+
+    template<
+        typename Engine,
+        std::size_t... Indices>
+    void Prepare(
+        Engine& engine,
+        std::index_sequence<Indices...>) const
+    {
+        (PrepareCrossover(std::get<Indices>(m_crossovers), m_choice.GetCount(Indices), engine), ...);
+    }
+private:
+    // Выбор скрещивания
+    WeightedChoice<sizeof...(Crossovers)> m_choice;
+    // Скрещивания
+    std::tuple<Crossovers...> m_crossovers;
+};
+
+}
@@ -0,0 +1,294 @@
+﻿#pragma once
+
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#ifdef _DEBUG
+#   include <iostream>
+#endif
+
+#include "Population.hpp"
+
+namespace GA
+{
+
+/**
+ * Способ обработки недопустимых особей
+ */
+enum class ConstraintHandling
+{
+    // Смертельный штраф: недопустимая особь получает бесконечно плохую
+    // приспособленность и не выигрывает ни одного турнира с допустимой
+    DeathPenalty,
+    // Правила допустимости Деба: допустимая особь лучше недопустимой,
+    // из двух допустимых лучше та, у которой меньше приспособленность,
+    // из двух недопустимых - та, у которой меньше нарушение ограничений.
+    // "An efficient constraint handling method for genetic algorithms", Deb, 2000
+    FeasibilityRules
+};
+
+/**
+ * Результат вычисления приспособленности с проверкой ограничений
+ */
+struct ConstraintCounts
+{
+    // Количество вычислений функции приспособленности
+    std::size_t numEvaluations = 0;
+    // Количество неизменённых особей, не оценённых повторно
+    std::size_t numUnchanged = 0;
+    // Количество изменённых недопустимых особей, не переданных в функцию приспособленности
+    std::size_t numRejected = 0;
+    // Количество особей, исправленных функцией исправления
+    std::size_t numRepaired = 0;
+    // Количество недопустимых особей в популяции после исправления
+    std::size_t numInfeasible = 0;
+};
+
+/**
+ * Обработка ограничений перед вычислением приспособленности.
+ * Для задач, в которых ограничения проверяются дёшево, а функция
+ * приспособленности дорога: сначала одним проходом по популяции вычисляется
+ * нарушение ограничений (и недопустимые особи по возможности исправляются),
+ * затем функция приспособленности вызывается только для допустимых особей.
+ * Недопустимые особи получают приспособленность по выбранному способу обработки.
+ *
+ * Правила Деба выражены через приспособленность: недопустимая особь получает
+ * значение "худшая допустимая приспособленность популяции + нарушение", поэтому
+ * любое сравнение по приспособленности - турнир TournamentSelection, пакетный
+ * SelectIndices, вытеснение - сравнивает особи по правилам Деба.
+ * Если в популяции нет допустимых особей, берётся худшая допустимая
+ * приспособленность с начала запуска; недопустимая особь никогда
+ * не считается лучшей особью запуска
+ */
+template<
+    typename GeneType>
+class ConstraintHandler
+{
+public:
+    // Тип популяции
+    using population_type = Population<GeneType>;
+    // Тип значения гена
+    using value_type = typename GeneType::value_type;
+    // Тип функции приспособленности
+    using fitness_function = typename population_type::fitness_function;
+    // Тип функции нарушения ограничений: суммарное нарушение по значению гена,
+    // 0 (или меньше) - особь допустима. Вызывается из одного потока
+    using violation_function = std::function<value_type(const value_type)>;
+    // Тип функции исправления: изменяет ген недопустимой особи,
+    // стараясь сделать её допустимой
+    using repair_function = std::function<void(GeneType&)>;
+public:
+    ConstraintHandler() = default;
+    /**
+     * Конструктор.
+     *
+     * \param violation Функция нарушения ограничений
+     * \param handling Способ обработки недопустимых особей
+     * \param repair Функция исправления (пустая - не исправлять)
+     */
+    ConstraintHandler(
+        const violation_function& violation,
+        const ConstraintHandling handling = ConstraintHandling::FeasibilityRules,
+        const repair_function& repair = {}) :
+        m_violation(violation),
+        m_repair(repair),
+        m_handling(handling) {}
+
+    /**
+     * Проверка, заданы ли ограничения
+     *
+     * \return true, если задана функция нарушения ограничений
+     */
+    bool IsEnabled() const
+    {
+        return static_cast<bool>(m_violation);
+    }
+
+    /**
+     * Проверка, допустима ли особь
+     *
+     * \param value Значение гена
+     * \return true, если ограничения не нарушены
+     */
+    bool IsFeasible(
+        const value_type value) const
+    {
+        return !m_violation || m_violation(value) <= 0;
+    }
+
+    /**
+     * Функция приспособленности с проверкой ограничений для локального поиска.
+     * Недопустимое значение получает штраф без вызова функции приспособленности:
+     * бесконечность при смертельном штрафе, иначе худшая допустимая
+     * приспособленность запуска + нарушение. Функцию можно вызывать из нескольких
+     * потоков, функция нарушения ограничений при этом вызывается под блокировкой.
+     * Обработчик должен жить, пока используется возвращённая функция
+     *
+     * \param fitnessFn Функция приспособленности
+     * \param numRejected Счётчик значений, отсеянных без вычисления
+     * \return Функция приспособленности
+     */
+    fitness_function Guard(
+        const fitness_function& fitnessFn,
+        std::atomic<std::size_t>& numRejected) const
+    {
+        return [this, fitnessFn, &numRejected, mutex = std::make_shared<std::mutex>()] (const value_type value)
+        {
+            value_type violation;
+            {
+                std::lock_guard<std::mutex> lock(*mutex);
+                violation = m_violation(value);
+            }
+            if (violation > 0) {
+                ++numRejected;
+                return m_handling == ConstraintHandling::DeathPenalty
+                    ? std::numeric_limits<value_type>::infinity() : m_worstFeasible + violation;
+            }
+            return fitnessFn(value);
+        };
+    }
+
+    /**
+     * Сброс запомненной худшей допустимой приспособленности перед новым запуском
+     *
+     * \return
+     */
+    void Reset()
+    {
+        m_hasWorstFeasible = false;
+        m_worstFeasible = static_cast<value_type>(0);
+    }
+
+    /**
+     * Вычисление приспособленности популяции с предварительной проверкой ограничений.
+     * Нарушение вычисляется для всех особей: приспособленность неизменённых
+     * недопустимых особей зависит от худшей допустимой особи и пересчитывается.
+     * Функция приспособленности вызывается только для изменённых допустимых особей
+     *
+     * \param population Популяция
+     * \param fitnessFn Функция приспособленности
+     * \param numThreads Количество потоков вычисления приспособленности (0 - по числу ядер)
+     * \return Количество вычислений, пропусков и отсеянных особей
+     */
+    ConstraintCounts Evaluate(
+        population_type& population,
+        const fitness_function& fitnessFn,
+        const std::size_t numThreads)
+    {
+        return Evaluate(population, [&fitnessFn, numThreads] (population_type& checked)
+        {
+            return checked.CalculateChangedFitness(fitnessFn, numThreads);
+        });
+    }
+
+    /**
+     * Вычисление приспособленности популяции с предварительной проверкой ограничений
+     * заданным способом. Недопустимые особи до назначения штрафа помечаются оценёнными,
+     * поэтому способ вычисления видит неоценёнными только изменённые допустимые особи
+     *
+     * \param population Популяция
+     * \param evaluate Вычисление приспособленности неоценённых особей,
+     * вызывается как evaluate(population) и возвращает количество вычислений
+     * \return Количество вычислений, пропусков и отсеянных особей
+     */
+    template<
+        typename Evaluator>
+    ConstraintCounts Evaluate(
+        population_type& population,
+        const Evaluator& evaluate)
+    {
+        ConstraintCounts counts;
+        const std::size_t size = population.GetSize();
+        m_violations.resize(size);
+        // Проверка ограничений дешёвая, поэтому выполняется одним последовательным проходом
+        for (std::size_t i = 0; i < size; ++i) {
+            auto& individual = population[i];
+            const bool changed = !individual.IsEvaluated();
+            value_type violation = m_violation(individual());
+            if (violation > 0 && m_repair) {
+                m_repair(individual.GetGene());
+                violation = m_violation(individual());
+                ++counts.numRepaired;
+            }
+            m_violations[i] = violation;
+            if (violation > 0) {
+                ++counts.numInfeasible;
+                counts.numRejected += changed ? 1 : 0;
+                // Временное значение, окончательное назначает Penalize
+                individual.SetFitness(std::numeric_limits<value_type>::infinity());
+            }
+            else if (individual.IsEvaluated()) {
+                ++counts.numUnchanged;
+            }
+        }
+        // Дорогая функция приспособленности - только для допустимых особей
+        counts.numEvaluations = evaluate(population);
+        if (counts.numInfeasible > 0) {
+            Penalize(population);
+        }
+#ifdef _DEBUG
+        std::cout << "\tConstraints: " << counts.numInfeasible << " infeasible, "
+            << counts.numRejected << " evaluations saved, " << counts.numRepaired << " repaired" << std::endl;
+#endif
+        return counts;
+    }
+private:
+    /**
+     * Назначение приспособленности недопустимым особям
+     *
+     * \param population Популяция с вычисленным нарушением ограничений
+     * \return
+     */
+    void Penalize(
+        population_type& population)
+    {
+        if (m_handling == ConstraintHandling::DeathPenalty) {
+            for (std::size_t i = 0; i < population.GetSize(); ++i) {
+                if (m_violations[i] > 0) {
+                    population[i].SetFitness(std::numeric_limits<value_type>::infinity());
+                }
+            }
+            return;
+        }
+        // Худшая допустимая приспособленность популяции. Если допустимых особей нет,
+        // берётся последняя известная, чтобы недопустимая особь не стала лучше
+        // ранее найденных допустимых
+        bool anyFeasible = false;
+        value_type worstFeasible = m_worstFeasible;
+        for (std::size_t i = 0; i < population.GetSize(); ++i) {
+            if (m_violations[i] <= 0) {
+                const value_type fitness = population[i].GetFitness();
+                worstFeasible = anyFeasible ? std::max(worstFeasible, fitness) : fitness;
+                anyFeasible = true;
+            }
+        }
+        if (anyFeasible) {
+            m_worstFeasible = m_hasWorstFeasible ? std::max(m_worstFeasible, worstFeasible) : worstFeasible;
+            m_hasWorstFeasible = true;
+        }
+        for (std::size_t i = 0; i < population.GetSize(); ++i) {
+            if (m_violations[i] > 0) {
+                population[i].SetFitness(worstFeasible + m_violations[i]);
+            }
+        }
+    }
+private:
+    // Функция нарушения ограничений
+    violation_function m_violation;
+    // Функция исправления
+    repair_function m_repair;
+    // Способ обработки недопустимых особей
+    ConstraintHandling m_handling = ConstraintHandling::FeasibilityRules;
+    // Нарушение ограничений особей последней оценённой популяции
+    std::vector<value_type> m_violations;
+    // Флаг, говорящий о том, что в запуске уже встречались допустимые особи
+    bool m_hasWorstFeasible = false;
+    // Худшая допустимая приспособленность с начала запуска
+    value_type m_worstFeasible = static_cast<value_type>(0);
+};
+
+}
@@ -0,0 +1,875 @@
+﻿#pragma once
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#ifdef _DEBUG
+#   include <iostream>
+#endif
+
+#include "Batch.hpp"
+#include "Parallel.hpp"
+#include "Diversity.hpp"
+#include "Statistics.hpp"
+
+namespace GA
+{
+
+// Разбиение переменных на подкомпоненты: индексы переменных каждой группы
+using VariableGroups = std::vector<std::vector<std::size_t>>;
+
+/**
+ * Проверка того, что функция приспособленности умеет вычислять вклад части
+ * переменных: Partial(x, indices) - сумма слагаемых, зависящих хотя бы от одной
+ * переменной из indices. После замены только этих переменных значение
+ * пересчитывается как f(x) - Partial(x, indices) + Partial(x', indices)
+ */
+template<
+    typename Fitness,
+    typename RealType,
+    typename = void>
+struct has_partial_fitness : std::false_type {};
+
+template<
+    typename Fitness,
+    typename RealType>
+struct has_partial_fitness<
+    Fitness,
+    RealType,
+    std::void_t<decltype(std::declval<const Fitness&>().Partial(
+        std::declval<Span<const RealType>>(),
+        std::declval<Span<const std::size_t>>()))>> : std::true_type {};
+
+template<
+    typename Fitness,
+    typename RealType>
+inline constexpr bool has_partial_fitness_v = has_partial_fitness<Fitness, RealType>::value;
+
+/**
+ * Замена части переменных вектора с вычислением изменения приспособленности.
+ * Если функция умеет вычислять вклад части переменных, пересчитываются только
+ * зависящие от них слагаемые, иначе функция вычисляется дважды полностью
+ *
+ * \param fitness Функция приспособленности
+ * \param x Вектор переменных (изменяется)
+ * \param indices Индексы заменяемых переменных
+ * \param values Новые значения переменных
+ * \return Новое значение функции минус старое
+ */
+template<
+    typename RealType,
+    typename Fitness>
+RealType ReplaceVariables(
+    const Fitness& fitness,
+    const Span<RealType> x,
+    const Span<const std::size_t> indices,
+    const Span<const RealType> values)
+{
+    const Span<const RealType> vector = x;
+    if constexpr (has_partial_fitness_v<Fitness, RealType>) {
+        const RealType before = fitness.Partial(vector, indices);
+        for (std::size_t i = 0; i < indices.GetSize(); ++i) {
+            x[indices[i]] = values[i];
+        }
+        return fitness.Partial(vector, indices) - before;
+    }
+    else {
+        const RealType before = fitness(vector);
+        for (std::size_t i = 0; i < indices.GetSize(); ++i) {
+            x[indices[i]] = values[i];
+        }
+        return fitness(vector) - before;
+    }
+}
+
+/**
+ * Случайное разбиение переменных на группы одного размера
+ * (последняя группа может быть меньше)
+ *
+ * \param dimension Количество переменных
+ * \param groupSize Размер группы
+ * \param engine Движок генерации случайных чисел
+ * \return Группы переменных
+ */
+template<
+    typename Engine>
+VariableGroups RandomGrouping(
+    const std::size_t dimension,
+    const std::size_t groupSize,
+    Engine& engine)
+{
+    std::vector<std::size_t> indices(dimension);
+    std::iota(indices.begin(), indices.end(), static_cast<std::size_t>(0));
+    std::shuffle(indices.begin(), indices.end(), engine);
+    const std::size_t size = std::max<std::size_t>(groupSize, 1);
+    VariableGroups groups;
+    groups.reserve((dimension + size - 1) / size);
+    for (std::size_t first = 0; first < dimension; first += size) {
+        groups.emplace_back(indices.begin() + first, indices.begin() + std::min(first + size, dimension));
+    }
+    return groups;
+}
+
+/**
+ * Дифференциальное группирование.
+ * Переменные i и j взаимодействуют, если изменение функции при сдвиге x[i]
+ * от нижней границы к верхней зависит от значения x[j]:
+ * |Δ(x[j] = min) - Δ(x[j] = середина)| > epsilon. Группа строится как
+ * транзитивное замыкание взаимодействий, поэтому цепочки вида x[k]-x[k+1]
+ * попадают в одну группу. Переменные, ни с чем не взаимодействующие,
+ * объединяются в группы заданного размера.
+ * Если функция умеет вычислять вклад части переменных, каждая проверка
+ * пары стоит два вычисления вклада одной переменной вместо двух полных
+ */
+template<
+    typename RealType>
+class DifferentialGrouping
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param minValue Нижняя граница переменных
+     * \param maxValue Верхняя граница переменных
+     * \param epsilon Порог взаимодействия
+     * \param separableGroupSize Размер групп для независимых переменных
+     */
+    DifferentialGrouping(
+        const RealType minValue,
+        const RealType maxValue,
+        const RealType epsilon = static_cast<RealType>(1e-3),
+        const std::size_t separableGroupSize = 50) :
+        m_minValue(minValue),
+        m_maxValue(maxValue),
+        m_epsilon(epsilon),
+        m_separableGroupSize(std::max<std::size_t>(separableGroupSize, 1)) {}
+
+    /**
+     * Разбиение переменных на группы
+     *
+     * \param fitness Функция приспособленности
+     * \param dimension Количество переменных
+     * \return Группы переменных
+     */
+    template<
+        typename Fitness>
+    VariableGroups operator () (
+        const Fitness& fitness,
+        const std::size_t dimension)
+    {
+        m_numEvaluations = 0;
+        const RealType middle = (m_minValue + m_maxValue) / static_cast<RealType>(2);
+        std::vector<RealType> x(dimension, m_minValue);
+        std::vector<char> assigned(dimension, 0);
+        std::vector<std::size_t> separable;
+        VariableGroups groups;
+        for (std::size_t first = 0; first < dimension; ++first) {
+            if (assigned[first]) {
+                continue;
+            }
+            assigned[first] = 1;
+            std::vector<std::size_t> group { first };
+            for (std::size_t k = 0; k < group.size(); ++k) {
+                const std::size_t i = group[k];
+                const RealType delta = Shift(fitness, x, i);
+                for (std::size_t j = first + 1; j < dimension; ++j) {
+                    if (assigned[j]) {
+                        continue;
+                    }
+                    x[j] = middle;
+                    const RealType shiftedDelta = Shift(fitness, x, i);
+                    x[j] = m_minValue;
+                    if (std::abs(delta - shiftedDelta) > m_epsilon) {
+                        assigned[j] = 1;
+                        group.push_back(j);
+                    }
+                }
+            }
+            if (group.size() > 1) {
+                std::sort(group.begin(), group.end());
+                groups.push_back(std::move(group));
+            }
+            else {
+                separable.push_back(first);
+            }
+        }
+        for (std::size_t i = 0; i < separable.size(); i += m_separableGroupSize) {
+            groups.emplace_back(separable.begin() + i,
+                separable.begin() + std::min(i + m_separableGroupSize, separable.size()));
+        }
+        return groups;
+    }
+
+    /**
+     * Получение количества вычислений приспособленности (полных или вклада
+     * переменной) за последнее разбиение
+     *
+     * \return Количество вычислений
+     */
+    std::size_t GetNumEvaluations() const
+    {
+        return m_numEvaluations;
+    }
+private:
+    /**
+     * Изменение функции при сдвиге переменной от нижней границы к верхней
+     *
+     * \param fitness Функция приспособленности
+     * \param x Вектор переменных, x[index] равен нижней границе
+     * \param index Индекс переменной
+     * \return Изменение функции
+     */
+    template<
+        typename Fitness>
+    RealType Shift(
+        const Fitness& fitness,
+        std::vector<RealType>& x,
+        const std::size_t index)
+    {
+        m_numEvaluations += 2;
+        const RealType delta = ReplaceVariables(fitness, Span<RealType>(x),
+            Span<const std::size_t>(&index, 1), Span<const RealType>(&m_maxValue, 1));
+        x[index] = m_minValue;
+        return delta;
+    }
+private:
+    // Нижняя граница переменных
+    RealType m_minValue;
+    // Верхняя граница переменных
+    RealType m_maxValue;
+    // Порог взаимодействия
+    RealType m_epsilon;
+    // Размер групп для независимых переменных
+    std::size_t m_separableGroupSize;
+    // Количество вычислений за последнее разбиение
+    std::size_t m_numEvaluations = 0;
+};
+
+/**
+ * Кооперативная коэволюция для задач большой размерности.
+ * Вектор решения делится на подкомпоненты (группы переменных), каждая
+ * подкомпонента эволюционирует в своей подпопуляции генетическим алгоритмом
+ * (турнирный отбор, BLX-α скрещивание, гауссова мутация, элитизм).
+ * Особь подпопуляции оценивается в контекстном векторе - лучшем известном
+ * решении, в котором заменены переменные её группы.
+ * За цикл каждая подкомпонента проходит заданное число поколений против
+ * контекста начала цикла; подкомпоненты обрабатываются параллельно.
+ * Затем лучшие особи подкомпонент по очереди переносятся в контекст, если
+ * это его улучшает. Если функция приспособленности умеет вычислять вклад
+ * части переменных (Partial), особь и изменение контекста оцениваются по
+ * слагаемым своей группы, а не по всему вектору.
+ * Функция приспособленности - объект с operator()(Span<const RealType>)
+ * и, необязательно, Partial(Span<const RealType>, Span<const std::size_t>);
+ * вызовы допускаются из нескольких потоков; решается задача минимизации
+ */
+template<
+    typename RealType>
+class CooperativeCoevolution
+{
+public:
+    // Тип значения
+    using value_type = RealType;
+    // Тип статистики поколения
+    using statistics_type = GenerationStatistics<value_type>;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param populationSize Размер подпопуляции
+     * \param tournamentSize Размер турнира
+     * \param crossoverProbability Вероятность скрещивания пары родителей
+     * \param mutationProbability Вероятность мутации каждой переменной
+     * \param mutationScale Стандартное отклонение мутации в долях ширины области поиска
+     * \param blendAlpha Коэффициент α скрещивания BLX-α
+     */
+    CooperativeCoevolution(
+        const std::size_t populationSize,
+        const std::size_t tournamentSize = 2,
+        const double crossoverProbability = 0.9,
+        const double mutationProbability = 0.05,
+        const RealType mutationScale = static_cast<RealType>(0.1),
+        const RealType blendAlpha = static_cast<RealType>(0.5)) :
+        m_populationSize(std::max<std::size_t>(populationSize, 2)),
+        m_tournamentSize(std::max<std::size_t>(tournamentSize, 1)),
+        m_crossoverProbability(crossoverProbability),
+        m_mutationProbability(mutationProbability),
+        m_mutationScale(mutationScale),
+        m_blendAlpha(blendAlpha) {}
+
+    /**
+     * Инициализация популяции и контекстного вектора
+     *
+     * \param dimension Количество переменных
+     * \param minValue Нижняя граница переменных
+     * \param maxValue Верхняя граница переменных
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void Init(
+        const std::size_t dimension,
+        const RealType minValue,
+        const RealType maxValue,
+        Engine& engine)
+    {
+        m_dimension = dimension;
+        m_minValue = minValue;
+        m_maxValue = maxValue;
+        std::uniform_real_distribution<RealType> distribution(minValue, maxValue);
+        m_values.resize(m_populationSize * dimension);
+        for (auto& value : m_values) {
+            value = distribution(engine);
+        }
+        m_context.assign(m_values.begin(), m_values.begin() + dimension);
+    }
+
+    /**
+     * Задание постоянного разбиения переменных на подкомпоненты,
+     * например полученного дифференциальным группированием
+     *
+     * \param groups Группы переменных
+     * \return
+     */
+    void SetGroups(
+        VariableGroups groups)
+    {
+        m_groups = std::move(groups);
+        m_randomGroupSize = 0;
+    }
+
+    /**
+     * Задание случайного разбиения, выполняемого заново в начале каждого цикла
+     *
+     * \param groupSize Размер группы
+     * \return
+     */
+    void SetRandomGrouping(
+        const std::size_t groupSize)
+    {
+        m_randomGroupSize = std::max<std::size_t>(groupSize, 1);
+    }
+
+    /**
+     * Задание количества поколений подпопуляции за цикл
+     *
+     * \param numGenerations Количество поколений
+     * \return
+     */
+    void SetGenerationsPerCycle(
+        const std::size_t numGenerations)
+    {
+        m_generationsPerCycle = std::max<std::size_t>(numGenerations, 1);
+    }
+
+    /**
+     * Задание количества потоков, между которыми делятся подкомпоненты.
+     * Функция приспособленности должна допускать вызов из нескольких потоков
+     *
+     * \param numThreads Количество потоков (0 - по числу ядер, 1 - последовательно)
+     * \return
+     */
+    void SetSubcomponentThreads(
+        const std::size_t numThreads)
+    {
+        m_subcomponentThreads = numThreads;
+    }
+
+    /**
+     * Запуск кооперативной коэволюции
+     *
+     * \param numCycles Количество циклов
+     * \param fitness Функция приспособленности
+     * \param engine Движок генерации случайных чисел
+     * \return Решение (значение функции приспособленности контекстного вектора)
+     */
+    template<
+        typename Fitness,
+        typename Engine>
+    value_type Run(
+        const std::size_t numCycles,
+        const Fitness& fitness,
+        Engine& engine)
+    {
+        m_statistics.clear();
+        m_numEvaluations = 1;
+        m_numPartialEvaluations = 0;
+        m_cycleEvaluations = 1;
+        m_cycleSkippedEvaluations = 0;
+        m_contextFitness = fitness(Span<const RealType>(m_context));
+        if (m_groups.empty() && m_randomGroupSize == 0) {
+            // Без разбиения - одна подкомпонента из всех переменных
+            m_groups.emplace_back(m_dimension);
+            std::iota(m_groups.front().begin(), m_groups.front().end(), static_cast<std::size_t>(0));
+        }
+        std::vector<Engine> engines;
+        for (std::size_t i = 0; i < numCycles; ++i) {
+#ifdef _DEBUG
+            std::cout << "Cycle " << i << std::endl;
+#endif
+            RecordStatistics(i);
+            if (m_randomGroupSize > 0) {
+                m_groups = RandomGrouping(m_dimension, m_randomGroupSize, engine);
+            }
+            m_subcomponents.resize(m_groups.size());
+            engines.clear();
+            engines.reserve(m_groups.size());
+            for (std::size_t g = 0; g < m_groups.size(); ++g) {
+                std::seed_seq seeds { engine(), engine(), engine(), engine() };
+                engines.emplace_back(seeds);
+            }
+            ParallelFor(0, m_groups.size(), m_subcomponentThreads, [&] (const std::size_t g)
+            {
+                Evolve(m_groups[g], m_subcomponents[g], fitness, engines[g]);
+            });
+            for (const auto& subcomponent : m_subcomponents) {
+                m_numEvaluations += subcomponent.numEvaluations;
+                m_numPartialEvaluations += subcomponent.numPartialEvaluations;
+                m_cycleEvaluations += subcomponent.numEvaluations + subcomponent.numPartialEvaluations;
+                m_cycleSkippedEvaluations += subcomponent.numSkippedEvaluations;
+            }
+            UpdateContext(fitness);
+#ifdef _DEBUG
+            std::cout << "Context fitness " << m_contextFitness << std::endl;
+            std::cout << std::endl;
+#endif
+        }
+        RecordStatistics(numCycles);
+        return m_contextFitness;
+    }
+
+    /**
+     * Получение контекстного вектора (лучшего найденного решения)
+     *
+     * \return Значения переменных
+     */
+    const std::vector<RealType>& GetContextVector() const
+    {
+        return m_context;
+    }
+
+    /**
+     * Получение разбиения переменных последнего цикла
+     *
+     * \return Группы переменных
+     */
+    const VariableGroups& GetGroups() const
+    {
+        return m_groups;
+    }
+
+    /**
+     * Получение статистики последнего запуска по циклам
+     *
+     * \return Статистика циклов
+     */
+    const std::vector<statistics_type>& GetStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /**
+     * Получение количества полных вычислений приспособленности за последний запуск
+     *
+     * \return Количество вычислений
+     */
+    std::size_t GetNumEvaluations() const
+    {
+        return m_numEvaluations;
+    }
+
+    /**
+     * Получение количества вычислений вклада подкомпоненты за последний запуск
+     *
+     * \return Количество вычислений
+     */
+    std::size_t GetNumPartialEvaluations() const
+    {
+        return m_numPartialEvaluations;
+    }
+private:
+    /**
+     * Рабочие данные подкомпоненты. Подпопуляция на время цикла копируется
+     * из общей матрицы в непрерывный массив, чтобы потоки не делили строки
+     */
+    struct Subcomponent
+    {
+        // Значения переменных группы, по строке на особь
+        std::vector<RealType> values;
+        // Значения переменных потомков
+        std::vector<RealType> offspring;
+        // Приспособленность особей
+        std::vector<RealType> fitness;
+        // Приспособленность потомков
+        std::vector<RealType> offspringFitness;
+        // Признак того, что потомка нужно оценить
+        std::vector<char> dirty;
+        // Контекстный вектор с переменными оцениваемой особи
+        std::vector<RealType> candidate;
+        // Индекс лучшей особи
+        std::size_t best = 0;
+        // Количество полных вычислений за цикл
+        std::size_t numEvaluations = 0;
+        // Количество вычислений вклада за цикл
+        std::size_t numPartialEvaluations = 0;
+        // Количество потомков, унаследовавших приспособленность родителя
+        std::size_t numSkippedEvaluations = 0;
+    };
+
+    /**
+     * Эволюция подкомпоненты против контекста начала цикла
+     *
+     * \param indices Переменные подкомпоненты
+     * \param subcomponent Рабочие данные подкомпоненты
+     * \param fitness Функция приспособленности
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Fitness,
+        typename Engine>
+    void Evolve(
+        const std::vector<std::size_t>& indices,
+        Subcomponent& subcomponent,
+        const Fitness& fitness,
+        Engine& engine)
+    {
+        const std::size_t size = indices.size();
+        subcomponent.values.resize(m_populationSize * size);
+        subcomponent.offspring.resize(m_populationSize * size);
+        subcomponent.fitness.resize(m_populationSize);
+        subcomponent.offspringFitness.resize(m_populationSize);
+        subcomponent.dirty.assign(m_populationSize, 1);
+        subcomponent.candidate = m_context;
+        subcomponent.numEvaluations = 0;
+        subcomponent.numPartialEvaluations = 0;
+        subcomponent.numSkippedEvaluations = 0;
+        for (std::size_t i = 0; i < m_populationSize; ++i) {
+            for (std::size_t j = 0; j < size; ++j) {
+                subcomponent.values[i * size + j] = m_values[i * m_dimension + indices[j]];
+            }
+        }
+        // Значение контекста без слагаемых группы: к нему прибавляется вклад особи
+        RealType offset = static_cast<RealType>(0);
+        if constexpr (has_partial_fitness_v<Fitness, RealType>) {
+            offset = m_contextFitness - fitness.Partial(Span<const RealType>(m_context), Span<const std::size_t>(indices));
+            ++subcomponent.numPartialEvaluations;
+        }
+        Evaluate(indices, subcomponent, subcomponent.values, subcomponent.fitness, offset, fitness);
+        for (std::size_t generation = 0; generation < m_generationsPerCycle; ++generation) {
+            Breed(indices, subcomponent, engine);
+            Evaluate(indices, subcomponent, subcomponent.offspring, subcomponent.offspringFitness, offset, fitness);
+            subcomponent.values.swap(subcomponent.offspring);
+            subcomponent.fitness.swap(subcomponent.offspringFitness);
+        }
+        subcomponent.best = static_cast<std::size_t>(std::min_element(
+            subcomponent.fitness.begin(), subcomponent.fitness.end()) - subcomponent.fitness.begin());
+        // Подкомпоненты не пересекаются по столбцам, запись без блокировок
+        for (std::size_t i = 0; i < m_populationSize; ++i) {
+            for (std::size_t j = 0; j < size; ++j) {
+                m_values[i * m_dimension + indices[j]] = subcomponent.values[i * size + j];
+            }
+        }
+    }
+
+    /**
+     * Оценка особей подпопуляции, помеченных как изменённые
+     *
+     * \param indices Переменные подкомпоненты
+     * \param subcomponent Рабочие данные подкомпоненты
+     * \param values Значения переменных особей
+     * \param result Приспособленность особей
+     * \param offset Значение контекста без слагаемых группы
+     * \param fitness Функция приспособленности
+     * \return
+     */
+    template<
+        typename Fitness>
+    void Evaluate(
+        const std::vector<std::size_t>& indices,
+        Subcomponent& subcomponent,
+        const std::vector<RealType>& values,
+        std::vector<RealType>& result,
+        const RealType offset,
+        const Fitness& fitness) const
+    {
+        const std::size_t size = indices.size();
+        const Span<const RealType> candidate(subcomponent.candidate);
+        for (std::size_t i = 0; i < m_populationSize; ++i) {
+            if (!subcomponent.dirty[i]) {
+                ++subcomponent.numSkippedEvaluations;
+                continue;
+            }
+            for (std::size_t j = 0; j < size; ++j) {
+                subcomponent.candidate[indices[j]] = values[i * size + j];
+            }
+            if constexpr (has_partial_fitness_v<Fitness, RealType>) {
+                result[i] = offset + fitness.Partial(candidate, Span<const std::size_t>(indices));
+                ++subcomponent.numPartialEvaluations;
+            }
+            else {
+                result[i] = fitness(candidate);
+                ++subcomponent.numEvaluations;
+            }
+        }
+    }
+
+    /**
+     * Создание поколения потомков подкомпоненты: лучшая особь переходит
+     * без изменений, остальные получаются турнирным отбором, скрещиванием
+     * BLX-α и гауссовой мутацией. Потомок, не изменённый операторами,
+     * наследует приспособленность родителя
+     *
+     * \param indices Переменные подкомпоненты
+     * \param subcomponent Рабочие данные подкомпоненты
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void Breed(
+        const std::vector<std::size_t>& indices,
+        Subcomponent& subcomponent,
+        Engine& engine) const
+    {
+        const std::size_t size = indices.size();
+        const auto& values = subcomponent.values;
+        const auto& fitness = subcomponent.fitness;
+        auto& offspring = subcomponent.offspring;
+        std::uniform_int_distribution<std::size_t> individual(0, m_populationSize - 1);
+        std::uniform_real_distribution<double> probability(0.0, 1.0);
+        std::uniform_real_distribution<RealType> blend(-m_blendAlpha, static_cast<RealType>(1) + m_blendAlpha);
+        std::normal_distribution<RealType> mutation(static_cast<RealType>(0), m_mutationScale * (m_maxValue - m_minValue));
+        const auto select = [&] ()
+        {
+            std::size_t index = individual(engine);
+            for (std::size_t i = 1; i < m_tournamentSize; ++i) {
+                const std::size_t candidate = individual(engine);
+                if (fitness[candidate] < fitness[index]) {
+                    index = candidate;
+                }
+            }
+            return index;
+        };
+        const auto copy = [&] (const std::size_t child, const std::size_t parent)
+        {
+            std::copy_n(values.begin() + parent * size, size, offspring.begin() + child * size);
+            subcomponent.offspringFitness[child] = fitness[parent];
+            subcomponent.dirty[child] = 0;
+        };
+        copy(0, static_cast<std::size_t>(std::min_element(fitness.begin(), fitness.end()) - fitness.begin()));
+        for (std::size_t i = 1; i < m_populationSize; i += 2) {
+            const std::size_t parent1 = select();
+            const std::size_t parent2 = select();
+            const bool pair = i + 1 < m_populationSize;
+            if (probability(engine) >= m_crossoverProbability) {
+                copy(i, parent1);
+                if (pair) {
+                    copy(i + 1, parent2);
+                }
+                continue;
+            }
+            for (std::size_t j = 0; j < size; ++j) {
+                const RealType value1 = values[parent1 * size + j];
+                const RealType value2 = values[parent2 * size + j];
+                const RealType delta = value2 - value1;
+                offspring[i * size + j] = Clamp(value1 + blend(engine) * delta);
+                if (pair) {
+                    offspring[(i + 1) * size + j] = Clamp(value1 + blend(engine) * delta);
+                }
+            }
+            subcomponent.dirty[i] = 1;
+            if (pair) {
+                subcomponent.dirty[i + 1] = 1;
+            }
+        }
+        for (std::size_t i = 1; i < m_populationSize; ++i) {
+            for (std::size_t j = 0; j < size; ++j) {
+                if (probability(engine) < m_mutationProbability) {
+                    RealType& value = offspring[i * size + j];
+                    value = Clamp(value + mutation(engine));
+                    subcomponent.dirty[i] = 1;
+                }
+            }
+        }
+    }
+
+    /**
+     * Перенос лучших особей подкомпонент в контекстный вектор.
+     * Пока контекст не изменился, приспособленность лучшей особи уже
+     * вычислена против него и используется без пересчёта; после изменения
+     * замена группы оценивается по её слагаемым (или одним полным вычислением
+     * нового контекста, если функция не умеет вычислять вклад).
+     * Замена принимается, только если улучшает контекст
+     *
+     * \param fitness Функция приспособленности
+     * \return
+     */
+    template<
+        typename Fitness>
+    void UpdateContext(
+        const Fitness& fitness)
+    {
+        bool changed = false;
+        for (std::size_t g = 0; g < m_groups.size(); ++g) {
+            const auto& indices = m_groups[g];
+            const auto& subcomponent = m_subcomponents[g];
+            const std::size_t size = indices.size();
+            const Span<const RealType> best(subcomponent.values.data() + subcomponent.best * size, size);
+            if (!changed) {
+                ++m_cycleSkippedEvaluations;
+                if (subcomponent.fitness[subcomponent.best] < m_contextFitness) {
+                    for (std::size_t j = 0; j < size; ++j) {
+                        m_context[indices[j]] = best[j];
+                    }
+                    m_contextFitness = subcomponent.fitness[subcomponent.best];
+                    changed = true;
+                }
+                continue;
+            }
+            m_saved.resize(size);
+            for (std::size_t j = 0; j < size; ++j) {
+                m_saved[j] = m_context[indices[j]];
+            }
+            if constexpr (has_partial_fitness_v<Fitness, RealType>) {
+                const RealType delta = ReplaceVariables(fitness, Span<RealType>(m_context),
+                    Span<const std::size_t>(indices), best);
+                m_numPartialEvaluations += 2;
+                m_cycleEvaluations += 2;
+                if (delta < static_cast<RealType>(0)) {
+                    m_contextFitness += delta;
+                    continue;
+                }
+            }
+            else {
+                // Приспособленность контекста до замены уже известна,
+                // поэтому полностью вычисляется только новый контекст
+                for (std::size_t j = 0; j < size; ++j) {
+                    m_context[indices[j]] = best[j];
+                }
+                const RealType value = fitness(Span<const RealType>(m_context));
+                ++m_numEvaluations;
+                ++m_cycleEvaluations;
+                if (value < m_contextFitness) {
+                    m_contextFitness = value;
+                    continue;
+                }
+            }
+            for (std::size_t j = 0; j < size; ++j) {
+                m_context[indices[j]] = m_saved[j];
+            }
+        }
+        if constexpr (has_partial_fitness_v<Fitness, RealType>) {
+            // Значение, собранное из приращений, раз в цикл вычисляется заново,
+            // чтобы не накапливалась погрешность округления
+            if (changed) {
+                m_contextFitness = fitness(Span<const RealType>(m_context));
+                ++m_numEvaluations;
+                ++m_cycleEvaluations;
+            }
+        }
+    }
+
+    /**
+     * Запись статистики цикла
+     *
+     * \param cycle Номер цикла
+     * \return
+     */
+    void RecordStatistics(
+        const std::size_t cycle)
+    {
+        statistics_type statistics;
+        statistics.generation = cycle;
+        statistics.bestFitness = m_contextFitness;
+        statistics.meanFitness = m_contextFitness;
+        double fitnessSum = 0.0;
+        std::size_t count = 0;
+        for (const auto& subcomponent : m_subcomponents) {
+            for (const RealType value : subcomponent.fitness) {
+                fitnessSum += value;
+            }
+            count += subcomponent.fitness.size();
+        }
+        if (count > 0) {
+            statistics.meanFitness = static_cast<value_type>(fitnessSum / count);
+        }
+        RunningVariance genes;
+        for (const RealType value : m_context) {
+            genes.Add(value);
+        }
+        statistics.geneMean = genes.GetMean();
+        statistics.geneVariance = genes.GetVariance();
+        statistics.numEvaluations = m_cycleEvaluations;
+        statistics.numSkippedEvaluations = m_cycleSkippedEvaluations;
+        m_cycleEvaluations = 0;
+        m_cycleSkippedEvaluations = 0;
+        m_statistics.push_back(statistics);
+    }
+
+    /**
+     * Ограничение значения границами поиска
+     *
+     * \param value Значение
+     * \return Значение в границах
+     */
+    RealType Clamp(
+        const RealType value) const
+    {
+        return std::min(std::max(value, m_minValue), m_maxValue);
+    }
+private:
+    // Размер подпопуляции
+    std::size_t m_populationSize;
+    // Размер турнира
+    std::size_t m_tournamentSize;
+    // Вероятность скрещивания
+    double m_crossoverProbability;
+    // Вероятность мутации переменной
+    double m_mutationProbability;
+    // Стандартное отклонение мутации в долях ширины области поиска
+    RealType m_mutationScale;
+    // Коэффициент α скрещивания BLX-α
+    RealType m_blendAlpha;
+    // Количество переменных
+    std::size_t m_dimension = 0;
+    // Границы поиска
+    RealType m_minValue = static_cast<RealType>(0);
+    RealType m_maxValue = static_cast<RealType>(0);
+    // Популяция: по строке из m_dimension значений на особь;
+    // подпопуляция подкомпоненты - столбцы её переменных
+    std::vector<RealType> m_values;
+    // Контекстный вектор
+    std::vector<RealType> m_context;
+    // Приспособленность контекстного вектора
+    RealType m_contextFitness = std::numeric_limits<RealType>::max();
+    // Значения переменных контекста, сохранённые на время пробной замены
+    std::vector<RealType> m_saved;
+    // Разбиение переменных
+    VariableGroups m_groups;
+    // Рабочие данные подкомпонент
+    std::vector<Subcomponent> m_subcomponents;
+    // Размер группы случайного разбиения (0 - разбиение постоянное)
+    std::size_t m_randomGroupSize = 0;
+    // Количество поколений подпопуляции за цикл
+    std::size_t m_generationsPerCycle = 1;
+    // Количество потоков для подкомпонент
+    std::size_t m_subcomponentThreads = 1;
+    // Статистика циклов
+    std::vector<statistics_type> m_statistics;
+    // Количество полных вычислений приспособленности
+    std::size_t m_numEvaluations = 0;
+    // Количество вычислений вклада подкомпоненты
+    std::size_t m_numPartialEvaluations = 0;
+    // Количество вычислений с начала цикла
+    std::size_t m_cycleEvaluations = 0;
+    // Количество пропущенных вычислений с начала цикла
+    std::size_t m_cycleSkippedEvaluations = 0;
+};
+
+}
@@ -1,15 +1,22 @@
 ﻿#pragma once
 
 #include <random>
+#include <vector>
 #include <cassert>
 #include <bitset>
+#include <cmath>
+#include <utility>
 #ifdef _DEBUG
 #   include <iostream>
 #endif
 
 #include "IntegerGene.hpp"
 #include "RealGene.hpp"
+#include "SelfAdaptiveRealGene.hpp"
 #include "Individual.hpp"
+#include "Batch.hpp"
+#include "Diversity.hpp"
+#include "Random.hpp"
 
 namespace GA
 {
@@ -111,15 +118,166 @@ public:
         const auto maxValue = parent1.GetGene().GetMaxValue();
 
         // Создаём двух детей
-        individual_type child1({ child1Gene, minValue, maxValue });
-        individual_type child2({ child2Gene, minValue, maxValue });
+        individual_type child1 = MakeChild(child1Gene, parent1, parent2, minValue, maxValue);
+        individual_type child2 = MakeChild(child2Gene, parent1, parent2, minValue, maxValue);
 
         // Возвращаем результат
         return result_type { child1, child2 };
     }
+
+    /**
+     * Пакетное применение скрещивания.
+     * Дети пары (parentIndices[2i], parentIndices[2i + 1]) записываются
+     * сразу в children[2i] и children[2i + 1], без промежуточных пар
+     *
+     * \param parents Особи, из которых выбираются родители
+     * \param parentIndices Индексы родителей
+     * \param children Участок популяции для детей
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void CrossBatch(
+        const Span<const individual_type> parents,
+        const Span<const std::size_t> parentIndices,
+        const Span<individual_type> children,
+        Engine& engine) const
+    {
+        CrossBatch(parents, parentIndices, children, engine, static_cast<AlleleFrequencies<IntegerType>*>(nullptr));
+    }
+
+    /**
+     * Пакетное применение скрещивания с учётом частот аллелей.
+     * Гены детей добавляются в частоты по мере записи, без отдельного прохода
+     *
+     * \param parents Особи, из которых выбираются родители
+     * \param parentIndices Индексы родителей
+     * \param children Участок популяции для детей
+     * \param engine Движок генерации случайных чисел
+     * \param alleles Частоты аллелей поколения детей
+     * \return
+     */
+    template<
+        typename Engine>
+    void CrossBatch(
+        const Span<const individual_type> parents,
+        const Span<const std::size_t> parentIndices,
+        const Span<individual_type> children,
+        Engine& engine,
+        AlleleFrequencies<IntegerType>& alleles) const
+    {
+        CrossBatch(parents, parentIndices, children, engine, &alleles);
+    }
+
+    /**
+     * Генерация точек скрещивания пакета: от 0 до числа бит включительно
+     *
+     * \param numPairs Количество пар
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void PrepareBatch(
+        const std::size_t numPairs,
+        Engine& engine) const
+    {
+        m_points.resize(numPairs);
+        RandomStream(engine).FillBounded(m_points, static_cast<std::uint32_t>(sizeof(IntegerType) * 8 + 1));
+    }
+
+    /**
+     * Скрещивание пары с точкой, подготовленной PrepareBatch
+     *
+     * \param parent1 Первый родитель
+     * \param parent2 Второй родитель
+     * \param child1 Первый ребёнок
+     * \param child2 Второй ребёнок
+     * \param index Номер подготовленной точки
+     * \param engine Движок генерации случайных чисел (не используется)
+     * \return
+     */
+    template<
+        typename Engine>
+    void CrossPrepared(
+        const individual_type& parent1,
+        const individual_type& parent2,
+        individual_type& child1,
+        individual_type& child2,
+        const std::size_t index,
+        Engine& /*engine*/) const
+    {
+        const auto& parent1Gene = parent1.GetGene();
+        const auto& parent2Gene = parent2.GetGene();
+        // Маски вычисляются так же, как в operator()
+        const std::size_t crossingoverPoint = m_points[index];
+        const IntegerType mask1 = std::numeric_limits<IntegerType>::max() << crossingoverPoint;
+        const IntegerType mask2 = std::numeric_limits<IntegerType>::max() >> ((sizeof(IntegerType) * 8) - crossingoverPoint);
+        const auto minValue = parent1Gene.GetMinValue();
+        const auto maxValue = parent1Gene.GetMaxValue();
+        child1 = MakeChild(static_cast<IntegerType>(
+            (parent1Gene.GetGene() & mask1) | (parent2Gene.GetGene() & mask2)), parent1, parent2, minValue, maxValue);
+        child2 = MakeChild(static_cast<IntegerType>(
+            (parent2Gene.GetGene() & mask1) | (parent1Gene.GetGene() & mask2)), parent1, parent2, minValue, maxValue);
+    }
+private:
+    template<
+        typename Engine>
+    void CrossBatch(
+        const Span<const individual_type> parents,
+        const Span<const std::size_t> parentIndices,
+        const Span<individual_type> children,
+        Engine& engine,
+        AlleleFrequencies<IntegerType>* alleles) const
+    {
+        // Точки скрещивания всех пар генерируются заранее
+        PrepareBatch(children.GetSize() / 2, engine);
+        for (std::size_t i = 0; i + 1 < children.GetSize(); i += 2) {
+            CrossPrepared(parents[parentIndices[i]], parents[parentIndices[i + 1]],
+                children[i], children[i + 1], i / 2, engine);
+            if (alleles) {
+                alleles->Add(std::as_const(children[i]).GetGene().GetGene());
+                alleles->Add(std::as_const(children[i + 1]).GetGene().GetGene());
+            }
+        }
+        if (CopyOddChild(parents, parentIndices, children) && alleles) {
+            alleles->Add(std::as_const(children[children.GetSize() - 1]).GetGene().GetGene());
+        }
+    }
+
+    /**
+     * Создание ребёнка. Если ген ребёнка совпал с геном родителя
+     * (крайняя точка скрещивания или одинаковые родители), ребёнок - копия
+     * этого родителя вместе с вычисленной приспособленностью
+     *
+     * \param gene Ген ребёнка
+     * \param parent1 Первый родитель
+     * \param parent2 Второй родитель
+     * \param minValue Минимальное значение гена
+     * \param maxValue Максимальное значение гена
+     * \return Ребёнок
+     */
+    static individual_type MakeChild(
+        const IntegerType gene,
+        const individual_type& parent1,
+        const individual_type& parent2,
+        const RealType minValue,
+        const RealType maxValue)
+    {
+        if (gene == parent1.GetGene().GetGene()) {
+            return parent1;
+        }
+        if (gene == parent2.GetGene().GetGene()) {
+            return parent2;
+        }
+        return individual_type({ gene, minValue, maxValue });
+    }
 private:
     // Распределение для генерации точки скрещивания
     mutable std::uniform_int_distribution<std::size_t> m_distribution;
+    // Точки скрещивания пар пакета
+    mutable std::vector<std::uint32_t> m_points;
 };
 
 /**
@@ -128,12 +286,15 @@ private:
  * "Генетические алгоритмы на Python", ДМК Пресс, стр. 50
  */
 template<
-    typename RealType>
+    typename RealType,
+    typename StorageType = RealType>
 class BlendCrossover
 {
 public:
+    // Тип гена - вещественный ген
+    using gene_type = RealGene<RealType, StorageType>;
     // Тип особи - особь с вещественным геном
-    using individual_type = Individual<RealGene<RealType>>;
+    using individual_type = Individual<gene_type>;
     // Тип результата скрещивания - пара особей
     using result_type = std::pair<individual_type, individual_type>;
 public:
@@ -151,7 +312,7 @@ public:
      *
      * \param parent1 Первый родитель
      * \param parent1 Второй родитель
-     * \param engine Движок генерации случайных чисел
+     * \param engine Движок генерации случайных чисел (не используется)
      * \return Пара особей-детей
      */
     template<
@@ -159,7 +320,7 @@ public:
     result_type operator() (
         const individual_type& parent1,
         const individual_type& parent2,
-        Engine& engine) const
+        Engine& /*engine*/) const
     {
 #ifdef _DEBUG
         std::cout << "\tBlend Crossover" << std::endl;
@@ -179,9 +340,142 @@ public:
         std::cout << "\t\tChild 1 =  " << child1 << std::endl;
         std::cout << "\t\tChild 2 =  " << child2 << std::endl;
 #endif
+        // Без смещения дети совпадают с родителями - копируем их вместе с приспособленностью
+        if (parent2GeneValue == parent1GeneValue || m_alpha == 0.0) {
+            return { parent1, parent2 };
+        }
         // Возвращаем результат
         return { { child1 }, { child2 } };
     }
+
+    /**
+     * Пакетное применение скрещивания.
+     * Дети пары (parentIndices[2i], parentIndices[2i + 1]) записываются
+     * сразу в children[2i] и children[2i + 1], без промежуточных пар
+     *
+     * \param parents Особи, из которых выбираются родители
+     * \param parentIndices Индексы родителей
+     * \param children Участок популяции для детей
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void CrossBatch(
+        const Span<const individual_type> parents,
+        const Span<const std::size_t> parentIndices,
+        const Span<individual_type> children,
+        Engine& engine) const
+    {
+        for (std::size_t i = 0; i + 1 < children.GetSize(); i += 2) {
+            CrossPrepared(parents[parentIndices[i]], parents[parentIndices[i + 1]],
+                children[i], children[i + 1], i / 2, engine);
+        }
+        CopyOddChild(parents, parentIndices, children);
+    }
+
+    /**
+     * Подготовка пакета. Скрещивание смешением не использует случайных чисел
+     *
+     * \param numPairs Количество пар
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void PrepareBatch(
+        const std::size_t /*numPairs*/,
+        Engine& /*engine*/) const {}
+
+    /**
+     * Скрещивание пары с записью детей на место
+     *
+     * \param parent1 Первый родитель
+     * \param parent2 Второй родитель
+     * \param child1 Первый ребёнок
+     * \param child2 Второй ребёнок
+     * \param index Номер пары в пакете (не используется)
+     * \param engine Движок генерации случайных чисел (не используется)
+     * \return
+     */
+    template<
+        typename Engine>
+    void CrossPrepared(
+        const individual_type& parent1,
+        const individual_type& parent2,
+        individual_type& child1,
+        individual_type& child2,
+        const std::size_t /*index*/,
+        Engine& /*engine*/) const
+    {
+        const RealType parent1GeneValue = parent1();
+        const RealType parent2GeneValue = parent2();
+        const RealType delta = static_cast<RealType>(m_alpha * (parent2GeneValue - parent1GeneValue));
+        // Без смещения дети совпадают с родителями - копируем их вместе с приспособленностью
+        if (delta == 0) {
+            child1 = parent1;
+            child2 = parent2;
+            return;
+        }
+        child1 = individual_type(gene_type(parent1GeneValue - delta));
+        child2 = individual_type(gene_type(parent2GeneValue + delta));
+    }
+private:
+    // Коэффициент α
+    double m_alpha;
+};
+
+/**
+ * Скрещивание смешением для особей с самоадаптивным геном.
+ * Значения генов детей вычисляются так же, как в BlendCrossover,
+ * а шаг мутации детей - среднее геометрическое шагов родителей
+ * (промежуточная рекомбинация стратегических параметров)
+ */
+template<
+    typename RealType>
+class SelfAdaptiveBlendCrossover
+{
+public:
+    // Тип особи - особь с самоадаптивным вещественным геном
+    using individual_type = Individual<SelfAdaptiveRealGene<RealType>>;
+    // Тип результата скрещивания - пара особей
+    using result_type = std::pair<individual_type, individual_type>;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param alpha Коэффициент α
+     */
+    SelfAdaptiveBlendCrossover(
+        const double alpha) :
+        m_alpha(alpha) {}
+
+    /**
+     * Применение скрещивания к особям
+     *
+     * \param parent1 Первый родитель
+     * \param parent1 Второй родитель
+     * \param engine Движок генерации случайных чисел (не используется)
+     * \return Пара особей-детей
+     */
+    template<
+        typename Engine>
+    result_type operator() (
+        const individual_type& parent1,
+        const individual_type& parent2,
+        Engine& /*engine*/) const
+    {
+#ifdef _DEBUG
+        std::cout << "\tSelf-Adaptive Blend Crossover" << std::endl;
+#endif
+        const auto parent1GeneValue = parent1.GetGene()();
+        const auto parent2GeneValue = parent2.GetGene()();
+        RealType child1 = parent1GeneValue - m_alpha * (parent2GeneValue - parent1GeneValue);
+        RealType child2 = parent2GeneValue + m_alpha * (parent2GeneValue - parent1GeneValue);
+        const RealType stepSize = static_cast<RealType>(std::sqrt(
+            parent1.GetGene().GetStepSize() * parent2.GetGene().GetStepSize()));
+        return { { { child1, stepSize } }, { { child2, stepSize } } };
+    }
 private:
     // Коэффициент α
     double m_alpha;
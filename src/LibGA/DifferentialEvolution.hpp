@@ -0,0 +1,466 @@
+﻿#pragma once
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#ifdef _DEBUG
+#   include <iostream>
+#endif
+
+#include "RealGene.hpp"
+#include "Population.hpp"
+#include "Parallel.hpp"
+#include "Diversity.hpp"
+#include "Statistics.hpp"
+
+namespace GA
+{
+
+/**
+ * Дифференциальная эволюция.
+ * Популяция хранится в виде структуры массивов (значения генов и значения
+ * приспособленности - отдельные непрерывные массивы), а пробные векторы
+ * строятся в два прохода: сначала последовательно выбираются случайные
+ * индексы и коэффициенты, затем один цикл без ветвлений вычисляет
+ * x[a] + F(x[b] - x[c]) + F(x[d] - x[e]) для всех особей сразу.
+ * Приспособленность пробных векторов вычисляется параллельно.
+ * Ген одномерный, поэтому биномиальное скрещивание всегда берёт компоненту
+ * мутантного вектора (обязательная позиция j_rand) и коэффициент
+ * скрещивания CR на результат не влияет
+ */
+template<
+    typename RealType>
+class DifferentialEvolution
+{
+public:
+    // Тип гена
+    using gene_type = RealGene<RealType>;
+    // Тип популяции
+    using population_type = Population<gene_type>;
+    // Тип особи
+    using individual_type = typename population_type::individual_type;
+    // Тип значения гена
+    using value_type = RealType;
+    // Тип статистики поколения
+    using statistics_type = GenerationStatistics<value_type>;
+    // Тип функции приспособленности
+    using fitness_function = typename population_type::fitness_function;
+
+    // Стратегия построения мутантного вектора
+    enum class Strategy
+    {
+        // x[r1] + F(x[r2] - x[r3])
+        Rand1Bin,
+        // x[best] + F(x[r1] - x[r2])
+        Best1Bin,
+        // x[i] + F(x[pbest] - x[i]) + F(x[r1] - x̃[r2]) с адаптацией F и архивом (JADE)
+        CurrentToPBest1Bin
+    };
+public:
+    /**
+     * Конструктор.
+     *
+     * \param populationSize Размер популяции (не меньше GetMinPopulationSize(strategy))
+     * \param strategy Стратегия построения мутантного вектора
+     * \param scaleFactor Коэффициент F (для JADE - начальное среднее μF)
+     * \param greediness Доля p лучших особей, из которых выбирается x[pbest] (JADE)
+     * \param adaptationRate Скорость адаптации c среднего μF (JADE)
+     */
+    DifferentialEvolution(
+        const std::size_t populationSize,
+        const Strategy strategy,
+        const RealType scaleFactor = static_cast<RealType>(0.5),
+        const RealType greediness = static_cast<RealType>(0.05),
+        const RealType adaptationRate = static_cast<RealType>(0.1)) :
+        m_population(std::max(populationSize, GetMinPopulationSize(strategy))),
+        m_strategy(strategy),
+        m_scaleFactor(scaleFactor),
+        m_meanScaleFactor(scaleFactor),
+        m_greediness(greediness),
+        m_adaptationRate(adaptationRate) {}
+
+    /**
+     * Наименьший размер популяции, при котором стратегия может выбрать
+     * различные индексы: x[r1], x[r2], x[r3] и текущая особь для Rand1Bin,
+     * x[r1], x[r2] и текущая особь для остальных стратегий
+     *
+     * \param strategy Стратегия построения мутантного вектора
+     * \return Размер популяции
+     */
+    static std::size_t GetMinPopulationSize(
+        const Strategy strategy)
+    {
+        return strategy == Strategy::Rand1Bin ? 4 : 3;
+    }
+
+    /**
+     * Инициализация алгоритма
+     *
+     * \param generator Алгоритм генерации популяции, задающий и границы поиска
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Generator,
+        typename Engine>
+    void Init(
+        const Generator& generator,
+        Engine& engine)
+    {
+        m_population.Init(generator, engine);
+        m_minValue = generator.GetMinValue();
+        m_maxValue = generator.GetMaxValue();
+        const std::size_t size = m_population.GetSize();
+        // Место за популяцией отводится под архив вытесненных родителей (JADE)
+        m_values.assign(2 * size, static_cast<RealType>(0));
+        for (std::size_t i = 0; i < size; ++i) {
+            m_values[i] = m_population[i]();
+        }
+        m_fitness.assign(size, static_cast<RealType>(0));
+        m_archiveSize = 0;
+        m_meanScaleFactor = m_scaleFactor;
+    }
+
+    /**
+     * Задание количества потоков для вычисления приспособленности.
+     * Функция приспособленности должна допускать вызов из нескольких потоков
+     *
+     * \param numThreads Количество потоков (0 - по числу ядер, 1 - последовательно)
+     * \return
+     */
+    void SetEvaluationThreads(
+        const std::size_t numThreads)
+    {
+        m_evaluationThreads = numThreads;
+    }
+
+    /**
+     * Запуск дифференциальной эволюции
+     *
+     * \param numGenerations Количество поколений
+     * \param fitnessFunction Функция приспособленности
+     * \param engine Движок генерации случайных чисел
+     * \return Решение (значение функции приспособленности наиболее приспособленной особи)
+     */
+    template<
+        typename Engine>
+    value_type Run(
+        const std::size_t numGenerations,
+        const fitness_function& fitnessFunction,
+        Engine& engine)
+    {
+        const std::size_t size = m_population.GetSize();
+        m_statistics.clear();
+        Evaluate(m_values.data(), m_fitness.data(), fitnessFunction);
+        for (std::size_t i = 0; i < numGenerations; ++i) {
+#ifdef _DEBUG
+            std::cout << "Generation " << i << std::endl;
+#endif
+            RecordStatistics(i);
+            DrawIndices(engine);
+            BuildTrials();
+            Evaluate(m_trials.data(), m_trialFitness.data(), fitnessFunction);
+            Select(engine);
+#ifdef _DEBUG
+            std::cout << std::endl;
+#endif
+        }
+        RecordStatistics(numGenerations);
+        // Переносим результат в популяцию
+        for (std::size_t i = 0; i < size; ++i) {
+            m_population[i] = individual_type(gene_type(m_values[i]));
+            m_population[i].SetFitness(m_fitness[i]);
+        }
+        return size > 0 ? m_fitness[GetBestIndex()] : static_cast<value_type>(0);
+    }
+
+    /**
+     * Получение популяции после запуска
+     *
+     * \return Популяция
+     */
+    population_type& GetPopulation()
+    {
+        return m_population;
+    }
+
+    /**
+     * Получение статистики последнего запуска по поколениям
+     *
+     * \return Статистика поколений
+     */
+    const std::vector<statistics_type>& GetStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /**
+     * Получение текущего среднего коэффициента μF (для JADE)
+     *
+     * \return Среднее значение F
+     */
+    RealType GetMeanScaleFactor() const
+    {
+        return m_meanScaleFactor;
+    }
+private:
+    /**
+     * Вычисление приспособленности массива значений
+     *
+     * \param values Значения генов
+     * \param fitness Массив для значений приспособленности
+     * \param fitnessFunction Функция приспособленности
+     * \return
+     */
+    void Evaluate(
+        const RealType* values,
+        RealType* fitness,
+        const fitness_function& fitnessFunction) const
+    {
+        ParallelFor(0, m_population.GetSize(), m_evaluationThreads, [&] (const std::size_t i)
+        {
+            fitness[i] = fitnessFunction(values[i]);
+        });
+    }
+
+    /**
+     * Получение индекса наиболее приспособленной особи
+     *
+     * \return Индекс особи
+     */
+    std::size_t GetBestIndex() const
+    {
+        return static_cast<std::size_t>(std::min_element(m_fitness.begin(),
+            m_fitness.begin() + m_population.GetSize()) - m_fitness.begin());
+    }
+
+    /**
+     * Выбор индексов и коэффициентов для всех пробных векторов.
+     * Пробный вектор i строится как x[a] + F(x[b] - x[c]) + F(x[d] - x[e]),
+     * неиспользуемая разность задаётся совпадающими индексами
+     *
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void DrawIndices(
+        Engine& engine)
+    {
+        const std::size_t size = m_population.GetSize();
+        for (auto* indices : { &m_a, &m_b, &m_c, &m_d, &m_e }) {
+            indices->resize(size);
+        }
+        m_scale.resize(size);
+        std::uniform_int_distribution<std::size_t> population(0, size - 1);
+        // Выбор индекса, отличного от уже выбранных
+        const auto distinct = [&] (const std::size_t i, const std::size_t r1, const std::size_t r2)
+        {
+            std::size_t r;
+            do {
+                r = population(engine);
+            } while (r == i || r == r1 || r == r2);
+            return r;
+        };
+        if (m_strategy == Strategy::CurrentToPBest1Bin) {
+            // Индексы p·NP лучших особей
+            const std::size_t numBest = std::clamp<std::size_t>(
+                static_cast<std::size_t>(std::ceil(m_greediness * size)), 1, size);
+            m_order.resize(size);
+            std::iota(m_order.begin(), m_order.end(), 0);
+            std::nth_element(m_order.begin(), m_order.begin() + numBest - 1, m_order.end(),
+                [this] (const std::size_t index1, const std::size_t index2)
+            {
+                return m_fitness[index1] < m_fitness[index2];
+            });
+            std::uniform_int_distribution<std::size_t> best(0, numBest - 1);
+            // r2 выбирается из объединения популяции и архива
+            std::uniform_int_distribution<std::size_t> pool(0, size + m_archiveSize - 1);
+            std::cauchy_distribution<RealType> cauchy(m_meanScaleFactor, static_cast<RealType>(0.1));
+            for (std::size_t i = 0; i < size; ++i) {
+                const std::size_t r1 = distinct(i, i, i);
+                std::size_t r2;
+                do {
+                    r2 = pool(engine);
+                } while (r2 == i || r2 == r1);
+                m_a[i] = i;
+                m_b[i] = m_order[best(engine)];
+                m_c[i] = i;
+                m_d[i] = r1;
+                m_e[i] = r2;
+                // F ~ Cauchy(μF, 0.1), усечённое сверху единицей; неположительные значения перевыбираются
+                RealType scale;
+                do {
+                    scale = cauchy(engine);
+                } while (scale <= static_cast<RealType>(0));
+                m_scale[i] = std::min(scale, static_cast<RealType>(1));
+            }
+            return;
+        }
+        const std::size_t best = m_strategy == Strategy::Best1Bin ? GetBestIndex() : 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            const std::size_t r1 = distinct(i, i, i);
+            const std::size_t r2 = distinct(i, r1, r1);
+            if (m_strategy == Strategy::Best1Bin) {
+                m_a[i] = best;
+                m_b[i] = r1;
+                m_c[i] = r2;
+            }
+            else {
+                m_a[i] = r1;
+                m_b[i] = r2;
+                m_c[i] = distinct(i, r1, r2);
+            }
+            m_d[i] = i;
+            m_e[i] = i;
+            m_scale[i] = m_scaleFactor;
+        }
+    }
+
+    /**
+     * Построение пробных векторов по выбранным индексам.
+     * Цикл не содержит ветвлений и обращается только к непрерывным массивам,
+     * поэтому компилятор может его векторизовать. Выход за границы
+     * исправляется как в JADE: значение ставится посередине между
+     * границей и родителем
+     *
+     * \return
+     */
+    void BuildTrials()
+    {
+        const std::size_t size = m_population.GetSize();
+        m_trials.resize(size);
+        m_trialFitness.resize(size);
+        const RealType* x = m_values.data();
+        const std::size_t* a = m_a.data();
+        const std::size_t* b = m_b.data();
+        const std::size_t* c = m_c.data();
+        const std::size_t* d = m_d.data();
+        const std::size_t* e = m_e.data();
+        const RealType* scale = m_scale.data();
+        RealType* trials = m_trials.data();
+        const RealType minValue = m_minValue;
+        const RealType maxValue = m_maxValue;
+        const RealType half = static_cast<RealType>(0.5);
+        for (std::size_t i = 0; i < size; ++i) {
+            const RealType trial = x[a[i]] + scale[i] * (x[b[i]] - x[c[i]]) + scale[i] * (x[d[i]] - x[e[i]]);
+            const RealType lower = trial < minValue ? half * (minValue + x[i]) : trial;
+            trials[i] = lower > maxValue ? half * (maxValue + x[i]) : lower;
+        }
+    }
+
+    /**
+     * Отбор: пробный вектор заменяет родителя, если он не хуже.
+     * Для JADE вытесненные родители попадают в архив, а по успешным
+     * значениям F обновляется среднее μF (среднее Лемера)
+     *
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void Select(
+        Engine& engine)
+    {
+        const std::size_t size = m_population.GetSize();
+        const bool adaptive = m_strategy == Strategy::CurrentToPBest1Bin;
+        RealType scaleSum = static_cast<RealType>(0);
+        RealType scaleSquaresSum = static_cast<RealType>(0);
+        std::uniform_int_distribution<std::size_t> archive(0, size - 1);
+        for (std::size_t i = 0; i < size; ++i) {
+            if (m_trialFitness[i] > m_fitness[i]) {
+                continue;
+            }
+            if (adaptive) {
+                if (m_trialFitness[i] < m_fitness[i]) {
+                    scaleSum += m_scale[i];
+                    scaleSquaresSum += m_scale[i] * m_scale[i];
+                }
+                // Архив не больше популяции: при переполнении заменяем случайного
+                const std::size_t slot = m_archiveSize < size ? m_archiveSize++ : archive(engine);
+                m_values[size + slot] = m_values[i];
+            }
+            m_values[i] = m_trials[i];
+            m_fitness[i] = m_trialFitness[i];
+        }
+        if (adaptive && scaleSum > static_cast<RealType>(0)) {
+            m_meanScaleFactor = (1 - m_adaptationRate) * m_meanScaleFactor
+                + m_adaptationRate * scaleSquaresSum / scaleSum;
+        }
+    }
+
+    /**
+     * Запись статистики текущей популяции
+     *
+     * \param generation Номер поколения
+     * \return
+     */
+    void RecordStatistics(
+        const std::size_t generation)
+    {
+        const std::size_t size = m_population.GetSize();
+        statistics_type statistics;
+        statistics.generation = generation;
+        RunningVariance genes;
+        double fitnessSum = 0.0;
+        value_type bestFitness = std::numeric_limits<value_type>::max();
+        for (std::size_t i = 0; i < size; ++i) {
+            bestFitness = std::min(bestFitness, m_fitness[i]);
+            fitnessSum += m_fitness[i];
+            genes.Add(m_values[i]);
+        }
+        if (size > 0) {
+            statistics.bestFitness = bestFitness;
+            statistics.meanFitness = static_cast<value_type>(fitnessSum / size);
+        }
+        statistics.geneMean = genes.GetMean();
+        statistics.geneVariance = genes.GetVariance();
+        // Каждое поколение оцениваются все пробные векторы
+        statistics.numEvaluations = size;
+        m_statistics.push_back(statistics);
+    }
+private:
+    // Популяция (заполняется при инициализации и по окончании запуска)
+    population_type m_population;
+    // Стратегия построения мутантного вектора
+    Strategy m_strategy;
+    // Коэффициент F
+    RealType m_scaleFactor;
+    // Среднее μF (JADE)
+    RealType m_meanScaleFactor;
+    // Доля лучших особей p (JADE)
+    RealType m_greediness;
+    // Скорость адаптации c (JADE)
+    RealType m_adaptationRate;
+    // Границы поиска
+    RealType m_minValue = static_cast<RealType>(0);
+    RealType m_maxValue = static_cast<RealType>(0);
+    // Значения генов: сначала популяция, затем архив вытесненных родителей
+    std::vector<RealType> m_values;
+    // Приспособленность особей популяции
+    std::vector<RealType> m_fitness;
+    // Количество особей в архиве
+    std::size_t m_archiveSize = 0;
+    // Пробные векторы и их приспособленность
+    std::vector<RealType> m_trials;
+    std::vector<RealType> m_trialFitness;
+    // Индексы слагаемых x[a] + F(x[b] - x[c]) + F(x[d] - x[e]) для каждой особи
+    std::vector<std::size_t> m_a;
+    std::vector<std::size_t> m_b;
+    std::vector<std::size_t> m_c;
+    std::vector<std::size_t> m_d;
+    std::vector<std::size_t> m_e;
+    // Коэффициент F для каждой особи
+    std::vector<RealType> m_scale;
+    // Индексы особей для выбора p лучших
+    std::vector<std::size_t> m_order;
+    // Статистика поколений
+    std::vector<statistics_type> m_statistics;
+    // Количество потоков вычисления приспособленности
+    std::size_t m_evaluationThreads = 1;
+};
+
+}
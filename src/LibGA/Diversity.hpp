@@ -0,0 +1,338 @@
+﻿#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <type_traits>
+
+#include "Batch.hpp"
+
+namespace GA
+{
+
+/**
+ * Частоты аллелей целочисленных генов.
+ * Для каждой позиции бита хранится количество особей, у которых этот бит установлен.
+ * По частотам за O(bits) вычисляются среднее попарное расстояние Хэмминга
+ * и энтропия популяции - без перебора O(n²) пар.
+ * Гены добавляются через вертикальные (bit-sliced) счётчики: бит b слова
+ * m_planes[i] - это i-й разряд счётчика позиции b. Добавление гена - это
+ * сложение с переносом сразу по всем позициям, а в массив m_counts
+ * счётчики сбрасываются раз в 255 генов
+ */
+template<
+    typename IntegerType>
+class AlleleFrequencies
+{
+public:
+    // Количество битов гена
+    static constexpr std::size_t num_bits = sizeof(IntegerType) * 8;
+    static_assert(num_bits <= 64, "Gene must fit into 64 bits");
+public:
+    /**
+     * Очистка счётчиков
+     *
+     * \return
+     */
+    void Reset()
+    {
+        m_counts.fill(0);
+        m_planes.fill(0);
+        m_pending = 0;
+        m_size = 0;
+    }
+
+    /**
+     * Добавление гена
+     *
+     * \param gene Закодированный ген
+     * \return
+     */
+    void Add(
+        const IntegerType gene)
+    {
+        std::uint64_t carry = static_cast<std::uint64_t>(gene);
+        for (std::size_t i = 0; i < m_planes.size() && carry != 0; ++i) {
+            const std::uint64_t next = m_planes[i] & carry;
+            m_planes[i] ^= carry;
+            carry = next;
+        }
+        ++m_size;
+        if (++m_pending == max_pending) {
+            Flush();
+        }
+    }
+
+    /**
+     * Добавление генов участка популяции
+     *
+     * \param individuals Участок популяции
+     * \return
+     */
+    template<
+        typename IndividualType>
+    void AddAll(
+        const Span<IndividualType> individuals)
+    {
+        for (const auto& individual : individuals) {
+            Add(individual.GetGene().GetGene());
+        }
+    }
+
+    /**
+     * Учёт инвертирования бита у одной из добавленных особей
+     *
+     * \param bit Позиция бита
+     * \param isSet Значение бита после инвертирования
+     * \return
+     */
+    void FlipBit(
+        const std::size_t bit,
+        const bool isSet)
+    {
+        if (isSet) {
+            ++m_counts[bit];
+        }
+        else {
+            --m_counts[bit];
+        }
+    }
+
+    /**
+     * Объединение со счётчиками другой части популяции
+     *
+     * \param other Частоты аллелей другой части популяции
+     * \return
+     */
+    void Merge(
+        const AlleleFrequencies& other)
+    {
+        Flush();
+        other.Flush();
+        for (std::size_t bit = 0; bit < num_bits; ++bit) {
+            m_counts[bit] += other.m_counts[bit];
+        }
+        m_size += other.m_size;
+    }
+
+    /**
+     * Получение количества добавленных генов
+     *
+     * \return Количество генов
+     */
+    std::size_t GetSize() const
+    {
+        return m_size;
+    }
+
+    /**
+     * Получение количества генов с установленным битом
+     *
+     * \param bit Позиция бита
+     * \return Количество генов
+     */
+    std::size_t GetCount(
+        const std::size_t bit) const
+    {
+        Flush();
+        return m_counts[bit];
+    }
+
+    /**
+     * Среднее попарное расстояние Хэмминга: Σ c(n - c) / (n(n - 1) / 2)
+     *
+     * \return Среднее расстояние в битах
+     */
+    double GetMeanHammingDistance() const
+    {
+        if (m_size < 2) {
+            return 0.0;
+        }
+        Flush();
+        double sum = 0.0;
+        for (const std::size_t count : m_counts) {
+            sum += static_cast<double>(count) * (m_size - count);
+        }
+        return sum / (0.5 * m_size * (m_size - 1));
+    }
+
+    /**
+     * Средняя по позициям энтропия аллелей (от 0 - все гены одинаковы, до 1)
+     *
+     * \return Энтропия в битах на позицию
+     */
+    double GetEntropy() const
+    {
+        if (m_size == 0) {
+            return 0.0;
+        }
+        Flush();
+        double sum = 0.0;
+        for (const std::size_t count : m_counts) {
+            const double p = static_cast<double>(count) / m_size;
+            if (p > 0.0 && p < 1.0) {
+                sum -= p * std::log2(p) + (1.0 - p) * std::log2(1.0 - p);
+            }
+        }
+        return sum / num_bits;
+    }
+private:
+    /**
+     * Перенос вертикальных счётчиков в m_counts
+     *
+     * \return
+     */
+    void Flush() const
+    {
+        if (m_pending == 0) {
+            return;
+        }
+        for (std::size_t bit = 0; bit < num_bits; ++bit) {
+            std::size_t count = 0;
+            for (std::size_t i = 0; i < m_planes.size(); ++i) {
+                count |= static_cast<std::size_t>((m_planes[i] >> bit) & 1) << i;
+            }
+            m_counts[bit] += count;
+        }
+        m_planes.fill(0);
+        m_pending = 0;
+    }
+private:
+    // Количество генов, после которого счётчики переносятся в m_counts
+    static constexpr std::size_t max_pending = 255;
+    // Количество генов с установленным битом для каждой позиции
+    mutable std::array<std::size_t, num_bits> m_counts {};
+    // Вертикальные 8-и битные счётчики
+    mutable std::array<std::uint64_t, 8> m_planes {};
+    // Количество генов в вертикальных счётчиках
+    mutable std::size_t m_pending = 0;
+    // Количество добавленных генов
+    std::size_t m_size = 0;
+};
+
+/**
+ * Потоковое вычисление среднего и дисперсии (алгоритм Уэлфорда).
+ * Значения обрабатываются за один проход без хранения
+ */
+class RunningVariance
+{
+public:
+    /**
+     * Добавление значения
+     *
+     * \param value Значение
+     * \return
+     */
+    void Add(
+        const double value)
+    {
+        ++m_count;
+        const double delta = value - m_mean;
+        m_mean += delta / m_count;
+        m_m2 += delta * (value - m_mean);
+    }
+
+    /**
+     * Объединение с другой выборкой (формула Чана)
+     *
+     * \param other Другая выборка
+     * \return
+     */
+    void Merge(
+        const RunningVariance& other)
+    {
+        if (other.m_count == 0) {
+            return;
+        }
+        const std::size_t count = m_count + other.m_count;
+        const double delta = other.m_mean - m_mean;
+        m_mean += delta * other.m_count / count;
+        m_m2 += other.m_m2 + delta * delta * m_count * other.m_count / count;
+        m_count = count;
+    }
+
+    /**
+     * Получение количества значений
+     *
+     * \return Количество значений
+     */
+    std::size_t GetCount() const
+    {
+        return m_count;
+    }
+    /**
+     * Получение среднего
+     *
+     * \return Среднее
+     */
+    double GetMean() const
+    {
+        return m_mean;
+    }
+    /**
+     * Получение дисперсии (смещённой, по всей популяции)
+     *
+     * \return Дисперсия
+     */
+    double GetVariance() const
+    {
+        return m_count > 0 ? m_m2 / m_count : 0.0;
+    }
+private:
+    // Количество значений
+    std::size_t m_count = 0;
+    // Среднее
+    double m_mean = 0.0;
+    // Сумма квадратов отклонений от среднего
+    double m_m2 = 0.0;
+};
+
+/**
+ * Проверка наличия у скрещивания пакетного метода, учитывающего частоты аллелей
+ */
+template<
+    typename Crossover,
+    typename Engine,
+    typename Frequencies,
+    typename = void>
+struct has_tracked_batch_crossover : std::false_type {};
+
+template<
+    typename Crossover,
+    typename Engine,
+    typename Frequencies>
+struct has_tracked_batch_crossover<
+    Crossover,
+    Engine,
+    Frequencies,
+    std::void_t<decltype(std::declval<const Crossover&>().CrossBatch(
+        std::declval<Span<const typename Crossover::individual_type>>(),
+        std::declval<Span<const std::size_t>>(),
+        std::declval<Span<typename Crossover::individual_type>>(),
+        std::declval<Engine&>(),
+        std::declval<Frequencies&>()))>> : std::true_type {};
+
+/**
+ * Проверка наличия у мутатора пакетного метода, учитывающего частоты аллелей
+ */
+template<
+    typename Mutator,
+    typename Engine,
+    typename Frequencies,
+    typename = void>
+struct has_tracked_batch_mutation : std::false_type {};
+
+template<
+    typename Mutator,
+    typename Engine,
+    typename Frequencies>
+struct has_tracked_batch_mutation<
+    Mutator,
+    Engine,
+    Frequencies,
+    std::void_t<decltype(std::declval<const Mutator&>().MutateBatch(
+        std::declval<Span<typename Mutator::individual_type>>(),
+        std::declval<Engine&>(),
+        std::declval<Frequencies&>()))>> : std::true_type {};
+
+}
@@ -0,0 +1,409 @@
+﻿#pragma once
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#ifdef _DEBUG
+#   include <iostream>
+#endif
+
+#include "Parallel.hpp"
+#include "Statistics.hpp"
+
+namespace GA
+{
+
+/**
+ * Самонастраивающийся планировщик вычисления приспособленности.
+ * При калибровке планировщик измеряет стоимость одного вычисления на первых
+ * изменённых особях (последовательно, по плотному массиву значений и в пуле
+ * потоков, что даёт реальное ускорение S) и накладные расходы D на запуск
+ * цикла в пуле, а затем выбирает способ вычисления, количество потоков
+ * и размер части, минимизируя оценку времени n * c / min(T, S) + D * T / Tmax.
+ * Остальные особи вычисляются выбранным способом.
+ * Калибровка повторяется раз в recalibrationInterval вызовов, а также
+ * сразу, если измеренное время вызова сильно расходится с оценкой
+ */
+template<
+    typename ValueType>
+class ExecutionPlanner
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param maxThreads Наибольшее количество потоков (0 - по числу ядер)
+     * \param recalibrationInterval Количество вызовов между калибровками
+     */
+    explicit ExecutionPlanner(
+        const std::size_t maxThreads = 0,
+        const std::size_t recalibrationInterval = 50) :
+        m_maxThreads(GetNumThreads(maxThreads)),
+        m_recalibrationInterval(std::max<std::size_t>(recalibrationInterval, 1)) {}
+    /**
+     * Конструктор копирования: пул потоков не копируется и создаётся заново при необходимости
+     *
+     * \param other Другой планировщик
+     */
+    ExecutionPlanner(
+        const ExecutionPlanner& other) :
+        m_maxThreads(other.m_maxThreads),
+        m_recalibrationInterval(other.m_recalibrationInterval),
+        m_numCalls(other.m_numCalls),
+        m_recalibrate(other.m_recalibrate),
+        m_serialNs(other.m_serialNs),
+        m_batchNs(other.m_batchNs),
+        m_speedup(other.m_speedup),
+        m_decision(other.m_decision) {}
+    ExecutionPlanner& operator = (
+        const ExecutionPlanner& other)
+    {
+        if (this != &other) {
+            m_maxThreads = other.m_maxThreads;
+            m_recalibrationInterval = other.m_recalibrationInterval;
+            m_numCalls = other.m_numCalls;
+            m_recalibrate = other.m_recalibrate;
+            m_serialNs = other.m_serialNs;
+            m_batchNs = other.m_batchNs;
+            m_speedup = other.m_speedup;
+            m_decision = other.m_decision;
+            m_pool.reset();
+        }
+        return *this;
+    }
+
+    /**
+     * Вычисление приспособленности изменённых особей популяции.
+     * Особи, которые операторы не изменили, сохраняют приспособленность
+     *
+     * \param population Популяция
+     * \param fitnessFn Функция приспособленности (при нескольких потоках должна допускать одновременный вызов)
+     * \return Количество вычислений приспособленности
+     */
+    template<
+        typename PopulationType,
+        typename FitnessFunction>
+    std::size_t Evaluate(
+        PopulationType& population,
+        const FitnessFunction& fitnessFn)
+    {
+        m_changed.clear();
+        for (std::size_t i = 0; i < population.GetSize(); ++i) {
+            if (!population[i].IsEvaluated()) {
+                m_changed.push_back(i);
+            }
+        }
+        const std::size_t size = m_changed.size();
+        if (size == 0) {
+            return 0;
+        }
+        std::size_t done = 0;
+        m_decision.calibrated = m_recalibrate || m_numCalls % m_recalibrationInterval == 0;
+        ++m_numCalls;
+        if (m_decision.calibrated) {
+            done = Calibrate(population, fitnessFn);
+            Plan(size);
+            m_recalibrate = false;
+        }
+        if (done < size) {
+            const auto start = std::chrono::steady_clock::now();
+            Execute(population, fitnessFn, done, size);
+            const double elapsed = std::chrono::duration<double, std::nano>(
+                std::chrono::steady_clock::now() - start).count();
+            // Оценка сильно разошлась с измерением - стоимость функции изменилась
+            const double predicted = Predict(m_decision.strategy, m_decision.numThreads, size - done);
+            m_recalibrate = elapsed > 2.0 * predicted + calibrationNs || 2.0 * elapsed + calibrationNs < predicted;
+        }
+        return size;
+    }
+
+    /**
+     * Получение последнего решения планировщика
+     *
+     * \return Решение планировщика
+     */
+    const ExecutionDecision& GetDecision() const
+    {
+        return m_decision;
+    }
+private:
+    // Наименьшее время измерения при калибровке, нс
+    static constexpr double calibrationNs = 100000.0;
+    // Желаемое время обработки одной части в пуле потоков, нс
+    static constexpr double chunkNs = 20000.0;
+
+    /**
+     * Калибровка: измерение стоимости вычисления на первых изменённых особях
+     * и накладных расходов пула потоков. Особи, на которых шло измерение, оцениваются
+     *
+     * \param population Популяция
+     * \param fitnessFn Функция приспособленности
+     * \return Количество уже оценённых особей из m_changed
+     */
+    template<
+        typename PopulationType,
+        typename FitnessFunction>
+    std::size_t Calibrate(
+        PopulationType& population,
+        const FitnessFunction& fitnessFn)
+    {
+        const std::size_t size = m_changed.size();
+        // Последовательно: части удваиваются, пока измерение не станет достаточно долгим
+        std::size_t done = 0;
+        m_serialNs = Measure(size, done, 1, [&] (const std::size_t first, const std::size_t last)
+        {
+            Execute(population, fitnessFn, ExecutionStrategy::Serial, first, last);
+        });
+        // По плотному массиву - на следующих особях, если они есть
+        if (done < size) {
+            m_batchNs = Measure(size, done, 1, [&] (const std::size_t first, const std::size_t last)
+            {
+                Execute(population, fitnessFn, ExecutionStrategy::Batch, first, last);
+            });
+        }
+        else if (m_batchNs <= 0.0) {
+            m_batchNs = m_serialNs;
+        }
+        // Запуск пустого цикла во всех потоках пула
+        m_decision.dispatchNs = 0.0;
+        if (m_maxThreads > 1) {
+            EnsurePool(m_maxThreads);
+            std::vector<double> times;
+            for (int repeat = 0; repeat < 5; ++repeat) {
+                const auto start = std::chrono::steady_clock::now();
+                m_pool->ParallelFor(0, m_maxThreads, 1, [] (const std::size_t) {});
+                times.push_back(std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start).count());
+            }
+            std::nth_element(times.begin(), times.begin() + times.size() / 2, times.end());
+            m_decision.dispatchNs = times[times.size() / 2];
+            // Ускорение в пуле измеряется на следующих особях: потоков может быть
+            // больше, чем ядер, а функция может ждать внешний ресурс, не занимая ядро
+            if (done < size) {
+                const std::size_t first = done;
+                std::size_t numParts = 0;
+                const double parallelNs = Measure(size, done, m_maxThreads, [&] (const std::size_t begin, const std::size_t end)
+                {
+                    ++numParts;
+                    m_pool->ParallelFor(begin, end, (end - begin + m_maxThreads - 1) / m_maxThreads, [&] (const std::size_t k)
+                    {
+                        population[m_changed[k]].CalculateFitness(fitnessFn);
+                    });
+                });
+                const double count = static_cast<double>(done - first);
+                const double perEvaluationNs = std::max(parallelNs - numParts * m_decision.dispatchNs / count, 1e-3);
+                m_speedup = std::clamp(m_serialNs / perEvaluationNs, 1.0, static_cast<double>(m_maxThreads));
+            }
+        }
+        m_decision.evaluationNs = m_serialNs;
+        m_decision.speedup = m_speedup;
+        return done;
+    }
+
+    /**
+     * Измерение средней стоимости вычисления частями удваивающегося размера
+     *
+     * \param size Количество изменённых особей
+     * \param done Количество уже оценённых особей (увеличивается)
+     * \param firstPart Размер первой части
+     * \param evaluate Вычисление особей [first, last), вызывается как evaluate(first, last)
+     * \return Средняя стоимость одного вычисления, нс
+     */
+    template<
+        typename Function>
+    static double Measure(
+        const std::size_t size,
+        std::size_t& done,
+        const std::size_t firstPart,
+        const Function& evaluate)
+    {
+        double elapsed = 0.0;
+        std::size_t count = 0;
+        for (std::size_t part = firstPart; done < size && elapsed < calibrationNs; part *= 2) {
+            const std::size_t last = std::min(done + part, size);
+            const auto start = std::chrono::steady_clock::now();
+            evaluate(done, last);
+            elapsed += std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            count += last - done;
+            done = last;
+        }
+        return count > 0 ? elapsed / count : 0.0;
+    }
+
+    /**
+     * Выбор способа вычисления, количества потоков и размера части
+     *
+     * \param size Количество вычислений в вызове
+     * \return
+     */
+    void Plan(
+        const std::size_t size)
+    {
+        // Последовательный способ меняем на пакетный, только если он заметно быстрее
+        ExecutionStrategy strategy = m_batchNs < 0.9 * m_serialNs
+            ? ExecutionStrategy::Batch
+            : ExecutionStrategy::Serial;
+        std::size_t numThreads = 1;
+        double best = Predict(strategy, 1, size);
+        for (std::size_t threads = 2; threads <= std::min(m_maxThreads, size); ++threads) {
+            // Потоки должны выигрывать заметно, иначе остаёмся в одном потоке
+            const double predicted = Predict(ExecutionStrategy::Parallel, threads, size);
+            if (predicted < 0.8 * Predict(strategy, 1, size) && predicted < best) {
+                best = predicted;
+                numThreads = threads;
+            }
+        }
+        if (numThreads > 1) {
+            strategy = ExecutionStrategy::Parallel;
+            EnsurePool(numThreads);
+        }
+        m_decision.strategy = strategy;
+        m_decision.numThreads = numThreads;
+        m_decision.chunkSize = numThreads > 1
+            ? std::clamp<std::size_t>(static_cast<std::size_t>(std::ceil(chunkNs / std::max(m_serialNs, 1.0))),
+                1, (size + numThreads - 1) / numThreads)
+            : size;
+#ifdef _DEBUG
+        std::cout << "\tExecution plan: strategy " << static_cast<int>(strategy) << ", threads " << numThreads
+            << ", chunk " << m_decision.chunkSize << ", " << m_serialNs << " ns per evaluation" << std::endl;
+#endif
+    }
+
+    /**
+     * Оценка времени вычисления
+     *
+     * \param strategy Способ вычисления
+     * \param numThreads Количество потоков
+     * \param size Количество вычислений
+     * \return Время, нс
+     */
+    double Predict(
+        const ExecutionStrategy strategy,
+        const std::size_t numThreads,
+        const std::size_t size) const
+    {
+        switch (strategy) {
+        case ExecutionStrategy::Batch:
+            return size * m_batchNs;
+        case ExecutionStrategy::Parallel:
+            return size * m_serialNs / std::min(static_cast<double>(numThreads), m_speedup)
+                + m_decision.dispatchNs * numThreads / std::max<std::size_t>(m_maxThreads, 1);
+        default:
+            return size * m_serialNs;
+        }
+    }
+
+    /**
+     * Создание пула потоков заданного размера, если текущий пул другого размера
+     *
+     * \param numThreads Количество потоков
+     * \return
+     */
+    void EnsurePool(
+        const std::size_t numThreads)
+    {
+        if (!m_pool || m_pool->GetNumThreads() != numThreads) {
+            m_pool.reset();
+            m_pool = std::make_unique<ThreadPool>(numThreads);
+        }
+    }
+
+    /**
+     * Вычисление особей m_changed[first, last) выбранным способом
+     *
+     * \param population Популяция
+     * \param fitnessFn Функция приспособленности
+     * \param first Начало диапазона
+     * \param last Конец диапазона
+     * \return
+     */
+    template<
+        typename PopulationType,
+        typename FitnessFunction>
+    void Execute(
+        PopulationType& population,
+        const FitnessFunction& fitnessFn,
+        const std::size_t first,
+        const std::size_t last)
+    {
+        Execute(population, fitnessFn, m_decision.strategy, first, last);
+    }
+
+    /**
+     * Вычисление особей m_changed[first, last) заданным способом
+     *
+     * \param population Популяция
+     * \param fitnessFn Функция приспособленности
+     * \param strategy Способ вычисления
+     * \param first Начало диапазона
+     * \param last Конец диапазона
+     * \return
+     */
+    template<
+        typename PopulationType,
+        typename FitnessFunction>
+    void Execute(
+        PopulationType& population,
+        const FitnessFunction& fitnessFn,
+        const ExecutionStrategy strategy,
+        const std::size_t first,
+        const std::size_t last)
+    {
+        switch (strategy) {
+        case ExecutionStrategy::Batch:
+            // Значения генов собираются в плотный массив, вычисляются
+            // одним циклом и раскладываются обратно
+            m_values.resize(last - first);
+            for (std::size_t k = first; k < last; ++k) {
+                m_values[k - first] = population[m_changed[k]]();
+            }
+            for (auto& value : m_values) {
+                value = fitnessFn(value);
+            }
+            for (std::size_t k = first; k < last; ++k) {
+                population[m_changed[k]].SetFitness(m_values[k - first]);
+            }
+            break;
+        case ExecutionStrategy::Parallel:
+            // Копия планировщика создаёт свой пул при первом использовании
+            EnsurePool(m_decision.numThreads);
+            m_pool->ParallelFor(first, last, m_decision.chunkSize, [&] (const std::size_t k)
+            {
+                population[m_changed[k]].CalculateFitness(fitnessFn);
+            });
+            break;
+        default:
+            for (std::size_t k = first; k < last; ++k) {
+                population[m_changed[k]].CalculateFitness(fitnessFn);
+            }
+            break;
+        }
+    }
+private:
+    // Наибольшее количество потоков
+    std::size_t m_maxThreads;
+    // Количество вызовов между калибровками
+    std::size_t m_recalibrationInterval;
+    // Количество вызовов с изменёнными особями
+    std::size_t m_numCalls = 0;
+    // Флаг внеочередной калибровки
+    bool m_recalibrate = false;
+    // Стоимость последовательного вычисления, нс
+    double m_serialNs = 0.0;
+    // Стоимость вычисления по плотному массиву, нс
+    double m_batchNs = 0.0;
+    // Измеренное ускорение в пуле из m_maxThreads потоков (до измерения - без ускорения)
+    double m_speedup = 1.0;
+    // Текущее решение
+    ExecutionDecision m_decision;
+    // Пул потоков (создаётся, только если нужен)
+    std::unique_ptr<ThreadPool> m_pool;
+    // Индексы изменённых особей
+    std::vector<std::size_t> m_changed;
+    // Значения генов и приспособленности для пакетного способа
+    std::vector<ValueType> m_values;
+};
+
+}
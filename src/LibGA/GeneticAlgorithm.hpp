@@ -1,5 +1,13 @@
 ﻿#pragma once
 
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include <variant>
+#include <functional>
+#include <type_traits>
 #ifdef _DEBUG
 #   include <iostream>
 #endif
@@ -8,6 +16,19 @@
 #include "Selectors.hpp"
 #include "Crossovers.hpp"
 #include "Mutators.hpp"
+#include "AdaptiveOperators.hpp"
+#include "CompositeOperators.hpp"
+#include "Surrogates.hpp"
+#include "LocalSearch.hpp"
+#include "Parallel.hpp"
+#include "Numa.hpp"
+#include "Niching.hpp"
+#include "Diversity.hpp"
+#include "Statistics.hpp"
+#include "Constraints.hpp"
+#include "MemoryAccounting.hpp"
+#include "Snapshot.hpp"
+#include "ExecutionPlanner.hpp"
 
 namespace GA
 {
@@ -27,8 +48,32 @@ public:
     using gene_type = GeneType;
     // Тип популяции
     using population_type = Population<GeneType>;
+    // Тип особи
+    using individual_type = typename population_type::individual_type;
+    // Тип значения гена
+    using value_type = typename GeneType::value_type;
+    // Тип статистики поколения
+    using statistics_type = GenerationStatistics<value_type>;
     // Тип функции приспособленности
     using fitness_function = typename Population<GeneType>::fitness_function;
+    // Тип функции улучшения оценённой популяции (например, MemeticRefinement),
+    // вызывается как refinement(population, fitnessFunction, generation)
+    // и возвращает количество сделанных вычислений приспособленности
+    using refinement_function = std::function<
+        std::size_t(population_type&, const fitness_function&, const std::size_t)>;
+    // Тип функции нишевания (например, FitnessSharing или Clearing),
+    // изменяет приспособленность оценённой популяции перед отбором
+    using niching_function = std::function<void(population_type&)>;
+    // Тип обработчика ограничений
+    using constraint_handler_type = ConstraintHandler<GeneType>;
+    // Тип снимка состояния запуска
+    using snapshot_type = RunSnapshot<individual_type, statistics_type>;
+private:
+    // Тип частот аллелей - только для генов с целочисленным кодированием
+    using alleles_type = std::conditional_t<
+        GeneType::is_integer,
+        AlleleFrequencies<typename GeneType::gene_type>,
+        std::monostate>;
 public:
     /**
      * Конструктор.
@@ -44,6 +89,7 @@ public:
         const Crossover& crossover,
         const Mutator& mutator) :
         m_population(populationSize),
+        m_offspring(populationSize),
         m_selector(selector),
         m_crossover(crossover),
         m_mutator(mutator) {}
@@ -65,6 +111,240 @@ public:
         m_population.Init(generator, engine);
     }
 
+    /**
+     * Включение гибридного (меметического) режима.
+     * Функция улучшения вызывается в каждом поколении после вычисления
+     * приспособленности и до отбора. Вычисления приспособленности, сделанные
+     * улучшением, входят в статистику поколения. При заданных ограничениях
+     * улучшение получает функцию приспособленности, которая штрафует
+     * недопустимые точки без вызова исходной (ConstraintHandler::Guard).
+     * Чтобы после запуска прочитать статистику улучшения, его можно
+     * передать через std::ref
+     *
+     * \param refinement Функция улучшения популяции (пустая - отключить)
+     * \return
+     */
+    void SetRefinement(
+        const refinement_function& refinement)
+    {
+        m_refinement = refinement;
+    }
+
+    /**
+     * Включение нишевания приспособленности.
+     * Функция вызывается в каждом поколении после записи статистики
+     * и изменяет приспособленность копии популяции, по которой выбираются
+     * родители. Особи популяции, копии родителей и дети сохраняют исходную
+     * приспособленность, поэтому неизменённые особи не оцениваются заново.
+     * Алгоритм выбора без пакетного метода возвращает копии особей без индексов,
+     * поэтому с ним приспособленность выбранных родителей сбрасывается
+     *
+     * \param niching Функция нишевания (пустая - отключить)
+     * \return
+     */
+    void SetNiching(
+        const niching_function& niching)
+    {
+        m_niching = niching;
+    }
+
+    /**
+     * Включение детерминированного вытеснения (DeterministicCrowding).
+     * Дети оцениваются сразу после создания, и каждый ребёнок занимает место
+     * в следующем поколении, только если он не хуже ближайшего к нему родителя
+     * своей пары. Это самостоятельный метод нишевания, поэтому функция
+     * SetNiching в этом режиме не применяется. Потомки создаются последовательно.
+     * Классическому варианту со случайными парами соответствует турнир размера 1.
+     * Режим с суррогатной моделью вытеснение не использует
+     *
+     * \param enabled true - вытеснение включено
+     * \return
+     */
+    void SetDeterministicCrowding(
+        const bool enabled)
+    {
+        m_crowding = enabled;
+    }
+
+    /**
+     * Задание количества потоков для создания потомков.
+     * При значении, отличном от 1, отбор, скрещивание и мутация выполняются
+     * параллельно: слоты потомков делятся на части, и каждый поток со своими
+     * копиями операторов и своим движком случайных чисел обрабатывает свою часть.
+     * Работает только с алгоритмами выбора, имеющими SelectIndices, и без
+     * адаптивных операторов с обратной связью; иначе потомки создаются последовательно
+     *
+     * \param numThreads Количество потоков (0 - по числу ядер, 1 - последовательно)
+     * \return
+     */
+    void SetBreedingThreads(
+        const std::size_t numThreads)
+    {
+        m_breedingThreads = numThreads;
+    }
+
+    /**
+     * Задание количества потоков для вычисления приспособленности.
+     * Функция приспособленности должна допускать вызов из нескольких потоков.
+     * Режим с суррогатной моделью всегда вычисляет приспособленность последовательно
+     *
+     * \param numThreads Количество потоков (0 - по числу ядер, 1 - последовательно)
+     * \return
+     */
+    void SetEvaluationThreads(
+        const std::size_t numThreads)
+    {
+        m_evaluationThreads = numThreads;
+    }
+
+    /**
+     * Задание размещения потоков с учётом NUMA.
+     * Буферы популяции выделяются заново так, что каждую их непрерывную часть
+     * впервые затрагивает (и, значит, размещает на своём узле) поток, который
+     * затем вычисляет приспособленность и создаёт потомков в этой части.
+     * Потоки привязываются к процессорам своих узлов. Количество потоков
+     * вычисления приспособленности и создания потомков становится равным
+     * количеству потоков размещения. На машине с одним узлом потоки
+     * не привязываются, и поведение совпадает с обычным многопоточным режимом.
+     * Вызывать до Init, чтобы популяция не копировалась
+     *
+     * \param placement Размещение потоков
+     * \return
+     */
+    void SetPlacement(
+        const ThreadPlacement& placement)
+    {
+        m_placement = std::make_shared<const ThreadPlacement>(placement);
+        m_population.Place(m_placement);
+        m_offspring.Place(m_placement);
+        m_breedingThreads = placement.GetNumThreads();
+        m_evaluationThreads = placement.GetNumThreads();
+    }
+
+    /**
+     * Задание ограничений задачи.
+     * Перед вычислением приспособленности все особи проверяются на допустимость
+     * (и при необходимости исправляются), функция приспособленности вызывается
+     * только для допустимых. Количество сэкономленных вычислений и исправлений
+     * записывается в статистику поколения. Со смертельным штрафом средняя
+     * приспособленность в статистике бесконечна, пока в популяции есть
+     * недопустимые особи. Допустимые особи вычисляются тем же способом,
+     * что и без ограничений: с размещением потоков, планировщиком или пулом
+     *
+     * \param constraints Обработчик ограничений (пустой - отключить)
+     * \return
+     */
+    void SetConstraints(
+        const constraint_handler_type& constraints)
+    {
+        m_constraints = constraints;
+    }
+
+    /**
+     * Включение самонастраивающегося планировщика вычисления приспособленности.
+     * Планировщик сам выбирает последовательное вычисление, вычисление по плотному
+     * массиву значений генов или пул потоков, а также количество потоков и размер
+     * части, калибруясь по измеренной стоимости функции приспособленности
+     * в первом поколении и периодически после него. Решения записываются
+     * в статистику поколения (GenerationStatistics::execution). Заменяет
+     * SetEvaluationThreads; при размещении потоков не применяется, и решения
+     * не записываются. Функция приспособленности должна допускать вызов
+     * из нескольких потоков, если maxThreads больше 1
+     *
+     * \param enabled true - планирование включено
+     * \param maxThreads Наибольшее количество потоков (0 - по числу ядер)
+     * \param recalibrationInterval Количество поколений между калибровками
+     * \return
+     */
+    void SetExecutionPlanning(
+        const bool enabled,
+        const std::size_t maxThreads = 0,
+        const std::size_t recalibrationInterval = 50)
+    {
+        m_planning = enabled;
+        m_planner = ExecutionPlanner<value_type>(maxThreads, recalibrationInterval);
+    }
+
+    /**
+     * Задание токена отмены.
+     * Run проверяет токен один раз за поколение, после оценки популяции,
+     * и при отмене сразу возвращает лучшую особь оценённой популяции
+     *
+     * \param cancellation Токен отмены
+     * \return
+     */
+    void SetCancellation(
+        const CancellationToken& cancellation)
+    {
+        m_cancellation = cancellation;
+    }
+
+    /**
+     * Получение снимка состояния запуска: лучшей особи с начала запуска,
+     * статистики последнего поколения и количества вычислений.
+     * Можно вызывать из любого потока во время работы Run: алгоритм
+     * публикует снимок после каждого поколения без блокировок
+     *
+     * \return Снимок состояния запуска
+     */
+    snapshot_type GetSnapshot() const
+    {
+        return m_snapshot.Read();
+    }
+
+    /**
+     * Включение учёта памяти по поколениям.
+     * Для каждого поколения в статистику (GenerationStatistics::memory)
+     * записываются выделения этапов вычисления приспособленности, создания
+     * потомков и записи статистики, использование арены поколения и размер
+     * буферов популяций. Выделения видны, только если в программе установлен
+     * счётчик GA_COUNT_GLOBAL_ALLOCATIONS; измерения используют общий счётчик,
+     * поэтому несколько алгоритмов, работающих одновременно, мешают друг другу
+     *
+     * \param enabled true - учёт включён
+     * \return
+     */
+    void SetMemoryAccounting(
+        const bool enabled)
+    {
+        m_memoryAccounting = enabled;
+    }
+
+    /**
+     * Получение ресурса памяти текущего поколения.
+     * Подходит для временных данных функций улучшения и нишевания:
+     * память освобождается целиком за O(1) в начале каждого поколения,
+     * поэтому объекты в ней не должны переживать поколение
+     *
+     * \return Ресурс памяти арены поколения
+     */
+    std::pmr::memory_resource* GetGenerationResource()
+    {
+        return m_arena.GetResource();
+    }
+
+    /**
+     * Получение текущей популяции
+     *
+     * \return Константная ссылка на популяцию
+     */
+    const population_type& GetPopulation() const
+    {
+        return m_population;
+    }
+
+    /**
+     * Получение статистики последнего запуска по поколениям.
+     * Запись с номером поколения i описывает оценённую популяцию перед отбором
+     * i-го поколения, последняя запись - итоговую популяцию
+     *
+     * \return Статистика поколений
+     */
+    const std::vector<statistics_type>& GetStatistics() const
+    {
+        return m_statistics;
+    }
+
     /**
      * Запуск генетического алгоритма
      *
@@ -80,50 +360,781 @@ public:
         const fitness_function& fitnessFunction,
         Engine& engine)
     {
+        // Создаём временную популяцию родителей. Копии выбранных родителей нужны
+        // адаптивным операторам для сравнения детей с родителями после оценки потомков
+        // и алгоритмам выбора без пакетного метода. Иначе популяция остаётся пустой
+        population_type parents(RequiresParentCopies<Engine>() ? m_population.GetSize() : 0);
+        m_statistics.clear();
+        m_statistics.reserve(numGenerations + 1);
+        m_allelesValid = false;
+        // Функция приспособленности могла измениться с прошлого запуска
+        m_population.Invalidate();
+        m_numEvaluations = 0;
+        m_numSkippedEvaluations = 0;
+        m_numRejectedEvaluations = 0;
+        m_numRepairs = 0;
+        BeginRun();
         // Запускаем цикл по поколениям
         for (std::size_t i = 0; i < numGenerations; ++i) {
 #ifdef _DEBUG
             std::cout << "Generation " << i << std::endl;
 #endif
-            // Вычисляем приспособленность популяции
-            m_population.CalculateFitness(fitnessFunction);
-            // Создаём временную популяцию родителей. В неё будут помещены копии выбранных родителей
-            population_type parents(m_population.GetSize());
-            // Проходим по всей текущей популяции (в ней сейчас все родители)
-            for (std::size_t j = 0; j < m_population.GetSize(); ++j) {
-                // Выбираем родителя
-                parents[j] = m_selector.Select(m_population, engine);
-            }
-            // Проходим по всей текущей популяции
-            for (std::size_t j = 0; j < m_population.GetSize(); j += 2) {
-                // Скрещиваем двух соседних родителей (среди выбранных) и получаем двух детей
-                auto [child1, child2] = m_crossover(parents[j], parents[j + 1], engine);
-                // Заменяем родителей детьми
-                m_population[j] = child1;
-                m_population[j + 1] = child2;
-            }
-            // Теперь популяция состоит из детей. Добавляем мутацию к детям
-            m_population.Mutate(m_mutator, engine);
+            BeginGeneration();
+            {
+                MemoryPhase phase(m_memory.evaluation, m_memoryAccounting);
+                // Вычисляем приспособленность популяции.
+                // При вытеснении популяция уже оценена в предыдущем поколении
+                if (!m_crowding || i == 0) {
+                    CalculateFitness(m_population, fitnessFunction);
+                }
+                // Сообщаем адаптивным операторам результат предыдущего поколения
+                if (i > 0) {
+                    Feedback(parents, m_population);
+                }
+                // Улучшаем лучших особей локальным поиском
+                Refine(fitnessFunction, i);
+            }
+            {
+                MemoryPhase phase(m_memory.bookkeeping, m_memoryAccounting);
+                RecordStatistics(i);
+            }
+            // Популяция оценена: при отмене останавливаемся, не создавая потомков
+            if (m_cancellation.IsCancelled()) {
+                EndGeneration(parents, m_offspring.GetSize());
+                return FinishRun(true);
+            }
+            {
+                MemoryPhase phase(m_memory.bookkeeping, m_memoryAccounting);
+                Niche();
+            }
+            {
+                MemoryPhase phase(m_memory.breeding, m_memoryAccounting);
+                // Выбираем родителей, скрещиваем их и мутируем детей.
+                // Дети записываются во второй буфер, который затем становится текущей популяцией
+                Breed(parents, m_offspring, engine);
+                if (m_crowding) {
+                    CalculateFitness(m_offspring, fitnessFunction);
+                    Crowd<Engine>(parents);
+                }
+            }
+            EndGeneration(parents, m_offspring.GetSize());
+            m_population.Swap(m_offspring);
+            // Частоты аллелей были собраны при создании детей,
+            // но при вытеснении часть детей заменена родителями
+            m_allelesValid = !m_crowding;
             // Получили поколение детей. Идём на следующую итерацию
 #ifdef _DEBUG
             std::cout << std::endl;
 #endif
         }
-        // Вычисляем приспособленность популяции
-        m_population.CalculateFitness(fitnessFunction);
+        BeginGeneration();
+        {
+            MemoryPhase phase(m_memory.evaluation, m_memoryAccounting);
+            // Вычисляем приспособленность популяции
+            if (!m_crowding || numGenerations == 0) {
+                CalculateFitness(m_population, fitnessFunction);
+            }
+            if (numGenerations > 0) {
+                Feedback(parents, m_population);
+            }
+            Refine(fitnessFunction, numGenerations);
+        }
+        {
+            MemoryPhase phase(m_memory.bookkeeping, m_memoryAccounting);
+            RecordStatistics(numGenerations);
+        }
+        EndGeneration(parents, m_offspring.GetSize());
         // Выбираем наиболее приспособленную особь
         // и возвращаем значение её функции приспособленности
-        return m_population.GetBestIndividual().GetFitness();
+        return FinishRun(false);
+    }
+
+    /**
+     * Запуск генетического алгоритма с отсевом потомков суррогатной моделью.
+     * В каждом поколении создаётся в screening.GetCandidatesFactor() раз больше
+     * кандидатов, чем особей в популяции. Кандидаты ранжируются по предсказанию
+     * модели, и точно вычисляется приспособленность только лучших из них.
+     * Каждое точное вычисление дообучает модель
+     *
+     * \param numGenerations Количество поколений
+     * \param fitnessFunction Функция приспособленности
+     * \param screening Отсев суррогатной моделью
+     * \param engine Движок генерации случайных чисел
+     * \return Решение (значение функции приспособленности наиболее приспособленной особи)
+     */
+    template<
+        typename Model,
+        typename Engine>
+    typename GeneType::value_type Run(
+        const std::size_t numGenerations,
+        const fitness_function& fitnessFunction,
+        SurrogateScreening<Model>& screening,
+        Engine& engine)
+    {
+        // Точное вычисление, дообучающее модель
+        const fitness_function trueFitness = [&] (const value_type input)
+        {
+            const value_type fitness = fitnessFunction(input);
+            screening.Train(input, fitness);
+            return fitness;
+        };
+        // Предсказание модели
+        const fitness_function surrogateFitness = [&] (const value_type input)
+        {
+            return screening.Predict(input);
+        };
+        const std::size_t populationSize = m_population.GetSize();
+        const std::size_t numCandidates = populationSize * std::max<std::size_t>(screening.GetCandidatesFactor(), 1);
+        population_type parents(RequiresParentCopies<Engine>() ? numCandidates : 0);
+        population_type candidates(numCandidates);
+        m_statistics.clear();
+        m_statistics.reserve(numGenerations + 1);
+        m_allelesValid = false;
+        m_numEvaluations = 0;
+        m_numSkippedEvaluations = 0;
+        m_numRejectedEvaluations = 0;
+        m_numRepairs = 0;
+        BeginRun();
+        BeginGeneration();
+        {
+            MemoryPhase phase(m_memory.evaluation, m_memoryAccounting);
+            CalculateAllFitness(m_population, trueFitness);
+            Refine(trueFitness, 0);
+        }
+        {
+            MemoryPhase phase(m_memory.bookkeeping, m_memoryAccounting);
+            RecordStatistics(0);
+        }
+        EndGeneration(parents, candidates.GetSize());
+        for (std::size_t i = 0; i < numGenerations; ++i) {
+#ifdef _DEBUG
+            std::cout << "Generation " << i << std::endl;
+#endif
+            // Популяция оценена: при отмене останавливаемся, не создавая потомков
+            if (m_cancellation.IsCancelled()) {
+                return FinishRun(true);
+            }
+            BeginGeneration();
+            {
+                MemoryPhase phase(m_memory.breeding, m_memoryAccounting);
+                Niche();
+                Breed(parents, candidates, engine);
+            }
+            {
+                MemoryPhase phase(m_memory.evaluation, m_memoryAccounting);
+                if (screening.IsReady()) {
+                    // Ранжируем кандидатов по предсказанию модели.
+                    // Обратная связь операторам в этом случае строится по предсказаниям
+                    candidates.CalculateFitness(surrogateFitness);
+                    Feedback(parents, candidates);
+                    candidates.PartialSortByFitness(populationSize);
+                    for (std::size_t j = 0; j < populationSize; ++j) {
+                        m_population[j] = candidates[j];
+                    }
+                    CalculateAllFitness(m_population, trueFitness);
+                }
+                else {
+                    // Модель ещё не обучена - берём первых кандидатов без отсева
+                    for (std::size_t j = 0; j < populationSize; ++j) {
+                        m_population[j] = candidates[j];
+                    }
+                    CalculateAllFitness(m_population, trueFitness);
+                    Feedback(parents, m_population);
+                }
+                // Частоты аллелей собраны по кандидатам, а не по отобранным особям
+                m_allelesValid = false;
+                Refine(trueFitness, i + 1);
+            }
+            {
+                MemoryPhase phase(m_memory.bookkeeping, m_memoryAccounting);
+                RecordStatistics(i + 1);
+            }
+            EndGeneration(parents, candidates.GetSize());
+#ifdef _DEBUG
+            std::cout << std::endl;
+#endif
+        }
+        return FinishRun(false);
+    }
+private:
+    /**
+     * Параллельное вычисление приспособленности изменённых особей популяции
+     * с учётом размещения потоков, если оно задано. Особи, которые операторы
+     * не изменили, сохраняют приспособленность родителя
+     *
+     * \param population Популяция
+     * \param fitnessFunction Функция приспособленности
+     * \return
+     */
+    void CalculateFitness(
+        population_type& population,
+        const fitness_function& fitnessFunction)
+    {
+        // Вычисление неоценённых особей выбранным способом
+        const auto evaluate = [&] (population_type& changed)
+        {
+            return m_placement
+                ? changed.CalculateChangedFitness(fitnessFunction, *m_placement)
+                : m_planning
+                    ? m_planner.Evaluate(changed, fitnessFunction)
+                    : changed.CalculateChangedFitness(fitnessFunction, m_evaluationThreads);
+        };
+        if (m_constraints.IsEnabled()) {
+            AddConstraintCounts(m_constraints.Evaluate(population, evaluate));
+            return;
+        }
+        const std::size_t evaluations = evaluate(population);
+        m_numEvaluations += evaluations;
+        m_numSkippedEvaluations += population.GetSize() - evaluations;
+    }
+
+    /**
+     * Последовательное вычисление приспособленности всех особей популяции
+     * (режим с суррогатной моделью) с учётом ограничений, если они заданы
+     *
+     * \param population Популяция
+     * \param fitnessFunction Функция приспособленности
+     * \return
+     */
+    void CalculateAllFitness(
+        population_type& population,
+        const fitness_function& fitnessFunction)
+    {
+        if (m_constraints.IsEnabled()) {
+            population.Invalidate();
+            AddConstraintCounts(m_constraints.Evaluate(population, fitnessFunction, 1));
+            return;
+        }
+        population.CalculateFitness(fitnessFunction);
+        m_numEvaluations += population.GetSize();
+    }
+
+    /**
+     * Учёт результата вычисления приспособленности с проверкой ограничений
+     *
+     * \param counts Количество вычислений, пропусков и отсеянных особей
+     * \return
+     */
+    void AddConstraintCounts(
+        const ConstraintCounts& counts)
+    {
+        m_numEvaluations += counts.numEvaluations;
+        m_numSkippedEvaluations += counts.numUnchanged;
+        m_numRejectedEvaluations += counts.numRejected;
+        m_numRepairs += counts.numRepaired;
+        // Исправление изменяет гены на месте
+        if (counts.numRepaired > 0) {
+            m_allelesValid = false;
+        }
+    }
+
+    /**
+     * Нишевание приспособленности оценённой популяции перед отбором
+     *
+     * \return
+     */
+    void Niche()
+    {
+        if (m_niching && !m_crowding) {
+            m_selectionPopulation = m_population;
+            m_niching(m_selectionPopulation);
+        }
+    }
+
+    /**
+     * Получение популяции, по которой выбираются родители
+     *
+     * \return Копия популяции с нишевой приспособленностью или сама популяция
+     */
+    const population_type& GetSelectionPopulation() const
+    {
+        return m_niching && !m_crowding ? m_selectionPopulation : m_population;
+    }
+
+    /**
+     * Детерминированное вытеснение: оценённые дети из m_offspring
+     * соревнуются со своими родителями
+     *
+     * \param parents Популяция копий выбранных родителей (если они нужны)
+     * \return
+     */
+    template<
+        typename Engine>
+    void Crowd(
+        const population_type& parents)
+    {
+        // При пакетном отборе индексы родителей указывают в текущую популяцию,
+        // иначе - в популяцию копий
+        const population_type& source =
+            has_batch_selection_v<Selector, population_type, Engine> ? m_population : parents;
+        DeterministicCrowding<individual_type>(source.GetSpan(),
+            Span<const std::size_t>(m_parentIndices), m_offspring.GetSpan());
+    }
+
+    /**
+     * Проверка, нужны ли копии выбранных родителей
+     *
+     * \return true, если есть адаптивные операторы или алгоритм выбора без пакетного метода
+     */
+    template<
+        typename Engine>
+    static constexpr bool RequiresParentCopies()
+    {
+        return has_feedback_v<Crossover, population_type>
+            || has_feedback_v<Mutator, population_type>
+            || !has_batch_selection_v<Selector, population_type, Engine>;
+    }
+
+    /**
+     * Создание поколения потомков: отбор родителей из текущей популяции,
+     * скрещивание соседних родителей и мутация детей.
+     * Скрещивание и мутация выполняются пакетно, дети записываются
+     * прямо в буфер offspring
+     *
+     * \param parents Популяция для копий выбранных родителей (если они нужны)
+     * \param offspring Популяция, в которую помещаются дети
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void Breed(
+        population_type& parents,
+        population_type& offspring,
+        Engine& engine)
+    {
+        if constexpr (!RequiresParentCopies<Engine>()) {
+            if (m_breedingThreads != 1 && !m_crowding) {
+                BreedParallel(offspring, engine);
+                return;
+            }
+        }
+        m_parentIndices.resize(offspring.GetSize());
+        // Особи, из которых скрещивание берёт родителей по индексам
+        const population_type* source = &m_population;
+        if constexpr (has_batch_selection_v<Selector, population_type, Engine>) {
+            // Выбираем сразу все индексы родителей
+            m_selector.SelectIndices(GetSelectionPopulation(), m_parentIndices, engine);
+            if constexpr (RequiresParentCopies<Engine>()) {
+                for (std::size_t j = 0; j < parents.GetSize(); ++j) {
+                    parents[j] = m_population[m_parentIndices[j]];
+                }
+            }
+        }
+        else {
+            // Проходим по всей популяции родителей
+            for (std::size_t j = 0; j < parents.GetSize(); ++j) {
+                // Выбираем родителя
+                parents[j] = m_selector.Select(GetSelectionPopulation(), engine);
+                m_parentIndices[j] = j;
+                // Исходная приспособленность копии неизвестна
+                if (m_niching && !m_crowding) {
+                    parents[j].Invalidate();
+                }
+            }
+            source = &parents;
+        }
+        // Скрещиваем соседних родителей, дети сразу попадают в offspring,
+        // и добавляем мутацию к детям
+        ResetAlleles(m_alleles);
+        CrossAndMutate(m_crossover, m_mutator, source->GetSpan(),
+            Span<const std::size_t>(m_parentIndices), offspring.GetSpan(), engine, m_alleles);
+    }
+
+    /**
+     * Скрещивание и мутация участка потомков.
+     * Для целочисленных генов заодно собираются частоты аллелей детей:
+     * если операторы умеют обновлять их сами - по ходу работы,
+     * иначе - одним проходом после мутации
+     *
+     * \param crossover Алгоритм скрещивания
+     * \param mutator Алгоритм мутации
+     * \param parents Особи, из которых выбираются родители
+     * \param parentIndices Индексы родителей
+     * \param children Участок популяции для детей
+     * \param engine Движок генерации случайных чисел
+     * \param alleles Частоты аллелей детей
+     * \return
+     */
+    template<
+        typename Engine>
+    static void CrossAndMutate(
+        const Crossover& crossover,
+        const Mutator& mutator,
+        const Span<const individual_type> parents,
+        const Span<const std::size_t> parentIndices,
+        const Span<individual_type> children,
+        Engine& engine,
+        alleles_type& alleles)
+    {
+        if constexpr (has_tracked_batch_crossover<Crossover, Engine, alleles_type>::value
+            && has_tracked_batch_mutation<Mutator, Engine, alleles_type>::value) {
+            crossover.CrossBatch(parents, parentIndices, children, engine, alleles);
+            mutator.MutateBatch(children, engine, alleles);
+        }
+        else {
+            CrossoverBatch(crossover, parents, parentIndices, children, engine);
+            MutateBatch(mutator, children, engine);
+            if constexpr (GeneType::is_integer) {
+                alleles.AddAll(children);
+            }
+        }
+    }
+
+    /**
+     * Очистка частот аллелей (только для целочисленных генов)
+     *
+     * \param alleles Частоты аллелей
+     * \return
+     */
+    static void ResetAlleles(
+        alleles_type& alleles)
+    {
+        if constexpr (GeneType::is_integer) {
+            alleles.Reset();
+        }
+    }
+
+    /**
+     * Параллельное создание поколения потомков.
+     * Слоты потомков делятся на непрерывные части чётного размера.
+     * Каждый поток выполняет отбор, скрещивание и мутацию своей части
+     * за один проход, используя собственные копии операторов (их изменяемые
+     * распределения не разделяются между потоками) и собственный движок,
+     * засеянный из основного движка
+     *
+     * \param offspring Популяция, в которую помещаются дети
+     * \param engine Основной движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void BreedParallel(
+        population_type& offspring,
+        Engine& engine)
+    {
+        const std::size_t numPairs = offspring.GetSize() / 2;
+        const std::size_t numWorkers = std::max<std::size_t>(
+            std::min(GetNumThreads(m_breedingThreads), numPairs), 1);
+        const std::size_t chunkSize = ((numPairs + numWorkers - 1) / numWorkers) * 2;
+        // Состояние потоков создаётся один раз и переиспользуется между поколениями
+        while (m_workers.size() < numWorkers) {
+            m_workers.push_back({ m_selector, m_crossover, m_mutator, {}, {} });
+        }
+        // Движки потоков засеиваем последовательно из основного движка,
+        // поэтому результат воспроизводим при заданном количестве потоков
+        // Вектор движков живёт в арене поколения и не обращается к куче
+        std::pmr::vector<Engine> engines(m_arena.GetResource());
+        engines.reserve(numWorkers);
+        for (std::size_t w = 0; w < numWorkers; ++w) {
+            std::seed_seq seeds { engine(), engine(), engine(), engine() };
+            engines.emplace_back(seeds);
+        }
+        const auto breed = [&] (const std::size_t w)
+        {
+            const std::size_t begin = w * chunkSize;
+            if (begin >= offspring.GetSize()) {
+                return;
+            }
+            const std::size_t count = std::min(chunkSize, offspring.GetSize() - begin);
+            auto& worker = m_workers[w];
+            const auto children = offspring.GetSpan().SubSpan(begin, count);
+            worker.parentIndices.resize(count);
+            worker.selector.SelectIndices(GetSelectionPopulation(), worker.parentIndices, engines[w]);
+            ResetAlleles(worker.alleles);
+            CrossAndMutate(worker.crossover, worker.mutator, m_population.GetSpan(),
+                Span<const std::size_t>(worker.parentIndices), children, engines[w], worker.alleles);
+        };
+        // Часть w обрабатывается потоком w размещения - тем, на чьём узле она лежит
+        if (m_placement) {
+            ParallelFor(0, numWorkers, *m_placement, breed);
+        }
+        else {
+            ParallelFor(0, numWorkers, numWorkers, breed);
+        }
+        // Объединяем частоты аллелей частей
+        if constexpr (GeneType::is_integer) {
+            m_alleles.Reset();
+            for (std::size_t w = 0; w < numWorkers; ++w) {
+                m_alleles.Merge(m_workers[w].alleles);
+            }
+        }
+    }
+
+    /**
+     * Улучшение оценённой популяции, если включён гибридный режим
+     *
+     * \param fitnessFunction Функция приспособленности
+     * \param generation Номер поколения
+     * \return
+     */
+    void Refine(
+        const fitness_function& fitnessFunction,
+        const std::size_t generation)
+    {
+        if (m_refinement) {
+            if (m_constraints.IsEnabled()) {
+                // Локальный поиск не тратит вычисления на недопустимые точки
+                std::atomic<std::size_t> rejected(0);
+                const std::size_t evaluations = m_refinement(m_population,
+                    m_constraints.Guard(fitnessFunction, rejected), generation);
+                m_numEvaluations += evaluations - rejected;
+                m_numRejectedEvaluations += rejected;
+            }
+            else {
+                m_numEvaluations += m_refinement(m_population, fitnessFunction, generation);
+            }
+            // Локальный поиск мог изменить гены
+            m_allelesValid = false;
+        }
+    }
+
+    /**
+     * Начало поколения: освобождение арены и сброс учёта памяти
+     *
+     * \return
+     */
+    void BeginGeneration()
+    {
+        m_arena.Reset();
+        m_memory = {};
+    }
+
+    /**
+     * Конец поколения: запись памяти поколения в его статистику
+     * и публикация снимка состояния
+     *
+     * \param parents Копии родителей
+     * \param numOffspring Размер буфера потомков
+     * \return
+     */
+    void EndGeneration(
+        const population_type& parents,
+        const std::size_t numOffspring)
+    {
+        if (m_memoryAccounting && !m_statistics.empty()) {
+            m_memory.arenaBytes = m_arena.GetUsedBytes();
+            m_memory.arenaUpstreamBytes = m_arena.GetUpstreamBytes();
+            m_memory.populationBytes = (m_population.GetSize() + numOffspring + parents.GetSize()
+                + m_selectionPopulation.GetSize()) * sizeof(individual_type);
+            m_statistics.back().memory = m_memory;
+        }
+        PublishSnapshot();
+    }
+
+    /**
+     * Начало запуска: сброс лучшей особи и публикация пустого снимка
+     *
+     * \return
+     */
+    void BeginRun()
+    {
+        m_state = snapshot_type();
+        m_state.running = true;
+        m_constraints.Reset();
+        m_snapshot.Write(m_state);
+    }
+
+    /**
+     * Конец запуска: публикация итогового снимка
+     *
+     * \param cancelled true - запуск остановлен токеном отмены
+     * \return Значение функции приспособленности наиболее приспособленной допустимой
+     * особи популяции (бесконечность, если допустимых особей нет)
+     */
+    value_type FinishRun(
+        const bool cancelled)
+    {
+        m_state.running = false;
+        m_state.cancelled = cancelled;
+        PublishSnapshot();
+        if (!m_constraints.IsEnabled()) {
+            return m_population.GetBestIndividual().GetFitness();
+        }
+        value_type bestFitness = std::numeric_limits<value_type>::infinity();
+        for (std::size_t i = 0; i < m_population.GetSize(); ++i) {
+            const auto& individual = m_population[i];
+            if (individual.GetFitness() < bestFitness && m_constraints.IsFeasible(individual())) {
+                bestFitness = individual.GetFitness();
+            }
+        }
+        return bestFitness;
+    }
+
+    /**
+     * Публикация снимка состояния для читателей из других потоков
+     *
+     * \return
+     */
+    void PublishSnapshot()
+    {
+        if (!m_statistics.empty()) {
+            m_state.statistics = m_statistics.back();
+        }
+        m_snapshot.Write(m_state);
+    }
+
+    /**
+     * Запись статистики оценённой популяции.
+     * Приспособленность и значения генов обрабатываются за один проход,
+     * разнообразие целочисленных генов берётся из частот аллелей
+     *
+     * \param generation Номер поколения
+     * \return
+     */
+    void RecordStatistics(
+        const std::size_t generation)
+    {
+        statistics_type statistics;
+        statistics.generation = generation;
+        RunningVariance genes;
+        double fitnessSum = 0.0;
+        value_type bestFitness = std::numeric_limits<value_type>::max();
+        // Лучшая допустимая особь поколения (недопустимая не может стать лучшей особью запуска)
+        value_type bestFeasibleFitness = std::numeric_limits<value_type>::max();
+        std::size_t bestFeasibleIndex = m_population.GetSize();
+        for (std::size_t i = 0; i < m_population.GetSize(); ++i) {
+            const auto& individual = m_population[i];
+            if (individual.GetFitness() < bestFitness) {
+                bestFitness = individual.GetFitness();
+            }
+            if (individual.GetFitness() < bestFeasibleFitness && m_constraints.IsFeasible(individual())) {
+                bestFeasibleFitness = individual.GetFitness();
+                bestFeasibleIndex = i;
+            }
+            fitnessSum += individual.GetFitness();
+            genes.Add(individual());
+        }
+        if (m_population.GetSize() > 0) {
+            statistics.bestFitness = bestFitness;
+            statistics.meanFitness = static_cast<value_type>(fitnessSum / m_population.GetSize());
+        }
+        // Лучшая особь с начала запуска (нишевание ещё не изменило приспособленность)
+        if (bestFeasibleIndex < m_population.GetSize()
+            && (!m_state.best.IsEvaluated() || bestFeasibleFitness < m_state.best.GetFitness())) {
+            m_state.best = m_population[bestFeasibleIndex];
+            m_state.bestGeneration = generation;
+        }
+        m_state.totalEvaluations += m_numEvaluations;
+        statistics.geneMean = genes.GetMean();
+        statistics.geneVariance = genes.GetVariance();
+        statistics.numEvaluations = m_numEvaluations;
+        statistics.numSkippedEvaluations = m_numSkippedEvaluations;
+        statistics.numRejectedEvaluations = m_numRejectedEvaluations;
+        statistics.numRepairs = m_numRepairs;
+        // Решение планировщика записывается, только если он применялся
+        if (m_planning && !m_placement) {
+            statistics.execution = m_planner.GetDecision();
+        }
+        m_numEvaluations = 0;
+        m_numSkippedEvaluations = 0;
+        m_numRejectedEvaluations = 0;
+        m_numRepairs = 0;
+        if constexpr (GeneType::is_integer) {
+            if (!m_allelesValid) {
+                m_alleles.Reset();
+                m_alleles.AddAll(m_population.GetSpan());
+                m_allelesValid = true;
+            }
+            statistics.meanHammingDistance = m_alleles.GetMeanHammingDistance();
+            statistics.alleleEntropy = m_alleles.GetEntropy();
+        }
+        m_statistics.push_back(statistics);
+    }
+
+    /**
+     * Передача обратной связи адаптивным операторам.
+     * Потомки offspring[i] сравниваются с родителями parents[i]
+     *
+     * \param parents Популяция выбранных родителей
+     * \param offspring Оценённая популяция потомков
+     * \return
+     */
+    void Feedback(
+        const population_type& parents,
+        const population_type& offspring)
+    {
+        ApplyFeedback(m_crossover, parents, offspring);
+        ApplyFeedback(m_mutator, parents, offspring);
     }
 private:
     // Популяция
     population_type m_population;
+    // Буфер для следующего поколения
+    population_type m_offspring;
+    // Копия популяции с нишевой приспособленностью для отбора родителей
+    population_type m_selectionPopulation { 0 };
     // Алгоритм выбора
     Selector m_selector;
     // Алгоритм скрещивания
     Crossover m_crossover;
     // Алгоритм мутации
     Mutator m_mutator;
+    // Функция улучшения популяции
+    refinement_function m_refinement;
+    // Частоты аллелей текущей популяции (только для целочисленных генов)
+    alleles_type m_alleles;
+    // Флаг, говорящий о том, что частоты аллелей соответствуют текущей популяции
+    bool m_allelesValid = false;
+    // Статистика поколений
+    std::vector<statistics_type> m_statistics;
+    // Количество вычислений приспособленности с прошлой записи статистики
+    std::size_t m_numEvaluations = 0;
+    // Количество пропущенных вычислений неизменённых особей с прошлой записи статистики
+    std::size_t m_numSkippedEvaluations = 0;
+    // Количество вычислений, сэкономленных отсевом недопустимых особей, с прошлой записи статистики
+    std::size_t m_numRejectedEvaluations = 0;
+    // Количество исправленных недопустимых особей с прошлой записи статистики
+    std::size_t m_numRepairs = 0;
+    // Обработчик ограничений
+    constraint_handler_type m_constraints;
+    // Индексы выбранных родителей (буфер пакетного отбора)
+    std::vector<std::size_t> m_parentIndices;
+
+    /**
+     * Состояние потока параллельного создания потомков
+     */
+    struct BreedingWorker
+    {
+        // Копия алгоритма выбора
+        Selector selector;
+        // Копия алгоритма скрещивания
+        Crossover crossover;
+        // Копия алгоритма мутации
+        Mutator mutator;
+        // Индексы выбранных родителей
+        std::vector<std::size_t> parentIndices;
+        // Частоты аллелей созданных потомков
+        alleles_type alleles;
+    };
+    // Состояние потоков создания потомков
+    std::vector<BreedingWorker> m_workers;
+    // Количество потоков создания потомков
+    std::size_t m_breedingThreads = 1;
+    // Количество потоков вычисления приспособленности
+    std::size_t m_evaluationThreads = 1;
+    // Размещение потоков с учётом NUMA (пустое - без размещения)
+    std::shared_ptr<const ThreadPlacement> m_placement;
+    // Функция нишевания
+    niching_function m_niching;
+    // Флаг детерминированного вытеснения
+    bool m_crowding = false;
+    // Флаг учёта памяти по поколениям
+    bool m_memoryAccounting = false;
+    // Память текущего поколения
+    GenerationMemory m_memory;
+    // Арена временных данных поколения
+    GenerationArena m_arena;
+    // Флаг самонастраивающегося планирования вычисления приспособленности
+    bool m_planning = false;
+    // Планировщик вычисления приспособленности
+    ExecutionPlanner<value_type> m_planner;
+    // Токен отмены
+    CancellationToken m_cancellation;
+    // Состояние запуска, изменяемое только потоком алгоритма
+    snapshot_type m_state;
+    // Последний опубликованный снимок состояния
+    SeqLock<snapshot_type> m_snapshot;
 };
 
 // Тип для целочисленного генетического алгоритма
@@ -136,13 +1147,25 @@ using IntegerGeneticAlgorithm = GeneticAlgorithm<
     OnePointCrossover<RealType, IntegerType>,
     BitInvertMutator<RealType, IntegerType>>;
 
-// Тип для вещественного генетического алгоритма
+// Тип для вещественного генетического алгоритма.
+// StorageType - тип хранения генов и приспособленности
+// (RealType, float, BFloat16 или Float16), вычисления ведутся в RealType
 template<
-    typename RealType>
+    typename RealType,
+    typename StorageType = RealType>
 using RealGeneticAlgorithm = GeneticAlgorithm<
-    RealGene<RealType>,
-    TournamentSelection<RealGene<RealType>>,
-    BlendCrossover<RealType>,
-    GaussianMutator<RealType>>;
+    RealGene<RealType, StorageType>,
+    TournamentSelection<RealGene<RealType, StorageType>>,
+    BlendCrossover<RealType, StorageType>,
+    GaussianMutator<RealType, StorageType>>;
+
+// Тип для вещественного генетического алгоритма с самоадаптивным шагом мутации
+template<
+    typename RealType>
+using SelfAdaptiveRealGeneticAlgorithm = GeneticAlgorithm<
+    SelfAdaptiveRealGene<RealType>,
+    TournamentSelection<SelfAdaptiveRealGene<RealType>>,
+    SelfAdaptiveBlendCrossover<RealType>,
+    SelfAdaptiveGaussianMutator<RealType>>;
 
 }
@@ -1,12 +1,46 @@
 ﻿#pragma once
 
+#include <cmath>
+#include <limits>
 #include <functional>
+#include <type_traits>
+
+#include "ReducedPrecision.hpp"
 
 namespace GA
 {
 
+// Тип хранения приспособленности: storage_type гена, если он объявлен,
+// иначе тип значения гена
+template<
+    typename GeneType,
+    typename = void>
+struct fitness_storage
+{
+    using type = typename GeneType::value_type;
+};
+
+template<
+    typename GeneType>
+struct fitness_storage<
+    GeneType,
+    std::void_t<typename GeneType::storage_type>>
+{
+    using type = typename GeneType::storage_type;
+};
+
+template<
+    typename GeneType>
+using fitness_storage_t = typename fitness_storage<GeneType>::type;
+
 /**
  * Особь.
+ * Особь помнит, вычислена ли её приспособленность: неоценённая особь
+ * хранит NaN вместо приспособленности (отдельный флаг увеличил бы размер особи).
+ * Любой доступ к гену на запись сбрасывает оценку, поэтому особи,
+ * которых операторы не изменили, можно не оценивать повторно.
+ * Если функция приспособленности сама возвращает NaN, особь считается
+ * неоценённой и вычисляется заново в каждом поколении
  */
 template<
     typename GeneType>
@@ -17,6 +51,8 @@ public:
     using gene_type = typename GeneType::gene_type;
     // Тип значения гена
     using value_type = typename GeneType::value_type;
+    // Тип хранения приспособленности
+    using fitness_storage_type = fitness_storage_t<GeneType>;
     // Тип функции приспособленности
     using fitness_function = std::function<
         value_type(const value_type)>;
@@ -43,7 +79,40 @@ public:
         // Вычисляем приспособленность особи
         // передав в функцию приспособленности
         // ЗНАЧЕНИЕ гена (не то, чем он закодирован)
-        m_fitness = fitnessFn(m_gene());
+        m_fitness = ToStorage<fitness_storage_type>(fitnessFn(m_gene()));
+    }
+
+    /**
+     * Установка уже известного значения приспособленности
+     * (например, найденного локальным поиском)
+     *
+     * \param fitness Значение приспособленности
+     * \return
+     */
+    void SetFitness(
+        const value_type fitness)
+    {
+        m_fitness = ToStorage<fitness_storage_type>(fitness);
+    }
+
+    /**
+     * Проверка, вычислена ли приспособленность особи
+     *
+     * \return true, если приспособленность вычислена после последнего изменения гена
+     */
+    bool IsEvaluated() const
+    {
+        return !std::isnan(GetFitness());
+    }
+
+    /**
+     * Сброс вычисленной приспособленности
+     *
+     * \return
+     */
+    void Invalidate()
+    {
+        m_fitness = ToStorage<fitness_storage_type>(std::numeric_limits<value_type>::quiet_NaN());
     }
 
     /**
@@ -53,7 +122,7 @@ public:
      */
     value_type GetFitness() const
     {
-        return m_fitness;
+        return FromStorage<value_type>(m_fitness);
     }
     /**
      * Получение константной ссылки на ген
@@ -65,12 +134,14 @@ public:
         return m_gene;
     }
     /**
-     * Получение ссылки на ген
+     * Получение ссылки на ген для изменения.
+     * Приспособленность особи при этом сбрасывается
      *
      * \return Ссылка на ген
      */
     GeneType& GetGene()
     {
+        Invalidate();
         return m_gene;
     }
     /**
@@ -87,7 +158,8 @@ private:
     // Ген
     GeneType m_gene;
     // Приспособленность особи
-    value_type m_fitness = static_cast<value_type>(0);
+    // (NaN - приспособленность не вычислена)
+    fitness_storage_type m_fitness = ToStorage<fitness_storage_type>(std::numeric_limits<value_type>::quiet_NaN());
 };
 
 }
@@ -0,0 +1,263 @@
+﻿#pragma once
+
+#include <atomic>
+#include <vector>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+#ifdef _DEBUG
+#   include <iostream>
+#endif
+
+#include "IntegerGene.hpp"
+#include "RealGene.hpp"
+#include "Individual.hpp"
+#include "Parallel.hpp"
+
+namespace GA
+{
+
+/**
+ * Локальный поиск восхождением к вершине с окрестностью инверсии одного бита.
+ * На каждом шаге проверяются все гены, отличающиеся от текущего одним битом,
+ * и выбирается лучший из них (наискорейший спуск).
+ * Данный класс применим только к особям с целочисленным кодированием гена
+ */
+template<
+    typename RealType,
+    typename IntegerType>
+class BitFlipHillClimbing
+{
+public:
+    // Тип особи - особь с целочисленным геном
+    using individual_type = Individual<IntegerGene<RealType, IntegerType>>;
+    // Тип функции приспособленности
+    using fitness_function = typename individual_type::fitness_function;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param maxEvaluations Максимальное количество вычислений приспособленности
+     */
+    explicit BitFlipHillClimbing(
+        const std::size_t maxEvaluations) :
+        m_maxEvaluations(maxEvaluations) {}
+
+    /**
+     * Улучшение особи. Особь должна быть уже оценена
+     *
+     * \param individual Особь, ген и приспособленность которой будут заменены найденными
+     * \param fitnessFn Функция приспособленности
+     * \return Количество вычислений приспособленности
+     */
+    std::size_t operator() (
+        individual_type& individual,
+        const fitness_function& fitnessFn) const
+    {
+        std::size_t evaluations = 0;
+        auto current = std::as_const(individual).GetGene();
+        auto currentFitness = individual.GetFitness();
+        bool improved = true;
+        while (improved && evaluations < m_maxEvaluations) {
+            improved = false;
+            auto best = current;
+            auto bestFitness = currentFitness;
+            for (std::size_t bit = 0; bit < sizeof(IntegerType) * 8 && evaluations < m_maxEvaluations; ++bit) {
+                auto neighbour = current;
+                neighbour.InvertBit(bit);
+                const auto fitness = fitnessFn(neighbour());
+                ++evaluations;
+                if (fitness < bestFitness) {
+                    best = neighbour;
+                    bestFitness = fitness;
+                    improved = true;
+                }
+            }
+            current = best;
+            currentFitness = bestFitness;
+        }
+        individual.GetGene() = current;
+        individual.SetFitness(currentFitness);
+        return evaluations;
+    }
+private:
+    // Максимальное количество вычислений приспособленности
+    std::size_t m_maxEvaluations;
+};
+
+/**
+ * Локальный поиск по координате (компасный поиск).
+ * Проверяются точки x ± h; при улучшении шаг h увеличивается вдвое,
+ * иначе уменьшается вдвое. Поиск останавливается, когда шаг меньше
+ * минимального или исчерпан бюджет вычислений.
+ * Для одномерного гена это то же самое, что поиск Нелдера-Мида
+ * с симплексом из двух точек, но без лишних вычислений на отражение
+ * Данный класс применим только к особям с вещественным кодированием гена
+ */
+template<
+    typename RealType,
+    typename StorageType = RealType>
+class CoordinateSearch
+{
+public:
+    // Тип особи - особь с вещественным геном
+    using individual_type = Individual<RealGene<RealType, StorageType>>;
+    // Тип функции приспособленности
+    using fitness_function = typename individual_type::fitness_function;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param initialStep Начальный шаг
+     * \param minStep Минимальный шаг
+     * \param maxEvaluations Максимальное количество вычислений приспособленности
+     */
+    CoordinateSearch(
+        const RealType initialStep,
+        const RealType minStep,
+        const std::size_t maxEvaluations) :
+        m_initialStep(initialStep),
+        m_minStep(minStep),
+        m_maxEvaluations(maxEvaluations) {}
+
+    /**
+     * Улучшение особи. Особь должна быть уже оценена
+     *
+     * \param individual Особь, ген и приспособленность которой будут заменены найденными
+     * \param fitnessFn Функция приспособленности
+     * \return Количество вычислений приспособленности
+     */
+    std::size_t operator() (
+        individual_type& individual,
+        const fitness_function& fitnessFn) const
+    {
+        std::size_t evaluations = 0;
+        RealType current = individual();
+        RealType currentFitness = individual.GetFitness();
+        RealType step = m_initialStep;
+        while (step >= m_minStep && evaluations < m_maxEvaluations) {
+            bool improved = false;
+            for (const RealType direction : { static_cast<RealType>(1), static_cast<RealType>(-1) }) {
+                if (evaluations >= m_maxEvaluations) {
+                    break;
+                }
+                const RealType candidate = current + direction * step;
+                const RealType fitness = fitnessFn(candidate);
+                ++evaluations;
+                if (fitness < currentFitness) {
+                    current = candidate;
+                    currentFitness = fitness;
+                    improved = true;
+                    break;
+                }
+            }
+            step = improved ? step * 2 : step / 2;
+        }
+        individual.GetGene().SetValue(current);
+        individual.SetFitness(currentFitness);
+        return evaluations;
+    }
+private:
+    // Начальный шаг
+    RealType m_initialStep;
+    // Минимальный шаг
+    RealType m_minStep;
+    // Максимальное количество вычислений приспособленности
+    std::size_t m_maxEvaluations;
+};
+
+/**
+ * Меметическое улучшение популяции.
+ * Каждые period поколений numElites лучших особей улучшаются локальным поиском,
+ * причём особи обрабатываются параллельно. Найденные гены и значения
+ * приспособленности записываются обратно в популяцию (ламарковская схема).
+ * Функция приспособленности должна допускать вызов из нескольких потоков
+ */
+template<
+    typename LocalSearch>
+class MemeticRefinement
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param localSearch Алгоритм локального поиска
+     * \param period Период улучшения в поколениях
+     * \param numElites Количество улучшаемых лучших особей
+     * \param numThreads Количество потоков (0 - по числу ядер)
+     */
+    MemeticRefinement(
+        const LocalSearch& localSearch,
+        const std::size_t period,
+        const std::size_t numElites,
+        const std::size_t numThreads = 0) :
+        m_localSearch(localSearch),
+        m_period(std::max<std::size_t>(period, 1)),
+        m_numElites(numElites),
+        m_numThreads(numThreads) {}
+
+    /**
+     * Улучшение популяции. Популяция должна быть уже оценена
+     *
+     * \param population Популяция
+     * \param fitnessFn Функция приспособленности
+     * \param generation Номер поколения
+     * \return Количество вычислений приспособленности локальным поиском
+     */
+    template<
+        typename PopulationType>
+    std::size_t operator() (
+        PopulationType& population,
+        const typename PopulationType::fitness_function& fitnessFn,
+        const std::size_t generation)
+    {
+        const std::size_t numElites = std::min(m_numElites, population.GetSize());
+        if (generation % m_period != 0 || numElites == 0) {
+            return 0;
+        }
+        // Находим индексы лучших особей, не переставляя саму популяцию
+        m_elites.resize(population.GetSize());
+        std::iota(m_elites.begin(), m_elites.end(), 0);
+        std::nth_element(m_elites.begin(), m_elites.begin() + numElites - 1, m_elites.end(),
+            [&population] (const std::size_t index1, const std::size_t index2)
+        {
+            return population[index1].GetFitness() < population[index2].GetFitness();
+        });
+        std::atomic<std::size_t> evaluations(0);
+        ParallelFor(0, numElites, m_numThreads, [&] (const std::size_t i)
+        {
+            evaluations += m_localSearch(population[m_elites[i]], fitnessFn);
+        });
+        m_numEvaluations += evaluations;
+#ifdef _DEBUG
+        std::cout << "\tMemetic Refinement: " << numElites << " elites, "
+            << evaluations << " evaluations" << std::endl;
+#endif
+        return evaluations;
+    }
+
+    /**
+     * Получение количества вычислений приспособленности локальным поиском
+     *
+     * \return Количество вычислений
+     */
+    std::size_t GetNumEvaluations() const
+    {
+        return m_numEvaluations;
+    }
+private:
+    // Алгоритм локального поиска
+    LocalSearch m_localSearch;
+    // Период улучшения
+    std::size_t m_period;
+    // Количество улучшаемых особей
+    std::size_t m_numElites;
+    // Количество потоков
+    std::size_t m_numThreads;
+    // Индексы лучших особей
+    std::vector<std::size_t> m_elites;
+    // Количество вычислений приспособленности локальным поиском
+    std::size_t m_numEvaluations = 0;
+};
+
+}
@@ -0,0 +1,294 @@
+﻿#pragma once
+
+#include <atomic>
+#include <string>
+#include <cerrno>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <filesystem>
+#include <type_traits>
+#include <system_error>
+#ifdef _WIN32
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#endif
+
+#include "Batch.hpp"
+
+namespace GA
+{
+
+/**
+ * Массив фиксированного размера, отображённый в файл.
+ * Память выделяется операционной системой постранично по мере обращения,
+ * а страницы, которые больше не нужны, можно вернуть подсказкой DontNeed,
+ * поэтому резидентная часть массива может быть намного меньше его размера.
+ * Файл создаётся (или перезаписывается) конструктором и удаляется деструктором.
+ * Элементы должны быть тривиально копируемыми.
+ * Под Windows подсказки не поддерживаются и игнорируются
+ */
+template<
+    typename T>
+class MappedArray
+{
+    static_assert(std::is_trivially_copyable_v<T>, "Mapped elements must be trivially copyable");
+public:
+    // Подсказка о предстоящем доступе к участку массива
+    enum class Advice
+    {
+        // Обычный доступ
+        Normal,
+        // Последовательное чтение: агрессивное упреждающее чтение
+        Sequential,
+        // Участок скоро понадобится: начать чтение заранее
+        WillNeed,
+        // Участок больше не нужен: освободить резидентные страницы
+        DontNeed
+    };
+public:
+    MappedArray() = default;
+    /**
+     * Конструктор.
+     *
+     * \param path Путь к файлу
+     * \param size Количество элементов
+     */
+    MappedArray(
+        const std::filesystem::path& path,
+        const std::size_t size) :
+        m_path(path),
+        m_size(size)
+    {
+        Map();
+    }
+    MappedArray(const MappedArray&) = delete;
+    MappedArray& operator = (const MappedArray&) = delete;
+    MappedArray(
+        MappedArray&& other) noexcept
+    {
+        Swap(other);
+    }
+    MappedArray& operator = (
+        MappedArray&& other) noexcept
+    {
+        Swap(other);
+        return *this;
+    }
+    ~MappedArray()
+    {
+        Unmap();
+    }
+
+    /**
+     * Обмен с другим массивом за O(1)
+     *
+     * \param other Другой массив
+     * \return
+     */
+    void Swap(
+        MappedArray& other) noexcept
+    {
+        std::swap(m_path, other.m_path);
+        std::swap(m_size, other.m_size);
+        std::swap(m_data, other.m_data);
+#ifdef _WIN32
+        std::swap(m_file, other.m_file);
+        std::swap(m_mapping, other.m_mapping);
+#else
+        std::swap(m_file, other.m_file);
+#endif
+    }
+
+    /**
+     * Получение количества элементов
+     *
+     * \return Количество элементов
+     */
+    std::size_t GetSize() const
+    {
+        return m_size;
+    }
+
+    /**
+     * Получение участка массива
+     *
+     * \param offset Смещение первого элемента
+     * \param count Количество элементов
+     * \return Участок [offset, offset + count)
+     */
+    Span<T> GetSpan(
+        const std::size_t offset,
+        const std::size_t count) const
+    {
+        return { m_data + offset, count };
+    }
+
+    /**
+     * Подсказка операционной системе о доступе к участку массива.
+     * Границы участка расширяются до границ страниц
+     *
+     * \param offset Смещение первого элемента
+     * \param count Количество элементов
+     * \param advice Подсказка
+     * \return
+     */
+    void Advise(
+        const std::size_t offset,
+        const std::size_t count,
+        const Advice advice) const
+    {
+#ifndef _WIN32
+        if (count == 0 || m_data == nullptr) {
+            return;
+        }
+        static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const std::size_t begin = offset * sizeof(T) / pageSize * pageSize;
+        const std::size_t end = std::min((offset + count) * sizeof(T), m_size * sizeof(T));
+        int flag = MADV_NORMAL;
+        switch (advice) {
+        case Advice::Normal: flag = MADV_NORMAL; break;
+        case Advice::Sequential: flag = MADV_SEQUENTIAL; break;
+        case Advice::WillNeed: flag = MADV_WILLNEED; break;
+        case Advice::DontNeed: flag = MADV_DONTNEED; break;
+        }
+        // Для отображения MAP_SHARED MADV_DONTNEED не теряет данные:
+        // изменённые страницы остаются в страничном кэше и будут записаны в файл
+        madvise(reinterpret_cast<char*>(m_data) + begin, end - begin, flag);
+#else
+        (void)offset;
+        (void)count;
+        (void)advice;
+#endif
+    }
+private:
+    /**
+     * Создание файла и отображение его в память
+     *
+     * \return
+     */
+    void Map()
+    {
+        const std::size_t bytes = std::max<std::size_t>(m_size * sizeof(T), 1);
+#ifdef _WIN32
+        m_file = CreateFileW(m_path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+            CREATE_ALWAYS, FILE_ATTRIBUTE_TEMPORARY, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "CreateFile");
+        }
+        const ULARGE_INTEGER size { { static_cast<DWORD>(bytes & 0xFFFFFFFFull),
+            static_cast<DWORD>(static_cast<unsigned long long>(bytes) >> 32) } };
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READWRITE, size.HighPart, size.LowPart, nullptr);
+        if (m_mapping == nullptr) {
+            const auto error = static_cast<int>(GetLastError());
+            Unmap();
+            throw std::system_error(error, std::system_category(), "CreateFileMapping");
+        }
+        m_data = static_cast<T*>(MapViewOfFile(m_mapping, FILE_MAP_ALL_ACCESS, 0, 0, bytes));
+        if (m_data == nullptr) {
+            const auto error = static_cast<int>(GetLastError());
+            Unmap();
+            throw std::system_error(error, std::system_category(), "MapViewOfFile");
+        }
+#else
+        m_file = open(m_path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0600);
+        if (m_file < 0) {
+            throw std::system_error(errno, std::generic_category(), "open " + m_path.string());
+        }
+        if (ftruncate(m_file, static_cast<off_t>(bytes)) != 0) {
+            const int error = errno;
+            Unmap();
+            throw std::system_error(error, std::generic_category(), "ftruncate " + m_path.string());
+        }
+        void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+        if (data == MAP_FAILED) {
+            const int error = errno;
+            Unmap();
+            throw std::system_error(error, std::generic_category(), "mmap " + m_path.string());
+        }
+        m_data = static_cast<T*>(data);
+#endif
+    }
+
+    /**
+     * Снятие отображения и удаление файла
+     *
+     * \return
+     */
+    void Unmap()
+    {
+        const std::size_t bytes = std::max<std::size_t>(m_size * sizeof(T), 1);
+#ifdef _WIN32
+        if (m_data != nullptr) {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping != nullptr) {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_file);
+        }
+        m_mapping = nullptr;
+        m_file = INVALID_HANDLE_VALUE;
+#else
+        if (m_data != nullptr) {
+            munmap(m_data, bytes);
+        }
+        if (m_file >= 0) {
+            close(m_file);
+        }
+        m_file = -1;
+#endif
+        if (m_data != nullptr || !m_path.empty()) {
+            std::error_code error;
+            std::filesystem::remove(m_path, error);
+        }
+        m_data = nullptr;
+    }
+private:
+    // Путь к файлу
+    std::filesystem::path m_path;
+    // Количество элементов
+    std::size_t m_size = 0;
+    // Отображённые элементы
+    T* m_data = nullptr;
+#ifdef _WIN32
+    // Дескриптор файла
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    // Дескриптор отображения
+    HANDLE m_mapping = nullptr;
+#else
+    // Дескриптор файла
+    int m_file = -1;
+#endif
+};
+
+/**
+ * Уникальный путь к файлу в каталоге: к основе имени добавляются
+ * идентификатор процесса и номер, уникальный внутри процесса, поэтому
+ * несколько массивов и процессов могут использовать один каталог
+ *
+ * \param directory Каталог
+ * \param stem Основа имени файла
+ * \return Путь к файлу
+ */
+inline std::filesystem::path MakeUniquePath(
+    const std::filesystem::path& directory,
+    const std::string& stem)
+{
+    static std::atomic<std::uint64_t> counter { 0 };
+#ifdef _WIN32
+    const auto process = static_cast<unsigned long>(GetCurrentProcessId());
+#else
+    const auto process = static_cast<long>(getpid());
+#endif
+    return directory / (stem + "." + std::to_string(process) + "." + std::to_string(counter++));
+}
+
+}
@@ -0,0 +1,422 @@
+﻿#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <memory_resource>
+
+#include "Statistics.hpp"
+
+namespace GA
+{
+
+/**
+ * Счётчик выделений памяти: количество, байты, занятая память и её пик.
+ * Потокобезопасен. Пик сбрасывается в начале каждого этапа (BeginPhase),
+ * поэтому одновременные измерения этапов одним счётчиком не вкладываются
+ */
+class AllocationCounter
+{
+public:
+    /**
+     * Состояние счётчика в начале этапа
+     */
+    struct Mark
+    {
+        std::size_t numAllocations = 0;
+        std::size_t numBytes = 0;
+        std::size_t currentBytes = 0;
+    };
+public:
+    /**
+     * Учёт выделения
+     *
+     * \param bytes Размер
+     * \return
+     */
+    void Allocate(
+        const std::size_t bytes)
+    {
+        m_numAllocations.fetch_add(1, std::memory_order_relaxed);
+        m_numBytes.fetch_add(bytes, std::memory_order_relaxed);
+        const std::size_t current = m_currentBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        std::size_t peak = m_peakBytes.load(std::memory_order_relaxed);
+        while (current > peak && !m_peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {}
+    }
+
+    /**
+     * Учёт освобождения
+     *
+     * \param bytes Размер
+     * \return
+     */
+    void Deallocate(
+        const std::size_t bytes)
+    {
+        m_currentBytes.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+    /**
+     * Начало этапа: запоминается состояние, пик приравнивается к занятой памяти
+     *
+     * \return Состояние в начале этапа
+     */
+    Mark BeginPhase()
+    {
+        Mark mark;
+        mark.numAllocations = m_numAllocations.load(std::memory_order_relaxed);
+        mark.numBytes = m_numBytes.load(std::memory_order_relaxed);
+        mark.currentBytes = m_currentBytes.load(std::memory_order_relaxed);
+        m_peakBytes.store(mark.currentBytes, std::memory_order_relaxed);
+        return mark;
+    }
+
+    /**
+     * Конец этапа: выделения с начала этапа добавляются к usage
+     *
+     * \param mark Состояние в начале этапа
+     * \param usage Выделения этапа
+     * \return
+     */
+    void EndPhase(
+        const Mark& mark,
+        MemoryUsage& usage) const
+    {
+        usage.numAllocations += m_numAllocations.load(std::memory_order_relaxed) - mark.numAllocations;
+        usage.numBytes += m_numBytes.load(std::memory_order_relaxed) - mark.numBytes;
+        const std::size_t peak = m_peakBytes.load(std::memory_order_relaxed);
+        if (peak > mark.currentBytes) {
+            usage.peakBytes = std::max(usage.peakBytes, peak - mark.currentBytes);
+        }
+    }
+
+    /**
+     * Получение выделений за всё время работы счётчика
+     *
+     * \return Количество выделений, байты и пик занятой памяти
+     */
+    MemoryUsage GetTotal() const
+    {
+        MemoryUsage usage;
+        usage.numAllocations = m_numAllocations.load(std::memory_order_relaxed);
+        usage.numBytes = m_numBytes.load(std::memory_order_relaxed);
+        usage.peakBytes = m_peakBytes.load(std::memory_order_relaxed);
+        return usage;
+    }
+
+    /**
+     * Получение занятой памяти
+     *
+     * \return Байт выделено и не освобождено
+     */
+    std::size_t GetCurrentBytes() const
+    {
+        return m_currentBytes.load(std::memory_order_relaxed);
+    }
+private:
+    std::atomic<std::size_t> m_numAllocations { 0 };
+    std::atomic<std::size_t> m_numBytes { 0 };
+    std::atomic<std::size_t> m_currentBytes { 0 };
+    std::atomic<std::size_t> m_peakBytes { 0 };
+};
+
+/**
+ * Счётчик глобальных выделений (operator new).
+ * Заполняется, только если в одной единице трансляции программы
+ * развёрнут макрос GA_COUNT_GLOBAL_ALLOCATIONS()
+ *
+ * \return Счётчик
+ */
+inline AllocationCounter& GetGlobalAllocationCounter()
+{
+    static AllocationCounter counter;
+    return counter;
+}
+
+/**
+ * Выделение памяти с учётом в глобальном счётчике.
+ * Размер хранится перед блоком, чтобы освобождение знало его без sized delete
+ *
+ * \param bytes Размер
+ * \return Указатель на блок
+ */
+inline void* CountedAllocate(
+    const std::size_t bytes)
+{
+    constexpr std::size_t header = alignof(std::max_align_t);
+    auto* block = static_cast<unsigned char*>(std::malloc(bytes + header));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *reinterpret_cast<std::size_t*>(block) = bytes;
+    GetGlobalAllocationCounter().Allocate(bytes);
+    return block + header;
+}
+
+/**
+ * Освобождение памяти, выделенной CountedAllocate
+ *
+ * \param pointer Указатель на блок
+ * \return
+ */
+inline void CountedDeallocate(
+    void* pointer) noexcept
+{
+    if (pointer == nullptr) {
+        return;
+    }
+    constexpr std::size_t header = alignof(std::max_align_t);
+    auto* block = static_cast<unsigned char*>(pointer) - header;
+    GetGlobalAllocationCounter().Deallocate(*reinterpret_cast<std::size_t*>(block));
+    std::free(block);
+}
+
+/**
+ * Замена глобальных operator new и operator delete на считающие.
+ * Разворачивается в глобальной области ровно одной единицы трансляции программы.
+ * Выравнивающие варианты (std::align_val_t) не заменяются и не считаются;
+ * большие буферы популяции, выделяемые NumaAllocator напрямую у системы,
+ * тоже не проходят через operator new и учитываются отдельно (populationBytes)
+ */
+#define GA_COUNT_GLOBAL_ALLOCATIONS() \
+    void* operator new(std::size_t bytes) { return ::GA::CountedAllocate(bytes); } \
+    void operator delete(void* pointer) noexcept { ::GA::CountedDeallocate(pointer); } \
+    void operator delete(void* pointer, std::size_t) noexcept { ::GA::CountedDeallocate(pointer); }
+
+/**
+ * Измерение выделений этапа в глобальном счётчике.
+ * Выделения от создания объекта до его уничтожения добавляются к usage
+ */
+class MemoryPhase
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param usage Выделения этапа
+     * \param enabled false - ничего не измерять
+     */
+    MemoryPhase(
+        MemoryUsage& usage,
+        const bool enabled) :
+        m_usage(enabled ? &usage : nullptr)
+    {
+        if (m_usage) {
+            m_mark = GetGlobalAllocationCounter().BeginPhase();
+        }
+    }
+    ~MemoryPhase()
+    {
+        if (m_usage) {
+            GetGlobalAllocationCounter().EndPhase(m_mark, *m_usage);
+        }
+    }
+    MemoryPhase(const MemoryPhase&) = delete;
+    MemoryPhase& operator = (const MemoryPhase&) = delete;
+private:
+    // Выделения этапа (nullptr - измерение выключено)
+    MemoryUsage* m_usage;
+    // Состояние счётчика в начале этапа
+    AllocationCounter::Mark m_mark;
+};
+
+/**
+ * Полиморфный ресурс памяти, считающий выделения и передающий их дальше
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param upstream Ресурс, из которого выделяется память
+     */
+    explicit CountingResource(
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+        m_upstream(upstream) {}
+    CountingResource(const CountingResource&) = delete;
+    CountingResource& operator = (const CountingResource&) = delete;
+
+    /**
+     * Получение счётчика выделений
+     *
+     * \return Счётчик
+     */
+    AllocationCounter& GetCounter()
+    {
+        return m_counter;
+    }
+    /**
+     * Получение ресурса, из которого выделяется память
+     *
+     * \return Ресурс
+     */
+    std::pmr::memory_resource* GetUpstream() const
+    {
+        return m_upstream;
+    }
+    const AllocationCounter& GetCounter() const
+    {
+        return m_counter;
+    }
+private:
+    void* do_allocate(
+        const std::size_t bytes,
+        const std::size_t alignment) override
+    {
+        void* pointer = m_upstream->allocate(bytes, alignment);
+        m_counter.Allocate(bytes);
+        return pointer;
+    }
+    void do_deallocate(
+        void* pointer,
+        const std::size_t bytes,
+        const std::size_t alignment) override
+    {
+        m_counter.Deallocate(bytes);
+        m_upstream->deallocate(pointer, bytes, alignment);
+    }
+    bool do_is_equal(
+        const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+private:
+    // Ресурс, из которого выделяется память
+    std::pmr::memory_resource* m_upstream;
+    // Счётчик выделений
+    AllocationCounter m_counter;
+};
+
+/**
+ * Арена поколения: монотонный ресурс (std::pmr::monotonic_buffer_resource)
+ * поверх собственного буфера. Выделение - сдвиг указателя, освобождение
+ * отдельных блоков ничего не делает, Reset освобождает всё сразу.
+ * Если за поколение буфера не хватило, при Reset он увеличивается,
+ * поэтому в установившемся режиме арена не обращается к внешнему ресурсу,
+ * а Reset выполняется за O(1). Ресурс арены не потокобезопасен
+ */
+class GenerationArena
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param capacity Начальный размер буфера в байтах
+     * \param upstream Ресурс для выделений сверх буфера
+     */
+    explicit GenerationArena(
+        const std::size_t capacity = 4096,
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+        m_buffer(std::max<std::size_t>(capacity, 64)),
+        m_upstream(upstream),
+        m_arena(std::in_place, m_buffer.data(), m_buffer.size(), &m_upstream),
+        m_requests(&*m_arena) {}
+    /**
+     * Копирование создаёт пустую арену с тем же размером буфера
+     */
+    GenerationArena(
+        const GenerationArena& other) :
+        GenerationArena(other.GetCapacity(), other.m_upstream.GetUpstream()) {}
+    GenerationArena& operator = (
+        const GenerationArena& other)
+    {
+        if (this != &other) {
+            Rebuild(other.GetCapacity());
+        }
+        return *this;
+    }
+
+    /**
+     * Получение ресурса для выделений в текущем поколении
+     *
+     * \return Ресурс памяти
+     */
+    std::pmr::memory_resource* GetResource()
+    {
+        return &m_requests;
+    }
+
+    /**
+     * Освобождение всей памяти, выданной с прошлого Reset.
+     * Объекты, размещённые в арене, к этому моменту должны быть уничтожены
+     *
+     * \return
+     */
+    void Reset()
+    {
+        if (GetUpstreamBytes() == 0) {
+            // Всё уместилось в буфер: освобождать нечего, только сдвинуть указатель в начало
+            m_arena->release();
+            m_usedBaseline = m_requests.GetCounter().GetTotal().numBytes;
+            return;
+        }
+        // Буфера не хватило - увеличиваем его, чтобы следующее поколение в него уместилось
+        const std::size_t used = GetUsedBytes();
+        Rebuild(std::max(2 * m_buffer.size(), used + used / 2));
+    }
+
+    /**
+     * Получение количества байт, выданных с прошлого Reset
+     *
+     * \return Байт
+     */
+    std::size_t GetUsedBytes() const
+    {
+        return m_requests.GetCounter().GetTotal().numBytes - m_usedBaseline;
+    }
+    /**
+     * Получение количества байт, запрошенных у внешнего ресурса с прошлого Reset
+     *
+     * \return Байт
+     */
+    std::size_t GetUpstreamBytes() const
+    {
+        return m_upstream.GetCounter().GetTotal().numBytes - m_upstreamBaseline;
+    }
+    /**
+     * Получение размера буфера
+     *
+     * \return Байт
+     */
+    std::size_t GetCapacity() const
+    {
+        return m_buffer.size();
+    }
+private:
+    /**
+     * Создание монотонного ресурса поверх нового буфера.
+     * Счётчики ссылаются на место хранения ресурса, а не на сам ресурс,
+     * поэтому их пересоздавать не нужно
+     *
+     * \param capacity Размер буфера в байтах
+     * \return
+     */
+    void Rebuild(
+        const std::size_t capacity)
+    {
+        m_arena.reset();
+        m_buffer = std::vector<std::byte>(capacity);
+        m_arena.emplace(m_buffer.data(), m_buffer.size(), &m_upstream);
+        m_usedBaseline = m_requests.GetCounter().GetTotal().numBytes;
+        m_upstreamBaseline = m_upstream.GetCounter().GetTotal().numBytes;
+    }
+private:
+    // Буфер арены
+    std::vector<std::byte> m_buffer;
+    // Внешний ресурс со счётчиком
+    CountingResource m_upstream;
+    // Монотонный ресурс поверх буфера
+    std::optional<std::pmr::monotonic_buffer_resource> m_arena;
+    // Ресурс, выдаваемый пользователям арены, со счётчиком
+    CountingResource m_requests;
+    // Показания счётчиков на момент последнего Reset
+    std::size_t m_usedBaseline = 0;
+    std::size_t m_upstreamBaseline = 0;
+};
+
+}
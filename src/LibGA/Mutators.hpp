@@ -1,14 +1,23 @@
 ﻿#pragma once
 
 #include <random>
+#include <vector>
 #include <bitset>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <algorithm>
 #ifdef _DEBUG
 #   include <iostream>
 #endif
 
 #include "IntegerGene.hpp"
 #include "RealGene.hpp"
+#include "SelfAdaptiveRealGene.hpp"
 #include "Individual.hpp"
+#include "Batch.hpp"
+#include "Diversity.hpp"
+#include "Random.hpp"
 
 namespace GA
 {
@@ -64,17 +73,105 @@ public:
             const std::size_t mutationBit = m_bitDistribution(engine);
 #ifdef _DEBUG
             std::cout << "\t\tMutation: bit = " << mutationBit << std::endl;
-            std::bitset<sizeof(IntegerType) * 8> individualBeforeMutationBitSet(individual.GetGene().GetGene());
+            std::bitset<sizeof(IntegerType) * 8> individualBeforeMutationBitSet(std::as_const(individual).GetGene().GetGene());
             std::cout << "\t\tGene before mutation: " << individualBeforeMutationBitSet << std::endl;
 #endif
             // Инвертируем бит в гене особи
             individual.GetGene().InvertBit(mutationBit);
 #ifdef _DEBUG
-            std::bitset<sizeof(IntegerType) * 8> individualAfterMutationBitSet(individual.GetGene().GetGene());
+            std::bitset<sizeof(IntegerType) * 8> individualAfterMutationBitSet(std::as_const(individual).GetGene().GetGene());
             std::cout << "\t\tGene after mutation:  " << individualAfterMutationBitSet << std::endl;
 #endif
         }
     }
+
+    /**
+     * Пакетное применение мутатора к участку популяции.
+     * Решения о мутации и номера битов генерируются заранее для всего участка
+     *
+     * \param individuals Участок популяции
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void MutateBatch(
+        const Span<individual_type> individuals,
+        Engine& engine) const
+    {
+        PrepareBatch(individuals.GetSize(), engine);
+        for (std::size_t i = 0; i < individuals.GetSize(); ++i) {
+            MutatePrepared(individuals[i], i, engine);
+        }
+    }
+
+    /**
+     * Пакетное применение мутатора с учётом частот аллелей.
+     * Каждое инвертирование бита сразу изменяет счётчик его позиции
+     *
+     * \param individuals Участок популяции
+     * \param engine Движок генерации случайных чисел
+     * \param alleles Частоты аллелей, в которые уже добавлены гены участка
+     * \return
+     */
+    template<
+        typename Engine>
+    void MutateBatch(
+        const Span<individual_type> individuals,
+        Engine& engine,
+        AlleleFrequencies<IntegerType>& alleles) const
+    {
+        PrepareBatch(individuals.GetSize(), engine);
+        for (std::size_t i = 0; i < individuals.GetSize(); ++i) {
+            if (m_flags[i]) {
+                const std::size_t bit = m_bits[i];
+                auto& gene = individuals[i].GetGene();
+                gene.InvertBit(bit);
+                alleles.FlipBit(bit, (gene.GetGene() >> bit) & 1);
+            }
+        }
+    }
+
+    /**
+     * Заполнение буферов пакетной мутации. Мутация происходит, если
+     * равномерное число больше коэффициента, то есть с вероятностью 1 - m_mutation
+     *
+     * \param size Количество особей
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void PrepareBatch(
+        const std::size_t size,
+        Engine& engine) const
+    {
+        m_flags.resize(size);
+        m_bits.resize(size);
+        RandomStream stream(engine);
+        stream.FillBernoulli(m_flags, 1.0 - m_mutation);
+        stream.FillBounded(m_bits, static_cast<std::uint32_t>(sizeof(IntegerType) * 8));
+    }
+
+    /**
+     * Применение мутатора к особи с числами, подготовленными PrepareBatch
+     *
+     * \param individual Особь
+     * \param index Номер набора подготовленных чисел
+     * \param engine Движок генерации случайных чисел (не используется)
+     * \return
+     */
+    template<
+        typename Engine>
+    void MutatePrepared(
+        individual_type& individual,
+        const std::size_t index,
+        Engine& /*engine*/) const
+    {
+        if (m_flags[index]) {
+            individual.GetGene().InvertBit(m_bits[index]);
+        }
+    }
 private:
     // Распределение для выбора номера бита
     mutable std::uniform_int_distribution<std::size_t> m_bitDistribution;
@@ -82,6 +179,164 @@ private:
     mutable std::uniform_real_distribution<double> m_mutationDistribution;
     // Коэффициент мутации
     double m_mutation;
+    // Буферы пакетной мутации: решения о мутации и номера битов
+    mutable std::vector<std::uint8_t> m_flags;
+    mutable std::vector<std::uint32_t> m_bits;
+};
+
+/**
+ * Мутатор, заменяющий случайными битами непрерывный блок гена.
+ * Позиция блока выбирается случайно, размер задаётся в конструкторе.
+ * Обычно применяется редко, вместе с BitInvertMutator (см. MutatorChain):
+ * частые инвертирования отдельных бит уточняют решение,
+ * а редкие замены блоков выводят из локальных минимумов.
+ * Данный класс применим только к особям с целочисленным кодированием гена
+ */
+template<
+    typename RealType,
+    typename IntegerType>
+class BlockResetMutator
+{
+public:
+    // Тип особи - особь с целочисленным геном
+    using individual_type = Individual<IntegerGene<RealType, IntegerType>>;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param mutation Коэффициент мутации
+     * \param blockSize Количество бит в блоке (от 1 до количества бит гена)
+     */
+    BlockResetMutator(
+        const double mutation,
+        const std::size_t blockSize) :
+        m_mutation(mutation),
+        m_blockSize(std::clamp<std::size_t>(blockSize, 1, numBits)),
+        m_numOffsets(static_cast<std::uint32_t>(numBits - m_blockSize + 1)),
+        m_blockMask(m_blockSize == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << m_blockSize) - 1) {}
+
+    /**
+     * Применение мутатора к особи
+     *
+     * \param individual Особь
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void operator() (
+        individual_type& individual,
+        Engine& engine) const
+    {
+        if (std::uniform_real_distribution<double>(0.0, 1.0)(engine) > m_mutation) {
+#ifdef _DEBUG
+            std::cout << "\tBlock Reset Mutator" << std::endl;
+#endif
+            const std::size_t offset = std::uniform_int_distribution<std::uint32_t>(0, m_numOffsets - 1)(engine);
+            const auto bits = std::uniform_int_distribution<std::uint64_t>(
+                0, std::numeric_limits<std::uint64_t>::max())(engine);
+            ResetBlock(individual, offset, bits);
+        }
+    }
+
+    /**
+     * Пакетное применение мутатора к участку популяции
+     *
+     * \param individuals Участок популяции
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void MutateBatch(
+        const Span<individual_type> individuals,
+        Engine& engine) const
+    {
+        PrepareBatch(individuals.GetSize(), engine);
+        for (std::size_t i = 0; i < individuals.GetSize(); ++i) {
+            MutatePrepared(individuals[i], i, engine);
+        }
+    }
+
+    /**
+     * Заполнение буферов пакетной мутации: решения о мутации,
+     * позиции блоков и новые биты
+     *
+     * \param size Количество особей
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void PrepareBatch(
+        const std::size_t size,
+        Engine& engine) const
+    {
+        m_flags.resize(size);
+        m_offsets.resize(size);
+        m_bits.resize(size);
+        RandomStream stream(engine);
+        stream.FillBernoulli(m_flags, 1.0 - m_mutation);
+        stream.FillBounded(m_offsets, m_numOffsets);
+        stream.Fill(m_bits);
+    }
+
+    /**
+     * Применение мутатора к особи с числами, подготовленными PrepareBatch
+     *
+     * \param individual Особь
+     * \param index Номер набора подготовленных чисел
+     * \param engine Движок генерации случайных чисел (не используется)
+     * \return
+     */
+    template<
+        typename Engine>
+    void MutatePrepared(
+        individual_type& individual,
+        const std::size_t index,
+        Engine& /*engine*/) const
+    {
+        if (m_flags[index]) {
+            ResetBlock(individual, m_offsets[index], m_bits[index]);
+        }
+    }
+private:
+    /**
+     * Замена блока гена
+     *
+     * \param individual Особь
+     * \param offset Номер младшего бита блока
+     * \param bits Случайные биты
+     * \return
+     */
+    void ResetBlock(
+        individual_type& individual,
+        const std::size_t offset,
+        const std::uint64_t bits) const
+    {
+        const auto& gene = std::as_const(individual).GetGene();
+        const auto mask = static_cast<IntegerType>(m_blockMask << offset);
+        const auto value = static_cast<IntegerType>((gene.GetGene() & ~mask) | (bits & mask));
+        // Запись гена сбрасывает приспособленность, поэтому неизменённый ген не записывается
+        if (value != gene.GetGene()) {
+            individual.GetGene() = IntegerGene<RealType, IntegerType>(value, gene.GetMinValue(), gene.GetMaxValue());
+        }
+    }
+private:
+    // Количество бит гена
+    static constexpr std::size_t numBits = sizeof(IntegerType) * 8;
+    // Коэффициент мутации
+    double m_mutation;
+    // Количество бит в блоке
+    std::size_t m_blockSize;
+    // Количество возможных позиций блока
+    std::uint32_t m_numOffsets;
+    // Маска блока, начинающегося с младшего бита
+    std::uint64_t m_blockMask;
+    // Буферы пакетной мутации: решения о мутации, позиции блоков и новые биты
+    mutable std::vector<std::uint8_t> m_flags;
+    mutable std::vector<std::uint32_t> m_offsets;
+    mutable std::vector<std::uint64_t> m_bits;
 };
 
 /**
@@ -90,12 +345,13 @@ private:
  * "Генетические алгоритмы на Python", ДМК Пресс, стр. 53
  */
 template<
-    typename RealType>
+    typename RealType,
+    typename StorageType = RealType>
 class GaussianMutator
 {
 public:
-    // Тип особи - особь с целочисленным геном
-    using individual_type = Individual<RealGene<RealType>>;
+    // Тип особи - особь с вещественным геном
+    using individual_type = Individual<RealGene<RealType, StorageType>>;
 public:
     /**
      * Конструктор.
@@ -132,16 +388,79 @@ public:
             // Нормальное распределение в окресности значения особи
             std::normal_distribution<double> distribution(individual(), m_stddev);
 #ifdef _DEBUG
-            std::cout << "\t\tGene before mutation: " << individual.GetGene()() << std::endl;
+            std::cout << "\t\tGene before mutation: " << std::as_const(individual).GetGene()() << std::endl;
 #endif
             // Генерируем вещественное число, находящееся рядом со значением особи и
             // задаём новое значение особи
             individual.GetGene().SetValue(distribution(engine));
 #ifdef _DEBUG
-            std::cout << "\t\tGene after mutation:  " << individual.GetGene()() << std::endl;
+            std::cout << "\t\tGene after mutation:  " << std::as_const(individual).GetGene()() << std::endl;
 #endif
         }
     }
+
+    /**
+     * Пакетное применение мутатора к участку популяции.
+     * Вместо создания распределения для каждой особи
+     * масштабируется стандартное нормальное распределение;
+     * решения о мутации и нормальные числа генерируются заранее для всего участка
+     *
+     * \param individuals Участок популяции
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void MutateBatch(
+        const Span<individual_type> individuals,
+        Engine& engine) const
+    {
+        PrepareBatch(individuals.GetSize(), engine);
+        for (std::size_t i = 0; i < individuals.GetSize(); ++i) {
+            MutatePrepared(individuals[i], i, engine);
+        }
+    }
+
+    /**
+     * Заполнение буферов пакетной мутации: решения о мутации и нормальные числа
+     *
+     * \param size Количество особей
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void PrepareBatch(
+        const std::size_t size,
+        Engine& engine) const
+    {
+        m_flags.resize(size);
+        m_normals.resize(size);
+        RandomStream stream(engine);
+        stream.FillBernoulli(m_flags, 1.0 - m_mutation);
+        stream.FillNormal(m_normals);
+    }
+
+    /**
+     * Применение мутатора к особи с числами, подготовленными PrepareBatch
+     *
+     * \param individual Особь
+     * \param index Номер набора подготовленных чисел
+     * \param engine Движок генерации случайных чисел (не используется)
+     * \return
+     */
+    template<
+        typename Engine>
+    void MutatePrepared(
+        individual_type& individual,
+        const std::size_t index,
+        Engine& /*engine*/) const
+    {
+        if (m_flags[index]) {
+            individual.GetGene().SetValue(static_cast<RealType>(
+                individual() + m_stddev * m_normals[index]));
+        }
+    }
 private:
     // Распределение для генерации коэффициента мутации
     mutable std::uniform_real_distribution<double> m_mutationDistribution;
@@ -149,6 +468,193 @@ private:
     double m_mutation;
     // Стандартное отклонение
     double m_stddev;
+    // Буферы пакетной мутации: решения о мутации и нормальные числа
+    mutable std::vector<std::uint8_t> m_flags;
+    mutable std::vector<double> m_normals;
+};
+
+/**
+ * Самоадаптивная гауссова мутация.
+ * Шаг мутации хранится в гене каждой особи и сам подвергается
+ * логнормальной мутации перед изменением значения гена:
+ * σ' = σ * exp(τ * N(0, 1)), x' = x + σ' * N(0, 1).
+ * Удачные шаги выживают вместе с особями, поэтому отбор настраивает их сам.
+ * Данный класс применим только к особям с геном SelfAdaptiveRealGene
+ * "Evolution strategies – A comprehensive introduction", Beyer, Schwefel, 2002
+ */
+template<
+    typename RealType>
+class SelfAdaptiveGaussianMutator
+{
+public:
+    // Тип особи - особь с самоадаптивным вещественным геном
+    using individual_type = Individual<SelfAdaptiveRealGene<RealType>>;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param mutation Коэффициент мутации
+     * \param learningRate Скорость обучения τ (для одномерной задачи обычно 1/sqrt(2))
+     * \param minStepSize Минимальный шаг мутации
+     */
+    SelfAdaptiveGaussianMutator(
+        const double mutation,
+        const double learningRate = 0.7071,
+        const double minStepSize = 1e-12) :
+        m_mutation(mutation),
+        m_learningRate(learningRate),
+        m_minStepSize(minStepSize) {}
+
+    /**
+     * Применение мутатора к особи
+     *
+     * \param individual Особь
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void operator() (
+        individual_type& individual,
+        Engine& engine) const
+    {
+        // Генерируем случайное число из диапазона от 0 до 1,
+        // и если это число больше коэффициента мутации,
+        // применяем мутацию к особи
+        if (m_mutationDistribution(engine) > m_mutation) {
+#ifdef _DEBUG
+            std::cout << "\tSelf-Adaptive Gaussian Mutator" << std::endl;
+#endif
+            auto& gene = individual.GetGene();
+            // Сначала мутирует шаг, затем значение гена с новым шагом
+            const double stepSize = std::max(
+                m_minStepSize,
+                gene.GetStepSize() * std::exp(m_learningRate * m_normalDistribution(engine)));
+            gene.SetStepSize(static_cast<RealType>(stepSize));
+            gene.SetValue(static_cast<RealType>(gene() + stepSize * m_normalDistribution(engine)));
+#ifdef _DEBUG
+            std::cout << "\t\tStep size: " << gene.GetStepSize() << " Gene after mutation: " << gene() << std::endl;
+#endif
+        }
+    }
+private:
+    // Распределение для генерации коэффициента мутации
+    mutable std::uniform_real_distribution<double> m_mutationDistribution;
+    // Стандартное нормальное распределение
+    mutable std::normal_distribution<double> m_normalDistribution;
+    // Коэффициент мутации
+    double m_mutation;
+    // Скорость обучения τ
+    double m_learningRate;
+    // Минимальный шаг мутации
+    double m_minStepSize;
+};
+
+/**
+ * Гауссова мутация с правилом успеха 1/5.
+ * Общее для популяции стандартное отклонение увеличивается, если доля потомков,
+ * оказавшихся лучше своих родителей, больше 1/5, и уменьшается в противном случае:
+ * σ = σ * exp((p - 1/5) / (d * (1 - 1/5))), где p - доля успешных потомков поколения.
+ * Данный класс применим только к особям с вещественным кодированием гена
+ * "Evolutionsstrategie", Rechenberg, 1973
+ */
+template<
+    typename RealType,
+    typename StorageType = RealType>
+class OneFifthRuleGaussianMutator
+{
+public:
+    // Тип особи - особь с вещественным геном
+    using individual_type = Individual<RealGene<RealType, StorageType>>;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param mutation Коэффициент мутации
+     * \param stddev Начальное стандартное отклонение
+     * \param damping Коэффициент затухания d (чем больше, тем медленнее адаптация)
+     */
+    OneFifthRuleGaussianMutator(
+        const double mutation,
+        const double stddev,
+        const double damping = 1.0) :
+        m_mutation(mutation),
+        m_stddev(stddev),
+        m_damping(damping) {}
+
+    /**
+     * Применение мутатора к особи
+     *
+     * \param individual Особь
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void operator() (
+        individual_type& individual,
+        Engine& engine) const
+    {
+        if (m_mutationDistribution(engine) > m_mutation) {
+#ifdef _DEBUG
+            std::cout << "\tOne-Fifth Rule Gaussian Mutator" << std::endl;
+#endif
+            individual.GetGene().SetValue(static_cast<RealType>(
+                individual() + m_stddev * m_normalDistribution(engine)));
+        }
+    }
+
+    /**
+     * Обратная связь по результатам поколения.
+     * Потомок offspring[i] считается успешным, если он лучше родителя parents[i]
+     *
+     * \param parents Популяция выбранных родителей
+     * \param offspring Оценённая популяция потомков
+     * \return
+     */
+    template<
+        typename PopulationType>
+    void Feedback(
+        const PopulationType& parents,
+        const PopulationType& offspring)
+    {
+        if (offspring.GetSize() == 0) {
+            return;
+        }
+        std::size_t successes = 0;
+        for (std::size_t i = 0; i < offspring.GetSize(); ++i) {
+            // Решается задача минимизации
+            if (offspring[i].GetFitness() < parents[i].GetFitness()) {
+                ++successes;
+            }
+        }
+        const double successRate = static_cast<double>(successes) / offspring.GetSize();
+        m_stddev *= std::exp((successRate - 0.2) / (m_damping * 0.8));
+#ifdef _DEBUG
+        std::cout << "\tOne-Fifth Rule: success rate = " << successRate << " stddev = " << m_stddev << std::endl;
+#endif
+    }
+
+    /**
+     * Получение текущего стандартного отклонения
+     *
+     * \return Стандартное отклонение
+     */
+    double GetStddev() const
+    {
+        return m_stddev;
+    }
+private:
+    // Распределение для генерации коэффициента мутации
+    mutable std::uniform_real_distribution<double> m_mutationDistribution;
+    // Стандартное нормальное распределение
+    mutable std::normal_distribution<double> m_normalDistribution;
+    // Коэффициент мутации
+    double m_mutation;
+    // Текущее стандартное отклонение
+    double m_stddev;
+    // Коэффициент затухания
+    double m_damping;
 };
 
 }
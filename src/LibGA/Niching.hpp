@@ -0,0 +1,417 @@
+﻿#pragma once
+
+#include <cmath>
+#include <vector>
+#include <numeric>
+#include <algorithm>
+#ifdef _DEBUG
+#   include <iostream>
+#endif
+
+#include "Batch.hpp"
+
+namespace GA
+{
+
+/**
+ * Пространственный индекс по значениям генов.
+ * Ген одномерный, поэтому индекс - это отсортированный массив значений
+ * (одномерное k-d дерево) с префиксными суммами. Построение за O(n log n),
+ * поиск окрестности - двоичным поиском за O(log n), а сумма расстояний
+ * от точки до всех соседей в окрестности - за O(log n) через префиксные суммы
+ */
+template<
+    typename RealType>
+class SpatialIndex
+{
+public:
+    /**
+     * Построение индекса по значениям генов популяции
+     *
+     * \param population Популяция
+     * \return
+     */
+    template<
+        typename PopulationType>
+    void Build(
+        const PopulationType& population)
+    {
+        const std::size_t size = population.GetSize();
+        m_order.resize(size);
+        std::iota(m_order.begin(), m_order.end(), 0);
+        m_values.resize(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            m_values[i] = population[i]();
+        }
+        std::sort(m_order.begin(), m_order.end(), [this] (const std::size_t index1, const std::size_t index2)
+        {
+            return m_values[index1] < m_values[index2];
+        });
+        m_sorted.resize(size);
+        m_prefixSums.resize(size + 1);
+        m_prefixSums[0] = 0.0;
+        for (std::size_t k = 0; k < size; ++k) {
+            m_sorted[k] = m_values[m_order[k]];
+            m_prefixSums[k + 1] = m_prefixSums[k] + m_sorted[k];
+        }
+    }
+
+    /**
+     * Получение количества точек
+     *
+     * \return Количество точек
+     */
+    std::size_t GetSize() const
+    {
+        return m_sorted.size();
+    }
+
+    /**
+     * Получение значения гена особи
+     *
+     * \param index Индекс особи в популяции
+     * \return Значение гена
+     */
+    RealType GetValue(
+        const std::size_t index) const
+    {
+        return m_values[index];
+    }
+
+    /**
+     * Поиск окрестности |x - value| < radius
+     *
+     * \param value Центр окрестности
+     * \param radius Радиус
+     * \return Пара позиций [first, last) в отсортированном порядке
+     */
+    std::pair<std::size_t, std::size_t> FindRange(
+        const RealType value,
+        const RealType radius) const
+    {
+        const auto first = std::upper_bound(m_sorted.begin(), m_sorted.end(), value - radius);
+        const auto last = std::lower_bound(first, m_sorted.end(), value + radius);
+        return { static_cast<std::size_t>(first - m_sorted.begin()),
+            static_cast<std::size_t>(last - m_sorted.begin()) };
+    }
+
+    /**
+     * Обход особей в окрестности |x - value| < radius
+     *
+     * \param value Центр окрестности
+     * \param radius Радиус
+     * \param function Вызывается как function(index, distance) для каждой особи
+     * \return
+     */
+    template<
+        typename Function>
+    void ForEachInRadius(
+        const RealType value,
+        const RealType radius,
+        const Function& function) const
+    {
+        const auto [first, last] = FindRange(value, radius);
+        for (std::size_t k = first; k < last; ++k) {
+            function(m_order[k], std::abs(m_sorted[k] - value));
+        }
+    }
+
+    /**
+     * Сумма расстояний от value до точек с позициями [first, last)
+     *
+     * \param value Точка
+     * \param first Первая позиция
+     * \param last Позиция за последней
+     * \return Σ |x - value|
+     */
+    double SumDistances(
+        const RealType value,
+        const std::size_t first,
+        const std::size_t last) const
+    {
+        const std::size_t middle = static_cast<std::size_t>(
+            std::lower_bound(m_sorted.begin() + first, m_sorted.begin() + last, value) - m_sorted.begin());
+        const double left = static_cast<double>(value) * (middle - first) - (m_prefixSums[middle] - m_prefixSums[first]);
+        const double right = (m_prefixSums[last] - m_prefixSums[middle]) - static_cast<double>(value) * (last - middle);
+        return left + right;
+    }
+
+    /**
+     * Получение индекса особи по позиции в отсортированном порядке
+     *
+     * \param position Позиция
+     * \return Индекс особи в популяции
+     */
+    std::size_t GetIndex(
+        const std::size_t position) const
+    {
+        return m_order[position];
+    }
+private:
+    // Значения генов в порядке популяции
+    std::vector<RealType> m_values;
+    // Индексы особей, упорядоченные по значению гена
+    std::vector<std::size_t> m_order;
+    // Отсортированные значения генов
+    std::vector<RealType> m_sorted;
+    // Префиксные суммы отсортированных значений
+    std::vector<double> m_prefixSums;
+};
+
+/**
+ * Разделение приспособленности (fitness sharing, Goldberg и Richardson).
+ * Нишевое число особи m = Σ sh(d), sh(d) = 1 - (d / σ)^α при d < σ,
+ * считается по пространственному индексу. При α = 1 сумма по окрестности
+ * вычисляется через префиксные суммы за O(log n) на особь, иначе -
+ * перебором соседей. Задача минимизации: "качество" особи f_worst - f
+ * делится на нишевое число, то есть f' = f_worst - (f_worst - f) / m.
+ * Изменённая приспособленность используется только для отбора
+ */
+template<
+    typename RealType>
+class FitnessSharing
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param radius Радиус ниши σ
+     * \param alpha Показатель α функции разделения
+     */
+    explicit FitnessSharing(
+        const RealType radius,
+        const RealType alpha = static_cast<RealType>(1)) :
+        m_radius(radius),
+        m_alpha(alpha) {}
+
+    /**
+     * Применение разделения к оценённой популяции
+     *
+     * \param population Популяция
+     * \return
+     */
+    template<
+        typename PopulationType>
+    void operator() (
+        PopulationType& population)
+    {
+        const std::size_t size = population.GetSize();
+        if (size == 0) {
+            return;
+        }
+        // Худшая конечная приспособленность: особи с бесконечной приспособленностью
+        // (смертельный штраф) не разделяют её и не участвуют в вычислении худшей
+        bool anyFinite = false;
+        RealType worst = 0;
+        for (std::size_t i = 0; i < size; ++i) {
+            const RealType fitness = population[i].GetFitness();
+            if (std::isfinite(fitness)) {
+                worst = anyFinite ? std::max(worst, fitness) : fitness;
+                anyFinite = true;
+            }
+        }
+        if (!anyFinite) {
+            return;
+        }
+        m_index.Build(population);
+        m_nicheCounts.resize(size);
+        for (std::size_t i = 0; i < size; ++i) {
+            const RealType value = m_index.GetValue(i);
+            if (m_alpha == static_cast<RealType>(1)) {
+                const auto [first, last] = m_index.FindRange(value, m_radius);
+                m_nicheCounts[i] = (last - first) - m_index.SumDistances(value, first, last) / m_radius;
+            }
+            else {
+                double count = 0.0;
+                m_index.ForEachInRadius(value, m_radius, [&] (const std::size_t, const RealType distance)
+                {
+                    count += 1.0 - std::pow(static_cast<double>(distance / m_radius), static_cast<double>(m_alpha));
+                });
+                m_nicheCounts[i] = count;
+            }
+        }
+        for (std::size_t i = 0; i < size; ++i) {
+            // Особь всегда входит в свою нишу, m >= 1
+            const double count = std::max(m_nicheCounts[i], 1.0);
+            const RealType fitness = population[i].GetFitness();
+            if (!std::isfinite(fitness)) {
+                continue;
+            }
+            population[i].SetFitness(static_cast<RealType>(worst - (worst - fitness) / count));
+        }
+    }
+private:
+    // Радиус ниши
+    RealType m_radius;
+    // Показатель функции разделения
+    RealType m_alpha;
+    // Пространственный индекс
+    SpatialIndex<RealType> m_index;
+    // Нишевые числа
+    std::vector<double> m_nicheCounts;
+};
+
+/**
+ * Расчистка (clearing, Pétrowski).
+ * Особи просматриваются от лучшей к худшей. Непогашенная особь становится
+ * победителем ниши радиуса σ; из более слабых особей её окрестности
+ * (найденной по пространственному индексу) capacity - 1 лучших сохраняются,
+ * а остальные погашаются - получают худшую приспособленность популяции.
+ * Изменённая приспособленность используется только для отбора
+ */
+template<
+    typename RealType>
+class Clearing
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param radius Радиус ниши σ
+     * \param capacity Количество победителей в нише κ
+     */
+    explicit Clearing(
+        const RealType radius,
+        const std::size_t capacity = 1) :
+        m_radius(radius),
+        m_capacity(std::max<std::size_t>(capacity, 1)) {}
+
+    /**
+     * Применение расчистки к оценённой популяции
+     *
+     * \param population Популяция
+     * \return
+     */
+    template<
+        typename PopulationType>
+    void operator() (
+        PopulationType& population)
+    {
+        const std::size_t size = population.GetSize();
+        if (size == 0) {
+            return;
+        }
+        m_index.Build(population);
+        // Ранги особей по приспособленности
+        m_order.resize(size);
+        std::iota(m_order.begin(), m_order.end(), 0);
+        std::sort(m_order.begin(), m_order.end(), [&population] (const std::size_t index1, const std::size_t index2)
+        {
+            return population[index1].GetFitness() < population[index2].GetFitness();
+        });
+        m_ranks.resize(size);
+        for (std::size_t rank = 0; rank < size; ++rank) {
+            m_ranks[m_order[rank]] = rank;
+        }
+        const RealType worst = population[m_order.back()].GetFitness();
+        m_cleared.assign(size, false);
+        m_clearedCount = 0;
+        for (const std::size_t winner : m_order) {
+            if (m_cleared[winner]) {
+                continue;
+            }
+            // Более слабые непогашенные особи ниши
+            m_niche.clear();
+            m_index.ForEachInRadius(m_index.GetValue(winner), m_radius, [&] (const std::size_t index, const RealType)
+            {
+                if (m_ranks[index] > m_ranks[winner] && !m_cleared[index]) {
+                    m_niche.push_back(index);
+                }
+            });
+            const std::size_t numKept = std::min(m_capacity - 1, m_niche.size());
+            if (numKept > 0) {
+                std::nth_element(m_niche.begin(), m_niche.begin() + (numKept - 1), m_niche.end(),
+                    [this] (const std::size_t index1, const std::size_t index2)
+                {
+                    return m_ranks[index1] < m_ranks[index2];
+                });
+            }
+            for (std::size_t k = numKept; k < m_niche.size(); ++k) {
+                m_cleared[m_niche[k]] = true;
+                population[m_niche[k]].SetFitness(worst);
+                ++m_clearedCount;
+            }
+        }
+#ifdef _DEBUG
+        std::cout << "\tClearing: " << m_clearedCount << " cleared" << std::endl;
+#endif
+    }
+
+    /**
+     * Получение количества погашенных особей при последнем применении
+     *
+     * \return Количество особей
+     */
+    std::size_t GetNumCleared() const
+    {
+        return m_clearedCount;
+    }
+private:
+    // Радиус ниши
+    RealType m_radius;
+    // Количество победителей в нише
+    std::size_t m_capacity;
+    // Пространственный индекс
+    SpatialIndex<RealType> m_index;
+    // Индексы особей по возрастанию приспособленности
+    std::vector<std::size_t> m_order;
+    // Ранг каждой особи
+    std::vector<std::size_t> m_ranks;
+    // Флаги погашенных особей
+    std::vector<bool> m_cleared;
+    // Особи текущей ниши
+    std::vector<std::size_t> m_niche;
+    // Количество погашенных особей
+    std::size_t m_clearedCount = 0;
+};
+
+/**
+ * Детерминированное вытеснение (deterministic crowding, Mahfoud).
+ * Дети пары родителей (parentIndices[2i], parentIndices[2i + 1]) сопоставляются
+ * с родителями так, чтобы сумма расстояний между генами была меньше,
+ * и каждый ребёнок занимает своё место, только если он не хуже своего родителя;
+ * иначе на его место возвращается родитель. Расстояние считается только
+ * внутри пары, поэтому пространственный индекс здесь не нужен.
+ * Родители и дети должны быть уже оценены
+ *
+ * \param parents Особи, из которых выбирались родители
+ * \param parentIndices Индексы родителей
+ * \param children Дети (заменяются победителями)
+ * \return Количество мест, оставшихся за родителями
+ */
+template<
+    typename IndividualType>
+std::size_t DeterministicCrowding(
+    const Span<const IndividualType> parents,
+    const Span<const std::size_t> parentIndices,
+    const Span<IndividualType> children)
+{
+    std::size_t numParentsKept = 0;
+    const auto replace = [&] (const IndividualType& parent, IndividualType& child)
+    {
+        if (parent.GetFitness() < child.GetFitness()) {
+            child = parent;
+            ++numParentsKept;
+        }
+    };
+    for (std::size_t i = 0; i + 1 < children.GetSize(); i += 2) {
+        const IndividualType& parent1 = parents[parentIndices[i]];
+        const IndividualType& parent2 = parents[parentIndices[i + 1]];
+        const auto distance = [] (const IndividualType& individual1, const IndividualType& individual2)
+        {
+            return std::abs(individual1() - individual2());
+        };
+        if (distance(parent1, children[i]) + distance(parent2, children[i + 1])
+            <= distance(parent1, children[i + 1]) + distance(parent2, children[i])) {
+            replace(parent1, children[i]);
+            replace(parent2, children[i + 1]);
+        }
+        else {
+            replace(parent1, children[i + 1]);
+            replace(parent2, children[i]);
+        }
+    }
+    return numParentsKept;
+}
+
+}
@@ -0,0 +1,474 @@
+﻿#pragma once
+
+#include <new>
+#include <thread>
+#include <memory>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <type_traits>
+#ifdef _WIN32
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   include <windows.h>
+#else
+#   include <sched.h>
+#   include <unistd.h>
+#   include <sys/mman.h>
+#endif
+
+#include "Parallel.hpp"
+
+namespace GA
+{
+
+/**
+ * Топология NUMA: списки процессоров каждого узла.
+ * Под Linux читается из /sys/devices/system/node с учётом маски процессоров,
+ * доступных процессу. Если сведений нет (другая ОС, контейнер без sysfs),
+ * считается, что узел один и на нём все доступные процессоры
+ */
+class NumaTopology
+{
+public:
+    /**
+     * Получение топологии машины (определяется один раз)
+     *
+     * \return Топология
+     */
+    static const NumaTopology& Get()
+    {
+        static const NumaTopology topology;
+        return topology;
+    }
+
+    /**
+     * Получение количества узлов, на которых есть доступные процессоры
+     *
+     * \return Количество узлов, не меньше 1
+     */
+    std::size_t GetNumNodes() const
+    {
+        return m_nodes.size();
+    }
+
+    /**
+     * Получение процессоров узла
+     *
+     * \param node Номер узла (по порядку среди узлов с доступными процессорами)
+     * \return Номера процессоров
+     */
+    const std::vector<int>& GetCpus(
+        const std::size_t node) const
+    {
+        return m_nodes[node];
+    }
+private:
+    NumaTopology()
+    {
+        const std::vector<int> allowed = GetAllowedCpus();
+#ifndef _WIN32
+        for (int node = 0; ; ++node) {
+            std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            if (!cpulist) {
+                // Номера узлов могут идти с пропусками, но не больше чем до "possible"
+                if (node >= GetMaxNode()) {
+                    break;
+                }
+                continue;
+            }
+            std::string list;
+            std::getline(cpulist, list);
+            std::vector<int> cpus;
+            for (const int cpu : ParseCpuList(list)) {
+                if (std::find(allowed.begin(), allowed.end(), cpu) != allowed.end()) {
+                    cpus.push_back(cpu);
+                }
+            }
+            if (!cpus.empty()) {
+                m_nodes.push_back(std::move(cpus));
+            }
+        }
+#endif
+        if (m_nodes.empty()) {
+            m_nodes.push_back(allowed);
+        }
+    }
+
+    /**
+     * Получение процессоров, на которых процессу разрешено выполняться
+     *
+     * \return Номера процессоров
+     */
+    static std::vector<int> GetAllowedCpus()
+    {
+        std::vector<int> cpus;
+#ifndef _WIN32
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &mask)) {
+                    cpus.push_back(cpu);
+                }
+            }
+        }
+#endif
+        if (cpus.empty()) {
+            const int numCpus = static_cast<int>(GetNumThreads(0));
+            for (int cpu = 0; cpu < numCpus; ++cpu) {
+                cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+
+    /**
+     * Получение наибольшего возможного номера узла
+     *
+     * \return Номер узла
+     */
+    static int GetMaxNode()
+    {
+        std::ifstream possible("/sys/devices/system/node/possible");
+        std::string list;
+        std::getline(possible, list);
+        const std::vector<int> nodes = ParseCpuList(list);
+        return nodes.empty() ? 0 : nodes.back();
+    }
+
+    /**
+     * Разбор списка вида "0-3,8,10-11"
+     *
+     * \param list Список
+     * \return Номера по возрастанию
+     */
+    static std::vector<int> ParseCpuList(
+        const std::string& list)
+    {
+        std::vector<int> result;
+        std::size_t position = 0;
+        while (position < list.size()) {
+            std::size_t end = list.find(',', position);
+            if (end == std::string::npos) {
+                end = list.size();
+            }
+            const std::string range = list.substr(position, end - position);
+            const std::size_t dash = range.find('-');
+            try {
+                const int first = std::stoi(range.substr(0, dash));
+                const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int i = first; i <= last; ++i) {
+                    result.push_back(i);
+                }
+            }
+            catch (const std::exception&) {
+                // Пустой или повреждённый элемент списка пропускаем
+            }
+            position = end + 1;
+        }
+        return result;
+    }
+private:
+    // Процессоры каждого узла
+    std::vector<std::vector<int>> m_nodes;
+};
+
+/**
+ * Размещение потоков по процессорам с учётом NUMA.
+ * Поток w обрабатывает w-ю непрерывную часть диапазона (как в ParallelFor),
+ * и потоки распределяются по узлам подряд: первые части - на первый узел,
+ * следующие - на второй и т.д. Поэтому память, впервые затронутая потоком w,
+ * оказывается на его узле, и каждый поток в основном работает с локальной
+ * частью популяции.
+ * На машине с одним узлом потоки по умолчанию не привязываются:
+ * привязка там ничего не даёт, а планировщику мешает
+ */
+class ThreadPlacement
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param numThreads Количество потоков (0 - по числу доступных процессоров)
+     * \param pinSingleNode Привязывать потоки и на машине с одним узлом
+     */
+    explicit ThreadPlacement(
+        const std::size_t numThreads = 0,
+        const bool pinSingleNode = false)
+    {
+        const NumaTopology& topology = NumaTopology::Get();
+        std::vector<int> cpus;
+        std::vector<std::size_t> nodes;
+        for (std::size_t node = 0; node < topology.GetNumNodes(); ++node) {
+            for (const int cpu : topology.GetCpus(node)) {
+                cpus.push_back(cpu);
+                nodes.push_back(node);
+            }
+        }
+        const std::size_t count = numThreads > 0 ? numThreads : cpus.size();
+        const bool pin = topology.GetNumNodes() > 1 || pinSingleNode;
+        m_cpus.resize(count);
+        m_nodes.resize(count);
+        for (std::size_t w = 0; w < count; ++w) {
+            // Потоки равномерно распределяются по списку процессоров, упорядоченному по узлам
+            const std::size_t index = w * cpus.size() / count;
+            m_cpus[w] = pin ? cpus[index] : -1;
+            m_nodes[w] = nodes[index];
+        }
+    }
+
+    /**
+     * Получение количества потоков
+     *
+     * \return Количество потоков
+     */
+    std::size_t GetNumThreads() const
+    {
+        return m_cpus.size();
+    }
+
+    /**
+     * Получение процессора потока
+     *
+     * \param worker Номер потока
+     * \return Номер процессора или -1, если поток не привязывается
+     */
+    int GetCpu(
+        const std::size_t worker) const
+    {
+        return m_cpus[worker];
+    }
+
+    /**
+     * Получение узла потока
+     *
+     * \param worker Номер потока
+     * \return Номер узла
+     */
+    std::size_t GetNode(
+        const std::size_t worker) const
+    {
+        return m_nodes[worker];
+    }
+
+    /**
+     * Привязка текущего потока к процессору потока worker
+     *
+     * \param worker Номер потока
+     * \return true, если поток привязан
+     */
+    bool PinCurrentThread(
+        const std::size_t worker) const
+    {
+        const int cpu = m_cpus[worker % m_cpus.size()];
+        if (cpu < 0) {
+            return false;
+        }
+#ifdef _WIN32
+        return cpu < 64 && SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu) != 0;
+#else
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(cpu, &mask);
+        return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+#endif
+    }
+private:
+    // Процессор каждого потока (-1 - без привязки)
+    std::vector<int> m_cpus;
+    // Узел каждого потока
+    std::vector<std::size_t> m_nodes;
+};
+
+/**
+ * Параллельный цикл по диапазону [begin, end) с размещением потоков.
+ * Диапазон делится на непрерывные части так же, как в ParallelFor,
+ * и часть w обрабатывает отдельный поток, привязанный к процессору
+ * placement.GetCpu(w). Вызывающий поток только ожидает завершения,
+ * поэтому его собственная привязка не меняется
+ *
+ * \param begin Начало диапазона
+ * \param end Конец диапазона
+ * \param placement Размещение потоков
+ * \param function Тело цикла, вызывается как function(index)
+ * \return
+ */
+template<
+    typename Function>
+void ParallelFor(
+    const std::size_t begin,
+    const std::size_t end,
+    const ThreadPlacement& placement,
+    const Function& function)
+{
+    if (begin >= end) {
+        return;
+    }
+    const std::size_t size = end - begin;
+    const std::size_t numWorkers = std::max<std::size_t>(std::min(placement.GetNumThreads(), size), 1);
+    // Один непривязанный поток - выполняем в вызывающем потоке
+    if (numWorkers == 1 && placement.GetCpu(0) < 0) {
+        for (std::size_t i = begin; i < end; ++i) {
+            function(i);
+        }
+        return;
+    }
+    const std::size_t chunkSize = (size + numWorkers - 1) / numWorkers;
+    std::vector<std::thread> workers;
+    workers.reserve(numWorkers);
+    for (std::size_t w = 0; w < numWorkers && begin + w * chunkSize < end; ++w) {
+        const std::size_t chunkBegin = begin + w * chunkSize;
+        const std::size_t chunkEnd = std::min(chunkBegin + chunkSize, end);
+        workers.emplace_back([&function, &placement, w, chunkBegin, chunkEnd] ()
+        {
+            placement.PinCurrentThread(w);
+            for (std::size_t i = chunkBegin; i < chunkEnd; ++i) {
+                function(i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Аллокатор, размещающий страницы массива по узлам NUMA первым касанием.
+ * Большие массивы выделяются напрямую у операционной системы (страницы ещё
+ * не затронуты), после чего потоки размещения касаются каждой страницы своей
+ * части массива - ядро выделяет её на узле коснувшегося потока. Дальнейшее
+ * конструирование элементов в вызывающем потоке страниц уже не перемещает.
+ * Без размещения ведёт себя как обычный аллокатор
+ */
+template<
+    typename T>
+class NumaAllocator
+{
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    // Освобождение не зависит от размещения, поэтому все аллокаторы взаимозаменяемы
+    using is_always_equal = std::true_type;
+public:
+    NumaAllocator() = default;
+    /**
+     * Конструктор.
+     *
+     * \param placement Размещение потоков (пустое - без размещения)
+     */
+    explicit NumaAllocator(
+        std::shared_ptr<const ThreadPlacement> placement) :
+        m_placement(std::move(placement)) {}
+    template<
+        typename U>
+    NumaAllocator(
+        const NumaAllocator<U>& other) :
+        m_placement(other.GetPlacement()) {}
+
+    T* allocate(
+        const std::size_t n)
+    {
+        const std::size_t bytes = n * sizeof(T);
+        if (bytes < large_size) {
+            return static_cast<T*>(::operator new(bytes));
+        }
+#ifdef _WIN32
+        void* data = VirtualAlloc(nullptr, bytes, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+        if (data == nullptr) {
+            throw std::bad_alloc();
+        }
+#else
+        void* data = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (data == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+#endif
+        if (m_placement) {
+            Touch(static_cast<char*>(data), n);
+        }
+        return static_cast<T*>(data);
+    }
+
+    void deallocate(
+        T* data,
+        const std::size_t n)
+    {
+        const std::size_t bytes = n * sizeof(T);
+        if (bytes < large_size) {
+            ::operator delete(data);
+            return;
+        }
+#ifdef _WIN32
+        VirtualFree(data, 0, MEM_RELEASE);
+#else
+        munmap(data, bytes);
+#endif
+    }
+
+    /**
+     * Получение размещения потоков
+     *
+     * \return Размещение (может быть пустым)
+     */
+    const std::shared_ptr<const ThreadPlacement>& GetPlacement() const
+    {
+        return m_placement;
+    }
+
+    template<
+        typename U>
+    bool operator == (
+        const NumaAllocator<U>&) const
+    {
+        return true;
+    }
+    template<
+        typename U>
+    bool operator != (
+        const NumaAllocator<U>&) const
+    {
+        return false;
+    }
+private:
+    /**
+     * Первое касание страниц: поток w пишет в страницы своей части элементов
+     *
+     * \param data Начало массива
+     * \param n Количество элементов
+     * \return
+     */
+    void Touch(
+        char* data,
+        const std::size_t n) const
+    {
+#ifdef _WIN32
+        const std::size_t pageSize = 4096;
+#else
+        static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#endif
+        const std::size_t numWorkers = std::max<std::size_t>(std::min(m_placement->GetNumThreads(), n), 1);
+        const std::size_t chunkSize = (n + numWorkers - 1) / numWorkers;
+        ParallelFor(0, numWorkers, *m_placement, [&] (const std::size_t w)
+        {
+            const std::size_t begin = std::min(w * chunkSize, n) * sizeof(T);
+            const std::size_t end = std::min((w + 1) * chunkSize, n) * sizeof(T);
+            // Страница на границе частей достаётся тому, кто коснётся её первым
+            for (std::size_t offset = (begin + pageSize - 1) / pageSize * pageSize; offset < end; offset += pageSize) {
+                data[offset] = 0;
+            }
+        });
+    }
+private:
+    // Размер, начиная с которого память выделяется у операционной системы
+    static constexpr std::size_t large_size = std::size_t(1) << 20;
+    // Размещение потоков
+    std::shared_ptr<const ThreadPlacement> m_placement;
+};
+
+}
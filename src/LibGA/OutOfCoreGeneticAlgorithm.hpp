@@ -0,0 +1,471 @@
+﻿#pragma once
+
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+#include <filesystem>
+#ifdef _DEBUG
+#   include <iostream>
+#endif
+
+#include "RealGene.hpp"
+#include "Individual.hpp"
+#include "Selectors.hpp"
+#include "Crossovers.hpp"
+#include "Mutators.hpp"
+#include "Batch.hpp"
+#include "Parallel.hpp"
+#include "MappedStorage.hpp"
+#include "Diversity.hpp"
+#include "Statistics.hpp"
+
+namespace GA
+{
+
+/**
+ * Гистограмма значений приспособленности для отбора без произвольного доступа.
+ * Значение переводится в беззнаковый ключ, сохраняющий порядок
+ * (как при поразрядной сортировке чисел с плавающей точкой), и корзиной
+ * служат старшие 16 битов ключа: знак, порядок и старшие биты мантиссы.
+ * По гистограмме для каждой корзины вычисляется вероятность того,
+ * что особь из неё выиграет турнир размера k среди всей популяции
+ */
+template<
+    typename RealType>
+class FitnessHistogram
+{
+public:
+    // Количество битов ключа, задающих корзину
+    static constexpr std::size_t bin_bits = 16;
+    // Количество корзин
+    static constexpr std::size_t num_bins = std::size_t(1) << bin_bits;
+public:
+    FitnessHistogram() :
+        m_counts(num_bins, 0),
+        m_probabilities(num_bins, 0.0) {}
+
+    /**
+     * Очистка гистограммы
+     *
+     * \return
+     */
+    void Reset()
+    {
+        std::fill(m_counts.begin(), m_counts.end(), 0);
+    }
+
+    /**
+     * Добавление значения
+     *
+     * \param fitness Значение приспособленности
+     * \return
+     */
+    void Add(
+        const RealType fitness)
+    {
+        ++m_counts[GetBin(fitness)];
+    }
+
+    /**
+     * Вычисление вероятностей выбора турниром размера k.
+     * Если в лучших корзинах L особей, а в корзине m, то вероятность
+     * для каждой особи корзины равна ((N - L)ᵏ - (N - L - m)ᵏ) / (Nᵏ m)
+     *
+     * \param tournamentSize Размер турнира k
+     * \return
+     */
+    void Build(
+        const std::size_t tournamentSize)
+    {
+        const double total = static_cast<double>(
+            std::accumulate(m_counts.begin(), m_counts.end(), std::size_t(0)));
+        const double k = static_cast<double>(tournamentSize);
+        double better = 0.0;
+        for (std::size_t bin = 0; bin < num_bins; ++bin) {
+            const double count = static_cast<double>(m_counts[bin]);
+            if (count == 0.0) {
+                m_probabilities[bin] = 0.0;
+                continue;
+            }
+            const double worseOrEqual = (total - better) / total;
+            const double worse = std::max(total - better - count, 0.0) / total;
+            m_probabilities[bin] = (std::pow(worseOrEqual, k) - std::pow(worse, k)) / count;
+            better += count;
+        }
+    }
+
+    /**
+     * Получение вероятности выбора особи турниром
+     *
+     * \param fitness Значение приспособленности
+     * \return Вероятность
+     */
+    double GetProbability(
+        const RealType fitness) const
+    {
+        return m_probabilities[GetBin(fitness)];
+    }
+private:
+    /**
+     * Получение номера корзины значения
+     *
+     * \param fitness Значение приспособленности
+     * \return Номер корзины
+     */
+    static std::size_t GetBin(
+        const RealType fitness)
+    {
+        using key_type = std::conditional_t<sizeof(RealType) == 8, std::uint64_t, std::uint32_t>;
+        static_assert(sizeof(RealType) == sizeof(key_type), "Fitness must be float or double");
+        constexpr std::size_t key_bits = sizeof(key_type) * 8;
+        key_type key;
+        std::memcpy(&key, &fitness, sizeof(key));
+        // У отрицательных чисел инвертируются все биты, у положительных - только знак
+        key = (key >> (key_bits - 1)) != 0 ? static_cast<key_type>(~key)
+            : static_cast<key_type>(key | (key_type(1) << (key_bits - 1)));
+        return static_cast<std::size_t>(key >> (key_bits - bin_bits));
+    }
+private:
+    // Количество особей в корзинах
+    std::vector<std::size_t> m_counts;
+    // Вероятность выбора одной особи корзины
+    std::vector<double> m_probabilities;
+};
+
+/**
+ * Генетический алгоритм для популяций, не помещающихся в оперативную память.
+ * Текущее и следующее поколения хранятся в двух файлах, отображённых в память,
+ * и каждое поколение обрабатывается потоково, частями по chunkSize особей:
+ * 1. Первый проход вычисляет приспособленность и собирает общую гистограмму
+ *    приспособленности (FitnessHistogram).
+ * 2. Второй проход для каждой части вычисляет ожидаемое количество потомков
+ *    (сумму вероятностей выигрыша турнира её особей), округляет его
+ *    систематической выборкой так, что всего потомков ровно N, выбирает
+ *    родителей внутри части таблицей псевдонимов с этими же вероятностями,
+ *    скрещивает и мутирует их и дописывает детей во второй файл.
+ * Отбор эквивалентен турнирному по всей популяции (с точностью до корзины
+ * гистограммы), но пары родителей составляются внутри одной части.
+ * Обработанные части отдаются подсказкой DontNeed, поэтому резидентная
+ * память ограничена несколькими частями, а не размером популяции.
+ * Особь должна быть тривиально копируемой
+ */
+template<
+    typename GeneType,
+    typename Crossover,
+    typename Mutator>
+class OutOfCoreGeneticAlgorithm
+{
+public:
+    // Тип гена
+    using gene_type = GeneType;
+    // Тип особи
+    using individual_type = Individual<GeneType>;
+    // Тип значения гена
+    using value_type = typename GeneType::value_type;
+    // Тип статистики поколения
+    using statistics_type = GenerationStatistics<value_type>;
+    // Тип функции приспособленности
+    using fitness_function = typename individual_type::fitness_function;
+    // Тип хранилища особей
+    using storage_type = MappedArray<individual_type>;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param populationSize Размер популяции
+     * \param chunkSize Количество особей, обрабатываемых за раз
+     * \param directory Каталог для файлов поколений (имена файлов уникальны,
+     *                  поэтому каталог можно разделять между экземплярами)
+     * \param tournamentSize Размер турнира
+     * \param crossover Алгоритм скрещивания
+     * \param mutator Алгоритм мутации
+     */
+    OutOfCoreGeneticAlgorithm(
+        const std::size_t populationSize,
+        const std::size_t chunkSize,
+        const std::filesystem::path& directory,
+        const std::size_t tournamentSize,
+        const Crossover& crossover,
+        const Mutator& mutator) :
+        m_population(MakeUniquePath(directory, "population"), populationSize),
+        m_offspring(MakeUniquePath(directory, "population"), populationSize),
+        m_chunkSize(std::max<std::size_t>(chunkSize, 1)),
+        m_tournamentSize(tournamentSize),
+        m_crossover(crossover),
+        m_mutator(mutator) {}
+
+    /**
+     * Инициализация алгоритма. Популяция генерируется и записывается потоково
+     *
+     * \param generator Алгоритм генерации популяции
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Generator,
+        typename Engine>
+    void Init(
+        const Generator& generator,
+        Engine& engine)
+    {
+        ForEachChunk(m_population, [&] (const Span<individual_type> chunk)
+        {
+            for (auto& individual : chunk) {
+                individual = generator(engine);
+            }
+        });
+    }
+
+    /**
+     * Включение или отключение подсказок madvise (для сравнения)
+     *
+     * \param enabled true - подсказки включены
+     * \return
+     */
+    void SetAdvice(
+        const bool enabled)
+    {
+        m_advice = enabled;
+    }
+
+    /**
+     * Задание количества потоков для вычисления приспособленности.
+     * Функция приспособленности должна допускать вызов из нескольких потоков
+     *
+     * \param numThreads Количество потоков (0 - по числу ядер, 1 - последовательно)
+     * \return
+     */
+    void SetEvaluationThreads(
+        const std::size_t numThreads)
+    {
+        m_evaluationThreads = numThreads;
+    }
+
+    /**
+     * Получение статистики последнего запуска по поколениям
+     *
+     * \return Статистика поколений
+     */
+    const std::vector<statistics_type>& GetStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /**
+     * Получение наиболее приспособленной особи, найденной при последнем вычислении
+     *
+     * \return Особь
+     */
+    const individual_type& GetBestIndividual() const
+    {
+        return m_best;
+    }
+
+    /**
+     * Запуск генетического алгоритма
+     *
+     * \param numGenerations Количество поколений
+     * \param fitnessFunction Функция приспособленности
+     * \param engine Движок генерации случайных чисел
+     * \return Решение (значение функции приспособленности наиболее приспособленной особи)
+     */
+    template<
+        typename Engine>
+    value_type Run(
+        const std::size_t numGenerations,
+        const fitness_function& fitnessFunction,
+        Engine& engine)
+    {
+        m_statistics.clear();
+        for (std::size_t i = 0; i < numGenerations; ++i) {
+#ifdef _DEBUG
+            std::cout << "Generation " << i << std::endl;
+#endif
+            Evaluate(fitnessFunction, i);
+            Breed(engine);
+            m_population.Swap(m_offspring);
+#ifdef _DEBUG
+            std::cout << std::endl;
+#endif
+        }
+        Evaluate(fitnessFunction, numGenerations);
+        return m_best.GetFitness();
+    }
+private:
+    /**
+     * Последовательный обход частей хранилища с подсказками:
+     * следующая часть запрашивается заранее, обработанная - отдаётся
+     *
+     * \param storage Хранилище
+     * \param function Обработчик части, вызывается как function(chunk)
+     * \return
+     */
+    template<
+        typename Function>
+    void ForEachChunk(
+        const storage_type& storage,
+        const Function& function)
+    {
+        const std::size_t size = storage.GetSize();
+        if (m_advice) {
+            storage.Advise(0, size, storage_type::Advice::Sequential);
+        }
+        for (std::size_t begin = 0; begin < size; begin += m_chunkSize) {
+            const std::size_t count = std::min(m_chunkSize, size - begin);
+            if (m_advice && begin + count < size) {
+                storage.Advise(begin + count, std::min(m_chunkSize, size - begin - count),
+                    storage_type::Advice::WillNeed);
+            }
+            function(storage.GetSpan(begin, count));
+            if (m_advice) {
+                storage.Advise(begin, count, storage_type::Advice::DontNeed);
+            }
+        }
+    }
+
+    /**
+     * Первый проход: вычисление приспособленности, гистограммы и статистики
+     *
+     * \param fitnessFunction Функция приспособленности
+     * \param generation Номер поколения
+     * \return
+     */
+    void Evaluate(
+        const fitness_function& fitnessFunction,
+        const std::size_t generation)
+    {
+        m_histogram.Reset();
+        RunningVariance genes;
+        double fitnessSum = 0.0;
+        bool hasBest = false;
+        ForEachChunk(m_population, [&] (const Span<individual_type> chunk)
+        {
+            ParallelFor(0, chunk.GetSize(), m_evaluationThreads, [&] (const std::size_t i)
+            {
+                chunk[i].CalculateFitness(fitnessFunction);
+            });
+            for (const auto& individual : chunk) {
+                m_histogram.Add(individual.GetFitness());
+                fitnessSum += individual.GetFitness();
+                genes.Add(individual());
+                if (!hasBest || individual.GetFitness() < m_best.GetFitness()) {
+                    m_best = individual;
+                    hasBest = true;
+                }
+            }
+        });
+        m_histogram.Build(m_tournamentSize);
+        statistics_type statistics;
+        statistics.generation = generation;
+        if (m_population.GetSize() > 0) {
+            statistics.bestFitness = m_best.GetFitness();
+            statistics.meanFitness = static_cast<value_type>(fitnessSum / m_population.GetSize());
+        }
+        statistics.geneMean = genes.GetMean();
+        statistics.geneVariance = genes.GetVariance();
+        statistics.numEvaluations = m_population.GetSize();
+        m_statistics.push_back(statistics);
+    }
+
+    /**
+     * Второй проход: отбор родителей внутри частей, скрещивание и мутация.
+     * Дети дописываются в m_offspring последовательно
+     *
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void Breed(
+        Engine& engine)
+    {
+        const std::size_t size = m_population.GetSize();
+        // Систематическая выборка: один случайный сдвиг на все части
+        const double offset = std::uniform_real_distribution<double>(0.0, 1.0)(engine);
+        double expected = 0.0;
+        std::size_t written = 0;
+        std::size_t chunkBegin = 0;
+        ForEachChunk(m_population, [&] (const Span<individual_type> chunk)
+        {
+            chunkBegin += chunk.GetSize();
+            m_weights.resize(chunk.GetSize());
+            double chunkExpected = 0.0;
+            for (std::size_t i = 0; i < chunk.GetSize(); ++i) {
+                m_weights[i] = m_histogram.GetProbability(chunk[i].GetFitness());
+                chunkExpected += m_weights[i];
+            }
+            expected += chunkExpected * size;
+            // Последняя часть забирает остаток, накопленный ошибками округления
+            const std::size_t total = chunkBegin == size ? size
+                : std::min(static_cast<std::size_t>(std::floor(expected + offset)), size);
+            const std::size_t count = total > written ? total - written : 0;
+            if (count == 0) {
+                return;
+            }
+            m_table.Build(m_weights);
+            m_parentIndices.resize(count);
+            for (auto& index : m_parentIndices) {
+                index = m_table.Sample(engine);
+            }
+            const auto children = m_offspring.GetSpan(written, count);
+            const Span<const individual_type> parents = chunk;
+            const std::size_t numCrossed = count - count % 2;
+            CrossoverBatch(m_crossover, parents,
+                Span<const std::size_t>(m_parentIndices).SubSpan(0, numCrossed),
+                children.SubSpan(0, numCrossed), engine);
+            // Нечётный последний ребёнок - копия своего родителя
+            if (numCrossed < count) {
+                children[numCrossed] = parents[m_parentIndices[numCrossed]];
+            }
+            MutateBatch(m_mutator, children, engine);
+            if (m_advice) {
+                m_offspring.Advise(written, count, storage_type::Advice::DontNeed);
+            }
+            written += count;
+        });
+    }
+private:
+    // Текущее поколение
+    storage_type m_population;
+    // Следующее поколение
+    storage_type m_offspring;
+    // Количество особей, обрабатываемых за раз
+    std::size_t m_chunkSize;
+    // Размер турнира
+    std::size_t m_tournamentSize;
+    // Алгоритм скрещивания
+    Crossover m_crossover;
+    // Алгоритм мутации
+    Mutator m_mutator;
+    // Гистограмма приспособленности текущего поколения
+    FitnessHistogram<value_type> m_histogram;
+    // Вероятности выбора особей текущей части
+    std::vector<double> m_weights;
+    // Таблица псевдонимов для выбора родителей текущей части
+    AliasTable m_table;
+    // Индексы выбранных родителей текущей части
+    std::vector<std::size_t> m_parentIndices;
+    // Наиболее приспособленная особь
+    individual_type m_best;
+    // Статистика поколений
+    std::vector<statistics_type> m_statistics;
+    // Флаг использования подсказок madvise
+    bool m_advice = true;
+    // Количество потоков вычисления приспособленности
+    std::size_t m_evaluationThreads = 1;
+};
+
+// Тип для вещественного генетического алгоритма с внешним хранением популяции
+template<
+    typename RealType>
+using OutOfCoreRealGeneticAlgorithm = OutOfCoreGeneticAlgorithm<
+    RealGene<RealType>,
+    BlendCrossover<RealType>,
+    GaussianMutator<RealType>>;
+
+}
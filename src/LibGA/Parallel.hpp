@@ -0,0 +1,249 @@
+﻿#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <condition_variable>
+
+namespace GA
+{
+
+/**
+ * Получение количества потоков
+ *
+ * \param numThreads Запрошенное количество потоков (0 - по числу ядер)
+ * \return Количество потоков, не меньше 1
+ */
+inline std::size_t GetNumThreads(
+    const std::size_t numThreads)
+{
+    if (numThreads > 0) {
+        return numThreads;
+    }
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+/**
+ * Параллельный цикл по диапазону [begin, end).
+ * Диапазон делится на непрерывные части по количеству потоков,
+ * последнюю часть обрабатывает вызывающий поток
+ *
+ * \param begin Начало диапазона
+ * \param end Конец диапазона
+ * \param numThreads Количество потоков (0 - по числу ядер)
+ * \param function Тело цикла, вызывается как function(index)
+ * \return
+ */
+template<
+    typename Function>
+void ParallelFor(
+    const std::size_t begin,
+    const std::size_t end,
+    const std::size_t numThreads,
+    const Function& function)
+{
+    if (begin >= end) {
+        return;
+    }
+    const std::size_t size = end - begin;
+    const std::size_t numWorkers = std::min(GetNumThreads(numThreads), size);
+    if (numWorkers == 1) {
+        for (std::size_t i = begin; i < end; ++i) {
+            function(i);
+        }
+        return;
+    }
+    const std::size_t chunkSize = (size + numWorkers - 1) / numWorkers;
+    std::vector<std::thread> workers;
+    workers.reserve(numWorkers - 1);
+    for (std::size_t chunkBegin = begin + chunkSize; chunkBegin < end; chunkBegin += chunkSize) {
+        const std::size_t chunkEnd = std::min(chunkBegin + chunkSize, end);
+        workers.emplace_back([&function, chunkBegin, chunkEnd] ()
+        {
+            for (std::size_t i = chunkBegin; i < chunkEnd; ++i) {
+                function(i);
+            }
+        });
+    }
+    for (std::size_t i = begin; i < std::min(begin + chunkSize, end); ++i) {
+        function(i);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+/**
+ * Пул потоков для параллельных циклов с динамическим распределением частей.
+ * Потоки создаются один раз и ждут работы, поэтому запуск цикла стоит
+ * одного пробуждения потоков, а не их создания. Части диапазона выдаются
+ * потокам по мере освобождения, что выравнивает нагрузку при неравной
+ * стоимости итераций. Циклы запускаются из одного потока, по одному за раз
+ */
+class ThreadPool
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param numThreads Количество потоков, включая вызывающий (0 - по числу ядер)
+     */
+    explicit ThreadPool(
+        const std::size_t numThreads)
+    {
+        const std::size_t numWorkers = GA::GetNumThreads(numThreads) - 1;
+        m_workers.reserve(numWorkers);
+        for (std::size_t w = 0; w < numWorkers; ++w) {
+            m_workers.emplace_back([this] ()
+            {
+                WorkerLoop();
+            });
+        }
+    }
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator = (const ThreadPool&) = delete;
+
+    /**
+     * Получение количества потоков, включая вызывающий
+     *
+     * \return Количество потоков
+     */
+    std::size_t GetNumThreads() const
+    {
+        return m_workers.size() + 1;
+    }
+
+    /**
+     * Параллельный цикл по диапазону [begin, end) частями по chunkSize итераций.
+     * Вызывающий поток тоже обрабатывает части и возвращается после завершения всех
+     *
+     * \param begin Начало диапазона
+     * \param end Конец диапазона
+     * \param chunkSize Размер части (0 - как 1)
+     * \param function Тело цикла, вызывается как function(index)
+     * \return
+     */
+    template<
+        typename Function>
+    void ParallelFor(
+        const std::size_t begin,
+        const std::size_t end,
+        const std::size_t chunkSize,
+        const Function& function)
+    {
+        if (begin >= end) {
+            return;
+        }
+        const std::size_t chunk = std::max<std::size_t>(chunkSize, 1);
+        if (m_workers.empty() || end - begin <= chunk) {
+            for (std::size_t i = begin; i < end; ++i) {
+                function(i);
+            }
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_function = &function;
+            m_invoke = [] (const void* body, const std::size_t first, const std::size_t last)
+            {
+                const auto& loopBody = *static_cast<const Function*>(body);
+                for (std::size_t i = first; i < last; ++i) {
+                    loopBody(i);
+                }
+            };
+            m_next.store(begin, std::memory_order_relaxed);
+            m_end = end;
+            m_chunkSize = chunk;
+            m_numBusy = m_workers.size();
+            ++m_generation;
+        }
+        m_wake.notify_all();
+        RunChunks();
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_finished.wait(lock, [this] () { return m_numBusy == 0; });
+    }
+private:
+    /**
+     * Цикл рабочего потока: ожидание нового цикла и обработка его частей
+     *
+     * \return
+     */
+    void WorkerLoop()
+    {
+        std::uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [&] () { return m_stop || m_generation != seen; });
+                if (m_stop) {
+                    return;
+                }
+                seen = m_generation;
+            }
+            RunChunks();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (--m_numBusy == 0) {
+                    m_finished.notify_one();
+                }
+            }
+        }
+    }
+
+    /**
+     * Обработка частей текущего цикла, пока они не закончатся
+     *
+     * \return
+     */
+    void RunChunks()
+    {
+        for (;;) {
+            const std::size_t first = m_next.fetch_add(m_chunkSize, std::memory_order_relaxed);
+            if (first >= m_end) {
+                return;
+            }
+            m_invoke(m_function, first, std::min(first + m_chunkSize, m_end));
+        }
+    }
+private:
+    // Рабочие потоки
+    std::vector<std::thread> m_workers;
+    // Защищает параметры цикла и счётчики ниже
+    std::mutex m_mutex;
+    // Пробуждение рабочих потоков для нового цикла или остановки
+    std::condition_variable m_wake;
+    // Завершение текущего цикла всеми рабочими потоками
+    std::condition_variable m_finished;
+    // Номер текущего цикла
+    std::uint64_t m_generation = 0;
+    // Количество рабочих потоков, ещё обрабатывающих текущий цикл
+    std::size_t m_numBusy = 0;
+    // Флаг остановки пула
+    bool m_stop = false;
+    // Тело текущего цикла
+    const void* m_function = nullptr;
+    // Вызов тела цикла для итераций [first, last)
+    void (*m_invoke)(const void*, std::size_t, std::size_t) = nullptr;
+    // Начало следующей невыданной части
+    std::atomic<std::size_t> m_next { 0 };
+    // Конец диапазона текущего цикла
+    std::size_t m_end = 0;
+    // Размер части
+    std::size_t m_chunkSize = 1;
+};
+
+}
@@ -0,0 +1,402 @@
+﻿#pragma once
+
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+#include "Batch.hpp"
+
+namespace GA
+{
+
+/**
+ * Изменение перестановки, сделанное мутатором.
+ * По описанию изменения функция приспособленности может пересчитать
+ * значение за O(1), не проходя по всей перестановке
+ */
+struct PermutationMove
+{
+    // Вид изменения
+    enum class Type
+    {
+        // Обмен элементов на позициях first и second
+        Swap,
+        // Элемент с позиции first переносится так, что оказывается на позиции second
+        Insertion,
+        // Участок [first, second] разворачивается (2-opt), first <= second
+        Reversal
+    };
+
+    // Вид изменения
+    Type type = Type::Swap;
+    // Первая позиция
+    std::size_t first = 0;
+    // Вторая позиция
+    std::size_t second = 0;
+};
+
+/**
+ * Хромосома-перестановка чисел 0..n-1.
+ * Вместе с порядком элементов хранится обратная таблица - позиция каждого
+ * элемента, поэтому поиск элемента в перестановке выполняется за O(1).
+ * Операции изменения поддерживают обе таблицы согласованными
+ */
+template<
+    typename IndexType = std::uint32_t>
+class Permutation
+{
+    static_assert(std::is_unsigned_v<IndexType>, "Permutation elements must be unsigned");
+public:
+    // Тип элемента
+    using index_type = IndexType;
+public:
+    Permutation() = default;
+    /**
+     * Конструктор. Создаёт тождественную перестановку
+     *
+     * \param size Количество элементов
+     */
+    explicit Permutation(
+        const std::size_t size) :
+        m_order(size),
+        m_positions(size)
+    {
+        std::iota(m_order.begin(), m_order.end(), static_cast<IndexType>(0));
+        std::iota(m_positions.begin(), m_positions.end(), static_cast<IndexType>(0));
+    }
+
+    /**
+     * Случайное перемешивание
+     *
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void Shuffle(
+        Engine& engine)
+    {
+        std::shuffle(m_order.begin(), m_order.end(), engine);
+        UpdatePositions();
+    }
+
+    /**
+     * Получение количества элементов
+     *
+     * \return Количество элементов
+     */
+    std::size_t GetSize() const
+    {
+        return m_order.size();
+    }
+    /**
+     * Получение элемента на позиции
+     *
+     * \param position Позиция
+     * \return Элемент
+     */
+    IndexType operator [] (
+        const std::size_t position) const
+    {
+        return m_order[position];
+    }
+    /**
+     * Получение позиции элемента за O(1)
+     *
+     * \param element Элемент
+     * \return Позиция
+     */
+    std::size_t GetPosition(
+        const IndexType element) const
+    {
+        return m_positions[element];
+    }
+    /**
+     * Получение порядка элементов
+     *
+     * \return Элементы по позициям
+     */
+    Span<const IndexType> GetOrder() const
+    {
+        return m_order;
+    }
+    /**
+     * Получение порядка элементов для записи.
+     * После записи нужно вызвать UpdatePositions
+     *
+     * \return Элементы по позициям
+     */
+    Span<IndexType> GetOrder()
+    {
+        return m_order;
+    }
+    /**
+     * Изменение количества элементов без инициализации.
+     * Порядок нужно заполнить через GetOrder и вызвать UpdatePositions
+     *
+     * \param size Количество элементов
+     * \return
+     */
+    void Resize(
+        const std::size_t size)
+    {
+        m_order.resize(size);
+        m_positions.resize(size);
+    }
+    /**
+     * Восстановление таблицы позиций по порядку элементов
+     *
+     * \return
+     */
+    void UpdatePositions()
+    {
+        UpdatePositions(0, m_order.size());
+    }
+
+    /**
+     * Применение изменения
+     *
+     * \param move Изменение
+     * \return
+     */
+    void Apply(
+        const PermutationMove& move)
+    {
+        switch (move.type) {
+        case PermutationMove::Type::Swap:
+            Swap(move.first, move.second);
+            break;
+        case PermutationMove::Type::Insertion:
+            Move(move.first, move.second);
+            break;
+        case PermutationMove::Type::Reversal:
+            Reverse(move.first, move.second);
+            break;
+        }
+    }
+    /**
+     * Обмен элементов на двух позициях за O(1)
+     *
+     * \param position1 Первая позиция
+     * \param position2 Вторая позиция
+     * \return
+     */
+    void Swap(
+        const std::size_t position1,
+        const std::size_t position2)
+    {
+        std::swap(m_order[position1], m_order[position2]);
+        m_positions[m_order[position1]] = static_cast<IndexType>(position1);
+        m_positions[m_order[position2]] = static_cast<IndexType>(position2);
+    }
+    /**
+     * Перенос элемента с позиции from на позицию to.
+     * Сдвигаются только элементы между этими позициями
+     *
+     * \param from Исходная позиция
+     * \param to Новая позиция
+     * \return
+     */
+    void Move(
+        const std::size_t from,
+        const std::size_t to)
+    {
+        if (from < to) {
+            std::rotate(m_order.begin() + from, m_order.begin() + from + 1, m_order.begin() + to + 1);
+            UpdatePositions(from, to + 1);
+        }
+        else if (to < from) {
+            std::rotate(m_order.begin() + to, m_order.begin() + from, m_order.begin() + from + 1);
+            UpdatePositions(to, from + 1);
+        }
+    }
+    /**
+     * Разворот участка [first, last]
+     *
+     * \param first Первая позиция участка
+     * \param last Последняя позиция участка
+     * \return
+     */
+    void Reverse(
+        const std::size_t first,
+        const std::size_t last)
+    {
+        std::reverse(m_order.begin() + first, m_order.begin() + last + 1);
+        UpdatePositions(first, last + 1);
+    }
+private:
+    /**
+     * Восстановление позиций элементов участка [first, last)
+     *
+     * \param first Первая позиция
+     * \param last Позиция за последней
+     * \return
+     */
+    void UpdatePositions(
+        const std::size_t first,
+        const std::size_t last)
+    {
+        for (std::size_t i = first; i < last; ++i) {
+            m_positions[m_order[i]] = static_cast<IndexType>(i);
+        }
+    }
+private:
+    // Элементы по позициям
+    std::vector<IndexType> m_order;
+    // Позиции по элементам
+    std::vector<IndexType> m_positions;
+};
+
+/**
+ * Длина замкнутого маршрута коммивояжёра на плоскости.
+ * Расстояния вычисляются по координатам городов, поэтому память линейна
+ * по числу городов. Кроме полного вычисления за O(n) поддерживается
+ * пересчёт по изменению PermutationMove за O(1).
+ * Вызовы допускаются из нескольких потоков
+ */
+template<
+    typename RealType>
+class TourLength
+{
+public:
+    // Тип значения
+    using value_type = RealType;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param x Координаты городов по оси X
+     * \param y Координаты городов по оси Y
+     */
+    TourLength(
+        std::vector<RealType> x,
+        std::vector<RealType> y) :
+        m_x(std::move(x)),
+        m_y(std::move(y)) {}
+
+    /**
+     * Получение количества городов
+     *
+     * \return Количество городов
+     */
+    std::size_t GetSize() const
+    {
+        return m_x.size();
+    }
+
+    /**
+     * Вычисление длины маршрута за O(n)
+     *
+     * \param tour Маршрут
+     * \return Длина маршрута
+     */
+    template<
+        typename IndexType>
+    RealType operator () (
+        const Permutation<IndexType>& tour) const
+    {
+        const std::size_t size = tour.GetSize();
+        RealType length = static_cast<RealType>(0);
+        for (std::size_t i = 0; i < size; ++i) {
+            length += GetDistance(tour[i], tour[i + 1 < size ? i + 1 : 0]);
+        }
+        return length;
+    }
+
+    /**
+     * Изменение длины маршрута после применения move за O(1).
+     * Маршрут должен быть ещё не изменён
+     *
+     * \param tour Маршрут до изменения
+     * \param move Изменение
+     * \return Новая длина минус старая
+     */
+    template<
+        typename IndexType>
+    RealType Delta(
+        const Permutation<IndexType>& tour,
+        const PermutationMove& move) const
+    {
+        const std::size_t size = tour.GetSize();
+        if (size < 3 || move.first == move.second) {
+            return static_cast<RealType>(0);
+        }
+        const auto next = [size] (const std::size_t position) { return position + 1 < size ? position + 1 : 0; };
+        const auto previous = [size] (const std::size_t position) { return position > 0 ? position - 1 : size - 1; };
+        switch (move.type) {
+        case PermutationMove::Type::Swap: {
+            // Изменяются только рёбра, выходящие из двух позиций.
+            // Ребро k соединяет позиции k и k + 1; у соседних позиций рёбра общие
+            const std::size_t edges[] = { previous(move.first), move.first, previous(move.second), move.second };
+            const auto at = [&] (const std::size_t position)
+            {
+                return tour[position == move.first ? move.second : position == move.second ? move.first : position];
+            };
+            RealType delta = static_cast<RealType>(0);
+            for (std::size_t i = 0; i < 4; ++i) {
+                if (std::find(edges, edges + i, edges[i]) != edges + i) {
+                    continue;
+                }
+                delta += GetDistance(at(edges[i]), at(next(edges[i])))
+                    - GetDistance(tour[edges[i]], tour[next(edges[i])]);
+            }
+            return delta;
+        }
+        case PermutationMove::Type::Insertion: {
+            // Элемент вынимается, его соседи соединяются напрямую,
+            // затем он вставляется в ребро оставшегося маршрута из n - 1 городов
+            const IndexType element = tour[move.first];
+            const auto remaining = [&] (const std::size_t position)
+            {
+                return tour[position < move.first ? position : position + 1];
+            };
+            const IndexType before = remaining(move.second > 0 ? move.second - 1 : size - 2);
+            const IndexType after = remaining(move.second < size - 1 ? move.second : 0);
+            const IndexType left = tour[previous(move.first)];
+            const IndexType right = tour[next(move.first)];
+            return GetDistance(left, right) - GetDistance(left, element) - GetDistance(element, right)
+                + GetDistance(before, element) + GetDistance(element, after) - GetDistance(before, after);
+        }
+        case PermutationMove::Type::Reversal: {
+            // Маршрут симметричен: меняются только два ребра на концах участка
+            if (move.first == 0 && move.second == size - 1) {
+                return static_cast<RealType>(0);
+            }
+            const IndexType left = tour[previous(move.first)];
+            const IndexType right = tour[next(move.second)];
+            const IndexType first = tour[move.first];
+            const IndexType last = tour[move.second];
+            return GetDistance(left, last) + GetDistance(first, right)
+                - GetDistance(left, first) - GetDistance(last, right);
+        }
+        }
+        return static_cast<RealType>(0);
+    }
+
+    /**
+     * Расстояние между городами
+     *
+     * \param city1 Первый город
+     * \param city2 Второй город
+     * \return Расстояние
+     */
+    RealType GetDistance(
+        const std::size_t city1,
+        const std::size_t city2) const
+    {
+        const RealType dx = m_x[city1] - m_x[city2];
+        const RealType dy = m_y[city1] - m_y[city2];
+        return std::sqrt(dx * dx + dy * dy);
+    }
+private:
+    // Координаты городов по оси X
+    std::vector<RealType> m_x;
+    // Координаты городов по оси Y
+    std::vector<RealType> m_y;
+};
+
+}
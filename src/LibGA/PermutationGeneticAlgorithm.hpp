@@ -0,0 +1,790 @@
+﻿#pragma once
+
+#include <limits>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+#ifdef _DEBUG
+#   include <iostream>
+#endif
+
+#include "Parallel.hpp"
+#include "Statistics.hpp"
+#include "Permutation.hpp"
+
+namespace GA
+{
+
+/**
+ * Проверка, умеет ли функция приспособленности пересчитывать значение
+ * по изменению перестановки (метод Delta(permutation, move))
+ */
+template<
+    typename Fitness,
+    typename PermutationType,
+    typename = void>
+struct has_delta_fitness : std::false_type {};
+
+template<
+    typename Fitness,
+    typename PermutationType>
+struct has_delta_fitness<
+    Fitness,
+    PermutationType,
+    std::void_t<decltype(std::declval<const Fitness&>().Delta(
+        std::declval<const PermutationType&>(),
+        std::declval<const PermutationMove&>()))>> : std::true_type {};
+
+template<
+    typename Fitness,
+    typename PermutationType>
+inline constexpr bool has_delta_fitness_v = has_delta_fitness<Fitness, PermutationType>::value;
+
+/**
+ * Упорядоченное скрещивание (OX).
+ * Ребёнок получает участок первого родителя на тех же позициях, остальные
+ * позиции заполняются элементами второго родителя в его порядке, начиная
+ * за участком. Принадлежность элемента участку проверяется по таблице
+ * позиций первого родителя за O(1), поэтому скрещивание занимает O(n)
+ */
+template<
+    typename IndexType = std::uint32_t>
+class OrderCrossover
+{
+public:
+    // Тип хромосомы
+    using permutation_type = Permutation<IndexType>;
+public:
+    /**
+     * Применение скрещивания. Оба ребёнка строятся по одному участку
+     *
+     * \param parent1 Первый родитель
+     * \param parent2 Второй родитель
+     * \param child1 Первый ребёнок (участок первого родителя)
+     * \param child2 Второй ребёнок (участок второго родителя)
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void operator() (
+        const permutation_type& parent1,
+        const permutation_type& parent2,
+        permutation_type& child1,
+        permutation_type& child2,
+        Engine& engine) const
+    {
+#ifdef _DEBUG
+        std::cout << "\tOrder Crossover" << std::endl;
+#endif
+        std::uniform_int_distribution<std::size_t> distribution(0, parent1.GetSize() - 1);
+        std::size_t first = distribution(engine);
+        std::size_t last = distribution(engine);
+        if (first > last) {
+            std::swap(first, last);
+        }
+        Cross(parent1, parent2, first, last, child1);
+        Cross(parent2, parent1, first, last, child2);
+    }
+private:
+    /**
+     * Построение одного ребёнка
+     *
+     * \param donor Родитель, дающий участок
+     * \param other Родитель, задающий порядок остальных элементов
+     * \param first Первая позиция участка
+     * \param last Последняя позиция участка
+     * \param child Ребёнок
+     * \return
+     */
+    static void Cross(
+        const permutation_type& donor,
+        const permutation_type& other,
+        const std::size_t first,
+        const std::size_t last,
+        permutation_type& child)
+    {
+        const std::size_t size = donor.GetSize();
+        child.Resize(size);
+        const auto order = child.GetOrder();
+        for (std::size_t i = first; i <= last; ++i) {
+            order[i] = donor[i];
+        }
+        std::size_t position = last + 1 < size ? last + 1 : 0;
+        std::size_t source = position;
+        for (std::size_t k = 0; k < size; ++k) {
+            const IndexType element = other[source];
+            source = source + 1 < size ? source + 1 : 0;
+            const std::size_t donorPosition = donor.GetPosition(element);
+            if (donorPosition >= first && donorPosition <= last) {
+                continue;
+            }
+            order[position] = element;
+            position = position + 1 < size ? position + 1 : 0;
+        }
+        child.UpdatePositions();
+    }
+};
+
+/**
+ * Частично отображающее скрещивание (PMX).
+ * Ребёнок получает участок первого родителя, остальные позиции - элементы
+ * второго родителя; конфликтующий элемент заменяется по цепочке отображения
+ * участка. Каждый шаг цепочки - обращение к таблице позиций за O(1)
+ * вместо линейного поиска
+ */
+template<
+    typename IndexType = std::uint32_t>
+class PartiallyMappedCrossover
+{
+public:
+    // Тип хромосомы
+    using permutation_type = Permutation<IndexType>;
+public:
+    /**
+     * Применение скрещивания. Оба ребёнка строятся по одному участку
+     *
+     * \param parent1 Первый родитель
+     * \param parent2 Второй родитель
+     * \param child1 Первый ребёнок (участок первого родителя)
+     * \param child2 Второй ребёнок (участок второго родителя)
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void operator() (
+        const permutation_type& parent1,
+        const permutation_type& parent2,
+        permutation_type& child1,
+        permutation_type& child2,
+        Engine& engine) const
+    {
+#ifdef _DEBUG
+        std::cout << "\tPartially Mapped Crossover" << std::endl;
+#endif
+        std::uniform_int_distribution<std::size_t> distribution(0, parent1.GetSize() - 1);
+        std::size_t first = distribution(engine);
+        std::size_t last = distribution(engine);
+        if (first > last) {
+            std::swap(first, last);
+        }
+        Cross(parent1, parent2, first, last, child1);
+        Cross(parent2, parent1, first, last, child2);
+    }
+private:
+    /**
+     * Построение одного ребёнка
+     *
+     * \param donor Родитель, дающий участок
+     * \param other Родитель, дающий остальные элементы
+     * \param first Первая позиция участка
+     * \param last Последняя позиция участка
+     * \param child Ребёнок
+     * \return
+     */
+    static void Cross(
+        const permutation_type& donor,
+        const permutation_type& other,
+        const std::size_t first,
+        const std::size_t last,
+        permutation_type& child)
+    {
+        const std::size_t size = donor.GetSize();
+        child.Resize(size);
+        const auto order = child.GetOrder();
+        for (std::size_t i = 0; i < size; ++i) {
+            if (i >= first && i <= last) {
+                order[i] = donor[i];
+                continue;
+            }
+            // Элемент уже занят участком: берём элемент второго родителя
+            // с той позиции, на которой он стоит в участке, и так далее
+            IndexType element = other[i];
+            std::size_t position = donor.GetPosition(element);
+            while (position >= first && position <= last) {
+                element = other[position];
+                position = donor.GetPosition(element);
+            }
+            order[i] = element;
+        }
+        child.UpdatePositions();
+    }
+};
+
+/**
+ * Мутатор, меняющий местами два случайных элемента
+ */
+template<
+    typename IndexType = std::uint32_t>
+class SwapMutator
+{
+public:
+    // Тип хромосомы
+    using permutation_type = Permutation<IndexType>;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param mutation Коэффициент мутации
+     */
+    SwapMutator(
+        const double mutation) :
+        m_mutation(mutation) {}
+
+    /**
+     * Выбор изменения без применения
+     *
+     * \param permutation Хромосома
+     * \param move Выбранное изменение
+     * \param engine Движок генерации случайных чисел
+     * \return Нужно ли мутировать хромосому
+     */
+    template<
+        typename Engine>
+    bool Propose(
+        const permutation_type& permutation,
+        PermutationMove& move,
+        Engine& engine) const
+    {
+        if (permutation.GetSize() < 2 || m_mutationDistribution(engine) <= m_mutation) {
+            return false;
+        }
+        std::uniform_int_distribution<std::size_t> position(0, permutation.GetSize() - 1);
+        std::uniform_int_distribution<std::size_t> offset(1, permutation.GetSize() - 1);
+        const std::size_t position1 = position(engine);
+        const std::size_t position2 = (position1 + offset(engine)) % permutation.GetSize();
+        move = { PermutationMove::Type::Swap, std::min(position1, position2), std::max(position1, position2) };
+        return true;
+    }
+
+    /**
+     * Применение мутатора к хромосоме
+     *
+     * \param permutation Хромосома
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void operator() (
+        permutation_type& permutation,
+        Engine& engine) const
+    {
+        PermutationMove move;
+        if (Propose(permutation, move, engine)) {
+            permutation.Apply(move);
+        }
+    }
+private:
+    // Распределение для генерации коэффициента мутации
+    mutable std::uniform_real_distribution<double> m_mutationDistribution;
+    // Коэффициент мутации
+    double m_mutation;
+};
+
+/**
+ * Мутатор, переносящий случайный элемент на случайную позицию
+ */
+template<
+    typename IndexType = std::uint32_t>
+class InsertionMutator
+{
+public:
+    // Тип хромосомы
+    using permutation_type = Permutation<IndexType>;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param mutation Коэффициент мутации
+     */
+    InsertionMutator(
+        const double mutation) :
+        m_mutation(mutation) {}
+
+    /**
+     * Выбор изменения без применения
+     *
+     * \param permutation Хромосома
+     * \param move Выбранное изменение
+     * \param engine Движок генерации случайных чисел
+     * \return Нужно ли мутировать хромосому
+     */
+    template<
+        typename Engine>
+    bool Propose(
+        const permutation_type& permutation,
+        PermutationMove& move,
+        Engine& engine) const
+    {
+        const std::size_t size = permutation.GetSize();
+        if (size < 2 || m_mutationDistribution(engine) <= m_mutation) {
+            return false;
+        }
+        std::uniform_int_distribution<std::size_t> position(0, size - 1);
+        std::uniform_int_distribution<std::size_t> offset(1, size - 1);
+        const std::size_t from = position(engine);
+        move = { PermutationMove::Type::Insertion, from, (from + offset(engine)) % size };
+        return true;
+    }
+
+    /**
+     * Применение мутатора к хромосоме
+     *
+     * \param permutation Хромосома
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void operator() (
+        permutation_type& permutation,
+        Engine& engine) const
+    {
+        PermutationMove move;
+        if (Propose(permutation, move, engine)) {
+            permutation.Apply(move);
+        }
+    }
+private:
+    // Распределение для генерации коэффициента мутации
+    mutable std::uniform_real_distribution<double> m_mutationDistribution;
+    // Коэффициент мутации
+    double m_mutation;
+};
+
+/**
+ * Мутатор 2-opt: разворот случайного участка.
+ * Для маршрута это замена двух рёбер двумя другими
+ */
+template<
+    typename IndexType = std::uint32_t>
+class TwoOptMutator
+{
+public:
+    // Тип хромосомы
+    using permutation_type = Permutation<IndexType>;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param mutation Коэффициент мутации
+     */
+    TwoOptMutator(
+        const double mutation) :
+        m_mutation(mutation) {}
+
+    /**
+     * Выбор изменения без применения
+     *
+     * \param permutation Хромосома
+     * \param move Выбранное изменение
+     * \param engine Движок генерации случайных чисел
+     * \return Нужно ли мутировать хромосому
+     */
+    template<
+        typename Engine>
+    bool Propose(
+        const permutation_type& permutation,
+        PermutationMove& move,
+        Engine& engine) const
+    {
+        const std::size_t size = permutation.GetSize();
+        if (size < 2 || m_mutationDistribution(engine) <= m_mutation) {
+            return false;
+        }
+        std::uniform_int_distribution<std::size_t> position(0, size - 1);
+        std::uniform_int_distribution<std::size_t> offset(1, size - 1);
+        const std::size_t position1 = position(engine);
+        const std::size_t position2 = (position1 + offset(engine)) % size;
+        move = { PermutationMove::Type::Reversal, std::min(position1, position2), std::max(position1, position2) };
+        return true;
+    }
+
+    /**
+     * Применение мутатора к хромосоме
+     *
+     * \param permutation Хромосома
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void operator() (
+        permutation_type& permutation,
+        Engine& engine) const
+    {
+        PermutationMove move;
+        if (Propose(permutation, move, engine)) {
+            permutation.Apply(move);
+        }
+    }
+private:
+    // Распределение для генерации коэффициента мутации
+    mutable std::uniform_real_distribution<double> m_mutationDistribution;
+    // Коэффициент мутации
+    double m_mutation;
+};
+
+/**
+ * Генетический алгоритм с хромосомами-перестановками.
+ * Особь, не прошедшая скрещивание, наследует приспособленность родителя,
+ * а мутатор сообщает, что именно он изменил (PermutationMove). Если функция
+ * приспособленности умеет пересчитывать значение по изменению (Delta),
+ * такая особь оценивается за O(1); полностью, за O(n), оцениваются только
+ * дети скрещивания. Полные вычисления выполняются параллельно.
+ * Чтобы не накапливалась погрешность округления приращений, популяция
+ * периодически оценивается полностью, а лучшая перестановка оценивается
+ * полностью перед возвратом результата.
+ * Функция приспособленности - объект с operator()(permutation)
+ * и, необязательно, Delta(permutation, move); решается задача минимизации
+ */
+template<
+    typename RealType,
+    typename Crossover,
+    typename Mutator>
+class PermutationGeneticAlgorithm
+{
+public:
+    // Тип хромосомы
+    using permutation_type = typename Crossover::permutation_type;
+    // Тип значения приспособленности
+    using value_type = RealType;
+    // Тип статистики поколения
+    using statistics_type = GenerationStatistics<value_type>;
+
+    static_assert(std::is_same_v<permutation_type, typename Mutator::permutation_type>,
+        "Crossover and mutator must use the same permutation type");
+public:
+    /**
+     * Конструктор.
+     *
+     * \param populationSize Размер популяции
+     * \param tournamentSize Размер турнира
+     * \param crossoverProbability Вероятность скрещивания пары родителей
+     * \param crossover Алгоритм скрещивания
+     * \param mutator Алгоритм мутации
+     */
+    PermutationGeneticAlgorithm(
+        const std::size_t populationSize,
+        const std::size_t tournamentSize,
+        const double crossoverProbability,
+        const Crossover& crossover,
+        const Mutator& mutator) :
+        m_population(populationSize),
+        m_offspring(populationSize),
+        m_tournamentSize(std::max<std::size_t>(tournamentSize, 1)),
+        m_crossoverProbability(crossoverProbability),
+        m_crossover(crossover),
+        m_mutator(mutator) {}
+
+    /**
+     * Инициализация популяции случайными перестановками
+     *
+     * \param size Количество элементов перестановки
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void Init(
+        const std::size_t size,
+        Engine& engine)
+    {
+        for (auto& permutation : m_population) {
+            permutation = permutation_type(size);
+            permutation.Shuffle(engine);
+        }
+        m_best = permutation_type();
+        m_bestFitness = std::numeric_limits<value_type>::max();
+    }
+
+    /**
+     * Задание количества потоков для полного вычисления приспособленности.
+     * Функция приспособленности должна допускать вызов из нескольких потоков
+     *
+     * \param numThreads Количество потоков (0 - по числу ядер, 1 - последовательно)
+     * \return
+     */
+    void SetEvaluationThreads(
+        const std::size_t numThreads)
+    {
+        m_evaluationThreads = numThreads;
+    }
+
+    /**
+     * Задание периода полной переоценки популяции, накопившей приращения Delta
+     *
+     * \param period Период в поколениях (0 - не переоценивать)
+     * \return
+     */
+    void SetRescorePeriod(
+        const std::size_t period)
+    {
+        m_rescorePeriod = period;
+    }
+
+    /**
+     * Запуск генетического алгоритма
+     *
+     * \param numGenerations Количество поколений
+     * \param fitness Функция приспособленности
+     * \param engine Движок генерации случайных чисел
+     * \return Решение (лучшее найденное значение функции приспособленности)
+     */
+    template<
+        typename Fitness,
+        typename Engine>
+    value_type Run(
+        const std::size_t numGenerations,
+        const Fitness& fitness,
+        Engine& engine)
+    {
+        const std::size_t size = m_population.size();
+        m_statistics.clear();
+        m_numEvaluations = 0;
+        m_numDeltaEvaluations = 0;
+        m_fitness.resize(size);
+        m_offspringFitness.resize(size);
+        m_dirty.assign(size, 1);
+        m_generationEvaluations = Evaluate(m_population, m_fitness, fitness);
+        for (std::size_t i = 0; i < numGenerations; ++i) {
+#ifdef _DEBUG
+            std::cout << "Generation " << i << std::endl;
+#endif
+            RecordStatistics(i);
+            Breed(fitness, engine);
+            if constexpr (has_delta_fitness_v<Fitness, permutation_type>) {
+                // Значения, собранные из приращений, периодически вычисляются заново
+                if (m_rescorePeriod > 0 && (i + 1) % m_rescorePeriod == 0) {
+                    m_dirty.assign(size, 1);
+                }
+            }
+            m_generationEvaluations = Evaluate(m_offspring, m_offspringFitness, fitness);
+            m_population.swap(m_offspring);
+            m_fitness.swap(m_offspringFitness);
+        }
+        RecordStatistics(numGenerations);
+        if constexpr (has_delta_fitness_v<Fitness, permutation_type>) {
+            // Лучшее значение могло быть собрано из приращений
+            if (size > 0) {
+                m_bestFitness = fitness(m_best);
+                ++m_numEvaluations;
+            }
+        }
+        return m_bestFitness;
+    }
+
+    /**
+     * Получение лучшей найденной перестановки
+     *
+     * \return Перестановка
+     */
+    const permutation_type& GetBestPermutation() const
+    {
+        return m_best;
+    }
+
+    /**
+     * Получение популяции
+     *
+     * \return Перестановки популяции
+     */
+    const std::vector<permutation_type>& GetPopulation() const
+    {
+        return m_population;
+    }
+
+    /**
+     * Получение статистики последнего запуска по поколениям
+     *
+     * \return Статистика поколений
+     */
+    const std::vector<statistics_type>& GetStatistics() const
+    {
+        return m_statistics;
+    }
+
+    /**
+     * Получение количества полных вычислений приспособленности за последний запуск
+     *
+     * \return Количество вычислений
+     */
+    std::size_t GetNumEvaluations() const
+    {
+        return m_numEvaluations;
+    }
+
+    /**
+     * Получение количества пересчётов приспособленности по изменению за последний запуск
+     *
+     * \return Количество пересчётов
+     */
+    std::size_t GetNumDeltaEvaluations() const
+    {
+        return m_numDeltaEvaluations;
+    }
+private:
+    /**
+     * Полное вычисление приспособленности особей, помеченных как изменённые
+     *
+     * \param population Популяция
+     * \param values Приспособленность особей
+     * \param fitness Функция приспособленности
+     * \return Количество вычислений
+     */
+    template<
+        typename Fitness>
+    std::size_t Evaluate(
+        const std::vector<permutation_type>& population,
+        std::vector<value_type>& values,
+        const Fitness& fitness)
+    {
+        const auto evaluations = static_cast<std::size_t>(std::count(m_dirty.begin(), m_dirty.end(), 1));
+        m_numEvaluations += evaluations;
+        ParallelFor(0, population.size(), m_evaluationThreads, [&] (const std::size_t i)
+        {
+            if (m_dirty[i]) {
+                values[i] = fitness(population[i]);
+            }
+        });
+        return evaluations;
+    }
+
+    /**
+     * Создание поколения потомков: турнирный отбор, скрещивание и мутация.
+     * Приспособленность потомков, не прошедших скрещивание, пересчитывается
+     * по изменению, если функция приспособленности это поддерживает
+     *
+     * \param fitness Функция приспособленности
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Fitness,
+        typename Engine>
+    void Breed(
+        const Fitness& fitness,
+        Engine& engine)
+    {
+        const std::size_t size = m_population.size();
+        m_parents.resize(size);
+        std::uniform_int_distribution<std::size_t> distribution(0, size - 1);
+        for (auto& index : m_parents) {
+            index = distribution(engine);
+            for (std::size_t i = 1; i < m_tournamentSize; ++i) {
+                const std::size_t candidate = distribution(engine);
+                if (m_fitness[candidate] < m_fitness[index]) {
+                    index = candidate;
+                }
+            }
+        }
+        std::uniform_real_distribution<double> crossoverDistribution(0.0, 1.0);
+        for (std::size_t i = 0; i < size; i += 2) {
+            const std::size_t parent1 = m_parents[i];
+            if (i + 1 < size && crossoverDistribution(engine) < m_crossoverProbability) {
+                const std::size_t parent2 = m_parents[i + 1];
+                m_crossover(m_population[parent1], m_population[parent2], m_offspring[i], m_offspring[i + 1], engine);
+                m_dirty[i] = 1;
+                m_dirty[i + 1] = 1;
+                continue;
+            }
+            // Без скрещивания дети - копии родителей вместе с их приспособленностью
+            for (std::size_t j = i; j < std::min(i + 2, size); ++j) {
+                m_offspring[j] = m_population[m_parents[j]];
+                m_offspringFitness[j] = m_fitness[m_parents[j]];
+                m_dirty[j] = 0;
+            }
+        }
+        PermutationMove move;
+        for (std::size_t i = 0; i < size; ++i) {
+            if (!m_mutator.Propose(m_offspring[i], move, engine)) {
+                continue;
+            }
+            if constexpr (has_delta_fitness_v<Fitness, permutation_type>) {
+                if (!m_dirty[i]) {
+                    m_offspringFitness[i] += fitness.Delta(m_offspring[i], move);
+                    ++m_numDeltaEvaluations;
+                }
+            }
+            else {
+                m_dirty[i] = 1;
+            }
+            m_offspring[i].Apply(move);
+        }
+    }
+
+    /**
+     * Запись статистики текущей популяции и обновление лучшего решения
+     *
+     * \param generation Номер поколения
+     * \return
+     */
+    void RecordStatistics(
+        const std::size_t generation)
+    {
+        const std::size_t size = m_population.size();
+        statistics_type statistics;
+        statistics.generation = generation;
+        if (size > 0) {
+            const std::size_t best = static_cast<std::size_t>(
+                std::min_element(m_fitness.begin(), m_fitness.end()) - m_fitness.begin());
+            double fitnessSum = 0.0;
+            for (const value_type value : m_fitness) {
+                fitnessSum += value;
+            }
+            statistics.bestFitness = m_fitness[best];
+            statistics.meanFitness = static_cast<value_type>(fitnessSum / size);
+            statistics.numEvaluations = m_generationEvaluations;
+            statistics.numSkippedEvaluations = size - m_generationEvaluations;
+            if (m_fitness[best] < m_bestFitness) {
+                m_bestFitness = m_fitness[best];
+                m_best = m_population[best];
+            }
+        }
+        m_statistics.push_back(statistics);
+    }
+private:
+    // Текущая популяция
+    std::vector<permutation_type> m_population;
+    // Популяция потомков
+    std::vector<permutation_type> m_offspring;
+    // Приспособленность текущей популяции
+    std::vector<value_type> m_fitness;
+    // Приспособленность потомков
+    std::vector<value_type> m_offspringFitness;
+    // Признак того, что особь нужно оценить полностью
+    std::vector<char> m_dirty;
+    // Индексы выбранных родителей
+    std::vector<std::size_t> m_parents;
+    // Размер турнира
+    std::size_t m_tournamentSize;
+    // Вероятность скрещивания
+    double m_crossoverProbability;
+    // Алгоритм скрещивания
+    Crossover m_crossover;
+    // Алгоритм мутации
+    Mutator m_mutator;
+    // Лучшая найденная перестановка
+    permutation_type m_best;
+    // Приспособленность лучшей найденной перестановки
+    value_type m_bestFitness = std::numeric_limits<value_type>::max();
+    // Статистика поколений
+    std::vector<statistics_type> m_statistics;
+    // Количество полных вычислений приспособленности
+    std::size_t m_numEvaluations = 0;
+    // Количество пересчётов приспособленности по изменению
+    std::size_t m_numDeltaEvaluations = 0;
+    // Количество полных вычислений приспособленности последнего поколения
+    std::size_t m_generationEvaluations = 0;
+    // Количество потоков вычисления приспособленности
+    std::size_t m_evaluationThreads = 1;
+    // Период полной переоценки популяции в поколениях
+    std::size_t m_rescorePeriod = 100;
+};
+
+}
@@ -1,9 +1,14 @@
 ﻿#pragma once
 
+#include <memory>
 #include <vector>
 #include <algorithm>
 
 #include "Individual.hpp"
+#include "Batch.hpp"
+#include "Parallel.hpp"
+#include "Numa.hpp"
+#include "PopulationGenerators.hpp"
 
 namespace GA
 {
@@ -20,6 +25,8 @@ public:
     using individual_type = Individual<GeneType>;
     // Тип функции приспособленности
     using fitness_function = typename Individual<GeneType>::fitness_function;
+    // Тип массива особей
+    using storage_type = std::vector<individual_type, NumaAllocator<individual_type>>;
 public:
     /**
      * Конструктор.
@@ -31,7 +38,9 @@ public:
         m_population(populationSize) {}     // Задаём размер массива особей
 
     /**
-     * Инициализация популяции
+     * Инициализация популяции.
+     * Если генератор умеет заполнять всю популяцию сразу (Generate),
+     * особи записываются им прямо в массив популяции
      *
      * \param generator Алгоритм генерации популяции
      * \param engine Движок генерации случайных чисел
@@ -44,6 +53,10 @@ public:
         const Generator& generator,
         Engine& engine)
     {
+        if constexpr (has_bulk_generation_v<Generator, individual_type, Engine>) {
+            generator.Generate(GetSpan(), engine);
+            return;
+        }
         // Проходим по каждой особи.
         // На данном этапе особи созданы, но не содержат полезной информации
         // поскольку были сконструированы дефолтным конструктором
@@ -86,6 +99,52 @@ public:
     {
         return m_population[index];
     }
+    /**
+     * Получение участка, содержащего всех особей
+     *
+     * \return Участок популяции
+     */
+    Span<individual_type> GetSpan()
+    {
+        return m_population;
+    }
+    /**
+     * Получение участка, содержащего всех особей
+     *
+     * \return Константный участок популяции
+     */
+    Span<const individual_type> GetSpan() const
+    {
+        return m_population;
+    }
+    /**
+     * Размещение особей по узлам NUMA.
+     * Массив особей выделяется заново, и его страницы впервые затрагивают
+     * потоки размещения - каждый свою часть, которую он затем будет обрабатывать
+     * в CalculateFitness(fitnessFn, placement) и при создании потомков.
+     * Особи копируются в новый массив
+     *
+     * \param placement Размещение потоков (пустое - обычное выделение памяти)
+     * \return
+     */
+    void Place(
+        const std::shared_ptr<const ThreadPlacement>& placement)
+    {
+        storage_type placed(m_population.begin(), m_population.end(),
+            NumaAllocator<individual_type>(placement));
+        m_population = std::move(placed);
+    }
+    /**
+     * Обмен особями с другой популяцией за O(1)
+     *
+     * \param other Другая популяция
+     * \return
+     */
+    void Swap(
+        Population& other)
+    {
+        m_population.swap(other.m_population);
+    }
     /**
      * Вычисление приспособленности у каждой особи
      *
@@ -101,6 +160,100 @@ public:
             individual.CalculateFitness(fitnessFn);
         }
     }
+    /**
+     * Параллельное вычисление приспособленности у каждой особи.
+     * Функция приспособленности должна допускать вызов из нескольких потоков
+     *
+     * \param fitnessFn Функция приспособленности
+     * \param numThreads Количество потоков (0 - по числу ядер, 1 - последовательно)
+     * \return
+     */
+    void CalculateFitness(
+        const fitness_function& fitnessFn,
+        const std::size_t numThreads)
+    {
+        ParallelFor(0, m_population.size(), numThreads, [&] (const std::size_t i)
+        {
+            m_population[i].CalculateFitness(fitnessFn);
+        });
+    }
+    /**
+     * Параллельное вычисление приспособленности потоками с заданным размещением.
+     * Поток w обрабатывает w-ю непрерывную часть популяции - ту же,
+     * что он затронул первым при размещении
+     *
+     * \param fitnessFn Функция приспособленности
+     * \param placement Размещение потоков
+     * \return
+     */
+    void CalculateFitness(
+        const fitness_function& fitnessFn,
+        const ThreadPlacement& placement)
+    {
+        ParallelFor(0, m_population.size(), placement, [&] (const std::size_t i)
+        {
+            m_population[i].CalculateFitness(fitnessFn);
+        });
+    }
+    /**
+     * Сброс вычисленной приспособленности у каждой особи
+     *
+     * \return
+     */
+    void Invalidate()
+    {
+        for (auto& individual : m_population) {
+            individual.Invalidate();
+        }
+    }
+    /**
+     * Параллельное вычисление приспособленности только изменённых особей.
+     * Индексы неоценённых особей сначала собираются в плотный массив,
+     * который затем делится между потоками поровну
+     *
+     * \param fitnessFn Функция приспособленности
+     * \param numThreads Количество потоков (0 - по числу ядер, 1 - последовательно)
+     * \return Количество вычислений приспособленности
+     */
+    std::size_t CalculateChangedFitness(
+        const fitness_function& fitnessFn,
+        const std::size_t numThreads)
+    {
+        m_changed.clear();
+        for (std::size_t i = 0; i < m_population.size(); ++i) {
+            if (!m_population[i].IsEvaluated()) {
+                m_changed.push_back(i);
+            }
+        }
+        ParallelFor(0, m_changed.size(), numThreads, [&] (const std::size_t k)
+        {
+            m_population[m_changed[k]].CalculateFitness(fitnessFn);
+        });
+        return m_changed.size();
+    }
+    /**
+     * Параллельное вычисление приспособленности только изменённых особей
+     * потоками с заданным размещением. Индексы не уплотняются:
+     * поток w проходит свою часть популяции, чтобы обращаться к памяти своего узла
+     *
+     * \param fitnessFn Функция приспособленности
+     * \param placement Размещение потоков
+     * \return Количество вычислений приспособленности
+     */
+    std::size_t CalculateChangedFitness(
+        const fitness_function& fitnessFn,
+        const ThreadPlacement& placement)
+    {
+        const auto changed = static_cast<std::size_t>(std::count_if(m_population.begin(), m_population.end(),
+            [] (const individual_type& individual) { return !individual.IsEvaluated(); }));
+        ParallelFor(0, m_population.size(), placement, [&] (const std::size_t i)
+        {
+            if (!m_population[i].IsEvaluated()) {
+                m_population[i].CalculateFitness(fitnessFn);
+            }
+        });
+        return changed;
+    }
     /**
      * Мутация популяции
      *
@@ -122,6 +275,25 @@ public:
         }
     }
 
+    /**
+     * Частичная сортировка популяции по приспособленности.
+     * После вызова первые count особей - наиболее приспособленные, по возрастанию
+     *
+     * \param count Количество особей, которые нужно упорядочить
+     * \return
+     */
+    void PartialSortByFitness(
+        const std::size_t count)
+    {
+        std::partial_sort(m_population.begin(),
+            m_population.begin() + std::min(count, m_population.size()),
+            m_population.end(),
+            [] (const auto& individual1, const auto& individual2)
+        {
+            return individual1.GetFitness() < individual2.GetFitness();
+        });
+    }
+
     /**
      * Получение наиболее приспособленной особи
      *
@@ -144,7 +316,9 @@ public:
 
 private:
     // Массив особей
-    std::vector<individual_type> m_population;
+    storage_type m_population;
+    // Индексы изменённых особей (буфер CalculateChangedFitness)
+    std::vector<std::size_t> m_changed;
 };
 
 }
@@ -1,15 +1,198 @@
 ﻿#pragma once
 
+#include <array>
+#include <cmath>
+#include <vector>
+#include <cstdint>
 #include <numeric>
 #include <random>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
 
 #include "Individual.hpp"
 #include "IntegerGene.hpp"
 #include "RealGene.hpp"
+#include "Batch.hpp"
+#include "Parallel.hpp"
 
 namespace GA
 {
 
+/**
+ * Способ выбора начальных значений генов.
+ * Ген одномерный, поэтому многомерные последовательности вырождаются
+ * в одномерные, но сохраняют главное свойство - равномерное покрытие
+ * области поиска без пропусков
+ */
+enum class Sampling
+{
+    // Независимые равномерно распределённые значения
+    Uniform,
+    // Последовательность Соболя (в одномерном случае - ван дер Корпута
+    // по основанию 2 в порядке кода Грея)
+    Sobol,
+    // Последовательность Холтона по основанию 3
+    // (основание 2 в одномерном случае даёт те же точки, что и Соболь)
+    Halton,
+    // Латинский гиперкуб: область делится на N равных интервалов,
+    // в каждый попадает ровно одно случайное значение
+    LatinHypercube
+};
+
+/**
+ * Проверка того, что генератор умеет заполнять всю популяцию сразу:
+ * Generate(individuals, engine)
+ */
+template<
+    typename Generator,
+    typename IndividualType,
+    typename Engine,
+    typename = void>
+struct has_bulk_generation : std::false_type {};
+
+template<
+    typename Generator,
+    typename IndividualType,
+    typename Engine>
+struct has_bulk_generation<
+    Generator,
+    IndividualType,
+    Engine,
+    std::void_t<decltype(std::declval<const Generator&>().Generate(
+        std::declval<Span<IndividualType>>(),
+        std::declval<Engine&>()))>> : std::true_type {};
+
+template<
+    typename Generator,
+    typename IndividualType,
+    typename Engine>
+inline constexpr bool has_bulk_generation_v = has_bulk_generation<Generator, IndividualType, Engine>::value;
+
+/**
+ * Обращение порядка бит 64-битного числа
+ *
+ * \param value Число
+ * \return Число с обратным порядком бит
+ */
+inline std::uint64_t ReverseBits(
+    std::uint64_t value)
+{
+    value = ((value >> 1) & 0x5555555555555555ull) | ((value & 0x5555555555555555ull) << 1);
+    value = ((value >> 2) & 0x3333333333333333ull) | ((value & 0x3333333333333333ull) << 2);
+    value = ((value >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((value & 0x0F0F0F0F0F0F0F0Full) << 4);
+    value = ((value >> 8) & 0x00FF00FF00FF00FFull) | ((value & 0x00FF00FF00FF00FFull) << 8);
+    value = ((value >> 16) & 0x0000FFFF0000FFFFull) | ((value & 0x0000FFFF0000FFFFull) << 16);
+    return (value >> 32) | (value << 32);
+}
+
+/**
+ * Точка одномерной последовательности Соболя в [0, 1).
+ * Точка вычисляется по номеру независимо от остальных,
+ * поэтому последовательность заполняется параллельно
+ *
+ * \param index Номер точки
+ * \return Точка
+ */
+inline double SobolPoint(
+    const std::uint64_t index)
+{
+    // 53 старших бита - вся точность double
+    return static_cast<double>(ReverseBits(index ^ (index >> 1)) >> 11) * 0x1.0p-53;
+}
+
+/**
+ * Обратная запись номера в системе счисления base после запятой
+ * (точка последовательности ван дер Корпута) в [0, 1)
+ *
+ * \param index Номер точки
+ * \param base Основание
+ * \return Точка
+ */
+inline double RadicalInverse(
+    std::uint64_t index,
+    const std::uint64_t base)
+{
+    const double inverseBase = 1.0 / static_cast<double>(base);
+    double scale = inverseBase;
+    double result = 0.0;
+    while (index > 0) {
+        result += static_cast<double>(index % base) * scale;
+        index /= base;
+        scale *= inverseBase;
+    }
+    return result;
+}
+
+/**
+ * Последовательные точки ван дер Корпута начиная с заданного номера.
+ * Цифры номера хранятся и увеличиваются с переносом, поэтому следующая
+ * точка получается в среднем за O(1), а не за O(log n) делений
+ */
+class RadicalInverseSequence
+{
+public:
+    /**
+     * Конструктор.
+     *
+     * \param index Номер первой точки
+     * \param base Основание
+     */
+    RadicalInverseSequence(
+        std::uint64_t index,
+        const std::uint32_t base) :
+        m_base(base),
+        m_value(RadicalInverse(index, base))
+    {
+        double scale = 1.0 / base;
+        for (std::size_t i = 0; i < m_scales.size(); ++i) {
+            m_scales[i] = scale;
+            scale /= base;
+        }
+        for (std::size_t i = 0; index > 0; ++i) {
+            m_digits[i] = static_cast<std::uint32_t>(index % base);
+            index /= base;
+        }
+    }
+
+    /**
+     * Получение текущей точки и переход к следующей
+     *
+     * \return Точка в [0, 1)
+     */
+    double Next()
+    {
+        const double result = m_value;
+        std::size_t digit = 0;
+        for (; m_digits[digit] == m_base - 1; ++digit) {
+            m_digits[digit] = 0;
+            m_value -= (m_base - 1) * m_scales[digit];
+        }
+        ++m_digits[digit];
+        m_value += m_scales[digit];
+        return result;
+    }
+private:
+    // Основание
+    std::uint32_t m_base;
+    // Текущая точка
+    double m_value;
+    // Цифры номера, начиная с младшей
+    std::array<std::uint32_t, 64> m_digits {};
+    // Вес каждой цифры: base^-(i + 1)
+    std::array<double, 64> m_scales {};
+};
+
+/**
+ * Генератор особей со значениями генов в [minValue, maxValue).
+ * operator() создаёт одну случайную особь. Generate заполняет всю популяцию
+ * сразу прямо в её массиве: популяция делится на блоки постоянного размера,
+ * каждый блок получает свой движок, засеянный от общего, и блоки
+ * обрабатываются параллельно. Поэтому результат зависит только от состояния
+ * общего движка, но не от количества потоков. Квазислучайные
+ * последовательности сдвигаются на общее случайное смещение по модулю 1
+ * (сдвиг Крэнли-Паттерсона), чтобы разные запуски начинались по-разному
+ */
 template<
     typename GeneType>
 class DefaultPopulationGenerator
@@ -19,27 +202,95 @@ public:
     using value_type = typename Individual<GeneType>::value_type;
     using gene_type = typename Individual<GeneType>::gene_type;
 public:
+    /**
+     * Конструктор.
+     *
+     * \param minValue Нижняя граница значений генов
+     * \param maxValue Верхняя граница значений генов
+     * \param sampling Способ выбора значений при заполнении всей популяции
+     * \param numThreads Количество потоков заполнения (0 - по числу ядер, 1 - последовательно)
+     */
     DefaultPopulationGenerator(
         const value_type minValue,
-        const value_type maxValue) :
+        const value_type maxValue,
+        const Sampling sampling = Sampling::Uniform,
+        const std::size_t numThreads = 1) :
         m_minValue(minValue),
         m_maxValue(maxValue),
-        m_distribution(minValue, maxValue) {}
+        m_distribution(minValue, maxValue),
+        m_sampling(sampling),
+        m_numThreads(numThreads) {}
 
     template<
         typename Engine>
     individual_type operator () (
             Engine& engine) const
     {
-        if constexpr (GeneType::is_integer) {
-            return Individual(IntegerGene<value_type, gene_type> {
-                m_distribution(engine), m_minValue, m_maxValue});
-        }
-        else {
-            return Individual(RealGene<value_type> {
-                m_distribution(engine) });
+        return MakeIndividual(m_distribution(engine));
+    }
+
+    /**
+     * Заполнение всей популяции
+     *
+     * \param individuals Особи популяции
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void Generate(
+        const Span<individual_type> individuals,
+        Engine& engine) const
+    {
+        const std::size_t size = individuals.GetSize();
+        const std::size_t numBlocks = (size + blockSize - 1) / blockSize;
+        const double shift = std::uniform_real_distribution<double>(0.0, 1.0)(engine);
+        std::vector<std::array<typename Engine::result_type, 2>> seeds(numBlocks);
+        if (m_sampling == Sampling::Uniform || m_sampling == Sampling::LatinHypercube) {
+            for (auto& seed : seeds) {
+                seed = { engine(), engine() };
+            }
         }
+        const double scale = static_cast<double>(m_maxValue) - static_cast<double>(m_minValue);
+        ParallelFor(0, numBlocks, m_numThreads, [&] (const std::size_t block)
+        {
+            const std::size_t first = block * blockSize;
+            const std::size_t last = std::min(first + blockSize, size);
+            switch (m_sampling) {
+            case Sampling::Uniform: {
+                Engine blockEngine = MakeEngine<Engine>(seeds[block]);
+                std::uniform_real_distribution<value_type> distribution(m_minValue, m_maxValue);
+                for (std::size_t i = first; i < last; ++i) {
+                    individuals[i] = MakeIndividual(distribution(blockEngine));
+                }
+                break;
+            }
+            case Sampling::Sobol:
+                for (std::size_t i = first; i < last; ++i) {
+                    individuals[i] = MakeIndividual(ToValue(Wrap(SobolPoint(i) + shift), scale));
+                }
+                break;
+            case Sampling::Halton: {
+                RadicalInverseSequence sequence(first, 3);
+                for (std::size_t i = first; i < last; ++i) {
+                    individuals[i] = MakeIndividual(ToValue(Wrap(sequence.Next() + shift), scale));
+                }
+                break;
+            }
+            case Sampling::LatinHypercube: {
+                // В одномерном случае перестановка интервалов не нужна:
+                // порядок особей в популяции не влияет на отбор
+                Engine blockEngine = MakeEngine<Engine>(seeds[block]);
+                std::uniform_real_distribution<double> offset(0.0, 1.0);
+                for (std::size_t i = first; i < last; ++i) {
+                    individuals[i] = MakeIndividual(ToValue((i + offset(blockEngine)) / size, scale));
+                }
+                break;
+            }
+            }
+        });
     }
+
     value_type GetMinValue() const
     {
         return m_minValue;
@@ -49,9 +300,79 @@ public:
         return m_maxValue;
     }
 private:
+    /**
+     * Создание особи по значению гена
+     *
+     * \param value Значение гена
+     * \return Особь
+     */
+    individual_type MakeIndividual(
+        const value_type value) const
+    {
+        if constexpr (GeneType::is_integer) {
+            return Individual(IntegerGene<value_type, gene_type> {
+                value, m_minValue, m_maxValue});
+        }
+        else {
+            return Individual(GeneType {
+                value });
+        }
+    }
+
+    /**
+     * Отображение точки [0, 1) в [minValue, maxValue)
+     *
+     * \param point Точка
+     * \param scale Ширина области
+     * \return Значение гена
+     */
+    value_type ToValue(
+        const double point,
+        const double scale) const
+    {
+        const auto value = static_cast<value_type>(m_minValue + point * scale);
+        // Округление при переходе к value_type не должно давать верхнюю границу
+        return std::min(value, std::nextafter(m_maxValue, m_minValue));
+    }
+
+    /**
+     * Взятие дробной части сдвинутой точки
+     *
+     * \param point Точка в [0, 2)
+     * \return Точка в [0, 1)
+     */
+    static double Wrap(
+        const double point)
+    {
+        return point < 1.0 ? point : point - 1.0;
+    }
+
+    /**
+     * Создание движка блока
+     *
+     * \param seed Зерно
+     * \return Движок
+     */
+    template<
+        typename Engine,
+        typename Seed>
+    static Engine MakeEngine(
+        const Seed& seed)
+    {
+        std::seed_seq sequence(seed.begin(), seed.end());
+        return Engine(sequence);
+    }
+private:
+    // Количество особей в блоке, заполняемом одним движком
+    static constexpr std::size_t blockSize = 1 << 16;
+
     value_type m_minValue;
     value_type m_maxValue;
     mutable std::uniform_real_distribution<value_type> m_distribution;
+    // Способ выбора значений
+    Sampling m_sampling;
+    // Количество потоков заполнения
+    std::size_t m_numThreads;
 };
 
 }
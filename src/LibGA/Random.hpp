@@ -0,0 +1,458 @@
+﻿#pragma once
+
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#include "Batch.hpp"
+
+namespace GA
+{
+
+/**
+ * Генератор SplitMix64.
+ * Используется для получения начальных состояний других генераторов
+ * из одного 64-битного числа: соседние зёрна дают несвязанные состояния
+ * "Fast splittable pseudorandom number generators", Steele, Lea, Flood, 2014
+ */
+class SplitMix64
+{
+public:
+    // Тип генерируемого значения
+    using result_type = std::uint64_t;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param seed Зерно
+     */
+    explicit SplitMix64(
+        const std::uint64_t seed = 0) :
+        m_state(seed) {}
+
+    /**
+     * Генерация следующего значения
+     *
+     * \return Значение
+     */
+    std::uint64_t operator () ()
+    {
+        std::uint64_t z = (m_state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    static constexpr std::uint64_t min()
+    {
+        return 0;
+    }
+    static constexpr std::uint64_t max()
+    {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+private:
+    // Состояние
+    std::uint64_t m_state;
+};
+
+/**
+ * Циклический сдвиг влево
+ *
+ * \param value Значение
+ * \param shift Сдвиг (от 1 до 63)
+ * \return Сдвинутое значение
+ */
+inline std::uint64_t RotateLeft(
+    const std::uint64_t value,
+    const int shift)
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+/**
+ * Генератор xoshiro256++.
+ * Состояние - 256 бит, период 2^256 - 1, одно значение - несколько сложений,
+ * сдвигов и исключающих ИЛИ без умножений, поэтому генератор в несколько раз
+ * быстрее std::mt19937 и подходит для векторизации (см. RandomStream).
+ * Удовлетворяет требованиям UniformRandomBitGenerator и засеивается
+ * как стандартные движки - числом или std::seed_seq
+ * "Scrambled Linear Pseudorandom Number Generators", Blackman, Vigna, 2021
+ */
+class Xoshiro256PlusPlus
+{
+public:
+    // Тип генерируемого значения
+    using result_type = std::uint64_t;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param seed Зерно
+     */
+    explicit Xoshiro256PlusPlus(
+        const std::uint64_t seed = 0x853C49E6748FEA9Bull)
+    {
+        Seed(seed);
+    }
+    /**
+     * Конструктор из последовательности зёрен (например, std::seed_seq)
+     *
+     * \param seeds Последовательность зёрен
+     */
+    template<
+        typename SeedSequence,
+        typename = std::enable_if_t<!std::is_convertible_v<SeedSequence, std::uint64_t>>>
+    explicit Xoshiro256PlusPlus(
+        SeedSequence& seeds)
+    {
+        std::array<std::uint32_t, 8> words;
+        seeds.generate(words.begin(), words.end());
+        for (std::size_t i = 0; i < m_state.size(); ++i) {
+            m_state[i] = (static_cast<std::uint64_t>(words[2 * i]) << 32) | words[2 * i + 1];
+        }
+        // Нулевое состояние - неподвижная точка генератора
+        if (m_state[0] == 0 && m_state[1] == 0 && m_state[2] == 0 && m_state[3] == 0) {
+            Seed(0);
+        }
+    }
+
+    /**
+     * Засеивание числом. Состояние получается генератором SplitMix64
+     *
+     * \param seed Зерно
+     * \return
+     */
+    void Seed(
+        const std::uint64_t seed)
+    {
+        SplitMix64 generator(seed);
+        for (auto& word : m_state) {
+            word = generator();
+        }
+    }
+
+    /**
+     * Генерация следующего значения
+     *
+     * \return Значение
+     */
+    std::uint64_t operator () ()
+    {
+        const std::uint64_t result = RotateLeft(m_state[0] + m_state[3], 23) + m_state[0];
+        const std::uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = RotateLeft(m_state[3], 45);
+        return result;
+    }
+
+    /**
+     * Переход вперёд на 2^128 значений.
+     * Последовательные переходы дают неперекрывающиеся потоки для потоков выполнения
+     *
+     * \return
+     */
+    void Jump()
+    {
+        static constexpr std::uint64_t jump[] = {
+            0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull, 0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+        std::array<std::uint64_t, 4> state {};
+        for (const std::uint64_t word : jump) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (word & (1ull << bit)) {
+                    for (std::size_t i = 0; i < state.size(); ++i) {
+                        state[i] ^= m_state[i];
+                    }
+                }
+                (*this)();
+            }
+        }
+        m_state = state;
+    }
+
+    static constexpr std::uint64_t min()
+    {
+        return 0;
+    }
+    static constexpr std::uint64_t max()
+    {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+private:
+    // Состояние
+    std::array<std::uint64_t, 4> m_state;
+};
+
+/**
+ * Пакетный источник случайных чисел для операторов.
+ * Содержит Lanes независимых генераторов xoshiro256++, состояния которых
+ * хранятся по словам (структура массивов), поэтому один шаг всех генераторов -
+ * цикл фиксированной длины без ветвлений, который компилятор переводит
+ * в векторные инструкции (SSE2, AVX2 или AVX-512 в зависимости от флагов).
+ * Буферы заполняются целиком: равномерные числа в [0, 1), целые в [0, range)
+ * методом Лемира почти без делений, испытания Бернулли, нормальные числа.
+ * Операторы создают источник на пакет, засевая его от своего движка -
+ * тогда движок вызывается пару раз на пакет, а не на каждое число
+ */
+class RandomStream
+{
+public:
+    // Количество независимых генераторов
+    static constexpr std::size_t Lanes = 8;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param seed Зерно
+     */
+    explicit RandomStream(
+        const std::uint64_t seed)
+    {
+        Seed(seed);
+    }
+    /**
+     * Конструктор. Зерно берётся из движка
+     *
+     * \param engine Движок генерации случайных чисел
+     */
+    template<
+        typename Engine,
+        typename = std::enable_if_t<!std::is_integral_v<Engine>>>
+    explicit RandomStream(
+        Engine& engine)
+    {
+        Seed(std::uniform_int_distribution<std::uint64_t>(0, std::numeric_limits<std::uint64_t>::max())(engine));
+    }
+
+    /**
+     * Засеивание числом. Состояния генераторов получаются генератором SplitMix64
+     *
+     * \param seed Зерно
+     * \return
+     */
+    void Seed(
+        const std::uint64_t seed)
+    {
+        SplitMix64 generator(seed);
+        for (auto& word : m_state) {
+            for (auto& lane : word) {
+                lane = generator();
+            }
+        }
+        m_bufferPosition = Lanes;
+    }
+
+    /**
+     * Заполнение массива случайными 64-битными числами
+     *
+     * \param output Массив
+     * \return
+     */
+    void Fill(
+        const Span<std::uint64_t> output)
+    {
+        std::size_t i = 0;
+        const std::size_t size = output.GetSize();
+        for (; i + Lanes <= size; i += Lanes) {
+            Step(output.GetData() + i);
+        }
+        for (; i < size; ++i) {
+            output[i] = Next();
+        }
+    }
+
+    /**
+     * Заполнение массива равномерными числами в [0, 1) с шагом 2^-52.
+     * Старшие биты записываются в мантиссу числа из [1, 2), из которого
+     * вычитается 1 - только целочисленные операции, без преобразования типа
+     *
+     * \param output Массив
+     * \return
+     */
+    void FillUniform(
+        const Span<double> output)
+    {
+        static_assert(sizeof(double) == sizeof(std::uint64_t), "double must be 64 bits wide");
+        const std::size_t size = output.GetSize();
+        std::size_t i = 0;
+        std::array<std::uint64_t, Lanes> bits;
+        std::array<double, Lanes> values;
+        for (; i < size; i += Lanes) {
+            Step(bits.data());
+            for (std::size_t lane = 0; lane < Lanes; ++lane) {
+                bits[lane] = (bits[lane] >> 12) | 0x3FF0000000000000ull;
+            }
+            std::memcpy(values.data(), bits.data(), sizeof(values));
+            const std::size_t count = std::min(Lanes, size - i);
+            for (std::size_t lane = 0; lane < count; ++lane) {
+                output[i + lane] = values[lane] - 1.0;
+            }
+        }
+    }
+
+    /**
+     * Заполнение массива равномерными целыми числами в [0, range).
+     * Метод Лемира: старшая половина произведения 32-битного случайного
+     * числа на range; деление нужно только в редком случае, когда младшая
+     * половина меньше range, и отбрасываются значения, дающие смещение
+     * "Fast Random Integer Generation in an Interval", Lemire, 2019
+     *
+     * \param output Массив
+     * \param range Количество значений (больше 0)
+     * \return
+     */
+    void FillBounded(
+        const Span<std::uint32_t> output,
+        const std::uint32_t range)
+    {
+        const std::size_t size = output.GetSize();
+        std::array<std::uint64_t, Lanes> bits;
+        std::array<std::uint32_t, 2 * Lanes> random;
+        std::array<std::uint64_t, 2 * Lanes> products;
+        for (std::size_t i = 0; i < size; i += random.size()) {
+            Step(bits.data());
+            std::memcpy(random.data(), bits.data(), sizeof(random));
+            // Быстрый путь без ветвлений; признак редкого случая собирается в maybeBiased
+            std::uint32_t maybeBiased = 0;
+            for (std::size_t j = 0; j < random.size(); ++j) {
+                products[j] = static_cast<std::uint64_t>(random[j]) * range;
+                maybeBiased |= static_cast<std::uint32_t>(static_cast<std::uint32_t>(products[j]) < range);
+            }
+            if (maybeBiased) {
+                const std::uint32_t threshold = static_cast<std::uint32_t>(0u - range) % range;
+                for (auto& product : products) {
+                    while (static_cast<std::uint32_t>(product) < threshold) {
+                        product = static_cast<std::uint64_t>(static_cast<std::uint32_t>(Next())) * range;
+                    }
+                }
+            }
+            const std::size_t count = std::min(random.size(), size - i);
+            for (std::size_t j = 0; j < count; ++j) {
+                output[i + j] = static_cast<std::uint32_t>(products[j] >> 32);
+            }
+        }
+    }
+
+    /**
+     * Заполнение массива испытаниями Бернулли: 1 с вероятностью probability.
+     * Случайное 64-битное число сравнивается с порогом probability * 2^64
+     *
+     * \param output Массив
+     * \param probability Вероятность единицы
+     * \return
+     */
+    void FillBernoulli(
+        const Span<std::uint8_t> output,
+        const double probability)
+    {
+        const std::size_t size = output.GetSize();
+        if (probability >= 1.0 || probability <= 0.0) {
+            std::fill(output.begin(), output.end(), static_cast<std::uint8_t>(probability >= 1.0));
+            return;
+        }
+        const auto threshold = static_cast<std::uint64_t>(std::ldexp(probability, 64));
+        std::array<std::uint64_t, Lanes> bits;
+        for (std::size_t i = 0; i < size; i += Lanes) {
+            Step(bits.data());
+            const std::size_t count = std::min(Lanes, size - i);
+            for (std::size_t lane = 0; lane < count; ++lane) {
+                output[i + lane] = static_cast<std::uint8_t>(bits[lane] < threshold);
+            }
+        }
+    }
+
+    /**
+     * Заполнение массива стандартными нормальными числами (полярный метод
+     * Марсальи: точка, попавшая в единичный круг, даёт пару нормальных чисел
+     * без вычисления синуса и косинуса; отбрасывается около 21% точек)
+     *
+     * \param output Массив
+     * \return
+     */
+    void FillNormal(
+        const Span<double> output)
+    {
+        const std::size_t size = output.GetSize();
+        std::array<double, Lanes> uniforms;
+        for (std::size_t i = 0; i < size;) {
+            FillUniform(Span<double>(uniforms.data(), uniforms.size()));
+            for (std::size_t lane = 0; lane + 1 < Lanes && i < size; lane += 2) {
+                const double u = 2.0 * uniforms[lane] - 1.0;
+                const double v = 2.0 * uniforms[lane + 1] - 1.0;
+                const double s = u * u + v * v;
+                if (s >= 1.0 || s == 0.0) {
+                    continue;
+                }
+                const double factor = std::sqrt(-2.0 * std::log(s) / s);
+                output[i++] = u * factor;
+                if (i < size) {
+                    output[i++] = v * factor;
+                }
+            }
+        }
+    }
+
+    /**
+     * Генерация одного 64-битного числа
+     *
+     * \return Значение
+     */
+    std::uint64_t Next()
+    {
+        if (m_bufferPosition == Lanes) {
+            Step(m_buffer.data());
+            m_bufferPosition = 0;
+        }
+        return m_buffer[m_bufferPosition++];
+    }
+private:
+    /**
+     * Один шаг всех генераторов
+     *
+     * \param output Массив для Lanes значений
+     * \return
+     */
+    void Step(
+        std::uint64_t* output)
+    {
+        // Состояние копируется в локальные массивы: компилятор видит, что
+        // output с ним не пересекается, и векторизует цикл по генераторам
+        auto s0 = m_state[0];
+        auto s1 = m_state[1];
+        auto s2 = m_state[2];
+        auto s3 = m_state[3];
+        std::array<std::uint64_t, Lanes> result;
+        for (std::size_t lane = 0; lane < Lanes; ++lane) {
+            const std::uint64_t sum = s0[lane] + s3[lane];
+            result[lane] = ((sum << 23) | (sum >> 41)) + s0[lane];
+            const std::uint64_t t = s1[lane] << 17;
+            s2[lane] ^= s0[lane];
+            s3[lane] ^= s1[lane];
+            s1[lane] ^= s2[lane];
+            s0[lane] ^= s3[lane];
+            s2[lane] ^= t;
+            s3[lane] = (s3[lane] << 45) | (s3[lane] >> 19);
+        }
+        m_state = { s0, s1, s2, s3 };
+        std::memcpy(output, result.data(), sizeof(result));
+    }
+private:
+    // Состояния генераторов по словам: m_state[word][lane]
+    alignas(64) std::array<std::array<std::uint64_t, Lanes>, 4> m_state;
+    // Значения последнего шага для Next
+    std::array<std::uint64_t, Lanes> m_buffer {};
+    // Позиция следующего значения в m_buffer
+    std::size_t m_bufferPosition = Lanes;
+};
+
+}
@@ -1,13 +1,19 @@
 ﻿#pragma once
 
+#include "ReducedPrecision.hpp"
+
 namespace GA
 {
 
 /**
  * Ген с вещественным кодированием.
+ * Значение может храниться в более узком типе (float, BFloat16, Float16),
+ * чем тот, в котором выполняются вычисления: это уменьшает объём популяции
+ * и трафик памяти ценой точности хранения
  */
 template<
-    typename RealType>
+    typename RealType,
+    typename StorageType = RealType>
 class RealGene
 {
 public:
@@ -15,6 +21,8 @@ public:
     using value_type = RealType;
     // Тип гена
     using gene_type = RealType;
+    // Тип хранения значения гена и приспособленности особи
+    using storage_type = StorageType;
     // Флаг, говорящий о том,
     // что это ген с вещественным кодированием
     static constexpr bool is_integer = false;
@@ -27,7 +35,7 @@ public:
      */
     RealGene(
         const value_type value) :
-        m_value(value) {}
+        m_value(ToStorage<storage_type>(value)) {}
     /**
      * Получение значения, закодированного геном
      *
@@ -35,7 +43,7 @@ public:
      */
     value_type operator () () const
     {
-        return m_value;
+        return FromStorage<value_type>(m_value);
     }
     /**
      * Получение закодированного гена
@@ -44,7 +52,7 @@ public:
      */
     gene_type GetGene() const
     {
-        return m_value;
+        return FromStorage<gene_type>(m_value);
     }
     /**
      * Установка нового значения гена
@@ -54,13 +62,13 @@ public:
     void SetValue(
         const value_type newValue)
     {
-        m_value = newValue;
+        m_value = ToStorage<storage_type>(newValue);
     }
 private:
     // Значение гена. При вещественном кодировании
     // нет необходимости кодировать ген -
     // закодированный ген и его значение это одно и тоже
-    value_type m_value = static_cast<value_type>(0);
+    storage_type m_value = ToStorage<storage_type>(static_cast<value_type>(0));
 };
 
 }
@@ -0,0 +1,348 @@
+﻿#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+// MSVC не объявляет __F16C__, но с /arch:AVX2 инструкции F16C доступны
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#   define GA_HAS_F16C
+#   include <immintrin.h>
+#endif
+
+namespace GA
+{
+
+/**
+ * Число с плавающей точкой половинной точности (IEEE 754 binary16):
+ * 1 бит знака, 5 бит порядка, 10 бит мантиссы.
+ * Используется только для хранения - арифметика выполняется в float или шире.
+ * Диапазон ограничен ±65504, относительная точность около 2^-11.
+ * Если компилятор собирает код с F16C (-mf16c), преобразования выполняются
+ * одной инструкцией, иначе - программно с округлением к ближайшему чётному
+ */
+class Float16
+{
+public:
+    Float16() = default;
+    /**
+     * Конструктор.
+     *
+     * \param value Значение
+     */
+    explicit Float16(
+        const float value) :
+        m_bits(FromFloat(value)) {}
+    /**
+     * Преобразование в float
+     *
+     * \return Значение
+     */
+    operator float () const
+    {
+        return ToFloat(m_bits);
+    }
+    /**
+     * Получение двоичного представления
+     *
+     * \return Двоичное представление
+     */
+    std::uint16_t GetBits() const
+    {
+        return m_bits;
+    }
+
+    /**
+     * Преобразование float в двоичное представление binary16
+     *
+     * \param value Значение
+     * \return Двоичное представление
+     */
+    static std::uint16_t FromFloat(
+        const float value)
+    {
+#ifdef GA_HAS_F16C
+        return static_cast<std::uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+        std::uint32_t x;
+        std::memcpy(&x, &value, sizeof(x));
+        const std::uint32_t sign = (x >> 16) & 0x8000u;
+        x &= 0x7FFFFFFFu;
+        // Бесконечность или NaN (NaN остаётся NaN)
+        if (x >= 0x7F800000u) {
+            return static_cast<std::uint16_t>(sign | 0x7C00u | (x > 0x7F800000u ? 0x0200u : 0u));
+        }
+        // Всё, что не меньше 65520, округляется в бесконечность
+        if (x >= 0x477FF000u) {
+            return static_cast<std::uint16_t>(sign | 0x7C00u);
+        }
+        // Меньше 2^-14 - денормализованное число или ноль
+        if (x < 0x38800000u) {
+            if (x <= 0x33000000u) {
+                return static_cast<std::uint16_t>(sign);
+            }
+            const std::uint32_t mantissa = (x & 0x007FFFFFu) | 0x00800000u;
+            const std::uint32_t shift = 126u - (x >> 23);
+            std::uint32_t result = mantissa >> shift;
+            const std::uint32_t remainder = mantissa & ((1u << shift) - 1u);
+            const std::uint32_t halfway = 1u << (shift - 1u);
+            if (remainder > halfway || (remainder == halfway && (result & 1u))) {
+                ++result;
+            }
+            return static_cast<std::uint16_t>(sign | result);
+        }
+        // Нормализованное число: смещение порядка 127 -> 15.
+        // Перенос при округлении корректно переходит в порядок
+        std::uint32_t result = (x >> 13) - (112u << 10);
+        const std::uint32_t remainder = x & 0x1FFFu;
+        if (remainder > 0x1000u || (remainder == 0x1000u && (result & 1u))) {
+            ++result;
+        }
+        return static_cast<std::uint16_t>(sign | result);
+#endif
+    }
+    /**
+     * Преобразование двоичного представления binary16 во float (точное)
+     *
+     * \param bits Двоичное представление
+     * \return Значение
+     */
+    static float ToFloat(
+        const std::uint16_t bits)
+    {
+#ifdef GA_HAS_F16C
+        return _cvtsh_ss(bits);
+#else
+        const std::uint32_t sign = static_cast<std::uint32_t>(bits & 0x8000u) << 16;
+        const std::uint32_t exponent = (bits >> 10) & 0x1Fu;
+        const std::uint32_t mantissa = bits & 0x03FFu;
+        if (exponent == 0) {
+            // Ноль или денормализованное число: mantissa * 2^-24
+            const float value = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+            return sign ? -value : value;
+        }
+        std::uint32_t x;
+        if (exponent == 0x1Fu) {
+            x = sign | 0x7F800000u | (mantissa << 13);
+        }
+        else {
+            x = sign | ((exponent + 112u) << 23) | (mantissa << 13);
+        }
+        float value;
+        std::memcpy(&value, &x, sizeof(value));
+        return value;
+#endif
+    }
+private:
+    // Двоичное представление
+    std::uint16_t m_bits = 0;
+};
+
+/**
+ * Число с плавающей точкой bfloat16: старшие 16 бит float
+ * (1 бит знака, 8 бит порядка, 7 бит мантиссы).
+ * Диапазон тот же, что у float, относительная точность около 2^-8.
+ * Используется только для хранения - арифметика выполняется в float или шире
+ */
+class BFloat16
+{
+public:
+    BFloat16() = default;
+    /**
+     * Конструктор.
+     *
+     * \param value Значение
+     */
+    explicit BFloat16(
+        const float value) :
+        m_bits(FromFloat(value)) {}
+    /**
+     * Преобразование в float
+     *
+     * \return Значение
+     */
+    operator float () const
+    {
+        return ToFloat(m_bits);
+    }
+    /**
+     * Получение двоичного представления
+     *
+     * \return Двоичное представление
+     */
+    std::uint16_t GetBits() const
+    {
+        return m_bits;
+    }
+
+    /**
+     * Преобразование float в двоичное представление bfloat16
+     * с округлением к ближайшему чётному
+     *
+     * \param value Значение
+     * \return Двоичное представление
+     */
+    static std::uint16_t FromFloat(
+        const float value)
+    {
+        std::uint32_t x;
+        std::memcpy(&x, &value, sizeof(x));
+        // NaN не должен превратиться в бесконечность при округлении
+        if ((x & 0x7FFFFFFFu) > 0x7F800000u) {
+            return static_cast<std::uint16_t>((x >> 16) | 0x0040u);
+        }
+        x += 0x7FFFu + ((x >> 16) & 1u);
+        return static_cast<std::uint16_t>(x >> 16);
+    }
+    /**
+     * Преобразование двоичного представления bfloat16 во float (точное)
+     *
+     * \param bits Двоичное представление
+     * \return Значение
+     */
+    static float ToFloat(
+        const std::uint16_t bits)
+    {
+        const std::uint32_t x = static_cast<std::uint32_t>(bits) << 16;
+        float value;
+        std::memcpy(&value, &x, sizeof(value));
+        return value;
+    }
+private:
+    // Двоичное представление
+    std::uint16_t m_bits = 0;
+};
+
+/**
+ * Преобразование значения в тип хранения.
+ * Для 16-битных типов значение проходит через float
+ *
+ * \param value Значение
+ * \return Значение в типе хранения
+ */
+template<
+    typename StorageType,
+    typename ValueType>
+StorageType ToStorage(
+    const ValueType value)
+{
+    if constexpr (std::is_arithmetic_v<StorageType>) {
+        return static_cast<StorageType>(value);
+    }
+    else {
+        return StorageType(static_cast<float>(value));
+    }
+}
+
+/**
+ * Преобразование значения из типа хранения в тип вычислений
+ *
+ * \param value Значение в типе хранения
+ * \return Значение
+ */
+template<
+    typename ValueType,
+    typename StorageType>
+ValueType FromStorage(
+    const StorageType value)
+{
+    if constexpr (std::is_arithmetic_v<StorageType>) {
+        return static_cast<ValueType>(value);
+    }
+    else {
+        return static_cast<ValueType>(static_cast<float>(value));
+    }
+}
+
+/**
+ * Пакетное преобразование binary16 во float.
+ * С F16C обрабатывается по 8 значений за инструкцию
+ *
+ * \param input Исходные значения
+ * \param output Результат
+ * \param count Количество значений
+ * \return
+ */
+inline void ConvertToFloat(
+    const Float16* input,
+    float* output,
+    const std::size_t count)
+{
+    static_assert(sizeof(Float16) == sizeof(std::uint16_t), "Float16 must be 16 bits wide");
+    std::size_t i = 0;
+#ifdef GA_HAS_F16C
+    for (; i + 8 <= count; i += 8) {
+        const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(input + i));
+        _mm256_storeu_ps(output + i, _mm256_cvtph_ps(half));
+    }
+#endif
+    for (; i < count; ++i) {
+        output[i] = static_cast<float>(input[i]);
+    }
+}
+
+/**
+ * Пакетное преобразование float в binary16 с округлением к ближайшему чётному.
+ * С F16C обрабатывается по 8 значений за инструкцию
+ *
+ * \param input Исходные значения
+ * \param output Результат
+ * \param count Количество значений
+ * \return
+ */
+inline void ConvertFromFloat(
+    const float* input,
+    Float16* output,
+    const std::size_t count)
+{
+    std::size_t i = 0;
+#ifdef GA_HAS_F16C
+    for (; i + 8 <= count; i += 8) {
+        const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(input + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(output + i), half);
+    }
+#endif
+    for (; i < count; ++i) {
+        output[i] = Float16(input[i]);
+    }
+}
+
+/**
+ * Пакетное преобразование bfloat16 во float.
+ * Преобразование - сдвиг, поэтому цикл векторизуется компилятором
+ *
+ * \param input Исходные значения
+ * \param output Результат
+ * \param count Количество значений
+ * \return
+ */
+inline void ConvertToFloat(
+    const BFloat16* input,
+    float* output,
+    const std::size_t count)
+{
+    static_assert(sizeof(BFloat16) == sizeof(std::uint16_t), "BFloat16 must be 16 bits wide");
+    for (std::size_t i = 0; i < count; ++i) {
+        output[i] = BFloat16::ToFloat(input[i].GetBits());
+    }
+}
+
+/**
+ * Пакетное преобразование float в bfloat16 с округлением к ближайшему чётному
+ *
+ * \param input Исходные значения
+ * \param output Результат
+ * \param count Количество значений
+ * \return
+ */
+inline void ConvertFromFloat(
+    const float* input,
+    BFloat16* output,
+    const std::size_t count)
+{
+    for (std::size_t i = 0; i < count; ++i) {
+        output[i] = BFloat16(input[i]);
+    }
+}
+
+}
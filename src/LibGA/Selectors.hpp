@@ -1,13 +1,18 @@
 ﻿#pragma once
 
+#include <cmath>
 #include <random>
+#include <limits>
 #include <vector>
+#include <numeric>
 #include <algorithm>
+#include <type_traits>
 #ifdef _DEBUG
 #   include <iostream>
 #endif
 
 #include "Population.hpp"
+#include "Random.hpp"
 
 namespace GA
 {
@@ -16,7 +21,9 @@ namespace GA
 
 /**
  * Турнирный отбор.
- * "Генетические алгоритмы на Python", ДМК Пресс, стр. 42
+ * "Генетические алгоритмы на Python", ДМК Пресс, стр. 42.
+ * С обработчиком ограничений ConstraintHandler в режиме FeasibilityRules
+ * турнир сравнивает особи по правилам допустимости Деба
  */
 template<
     typename GeneType>
@@ -55,32 +62,456 @@ public:
 #endif
         // Равномерное распределение для выбора особи из популяции (от 0 до РАЗМЕР_ПОПУЛЯЦИИ - 1)
         std::uniform_int_distribution<std::size_t> distribution(0, population.GetSize() - 1);
-        // Массив, в который будем помещать выбранные особи
-        std::vector<individual_type> selectedIndividuals(m_tournamentSize);
-        // Выбираем особи
-        for (auto& current : selectedIndividuals) {
-            current = population[distribution(engine)];
-        }
+        // Индекс лучшей из выбранных особей. Особи не копируются во временный
+        // массив, поэтому отбор не выделяет память
+        std::size_t best = distribution(engine);
 #ifdef _DEBUG
-        for (const auto& current : selectedIndividuals) {
-            std::cout << "\t\tIndividual: " << current.GetGene()() << std::endl;
-        }
+        std::cout << "\t\tIndividual: " << population[best].GetGene()() << std::endl;
 #endif
-        // Отсортируем массив выбранных особей по возрастанию
+        // Выбираем остальные особи и оставляем наиболее приспособленную.
         // TODO: Добавить предикат сравнения функций приспособленности,
         // поскольку сейчас реализована задача минимизации, но необходимо
         // предусмотреть возможность решать задачу максимизации
-        std::sort(selectedIndividuals.begin(), selectedIndividuals.end(),
-            [] (const auto& individual1, const auto& individual2)
-        {
-            return individual1.GetFitness() < individual2.GetFitness();
-        });
-        // и вернём наиболее приспособленную среди выбранных
-        return selectedIndividuals.front();
+        for (std::size_t i = 1; i < m_tournamentSize; ++i) {
+            const std::size_t current = distribution(engine);
+#ifdef _DEBUG
+            std::cout << "\t\tIndividual: " << population[current].GetGene()() << std::endl;
+#endif
+            if (population[current].GetFitness() < population[best].GetFitness()) {
+                best = current;
+            }
+        }
+        return population[best];
+    }
+
+    /**
+     * Выбор пакета индексов родителей.
+     * В отличие от Select, особи не копируются. Все участники турниров
+     * выбираются заранее одним заполнением буфера
+     *
+     * \param population Популяция
+     * \param indices Массив, заполняемый индексами выбранных особей (размер задаёт вызывающий)
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void SelectIndices(
+        const population_type& population,
+        std::vector<std::size_t>& indices,
+        Engine& engine)
+    {
+        const std::size_t tournamentSize = std::max<std::size_t>(m_tournamentSize, 1);
+        m_candidates.resize(indices.size() * tournamentSize);
+        RandomStream(engine).FillBounded(m_candidates, static_cast<std::uint32_t>(population.GetSize()));
+        const std::uint32_t* candidate = m_candidates.data();
+        for (auto& index : indices) {
+            // Победитель турнира - особь с наименьшим значением функции приспособленности
+            index = *candidate++;
+            for (std::size_t i = 1; i < tournamentSize; ++i, ++candidate) {
+                if (population[*candidate].GetFitness() < population[index].GetFitness()) {
+                    index = *candidate;
+                }
+            }
+        }
     }
 private:
     // Размер турнира
     std::size_t m_tournamentSize;
+    // Участники турниров пакетного отбора
+    std::vector<std::uint32_t> m_candidates;
+};
+
+/**
+ * Таблица псевдонимов (alias method) для выборки из дискретного распределения.
+ * Построение за O(n), выборка за O(1)
+ * "A Linear Algorithm For Generating Random Numbers With a Given Distribution", Vose, 1991
+ */
+class AliasTable
+{
+public:
+    /**
+     * Построение таблицы по неотрицательным весам
+     *
+     * \param weights Веса (не обязательно нормированные)
+     * \return
+     */
+    void Build(
+        const std::vector<double>& weights)
+    {
+        const std::size_t n = weights.size();
+        m_probabilities.resize(n);
+        m_aliases.resize(n);
+        m_small.clear();
+        m_large.clear();
+        const double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+        for (std::size_t i = 0; i < n; ++i) {
+            // Если все веса нулевые, распределение равномерное
+            m_probabilities[i] = sum > 0.0 ? weights[i] * n / sum : 1.0;
+            m_aliases[i] = i;
+            if (m_probabilities[i] < 1.0) {
+                m_small.push_back(i);
+            }
+            else {
+                m_large.push_back(i);
+            }
+        }
+        // Каждую "недополненную" ячейку дополняем за счёт "переполненной"
+        while (!m_small.empty() && !m_large.empty()) {
+            const std::size_t small = m_small.back();
+            m_small.pop_back();
+            const std::size_t large = m_large.back();
+            m_aliases[small] = large;
+            m_probabilities[large] -= 1.0 - m_probabilities[small];
+            if (m_probabilities[large] < 1.0) {
+                m_large.pop_back();
+                m_small.push_back(large);
+            }
+        }
+        // Остатки из-за ошибок округления
+        for (const std::size_t i : m_small) {
+            m_probabilities[i] = 1.0;
+        }
+        for (const std::size_t i : m_large) {
+            m_probabilities[i] = 1.0;
+        }
+    }
+
+    /**
+     * Выборка индекса
+     *
+     * \param engine Движок генерации случайных чисел
+     * \return Индекс
+     */
+    template<
+        typename Engine>
+    std::size_t Sample(
+        Engine& engine) const
+    {
+        std::uniform_int_distribution<std::size_t> cellDistribution(0, m_probabilities.size() - 1);
+        std::uniform_real_distribution<double> coinDistribution(0.0, 1.0);
+        const std::size_t cell = cellDistribution(engine);
+        return coinDistribution(engine) < m_probabilities[cell] ? cell : m_aliases[cell];
+    }
+
+    /**
+     * Выборка пакета индексов. Ячейки и монеты для всех выборок
+     * генерируются заранее одним заполнением буферов
+     *
+     * \param indices Массив, заполняемый индексами (размер задаёт вызывающий)
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void SampleBatch(
+        std::vector<std::size_t>& indices,
+        Engine& engine) const
+    {
+        m_cells.resize(indices.size());
+        m_coins.resize(indices.size());
+        RandomStream stream(engine);
+        stream.FillBounded(m_cells, static_cast<std::uint32_t>(m_probabilities.size()));
+        stream.FillUniform(m_coins);
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            const std::size_t cell = m_cells[i];
+            indices[i] = m_coins[i] < m_probabilities[cell] ? cell : m_aliases[cell];
+        }
+    }
+
+    /**
+     * Получение размера таблицы
+     *
+     * \return Количество элементов распределения
+     */
+    std::size_t GetSize() const
+    {
+        return m_probabilities.size();
+    }
+private:
+    // Вероятности остаться в ячейке
+    std::vector<double> m_probabilities;
+    // Псевдонимы ячеек
+    std::vector<std::size_t> m_aliases;
+    // Рабочие списки построения
+    std::vector<std::size_t> m_small;
+    std::vector<std::size_t> m_large;
+    // Буферы пакетной выборки: ячейки и монеты
+    mutable std::vector<std::uint32_t> m_cells;
+    mutable std::vector<double> m_coins;
 };
 
+/**
+ * Вычисление весов пропорционального отбора для задачи минимизации.
+ * Вес особи - расстояние до худшей особи поколения (windowing).
+ * Худшая особь ищется среди конечных значений приспособленности,
+ * особи с бесконечной приспособленностью (смертельный штраф) получают нулевой вес
+ *
+ * \param population Популяция
+ * \param weights Массив весов
+ * \return
+ */
+template<
+    typename PopulationType>
+void CalculateProportionalWeights(
+    const PopulationType& population,
+    std::vector<double>& weights)
+{
+    weights.resize(population.GetSize());
+    double worst = -std::numeric_limits<double>::infinity();
+    for (std::size_t i = 0; i < population.GetSize(); ++i) {
+        const double fitness = population[i].GetFitness();
+        if (std::isfinite(fitness)) {
+            worst = std::max(worst, fitness);
+        }
+    }
+    for (std::size_t i = 0; i < population.GetSize(); ++i) {
+        const double fitness = population[i].GetFitness();
+        weights[i] = std::isfinite(fitness) ? worst - fitness : 0.0;
+    }
+}
+
+/**
+ * Пропорциональный отбор (рулетка) на основе таблицы псевдонимов.
+ * Таблица строится один раз на поколение за O(n), каждый выбор - O(1)
+ * "Генетические алгоритмы на Python", ДМК Пресс, стр. 39
+ */
+template<
+    typename GeneType>
+class RouletteWheelSelection
+{
+public:
+    // Тип популяции
+    using population_type = Population<GeneType>;
+public:
+    /**
+     * Выбор пакета индексов родителей
+     *
+     * \param population Популяция
+     * \param indices Массив, заполняемый индексами выбранных особей (размер задаёт вызывающий)
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void SelectIndices(
+        const population_type& population,
+        std::vector<std::size_t>& indices,
+        Engine& engine)
+    {
+#ifdef _DEBUG
+        std::cout << "\tRoulette Wheel Selection" << std::endl;
+#endif
+        CalculateProportionalWeights(population, m_weights);
+        m_table.Build(m_weights);
+        m_table.SampleBatch(indices, engine);
+    }
+private:
+    // Веса особей
+    std::vector<double> m_weights;
+    // Таблица псевдонимов
+    AliasTable m_table;
+};
+
+/**
+ * Стохастическая универсальная выборка (SUS).
+ * Все родители выбираются за один линейный проход по популяции
+ * равноотстоящими указателями со случайным сдвигом
+ * "Reducing Bias and Inefficiency in the Selection Algorithm", Baker, 1987
+ */
+template<
+    typename GeneType>
+class StochasticUniversalSampling
+{
+public:
+    // Тип популяции
+    using population_type = Population<GeneType>;
+public:
+    /**
+     * Выбор пакета индексов родителей
+     *
+     * \param population Популяция
+     * \param indices Массив, заполняемый индексами выбранных особей (размер задаёт вызывающий)
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void SelectIndices(
+        const population_type& population,
+        std::vector<std::size_t>& indices,
+        Engine& engine)
+    {
+#ifdef _DEBUG
+        std::cout << "\tStochastic Universal Sampling" << std::endl;
+#endif
+        if (indices.empty()) {
+            return;
+        }
+        CalculateProportionalWeights(population, m_weights);
+        double sum = std::accumulate(m_weights.begin(), m_weights.end(), 0.0);
+        // Все особи одинаковы - равномерное распределение
+        if (sum <= 0.0) {
+            std::fill(m_weights.begin(), m_weights.end(), 1.0);
+            sum = static_cast<double>(m_weights.size());
+        }
+        const double step = sum / indices.size();
+        std::uniform_real_distribution<double> distribution(0.0, step);
+        double pointer = distribution(engine);
+        double cumulative = m_weights[0];
+        std::size_t current = 0;
+        for (auto& index : indices) {
+            while (cumulative <= pointer && current + 1 < m_weights.size()) {
+                cumulative += m_weights[++current];
+            }
+            index = current;
+            pointer += step;
+        }
+        // Указатели дают индексы по порядку, а скрещиваются соседние родители
+        std::shuffle(indices.begin(), indices.end(), engine);
+    }
+private:
+    // Веса особей
+    std::vector<double> m_weights;
+};
+
+/**
+ * Ранговый отбор.
+ * Вероятность выбора зависит только от ранга особи (0 - лучшая):
+ * линейное ранжирование p(r) ∝ s - (2s - 2) r / (n - 1), 1 ≤ s ≤ 2,
+ * экспоненциальное ранжирование p(r) ∝ c^r, 0 < c < 1.
+ * Распределение рангов зависит только от размера популяции, поэтому
+ * таблица псевдонимов для него строится один раз. В каждом поколении сначала
+ * выбираются ранги, а затем упорядочиваются только особи до наибольшего выбранного ранга
+ * "Genetic Algorithms + Data Structures = Evolution Programs", Michalewicz, 1996
+ */
+template<
+    typename GeneType>
+class RankSelection
+{
+public:
+    // Тип популяции
+    using population_type = Population<GeneType>;
+    // Вид ранжирования
+    enum class Scheme
+    {
+        Linear,
+        Exponential
+    };
+public:
+    /**
+     * Конструктор.
+     *
+     * \param scheme Вид ранжирования
+     * \param pressure Давление отбора: s для линейного (от 1 до 2), c для экспоненциального (от 0 до 1)
+     */
+    RankSelection(
+        const Scheme scheme,
+        const double pressure) :
+        m_scheme(scheme),
+        m_pressure(pressure) {}
+
+    /**
+     * Выбор пакета индексов родителей
+     *
+     * \param population Популяция
+     * \param indices Массив, заполняемый индексами выбранных особей (размер задаёт вызывающий)
+     * \param engine Движок генерации случайных чисел
+     * \return
+     */
+    template<
+        typename Engine>
+    void SelectIndices(
+        const population_type& population,
+        std::vector<std::size_t>& indices,
+        Engine& engine)
+    {
+#ifdef _DEBUG
+        std::cout << "\tRank Selection" << std::endl;
+#endif
+        const std::size_t n = population.GetSize();
+        if (m_table.GetSize() != n) {
+            BuildRankTable(n);
+        }
+        // Выбираем ранги
+        m_table.SampleBatch(indices, engine);
+        const std::size_t maxRank = indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end());
+        // Упорядочиваем только нужную часть популяции: O(n + k log k), k = maxRank + 1
+        const auto compare = [&population] (const std::size_t index1, const std::size_t index2)
+        {
+            return population[index1].GetFitness() < population[index2].GetFitness();
+        };
+        m_order.resize(n);
+        std::iota(m_order.begin(), m_order.end(), 0);
+        const auto last = m_order.begin() + std::min(maxRank + 1, n);
+        std::nth_element(m_order.begin(), last - 1, m_order.end(), compare);
+        std::sort(m_order.begin(), last, compare);
+        // Переводим ранги в индексы особей
+        for (auto& index : indices) {
+            index = m_order[index];
+        }
+    }
+private:
+    /**
+     * Построение распределения рангов
+     *
+     * \param size Размер популяции
+     * \return
+     */
+    void BuildRankTable(
+        const std::size_t size)
+    {
+        std::vector<double> weights(size, 1.0);
+        for (std::size_t rank = 0; rank < size; ++rank) {
+            if (m_scheme == Scheme::Linear) {
+                weights[rank] = size > 1
+                    ? m_pressure - (2.0 * m_pressure - 2.0) * rank / (size - 1)
+                    : 1.0;
+            }
+            else {
+                weights[rank] = std::pow(m_pressure, static_cast<double>(rank));
+            }
+        }
+        m_table.Build(weights);
+    }
+private:
+    // Вид ранжирования
+    Scheme m_scheme;
+    // Давление отбора
+    double m_pressure;
+    // Таблица псевдонимов для распределения рангов
+    AliasTable m_table;
+    // Индексы особей, упорядоченные по приспособленности
+    std::vector<std::size_t> m_order;
+};
+
+/**
+ * Проверка наличия у алгоритма выбора пакетного метода SelectIndices
+ */
+template<
+    typename Selector,
+    typename PopulationType,
+    typename Engine,
+    typename = void>
+struct has_batch_selection : std::false_type {};
+
+template<
+    typename Selector,
+    typename PopulationType,
+    typename Engine>
+struct has_batch_selection<
+    Selector,
+    PopulationType,
+    Engine,
+    std::void_t<decltype(std::declval<Selector&>().SelectIndices(
+        std::declval<const PopulationType&>(),
+        std::declval<std::vector<std::size_t>&>(),
+        std::declval<Engine&>()))>> : std::true_type {};
+
+template<
+    typename Selector,
+    typename PopulationType,
+    typename Engine>
+inline constexpr bool has_batch_selection_v = has_batch_selection<Selector, PopulationType, Engine>::value;
+
 }
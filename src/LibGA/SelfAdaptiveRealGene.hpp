@@ -0,0 +1,91 @@
+﻿#pragma once
+
+namespace GA
+{
+
+/**
+ * Ген с вещественным кодированием и собственным шагом мутации.
+ * Шаг мутации (стратегический параметр) эволюционирует вместе со значением гена,
+ * поэтому каждая особь несёт свою величину шага
+ * "Evolution strategies – A comprehensive introduction", Beyer, Schwefel, 2002
+ */
+template<
+    typename RealType>
+class SelfAdaptiveRealGene
+{
+public:
+    // Тип значения гена
+    using value_type = RealType;
+    // Тип гена
+    using gene_type = RealType;
+    // Флаг, говорящий о том,
+    // что это ген с вещественным кодированием
+    static constexpr bool is_integer = false;
+public:
+    SelfAdaptiveRealGene() = default;
+    /**
+     * Конструктор.
+     *
+     * \param value Значение гена
+     * \param stepSize Шаг мутации
+     */
+    SelfAdaptiveRealGene(
+        const value_type value,
+        const value_type stepSize = static_cast<value_type>(1)) :
+        m_value(value),
+        m_stepSize(stepSize) {}
+    /**
+     * Получение значения, закодированного геном
+     *
+     * \return Значение, закодированное геном
+     */
+    value_type operator () () const
+    {
+        return m_value;
+    }
+    /**
+     * Получение закодированного гена
+     *
+     * \return Закодированный ген
+     */
+    gene_type GetGene() const
+    {
+        return m_value;
+    }
+    /**
+     * Установка нового значения гена
+     *
+     * \return
+     */
+    void SetValue(
+        const value_type newValue)
+    {
+        m_value = newValue;
+    }
+    /**
+     * Получение шага мутации
+     *
+     * \return Шаг мутации
+     */
+    value_type GetStepSize() const
+    {
+        return m_stepSize;
+    }
+    /**
+     * Установка нового шага мутации
+     *
+     * \return
+     */
+    void SetStepSize(
+        const value_type newStepSize)
+    {
+        m_stepSize = newStepSize;
+    }
+private:
+    // Значение гена
+    value_type m_value = static_cast<value_type>(0);
+    // Шаг мутации (стандартное отклонение гауссовой мутации)
+    value_type m_stepSize = static_cast<value_type>(1);
+};
+
+}
@@ -0,0 +1,208 @@
+﻿#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace GA
+{
+
+/**
+ * Последовательная блокировка (seqlock) для одного писателя и многих читателей.
+ * Писатель никогда не ждёт: он увеличивает счётчик версий до нечётного значения,
+ * записывает данные и увеличивает счётчик до чётного. Читатель копирует данные
+ * и повторяет чтение, если счётчик был нечётным или изменился за время копирования.
+ * Данные хранятся в атомарных словах, поэтому одновременные чтение и запись
+ * не являются гонкой данных. Тип должен быть тривиально копируемым.
+ * "Can Seqlocks Get Along With Programming Language Memory Models?", Boehm, 2012
+ */
+template<
+    typename T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock requires a trivially copyable type");
+public:
+    SeqLock()
+    {
+        Store(T());
+    }
+    /**
+     * Конструктор копирования: копируется текущее значение
+     *
+     * \param other Другая блокировка
+     */
+    SeqLock(
+        const SeqLock& other)
+    {
+        Store(other.Read());
+    }
+    SeqLock& operator = (
+        const SeqLock& other)
+    {
+        if (this != &other) {
+            Write(other.Read());
+        }
+        return *this;
+    }
+
+    /**
+     * Публикация нового значения. Вызывается только из одного потока
+     *
+     * \param value Значение
+     * \return
+     */
+    void Write(
+        const T& value)
+    {
+        const std::uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        Store(value);
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * Чтение согласованной копии последнего опубликованного значения.
+     * Можно вызывать из любого потока одновременно с Write
+     *
+     * \return Значение
+     */
+    T Read() const
+    {
+        T value;
+        for (;;) {
+            const std::uint64_t before = m_sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                Load(value);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_sequence.load(std::memory_order_relaxed) == before) {
+                    return value;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    /**
+     * Получение номера версии: увеличивается на 1 при каждой публикации
+     *
+     * \return Номер версии
+     */
+    std::uint64_t GetVersion() const
+    {
+        return m_sequence.load(std::memory_order_acquire) / 2;
+    }
+private:
+    // Количество 64-битных слов, в которых хранится значение
+    static constexpr std::size_t numWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    /**
+     * Запись значения в атомарные слова
+     *
+     * \param value Значение
+     * \return
+     */
+    void Store(
+        const T& value)
+    {
+        std::uint64_t words[numWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+        for (std::size_t i = 0; i < numWords; ++i) {
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * Чтение значения из атомарных слов
+     *
+     * \param value Значение
+     * \return
+     */
+    void Load(
+        T& value) const
+    {
+        std::uint64_t words[numWords];
+        for (std::size_t i = 0; i < numWords; ++i) {
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        }
+        std::memcpy(&value, words, sizeof(T));
+    }
+private:
+    // Счётчик версий (нечётный - идёт запись)
+    std::atomic<std::uint64_t> m_sequence { 0 };
+    // Значение, разложенное на атомарные слова
+    std::array<std::atomic<std::uint64_t>, numWords> m_words;
+};
+
+/**
+ * Токен кооперативной отмены.
+ * Копии токена разделяют один флаг: отмена через любую копию
+ * видна всем остальным. Отмена не блокирует и не ждёт остановки
+ */
+class CancellationToken
+{
+public:
+    CancellationToken() :
+        m_cancelled(std::make_shared<std::atomic<bool>>(false)) {}
+
+    /**
+     * Запрос отмены. Можно вызывать из любого потока
+     *
+     * \return
+     */
+    void Cancel() const
+    {
+        m_cancelled->store(true, std::memory_order_release);
+    }
+
+    /**
+     * Сброс запроса отмены, чтобы использовать токен повторно
+     *
+     * \return
+     */
+    void Reset() const
+    {
+        m_cancelled->store(false, std::memory_order_release);
+    }
+
+    /**
+     * Проверка, запрошена ли отмена
+     *
+     * \return true, если отмена запрошена
+     */
+    bool IsCancelled() const
+    {
+        return m_cancelled->load(std::memory_order_acquire);
+    }
+private:
+    // Общий флаг отмены
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+/**
+ * Снимок состояния запуска, доступный из других потоков во время работы алгоритма
+ */
+template<
+    typename IndividualType,
+    typename StatisticsType>
+struct RunSnapshot
+{
+    // Лучшая особь с начала запуска (до первой публикации приспособленность не вычислена)
+    IndividualType best;
+    // Поколение, в котором найдена лучшая особь
+    std::size_t bestGeneration = 0;
+    // Статистика последнего завершённого поколения
+    StatisticsType statistics;
+    // Количество вычислений приспособленности с начала запуска
+    std::size_t totalEvaluations = 0;
+    // Флаг, говорящий о том, что запуск ещё идёт
+    bool running = false;
+    // Флаг, говорящий о том, что запуск остановлен токеном отмены
+    bool cancelled = false;
+};
+
+}
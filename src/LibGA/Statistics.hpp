@@ -0,0 +1,115 @@
+﻿#pragma once
+
+#include <cstddef>
+
+namespace GA
+{
+
+/**
+ * Выделения памяти за этап работы алгоритма
+ */
+struct MemoryUsage
+{
+    // Количество выделений
+    std::size_t numAllocations = 0;
+    // Количество выделенных байт
+    std::size_t numBytes = 0;
+    // Наибольший прирост занятой памяти относительно начала этапа
+    std::size_t peakBytes = 0;
+};
+
+/**
+ * Память поколения по этапам.
+ * Выделения считаются, только если включён учёт памяти
+ * (GeneticAlgorithm::SetMemoryAccounting) и в программе установлен
+ * счётчик глобальных выделений (GA_COUNT_GLOBAL_ALLOCATIONS)
+ */
+struct GenerationMemory
+{
+    // Вычисление приспособленности, обратная связь и локальный поиск
+    MemoryUsage evaluation;
+    // Отбор, скрещивание и мутация
+    MemoryUsage breeding;
+    // Статистика и нишевание
+    MemoryUsage bookkeeping;
+    // Байт, выданных ареной поколения
+    std::size_t arenaBytes = 0;
+    // Байт, которые арене пришлось запросить сверх своего буфера
+    std::size_t arenaUpstreamBytes = 0;
+    // Размер буферов популяций (текущей, потомков и копий родителей)
+    std::size_t populationBytes = 0;
+};
+
+/**
+ * Способ вычисления приспособленности
+ */
+enum class ExecutionStrategy
+{
+    // Последовательно, прямо в массиве особей
+    Serial,
+    // Последовательно по плотному массиву значений генов изменённых особей
+    Batch,
+    // Частями в пуле потоков
+    Parallel
+};
+
+/**
+ * Решение планировщика вычисления приспособленности.
+ * Записывается, только если включено планирование
+ * (GeneticAlgorithm::SetExecutionPlanning)
+ */
+struct ExecutionDecision
+{
+    // Выбранный способ вычисления
+    ExecutionStrategy strategy = ExecutionStrategy::Serial;
+    // Количество потоков
+    std::size_t numThreads = 1;
+    // Размер части, выдаваемой потоку
+    std::size_t chunkSize = 0;
+    // Оценка стоимости одного вычисления, нс
+    double evaluationNs = 0.0;
+    // Оценка накладных расходов на запуск цикла в пуле потоков, нс
+    double dispatchNs = 0.0;
+    // Измеренное ускорение в пуле потоков
+    double speedup = 1.0;
+    // Флаг, говорящий о том, что в этом поколении выполнялась калибровка
+    bool calibrated = false;
+};
+
+/**
+ * Статистика поколения.
+ * Записывается генетическим алгоритмом после вычисления приспособленности
+ */
+template<
+    typename ValueType>
+struct GenerationStatistics
+{
+    // Номер поколения
+    std::size_t generation = 0;
+    // Наименьшее (лучшее) значение функции приспособленности
+    ValueType bestFitness = static_cast<ValueType>(0);
+    // Среднее значение функции приспособленности
+    ValueType meanFitness = static_cast<ValueType>(0);
+    // Среднее значение генов
+    double geneMean = 0.0;
+    // Дисперсия значений генов
+    double geneVariance = 0.0;
+    // Среднее попарное расстояние Хэмминга (только для целочисленных генов)
+    double meanHammingDistance = 0.0;
+    // Средняя энтропия аллелей, от 0 до 1 (только для целочисленных генов)
+    double alleleEntropy = 0.0;
+    // Количество вычислений приспособленности перед записью статистики
+    std::size_t numEvaluations = 0;
+    // Количество особей, не изменившихся с прошлой оценки и не оценённых повторно
+    std::size_t numSkippedEvaluations = 0;
+    // Количество изменённых недопустимых особей, не переданных в функцию приспособленности
+    std::size_t numRejectedEvaluations = 0;
+    // Количество особей, исправленных функцией исправления ограничений
+    std::size_t numRepairs = 0;
+    // Память поколения (только при включённом учёте памяти)
+    GenerationMemory memory;
+    // Решение планировщика вычисления приспособленности
+    ExecutionDecision execution;
+};
+
+}
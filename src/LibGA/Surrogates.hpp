@@ -0,0 +1,396 @@
+﻿#pragma once
+
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <algorithm>
+
+namespace GA
+{
+
+/**
+ * Суррогатная модель - регрессия k ближайших соседей.
+ * Хранит последние capacity точных вычислений в кольцевом буфере
+ * и предсказывает приспособленность взвешенным по обратному расстоянию
+ * средним по k ближайшим точкам
+ */
+template<
+    typename RealType>
+class KNearestNeighboursSurrogate
+{
+public:
+    // Тип значения
+    using value_type = RealType;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param numNeighbours Количество соседей k (не меньше 1)
+     * \param capacity Количество хранимых точек (не меньше 1)
+     */
+    KNearestNeighboursSurrogate(
+        const std::size_t numNeighbours,
+        const std::size_t capacity) :
+        m_numNeighbours(std::max<std::size_t>(numNeighbours, 1)),
+        m_capacity(std::max<std::size_t>(capacity, 1)) {}
+
+    /**
+     * Добавление точного вычисления в обучающую выборку
+     *
+     * \param input Значение гена
+     * \param fitness Значение функции приспособленности
+     * \return
+     */
+    void Train(
+        const value_type input,
+        const value_type fitness)
+    {
+        if (m_samples.size() < m_capacity) {
+            m_samples.emplace_back(input, fitness);
+        }
+        else {
+            m_samples[m_next] = { input, fitness };
+            m_next = (m_next + 1) % m_capacity;
+        }
+    }
+
+    /**
+     * Предсказание значения функции приспособленности
+     *
+     * \param input Значение гена
+     * \return Предсказанное значение
+     */
+    value_type Predict(
+        const value_type input) const
+    {
+        if (m_samples.empty()) {
+            return static_cast<value_type>(0);
+        }
+        m_neighbours.clear();
+        for (const auto& [x, y] : m_samples) {
+            m_neighbours.emplace_back(std::abs(x - input), y);
+        }
+        const std::size_t k = std::min(m_numNeighbours, m_neighbours.size());
+        std::partial_sort(m_neighbours.begin(), m_neighbours.begin() + k, m_neighbours.end(),
+            [] (const auto& neighbour1, const auto& neighbour2)
+        {
+            return neighbour1.first < neighbour2.first;
+        });
+        // Точное совпадение - возвращаем известное значение
+        if (m_neighbours.front().first == static_cast<value_type>(0)) {
+            return m_neighbours.front().second;
+        }
+        value_type weightSum = static_cast<value_type>(0);
+        value_type valueSum = static_cast<value_type>(0);
+        for (std::size_t i = 0; i < k; ++i) {
+            const value_type weight = static_cast<value_type>(1) / m_neighbours[i].first;
+            weightSum += weight;
+            valueSum += weight * m_neighbours[i].second;
+        }
+        return valueSum / weightSum;
+    }
+
+    /**
+     * Получение количества точек в обучающей выборке
+     *
+     * \return Количество точек
+     */
+    std::size_t GetNumSamples() const
+    {
+        return m_samples.size();
+    }
+private:
+    // Количество соседей
+    std::size_t m_numNeighbours;
+    // Количество хранимых точек
+    std::size_t m_capacity;
+    // Индекс точки, которая будет заменена следующей
+    std::size_t m_next = 0;
+    // Обучающая выборка (значение гена, приспособленность)
+    std::vector<std::pair<value_type, value_type>> m_samples;
+    // Буфер для поиска соседей (расстояние, приспособленность)
+    mutable std::vector<std::pair<value_type, value_type>> m_neighbours;
+};
+
+/**
+ * Суррогатная модель - интерполяция радиальными базисными функциями.
+ * Используется кубическое ядро φ(r) = r³ с линейным полиномиальным хвостом:
+ * s(x) = Σ wᵢ φ(|x - xᵢ|) + c₀ + c₁x.
+ * Веса пересчитываются (метод Гаусса) лениво - при первом предсказании
+ * после добавления новых точек
+ */
+template<
+    typename RealType>
+class RadialBasisSurrogate
+{
+public:
+    // Тип значения
+    using value_type = RealType;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param capacity Количество хранимых точек (не меньше 1)
+     */
+    explicit RadialBasisSurrogate(
+        const std::size_t capacity) :
+        m_capacity(std::max<std::size_t>(capacity, 1)) {}
+
+    /**
+     * Добавление точного вычисления в обучающую выборку
+     *
+     * \param input Значение гена
+     * \param fitness Значение функции приспособленности
+     * \return
+     */
+    void Train(
+        const value_type input,
+        const value_type fitness)
+    {
+        m_dirty = true;
+        // Совпадающие точки делают систему вырожденной - обновляем значение
+        for (auto& [x, y] : m_samples) {
+            if (x == input) {
+                y = fitness;
+                return;
+            }
+        }
+        if (m_samples.size() < m_capacity) {
+            m_samples.emplace_back(input, fitness);
+        }
+        else {
+            m_samples[m_next] = { input, fitness };
+            m_next = (m_next + 1) % m_capacity;
+        }
+    }
+
+    /**
+     * Предсказание значения функции приспособленности
+     *
+     * \param input Значение гена
+     * \return Предсказанное значение
+     */
+    value_type Predict(
+        const value_type input) const
+    {
+        if (m_samples.empty()) {
+            return static_cast<value_type>(0);
+        }
+        if (m_dirty) {
+            Fit();
+        }
+        const std::size_t n = m_samples.size();
+        double result = m_weights[n] + m_weights[n + 1] * input;
+        for (std::size_t i = 0; i < n; ++i) {
+            const double r = std::abs(static_cast<double>(input) - m_samples[i].first);
+            result += m_weights[i] * r * r * r;
+        }
+        return static_cast<value_type>(result);
+    }
+
+    /**
+     * Получение количества точек в обучающей выборке
+     *
+     * \return Количество точек
+     */
+    std::size_t GetNumSamples() const
+    {
+        return m_samples.size();
+    }
+private:
+    /**
+     * Решение системы [Φ P; Pᵀ 0] [w; c] = [y; 0]
+     *
+     * \return
+     */
+    void Fit() const
+    {
+        const std::size_t n = m_samples.size();
+        const std::size_t size = n + 2;
+        std::vector<double> matrix(size * size, 0.0);
+        m_weights.assign(size, 0.0);
+        for (std::size_t i = 0; i < n; ++i) {
+            for (std::size_t j = 0; j < n; ++j) {
+                const double r = std::abs(static_cast<double>(m_samples[i].first) - m_samples[j].first);
+                matrix[i * size + j] = r * r * r;
+            }
+            matrix[i * size + n] = 1.0;
+            matrix[i * size + n + 1] = m_samples[i].first;
+            matrix[n * size + i] = 1.0;
+            matrix[(n + 1) * size + i] = m_samples[i].first;
+            m_weights[i] = m_samples[i].second;
+        }
+        // Метод Гаусса с выбором главного элемента по столбцу
+        for (std::size_t column = 0; column < size; ++column) {
+            std::size_t pivot = column;
+            for (std::size_t row = column + 1; row < size; ++row) {
+                if (std::abs(matrix[row * size + column]) > std::abs(matrix[pivot * size + column])) {
+                    pivot = row;
+                }
+            }
+            if (std::abs(matrix[pivot * size + column]) < std::numeric_limits<double>::epsilon()) {
+                continue;
+            }
+            if (pivot != column) {
+                for (std::size_t k = 0; k < size; ++k) {
+                    std::swap(matrix[pivot * size + k], matrix[column * size + k]);
+                }
+                std::swap(m_weights[pivot], m_weights[column]);
+            }
+            for (std::size_t row = column + 1; row < size; ++row) {
+                const double factor = matrix[row * size + column] / matrix[column * size + column];
+                for (std::size_t k = column; k < size; ++k) {
+                    matrix[row * size + k] -= factor * matrix[column * size + k];
+                }
+                m_weights[row] -= factor * m_weights[column];
+            }
+        }
+        for (std::size_t column = size; column-- > 0;) {
+            const double diagonal = matrix[column * size + column];
+            if (std::abs(diagonal) < std::numeric_limits<double>::epsilon()) {
+                m_weights[column] = 0.0;
+                continue;
+            }
+            double sum = m_weights[column];
+            for (std::size_t k = column + 1; k < size; ++k) {
+                sum -= matrix[column * size + k] * m_weights[k];
+            }
+            m_weights[column] = sum / diagonal;
+        }
+        m_dirty = false;
+    }
+private:
+    // Количество хранимых точек
+    std::size_t m_capacity;
+    // Индекс точки, которая будет заменена следующей
+    std::size_t m_next = 0;
+    // Обучающая выборка (значение гена, приспособленность)
+    std::vector<std::pair<value_type, value_type>> m_samples;
+    // Веса ядер и коэффициенты полинома
+    mutable std::vector<double> m_weights;
+    // Флаг, говорящий о том, что веса нужно пересчитать
+    mutable bool m_dirty = true;
+};
+
+/**
+ * Отсев потомков с помощью суррогатной модели.
+ * Генетический алгоритм создаёт в candidatesFactor раз больше потомков,
+ * ранжирует их по предсказанию модели и отправляет на точное вычисление
+ * только лучших. Модель дообучается на каждом точном вычислении.
+ * Пока в модели меньше minSamples точек, отсев не выполняется
+ */
+template<
+    typename Model>
+class SurrogateScreening
+{
+public:
+    // Тип значения
+    using value_type = typename Model::value_type;
+public:
+    /**
+     * Конструктор.
+     *
+     * \param model Суррогатная модель
+     * \param candidatesFactor Во сколько раз кандидатов больше, чем особей в популяции
+     * \param minSamples Минимальное количество точек для начала отсева
+     */
+    SurrogateScreening(
+        const Model& model,
+        const std::size_t candidatesFactor,
+        const std::size_t minSamples) :
+        m_model(model),
+        m_candidatesFactor(candidatesFactor),
+        m_minSamples(minSamples) {}
+
+    /**
+     * Учёт точного вычисления функции приспособленности
+     *
+     * \param input Значение гена
+     * \param fitness Значение функции приспособленности
+     * \return
+     */
+    void Train(
+        const value_type input,
+        const value_type fitness)
+    {
+        ++m_numTrueEvaluations;
+        m_model.Train(input, fitness);
+    }
+
+    /**
+     * Предсказание значения функции приспособленности
+     *
+     * \param input Значение гена
+     * \return Предсказанное значение
+     */
+    value_type Predict(
+        const value_type input)
+    {
+        ++m_numSurrogateEvaluations;
+        return m_model.Predict(input);
+    }
+
+    /**
+     * Проверка готовности модели к отсеву
+     *
+     * \return true, если в модели достаточно точек
+     */
+    bool IsReady() const
+    {
+        return m_model.GetNumSamples() >= m_minSamples;
+    }
+
+    /**
+     * Получение множителя количества кандидатов
+     *
+     * \return Во сколько раз кандидатов больше, чем особей в популяции
+     */
+    std::size_t GetCandidatesFactor() const
+    {
+        return m_candidatesFactor;
+    }
+
+    /**
+     * Получение количества точных вычислений
+     *
+     * \return Количество вычислений функции приспособленности
+     */
+    std::size_t GetNumTrueEvaluations() const
+    {
+        return m_numTrueEvaluations;
+    }
+
+    /**
+     * Получение количества суррогатных вычислений
+     *
+     * \return Количество предсказаний модели
+     */
+    std::size_t GetNumSurrogateEvaluations() const
+    {
+        return m_numSurrogateEvaluations;
+    }
+
+    /**
+     * Получение суррогатной модели
+     *
+     * \return Константная ссылка на модель
+     */
+    const Model& GetModel() const
+    {
+        return m_model;
+    }
+private:
+    // Суррогатная модель
+    Model m_model;
+    // Множитель количества кандидатов
+    std::size_t m_candidatesFactor;
+    // Минимальное количество точек для начала отсева
+    std::size_t m_minSamples;
+    // Количество точных вычислений
+    std::size_t m_numTrueEvaluations = 0;
+    // Количество суррогатных вычислений
+    std::size_t m_numSurrogateEvaluations = 0;
+};
+
+}
@@ -0,0 +1,91 @@
+﻿#include <cmath>
+#include <random>
+
+#include "DifferentialEvolution.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Tests.hpp"
+
+namespace
+{
+
+using RealType = double;
+using DEType = GA::DifferentialEvolution<RealType>;
+using Strategy = DEType::Strategy;
+
+/**
+ * Функция с минимумом 4 в точке 3
+ */
+RealType Parabola(
+    const RealType x)
+{
+    return (x - 3) * (x - 3) + 4;
+}
+
+/**
+ * Запуск дифференциальной эволюции
+ *
+ * \param populationSize Размер популяции
+ * \param strategy Стратегия построения мутантного вектора
+ * \param numGenerations Количество поколений
+ * \param engine Движок генерации случайных чисел
+ * \return Алгоритм после запуска
+ */
+DEType RunDE(
+    const std::size_t populationSize,
+    const Strategy strategy,
+    const std::size_t numGenerations,
+    std::mt19937& engine)
+{
+    DEType de { populationSize, strategy };
+    GA::DefaultPopulationGenerator<GA::RealGene<RealType>> generator(-10.0, 10.0);
+    de.Init(generator, engine);
+    de.Run(numGenerations, Parabola, engine);
+    return de;
+}
+
+/**
+ * Слишком маленькая популяция увеличивается до наименьшего допустимого размера,
+ * а не зацикливает выбор различных индексов
+ */
+void TestSmallPopulation()
+{
+    std::mt19937 engine(1);
+    for (const auto strategy : { Strategy::Rand1Bin, Strategy::Best1Bin, Strategy::CurrentToPBest1Bin }) {
+        for (const std::size_t size : { std::size_t(0), std::size_t(1), std::size_t(3) }) {
+            auto de = RunDE(size, strategy, 5, engine);
+            Check(de.GetPopulation().GetSize() == std::max(size, DEType::GetMinPopulationSize(strategy)),
+                "population is clamped to the strategy minimum");
+            Check(de.GetStatistics().size() == 6, "small population runs all generations");
+        }
+    }
+}
+
+/**
+ * Каждая стратегия находит минимум параболы, а лучшая приспособленность не ухудшается
+ */
+void TestConvergence()
+{
+    for (const auto strategy : { Strategy::Rand1Bin, Strategy::Best1Bin, Strategy::CurrentToPBest1Bin }) {
+        std::mt19937 engine(7);
+        auto de = RunDE(40, strategy, 60, engine);
+        const auto& statistics = de.GetStatistics();
+        for (std::size_t i = 1; i < statistics.size(); ++i) {
+            Check(statistics[i].bestFitness <= statistics[i - 1].bestFitness, "best fitness never gets worse");
+        }
+        CheckNear(statistics.back().bestFitness, 4.0, 1e-6, "strategy finds the minimum");
+        for (const auto& individual : de.GetPopulation().GetSpan()) {
+            Check(individual() >= -10.0 && individual() <= 10.0, "trial vectors stay inside the bounds");
+            CheckNear(individual.GetFitness(), Parabola(individual()), 1e-12, "stored fitness matches the gene");
+        }
+    }
+}
+
+}
+
+int main()
+{
+    TestSmallPopulation();
+    TestConvergence();
+    return Report();
+}
@@ -0,0 +1,182 @@
+﻿#include <random>
+#include <vector>
+
+#include "Permutation.hpp"
+#include "PermutationGeneticAlgorithm.hpp"
+
+#include "Tests.hpp"
+
+namespace
+{
+
+using RealType = double;
+using PermutationType = GA::Permutation<>;
+using MoveType = GA::PermutationMove::Type;
+
+/**
+ * Случайные города в единичном квадрате
+ *
+ * \param size Количество городов
+ * \param engine Движок генерации случайных чисел
+ * \return Функция длины маршрута
+ */
+GA::TourLength<RealType> MakeCities(
+    const std::size_t size,
+    std::mt19937& engine)
+{
+    std::uniform_real_distribution<RealType> distribution(0.0, 1.0);
+    std::vector<RealType> x(size);
+    std::vector<RealType> y(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        x[i] = distribution(engine);
+        y[i] = distribution(engine);
+    }
+    return GA::TourLength<RealType>(std::move(x), std::move(y));
+}
+
+/**
+ * Проверка, что порядок - перестановка, а таблица позиций ему соответствует
+ *
+ * \param permutation Перестановка
+ * \return Согласованы ли таблицы
+ */
+bool IsConsistent(
+    const PermutationType& permutation)
+{
+    std::vector<bool> seen(permutation.GetSize(), false);
+    for (std::size_t i = 0; i < permutation.GetSize(); ++i) {
+        const auto element = permutation[i];
+        if (element >= permutation.GetSize() || seen[element] || permutation.GetPosition(element) != i) {
+            return false;
+        }
+        seen[element] = true;
+    }
+    return true;
+}
+
+/**
+ * Проверка одного изменения: приращение совпадает с разностью полных длин,
+ * а применение изменения сохраняет согласованность таблиц
+ *
+ * \param length Функция длины маршрута
+ * \param tour Маршрут
+ * \param move Изменение
+ * \return
+ */
+void CheckMove(
+    const GA::TourLength<RealType>& length,
+    const PermutationType& tour,
+    const GA::PermutationMove& move)
+{
+    PermutationType changed = tour;
+    changed.Apply(move);
+    Check(IsConsistent(changed), "move keeps order and positions consistent");
+    CheckNear(length.Delta(tour, move), length(changed) - length(tour), 1e-12, "delta matches full recomputation");
+}
+
+/**
+ * Приращение длины для всех изменений всех видов совпадает с полным пересчётом,
+ * включая соседние позиции и участки, проходящие через конец маршрута
+ */
+void TestDeltaMatchesFullLength()
+{
+    std::mt19937 engine(3);
+    for (const std::size_t size : { std::size_t(3), std::size_t(4), std::size_t(5), std::size_t(12) }) {
+        const auto length = MakeCities(size, engine);
+        PermutationType tour(size);
+        tour.Shuffle(engine);
+        for (std::size_t first = 0; first < size; ++first) {
+            for (std::size_t second = 0; second < size; ++second) {
+                CheckMove(length, tour, { MoveType::Insertion, first, second });
+                if (first <= second) {
+                    CheckMove(length, tour, { MoveType::Swap, first, second });
+                    CheckMove(length, tour, { MoveType::Reversal, first, second });
+                }
+            }
+        }
+    }
+}
+
+/**
+ * Изменения, предложенные мутаторами, пересчитываются так же точно
+ */
+void TestMutatorMoves()
+{
+    std::mt19937 engine(5);
+    const std::size_t size = 30;
+    const auto length = MakeCities(size, engine);
+    PermutationType tour(size);
+    tour.Shuffle(engine);
+    const GA::SwapMutator<> swap(0.0);
+    const GA::InsertionMutator<> insertion(0.0);
+    const GA::TwoOptMutator<> twoOpt(0.0);
+    for (int i = 0; i < 200; ++i) {
+        GA::PermutationMove move;
+        if (swap.Propose(tour, move, engine)) {
+            CheckMove(length, tour, move);
+            tour.Apply(move);
+        }
+        if (insertion.Propose(tour, move, engine)) {
+            CheckMove(length, tour, move);
+            tour.Apply(move);
+        }
+        if (twoOpt.Propose(tour, move, engine)) {
+            CheckMove(length, tour, move);
+            tour.Apply(move);
+        }
+    }
+    Check(IsConsistent(tour), "tour stays a permutation after many moves");
+}
+
+/**
+ * Скрещивания дают перестановки
+ */
+void TestCrossoversProducePermutations()
+{
+    std::mt19937 engine(9);
+    const std::size_t size = 17;
+    const GA::OrderCrossover<> order;
+    const GA::PartiallyMappedCrossover<> partiallyMapped;
+    for (int i = 0; i < 100; ++i) {
+        PermutationType parent1(size);
+        PermutationType parent2(size);
+        parent1.Shuffle(engine);
+        parent2.Shuffle(engine);
+        PermutationType child1(size);
+        PermutationType child2(size);
+        order(parent1, parent2, child1, child2, engine);
+        Check(IsConsistent(child1) && IsConsistent(child2), "order crossover produces permutations");
+        partiallyMapped(parent1, parent2, child1, child2, engine);
+        Check(IsConsistent(child1) && IsConsistent(child2), "partially mapped crossover produces permutations");
+    }
+}
+
+/**
+ * Алгоритм с пересчётом по изменению возвращает точную длину лучшего маршрута
+ */
+void TestAlgorithmResult()
+{
+    std::mt19937 engine(11);
+    const std::size_t size = 40;
+    const auto length = MakeCities(size, engine);
+    GA::PermutationGeneticAlgorithm<RealType, GA::OrderCrossover<>, GA::TwoOptMutator<>> ga {
+        50, 2, 0.3, GA::OrderCrossover<>(), GA::TwoOptMutator<>(0.2) };
+    ga.Init(size, engine);
+    const RealType result = ga.Run(100, length, engine);
+    Check(ga.GetNumDeltaEvaluations() > 0, "mutated children are scored by delta");
+    Check(IsConsistent(ga.GetBestPermutation()), "best tour is a permutation");
+    CheckNear(result, length(ga.GetBestPermutation()), 1e-12, "result is the exact length of the best tour");
+    const auto& statistics = ga.GetStatistics();
+    Check(statistics.back().bestFitness < statistics.front().bestFitness, "tour gets shorter");
+}
+
+}
+
+int main()
+{
+    TestDeltaMatchesFullLength();
+    TestMutatorMoves();
+    TestCrossoversProducePermutations();
+    TestAlgorithmResult();
+    return Report();
+}
@@ -0,0 +1,157 @@
+﻿#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+#include <cstdint>
+
+#include "ReducedPrecision.hpp"
+
+#include "Tests.hpp"
+
+namespace
+{
+
+/**
+ * Двоичное представление binary16 для значения
+ *
+ * \param value Значение
+ * \return Двоичное представление
+ */
+std::uint16_t Half(
+    const float value)
+{
+    return GA::Float16::FromFloat(value);
+}
+
+/**
+ * Точные значения, границы диапазона, денормализованные числа,
+ * бесконечности и NaN
+ */
+void TestFloat16SpecialValues()
+{
+    Check(Half(0.0f) == 0x0000, "zero");
+    Check(Half(-0.0f) == 0x8000, "negative zero keeps the sign");
+    Check(Half(1.0f) == 0x3C00, "one");
+    Check(Half(-2.0f) == 0xC000, "minus two");
+    Check(Half(65504.0f) == 0x7BFF, "largest finite value");
+    Check(Half(65519.0f) == 0x7BFF, "values below 65520 round to the largest finite value");
+    Check(Half(65520.0f) == 0x7C00, "values from 65520 round to infinity");
+    Check(Half(std::ldexp(1.0f, -14)) == 0x0400, "smallest normal value");
+    Check(Half(std::ldexp(1.0f, -24)) == 0x0001, "smallest subnormal value");
+    Check(Half(std::ldexp(1.0f, -25)) == 0x0000, "half of the smallest subnormal rounds to even zero");
+    Check(Half(std::ldexp(1.5f, -25)) == 0x0001, "above half of the smallest subnormal rounds up");
+    Check(Half(std::ldexp(3.0f, -25)) == 0x0002, "subnormal tie rounds to even");
+    Check(Half(std::numeric_limits<float>::infinity()) == 0x7C00, "infinity");
+    Check(Half(-std::numeric_limits<float>::infinity()) == 0xFC00, "negative infinity");
+    const std::uint16_t nan = Half(std::numeric_limits<float>::quiet_NaN());
+    Check((nan & 0x7C00) == 0x7C00 && (nan & 0x03FF) != 0, "NaN stays NaN");
+    Check(std::isnan(GA::Float16::ToFloat(nan)), "NaN converts back to NaN");
+    Check(GA::Float16::ToFloat(0x0001) == std::ldexp(1.0f, -24), "subnormal converts back exactly");
+}
+
+/**
+ * Половина шага округляется к чётной мантиссе, больше половины - вверх
+ */
+void TestFloat16RoundToNearestEven()
+{
+    const float step = std::ldexp(1.0f, -10);
+    Check(Half(1.0f + step / 2) == 0x3C00, "tie above an even mantissa rounds down");
+    Check(Half(1.0f + 3 * step / 2) == 0x3C02, "tie above an odd mantissa rounds up");
+    Check(Half(1.0f + step / 2 + std::ldexp(1.0f, -20)) == 0x3C01, "above the tie rounds up");
+    Check(Half(1.0f + step / 2 - std::ldexp(1.0f, -20)) == 0x3C00, "below the tie rounds down");
+    Check(Half(2048.0f - 0.5f) == 0x6800, "carry from the mantissa moves to the exponent");
+
+    // Для случайных значений результат - ближайшее представимое число
+    std::mt19937 engine(1);
+    std::uniform_real_distribution<float> mantissa(1.0f, 2.0f);
+    std::uniform_int_distribution<int> exponent(-26, 15);
+    for (int i = 0; i < 100000; ++i) {
+        const float value = std::ldexp(mantissa(engine), exponent(engine));
+        const std::uint16_t bits = Half(value);
+        const double error = std::abs(static_cast<double>(GA::Float16::ToFloat(bits)) - value);
+        for (const int offset : { -1, 1 }) {
+            const int neighbour = bits + offset;
+            if (neighbour < 0 || neighbour >= 0x7C00) {
+                continue;
+            }
+            const double neighbourError = std::abs(
+                static_cast<double>(GA::Float16::ToFloat(static_cast<std::uint16_t>(neighbour))) - value);
+            if (!(error < neighbourError || (error == neighbourError && (bits & 1) == 0))) {
+                Check(false, "conversion picks the nearest value, ties to even");
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * Каждое значение binary16, кроме NaN, переживает преобразование туда и обратно
+ */
+void TestFloat16RoundTrip()
+{
+    for (std::uint32_t bits = 0; bits <= 0xFFFF; ++bits) {
+        const bool isNan = (bits & 0x7C00) == 0x7C00 && (bits & 0x03FF) != 0;
+        if (!isNan && Half(GA::Float16::ToFloat(static_cast<std::uint16_t>(bits))) != bits) {
+            Check(false, "every binary16 value survives a round trip");
+            return;
+        }
+    }
+}
+
+/**
+ * Пакетные преобразования совпадают с поштучными, включая хвост короче пакета
+ */
+void TestFloat16Batch()
+{
+    std::mt19937 engine(2);
+    std::uniform_real_distribution<float> distribution(-70000.0f, 70000.0f);
+    const std::size_t count = 1003;
+    std::vector<float> values(count);
+    for (auto& value : values) {
+        value = distribution(engine) * std::ldexp(1.0f, static_cast<int>(engine() % 40) - 30);
+    }
+    std::vector<GA::Float16> halves(count);
+    std::vector<float> restored(count);
+    GA::ConvertFromFloat(values.data(), halves.data(), count);
+    GA::ConvertToFloat(halves.data(), restored.data(), count);
+    bool same = true;
+    for (std::size_t i = 0; i < count; ++i) {
+        same = same && halves[i].GetBits() == Half(values[i])
+            && restored[i] == GA::Float16::ToFloat(halves[i].GetBits());
+    }
+    Check(same, "batch conversion matches scalar conversion");
+}
+
+/**
+ * bfloat16: точные значения, округление к чётному и NaN
+ */
+void TestBFloat16()
+{
+    Check(GA::BFloat16::FromFloat(1.0f) == 0x3F80, "bfloat16 one");
+    const float step = std::ldexp(1.0f, -7);
+    Check(GA::BFloat16::FromFloat(1.0f + step / 2) == 0x3F80, "bfloat16 tie rounds to even");
+    Check(GA::BFloat16::FromFloat(1.0f + 3 * step / 2) == 0x3F82, "bfloat16 odd tie rounds up");
+    Check(std::isnan(static_cast<float>(GA::BFloat16(std::numeric_limits<float>::quiet_NaN()))),
+        "bfloat16 NaN stays NaN");
+    Check(static_cast<float>(GA::BFloat16(std::numeric_limits<float>::infinity()))
+        == std::numeric_limits<float>::infinity(), "bfloat16 infinity");
+    for (std::uint32_t bits = 0; bits <= 0xFFFF; ++bits) {
+        const bool isNan = (bits & 0x7F80) == 0x7F80 && (bits & 0x007F) != 0;
+        if (!isNan && GA::BFloat16::FromFloat(GA::BFloat16::ToFloat(static_cast<std::uint16_t>(bits))) != bits) {
+            Check(false, "every bfloat16 value survives a round trip");
+            return;
+        }
+    }
+}
+
+}
+
+int main()
+{
+    TestFloat16SpecialValues();
+    TestFloat16RoundToNearestEven();
+    TestFloat16RoundTrip();
+    TestFloat16Batch();
+    TestBFloat16();
+    return Report();
+}
@@ -0,0 +1,191 @@
+﻿#include <array>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+#include <cstdint>
+
+#include "Snapshot.hpp"
+#include "GeneticAlgorithm.hpp"
+#include "PopulationGenerators.hpp"
+
+#include "Tests.hpp"
+
+namespace
+{
+
+using RealType = double;
+
+/**
+ * Значение из нескольких слов: при разорванном чтении слова различаются
+ */
+struct Record
+{
+    // Слова, в которые писатель записывает одно и то же число
+    std::array<std::uint64_t, 31> words {};
+    // Дополнительное поле нечётного размера
+    std::uint32_t tail = 0;
+};
+
+/**
+ * Запись одного и того же числа во все поля
+ *
+ * \param value Число
+ * \return Значение
+ */
+Record MakeRecord(
+    const std::uint64_t value)
+{
+    Record record;
+    record.words.fill(value);
+    record.tail = static_cast<std::uint32_t>(value);
+    return record;
+}
+
+/**
+ * Проверка, что все поля значения записаны одной публикацией
+ *
+ * \param record Значение
+ * \return Согласовано ли значение
+ */
+bool IsWhole(
+    const Record& record)
+{
+    for (const auto word : record.words) {
+        if (word != record.words[0]) {
+            return false;
+        }
+    }
+    return record.tail == static_cast<std::uint32_t>(record.words[0]);
+}
+
+/**
+ * Чтение, публикация, номер версии и копирование в одном потоке
+ */
+void TestSequential()
+{
+    GA::SeqLock<Record> lock;
+    Check(lock.GetVersion() == 0, "initial version is zero");
+    Check(lock.Read().words[0] == 0 && IsWhole(lock.Read()), "initial value is value-initialised");
+    for (std::uint64_t i = 1; i <= 5; ++i) {
+        lock.Write(MakeRecord(i));
+        Check(lock.GetVersion() == i, "every write increments the version by one");
+        Check(lock.Read().words[0] == i && IsWhole(lock.Read()), "read returns the last write");
+    }
+    GA::SeqLock<Record> copy(lock);
+    Check(copy.Read().words[0] == 5, "copy holds the current value");
+    GA::SeqLock<Record> assigned;
+    assigned = lock;
+    Check(assigned.Read().words[0] == 5 && assigned.GetVersion() == 1, "assignment publishes the current value");
+}
+
+/**
+ * Читатели, работающие одновременно с писателем, никогда не видят
+ * разорванных значений, а значения и версии у каждого читателя не убывают
+ */
+void TestConcurrentReaders()
+{
+    const std::uint64_t minWrites = 200000;
+    const std::size_t minReads = 2000000;
+    const std::size_t numReaders = 3;
+    GA::SeqLock<Record> lock;
+    std::atomic<bool> done { false };
+    std::atomic<std::size_t> torn { 0 };
+    std::atomic<std::size_t> reordered { 0 };
+    std::atomic<std::size_t> reads { 0 };
+    std::vector<std::thread> readers;
+    for (std::size_t i = 0; i < numReaders; ++i) {
+        readers.emplace_back([&] ()
+        {
+            std::uint64_t lastValue = 0;
+            std::uint64_t lastVersion = 0;
+            while (!done.load(std::memory_order_acquire)) {
+                const std::uint64_t version = lock.GetVersion();
+                const Record record = lock.Read();
+                torn += IsWhole(record) ? 0 : 1;
+                reordered += record.words[0] < lastValue || version < lastVersion ? 1 : 0;
+                lastValue = record.words[0];
+                lastVersion = version;
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    // Писатель работает, пока читатели не сделают достаточно чтений
+    std::uint64_t numWrites = 0;
+    while (numWrites < minWrites || reads.load(std::memory_order_relaxed) < minReads) {
+        lock.Write(MakeRecord(++numWrites));
+    }
+    done.store(true, std::memory_order_release);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    Check(torn == 0, "no torn reads");
+    Check(reordered == 0, "values and versions never go backwards");
+    Check(lock.GetVersion() == numWrites && lock.Read().words[0] == numWrites, "final value is the last write");
+}
+
+/**
+ * Копии токена отмены разделяют один флаг
+ */
+void TestCancellationToken()
+{
+    GA::CancellationToken token;
+    const GA::CancellationToken copy = token;
+    Check(!copy.IsCancelled(), "token starts not cancelled");
+    token.Cancel();
+    Check(copy.IsCancelled(), "cancellation is visible through copies");
+    copy.Reset();
+    Check(!token.IsCancelled(), "reset is visible through copies");
+}
+
+/**
+ * Снимки, прочитанные во время работы алгоритма, согласованы,
+ * а отмена из другого потока останавливает запуск
+ */
+void TestRunSnapshots()
+{
+    const auto fitness = [] (const RealType x) { return x * x + 4; };
+    const std::size_t numGenerations = 1000000;
+    const std::size_t cancelGeneration = 20;
+    std::mt19937 engine(3);
+    GA::RealGeneticAlgorithm<RealType> ga { 50, 2, 0.5, { 0.65, 0.1 } };
+    GA::DefaultPopulationGenerator<decltype(ga)::gene_type> generator(-10.0, 10.0);
+    ga.Init(generator, engine);
+    GA::CancellationToken token;
+    ga.SetCancellation(token);
+    std::size_t inconsistent = 0;
+    std::thread reader([&] ()
+    {
+        for (;;) {
+            const auto snapshot = ga.GetSnapshot();
+            if (snapshot.best.IsEvaluated()) {
+                inconsistent += snapshot.best.GetFitness() != fitness(snapshot.best()) ? 1 : 0;
+                inconsistent += snapshot.bestGeneration > snapshot.statistics.generation ? 1 : 0;
+            }
+            if (snapshot.statistics.generation >= cancelGeneration) {
+                break;
+            }
+            std::this_thread::yield();
+        }
+        token.Cancel();
+    });
+    ga.Run(numGenerations, fitness, engine);
+    reader.join();
+    const auto snapshot = ga.GetSnapshot();
+    Check(inconsistent == 0, "snapshots read during the run are consistent");
+    Check(snapshot.cancelled && !snapshot.running, "final snapshot reports the cancelled run as finished");
+    Check(snapshot.statistics.generation >= cancelGeneration && snapshot.statistics.generation < numGenerations,
+        "run stops soon after cancellation");
+    Check(snapshot.best.GetFitness() == fitness(snapshot.best()), "final best fitness matches the gene");
+}
+
+}
+
+int main()
+{
+    TestSequential();
+    TestConcurrentReaders();
+    TestCancellationToken();
+    TestRunSnapshots();
+    return Report();
+}
@@ -0,0 +1,59 @@
+﻿#pragma once
+
+#include <cmath>
+#include <iostream>
+
+// Количество проваленных проверок
+inline int numFailures = 0;
+
+/**
+ * Проверка условия: при невыполнении выводится сообщение и засчитывается провал
+ *
+ * \param condition Условие
+ * \param message Описание проверки
+ * \return
+ */
+inline void Check(
+    const bool condition,
+    const char* message)
+{
+    if (!condition) {
+        ++numFailures;
+        std::cerr << "FAILED: " << message << std::endl;
+    }
+}
+
+/**
+ * Проверка приближённого равенства
+ *
+ * \param actual Полученное значение
+ * \param expected Ожидаемое значение
+ * \param tolerance Допустимое абсолютное отклонение
+ * \param message Описание проверки
+ * \return
+ */
+inline void CheckNear(
+    const double actual,
+    const double expected,
+    const double tolerance,
+    const char* message)
+{
+    if (!(std::abs(actual - expected) <= tolerance)) {
+        ++numFailures;
+        std::cerr << "FAILED: " << message << ": " << actual << " != " << expected << std::endl;
+    }
+}
+
+/**
+ * Итог проверок для возврата из main
+ *
+ * \return 0, если все проверки прошли
+ */
+inline int Report()
+{
+    if (numFailures > 0) {
+        std::cerr << numFailures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}